@@ -154,6 +154,12 @@ PRP_API PRP_Size PRP_CALL CONT_StrArrLen(const CONT_StrArr *pStr_arr) {
     return pStr_arr->len;
 }
 
+PRP_API PRP_Size PRP_CALL CONT_StrArrAllocSize(const CONT_StrArr *pStr_arr) {
+    ASSERT_INVARIANT_EXPR(pStr_arr);
+
+    return pStr_arr->cap * sizeof(StrInfo) + pStr_arr->bffr_size;
+}
+
 PRP_API const PRP_Char8 *PRP_CALL CONT_StrArrGetUnchecked(
     const CONT_StrArr *pStr_arr, PRP_Size i, PRP_Size *pStr_len) {
     ASSERT_INVARIANT_EXPR(pStr_arr);
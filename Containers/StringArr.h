@@ -116,6 +116,16 @@ PRP_API PRP_Result PRP_CALL CONT_StrArrDeleteChecked(CONT_StrArr **ppStr_arr);
  * @note Assumes valid string-array (asserts in debug).
  */
 PRP_API PRP_Size PRP_CALL CONT_StrArrLen(const CONT_StrArr *pStr_arr);
+/**
+ * Returns the number of bytes allocated for the strings and their info.
+ *
+ * @param pStr_arr String-Array instance.
+ *
+ * @return Allocated bytes, excluding the instance itself.
+ *
+ * @note Assumes valid string-array (asserts in debug).
+ */
+PRP_API PRP_Size PRP_CALL CONT_StrArrAllocSize(const CONT_StrArr *pStr_arr);
 
 /**
  * Retrieves the string at the given index.
@@ -23,6 +23,10 @@ extern "C" {
  *     Indicates that PRP is run on linux, and the user specifically wants to
  *     use Wayland window backend for helix, otherwise default window backend
  *     for linux is x11.
+ *
+ * PRP_FECS_SYSTEM_STATS
+ *     Enables per system instance execution counters in FECS, queried via
+ *     FECS_WorldGetSystemStats. Without it nothing is counted or timed.
  */
 
 #ifdef PRP_NDEBUG
@@ -815,6 +819,22 @@ extern "C" {
 #define PRP_UNLIKELY(x) (x)
 #endif
 
+/* ---- PREFETCH ---- */
+
+// Read prefetch hint into all cache levels, a no-op where unsupported.
+#if defined(PRP_HAS_BUILTIN_PREFETCH)
+#define PRP_PREFETCH(pAddr) __builtin_prefetch((pAddr), 0, 3)
+
+#elif defined(PRP_COMPILER_MSVC) &&                                            \
+    (defined(PRP_CPU_COMPILE_ARCH_X86_64_COMPILE) ||                           \
+     defined(PRP_CPU_COMPILE_ARCH_X86_COMPILE))
+#include <xmmintrin.h>
+#define PRP_PREFETCH(pAddr) _mm_prefetch((const char *)(pAddr), _MM_HINT_T0)
+
+#else
+#define PRP_PREFETCH(pAddr) ((void)(pAddr))
+#endif
+
 /* ---- ALIGNMENT ---- */
 
 #if defined(PRP_COMPILER_MSVC)
@@ -5,6 +5,8 @@ extern "C" {
 #endif
 
 #include "Internals/Typedefs.h"
+#include "Math/Matrix/Mat4/Defs.h"
+#include "Math/Vector/Vec3.h"
 
 /* ----  COMPS ---- */
 
@@ -13,23 +15,156 @@ extern "C" {
  *
  * @param pName     The name of the component.
  * @param name_len  The len of the name.
- * @param comp_size The size of the component struct.
+ * @param comp_size The size of the component struct, 0 registers a tag.
  * @param pComp_id  Output pointer to the component id.
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_ALREADY_EXISTS if the component name is already used.
  * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
  * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending, see FECS_WorldLoadAsync.
  * @return PRP_ERR_INV_ARG if arguments are invalid.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -Tags carry no data, they are stored as a single 64 bit mask per chunk
+ *  instead of a component array. Adding/removing a tag is done via
+ *  FECS_EntitySetTag and doesn't move the entity. Layouts still have to declare
+ *  the tags their entities can carry.
+ * -Tags in a system instance inc sub decl only run the system on entities that
+ *  have the tag, tags in the exc sub decl skip entities that have the tag
+ *  without excluding the layout.
  */
 PRP_API PRP_Result PRP_CALL FECS_CompRegister(PRP_Char8 *pName,
                                               PRP_Size name_len,
                                               PRP_Size comp_size,
                                               FECS_CompId *pComp_id);
 
+/**
+ * Registers a new shared component to the FECS registry.
+ * A shared component is stored once per chunk instead of once per entity, and
+ * entities are grouped into chunks by the values of their shared components.
+ *
+ * @param pName     The name of the component.
+ * @param name_len  The len of the name.
+ * @param comp_size The size of the component struct.
+ * @param pComp_id  Output pointer to the component id.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_ALREADY_EXISTS if the component name is already used.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending, see FECS_WorldLoadAsync.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Shared values are given at spawn time via FECS_EntitySpawnShared, entities
+ *  spawned without them get zeroed shared values.
+ * -FECS_EntityGetComp and FECS_SystemInstanceFetchComp return a pointer to the
+ *  single value shared by the chunk, not an array. FECS_EntitySetComp rejects
+ *  shared components since the value isn't owned by a single entity.
+ * -Values are compared bytewise, so the component struct must have no padding
+ *  or have it zeroed, else equal values may land in different chunks.
+ */
+PRP_API PRP_Result PRP_CALL FECS_CompRegisterShared(PRP_Char8 *pName,
+                                                    PRP_Size name_len,
+                                                    PRP_Size comp_size,
+                                                    FECS_CompId *pComp_id);
+
+/**
+ * Registers a new sparse component to the FECS registry.
+ * A sparse component is stored in a dense array per layout holding only the
+ * entities that currently have it, so it can be added/removed in O(1) every
+ * frame without moving the entity.
+ *
+ * @param pName     The name of the component.
+ * @param name_len  The len of the name.
+ * @param comp_size The size of the component struct.
+ * @param pComp_id  Output pointer to the component id.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_ALREADY_EXISTS if the component name is already used.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending, see FECS_WorldLoadAsync.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Layouts still have to declare the sparse components their entities can
+ *  have. Like tags, sparse components in a system instance inc/exc sub decl
+ *  filter entities by whether they currently have the component.
+ * -Inside systems the value is fetched per entity via
+ *  FECS_SystemInstanceFetchSparse.
+ */
+PRP_API PRP_Result PRP_CALL FECS_CompRegisterSparse(PRP_Char8 *pName,
+                                                    PRP_Size name_len,
+                                                    PRP_Size comp_size,
+                                                    FECS_CompId *pComp_id);
+
+/**
+ * Registers a new double buffered component to the FECS registry.
+ * A double buffered component is a regular component array plus a second copy
+ * holding its values as of the last FECS_WorldSwapBuffers, so systems can read
+ * the previous frame of every entity while others write the current one.
+ *
+ * @param pName     The name of the component.
+ * @param name_len  The len of the name.
+ * @param comp_size The size of the component struct.
+ * @param pComp_id  Output pointer to the component id.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_ALREADY_EXISTS if the component name is already used.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending, see FECS_WorldLoadAsync.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Everything except FECS_SystemInstanceFetchPrevComp and
+ *  FECS_SystemInstanceFetchBatchPrevComp accesses the current values, exactly
+ *  like a regular component.
+ * -The previous values are undefined until the first swap after the entity is
+ *  spawned, unless the layout has a default for the comp.
+ */
+PRP_API PRP_Result PRP_CALL FECS_CompRegisterDouble(PRP_Char8 *pName,
+                                                    PRP_Size name_len,
+                                                    PRP_Size comp_size,
+                                                    FECS_CompId *pComp_id);
+/**
+ * Registers a named default value of a component, so that layouts in world
+ * files can spawn their entities with it, e.g:
+ *
+ * layout Mover {
+ *     Pos;
+ *     Vel: Forward;
+ * }
+ *
+ * @param pName       The name of the default.
+ * @param name_len    The len of the name.
+ * @param comp_id     The component the value is of.
+ * @param pData       The value, the size of the comp is copied.
+ * @param pDefault_id Output pointer to the default id.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_ALREADY_EXISTS if the default name is already used.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending, see FECS_WorldLoadAsync.
+ * @return PRP_ERR_INV_ARG if arguments are invalid, or the comp is a tag,
+ *                         shared or sparse comp.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Must be registered before the worlds using it are loaded, layout decls
+ *  naming an unregistered default or a default of another comp are skipped.
+ * -See FECS_LayoutSetDefault for how defaults are applied.
+ */
+PRP_API PRP_Result PRP_CALL FECS_CompDefaultRegister(
+    PRP_Char8 *pName, PRP_Size name_len, FECS_CompId comp_id,
+    const void *pData, FECS_CompDefaultId *pDefault_id);
+
 /* ----  SYSTEMS ---- */
 
 /**
@@ -46,6 +181,7 @@ PRP_API PRP_Result PRP_CALL FECS_CompRegister(PRP_Char8 *pName,
  * @return PRP_ERR_ALREADY_EXISTS if the system name is already used.
  * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
  * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending, see FECS_WorldLoadAsync.
  * @return PRP_ERR_INV_ARG if arguments are invalid or pComp_ids_needed contains
  *                         invalid comp id(s).
  *
@@ -58,6 +194,36 @@ PRP_API PRP_Result PRP_CALL FECS_SystemRegister(PRP_Char8 *pName,
                                                 PRP_Size comp_ids_needed_count,
                                                 FECS_CompId *pComp_ids_needed,
                                                 FECS_SystemId *pSystem_id);
+/**
+ * Registers a new batched system to the FECS registry, its instances receive
+ * upto FECS_SYSTEM_EXEC_BATCH_CAP chunks per call instead of one.
+ *
+ * @param pName                 The name of the system.
+ * @param name_len              The len of the name.
+ * @param system_func           The function pointer to the batched system
+ *                              func.
+ * @param comp_ids_needed_count The len of the pComp_ids_needed array.
+ * @param pComp_ids_needed      The array of component ids the system will use.
+ * @param pSystem_id            Output pointer to the component id.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_ALREADY_EXISTS if the system name is already used.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending, see FECS_WorldLoadAsync.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or pComp_ids_needed contains
+ *                         invalid comp id(s).
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Meant for small systems where the per chunk dispatch outweighs the work,
+ *  the next chunk is prefetched while a batch runs.
+ * -Sparse components can't be fetched from a batched system.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SystemRegisterBatched(
+    PRP_Char8 *pName, PRP_Size name_len, FECS_SystemBatchFunc system_func,
+    PRP_Size comp_ids_needed_count, FECS_CompId *pComp_ids_needed,
+    FECS_SystemId *pSystem_id);
 
 /* ----  WORLD ---- */
 
@@ -93,6 +259,61 @@ PRP_API PRP_Result PRP_CALL FECS_WorldLoad(const PRP_Char8 *pFile_path,
  * -Panics and exits if FECS not initialized correctly.
  */
 PRP_API PRP_Result PRP_CALL FECS_WorldUnload(FECS_WorldId *pWorld_id);
+/**
+ * Starts loading a given world on a background thread, the file read, compile
+ * and world creation all happen off the calling thread.
+ *
+ * @param pFile_path The file path to the world to load.
+ * @param ppTask     Output pointer to the pending load.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if no thread can be started.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Comps, comp defaults and systems can't be registered while a load is
+ *  pending, the compile resolves names against them. Registering returns
+ *  PRP_ERR_BUSY till every load is waited on.
+ * -Every load must be waited on with FECS_WorldLoadWait, even failed ones and
+ *  before FECS_Exit.
+ */
+PRP_API PRP_Result PRP_CALL FECS_WorldLoadAsync(const PRP_Char8 *pFile_path,
+                                                FECS_WorldLoadTask **ppTask);
+/**
+ * Checks without blocking if a pending load is done.
+ *
+ * @param pTask    The pending load.
+ * @param pIs_done Output pointer to PRP_True if FECS_WorldLoadWait won't block.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_WorldLoadPoll(FECS_WorldLoadTask *pTask,
+                                               PRP_Bool *pIs_done);
+/**
+ * Blocks till a pending load is done and adds the world to the FECS. The world
+ * becomes visible only here, as a whole, on the calling thread.
+ *
+ * @param ppTask    The pending load, deleted and set to NULL regardless.
+ * @param pWorld_id Output world id if the loading succeeds.
+ *
+ * @return PRP_OK on full/partial success.
+ * @return PRP_ERR_IO on file opening/indexing errors.
+ * @return PRP_ERR_PARSE on invalid file structure/syntax.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_WorldLoadWait(FECS_WorldLoadTask **ppTask,
+                                               FECS_WorldId *pWorld_id);
 
 /**
  * Finds if a world contains a specific layout seached by its name.
@@ -134,210 +355,1438 @@ PRP_API PRP_Result PRP_CALL FECS_WorldFindLayoutId(FECS_WorldId world_id,
 PRP_API PRP_Result PRP_CALL FECS_WorldFindSystemInstanceId(
     FECS_WorldId world_id, const PRP_Char8 *pName, PRP_Size name_len,
     FECS_SystemInstanceId *pSystem_instance_id);
-
-/* ----  ENTITIES  ---- */
-
 /**
- * Spawns a new entity inside the given world and layout.
+ * Computes the memory footprint of a world.
  *
- * @param world_id  The id to the world in which the layout lies.
- * @param layout_id The id to the layout in which to spawn the entity.
- * @param pEntity   Output pointer to the entity filled with data on success.
+ * @param world_id The id of the world.
+ * @param pStats   Output pointer to the stats.
  *
  * @return PRP_OK on success.
- * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
- * @return PRP_ERR_OOM if allocation fails.
  * @return PRP_ERR_INV_ARG if arguments are invalid.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -Walks every chunk of the world, meant for diagnostics not per frame use.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntitySpawn(FECS_WorldId world_id,
-                                             FECS_LayoutId layout_id,
-                                             FECS_EntityId *pEntity);
+PRP_API PRP_Result PRP_CALL
+FECS_WorldGetMemoryStats(FECS_WorldId world_id, FECS_WorldMemoryStats *pStats);
 /**
- * Spawns a new group of entities inside the given world and layout.
+ * Computes the memory footprint of a layout, split by category.
  *
- * @param world_id     The id to the world in which the layout lies.
- * @param layout_id    The id to the layout in which to spawn the entities.
- * @param entity_count The number of entities to spawn.
- * @param ppGroup      Output pointer to the group filled with data on success.
+ * @param world_id  The id of the world the layout belongs to.
+ * @param layout_id The id of the layout.
+ * @param pStats    Output pointer to the stats.
  *
  * @return PRP_OK on success.
- * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
- * @return PRP_ERR_OOM if allocation fails.
  * @return PRP_ERR_INV_ARG if arguments are invalid.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntityGroupSpawn(FECS_WorldId world_id,
+PRP_API PRP_Result PRP_CALL FECS_WorldGetLayoutMemoryStats(
+    FECS_WorldId world_id, FECS_LayoutId layout_id,
+    FECS_LayoutMemoryStats *pStats);
+/**
+ * Sets the value a component of every entity spawned into a layout starts
+ * with, so spawning doesn't need a FECS_EntitySetComp per component.
+ *
+ * @param world_id  The id of the world the layout belongs to.
+ * @param layout_id The id of the layout.
+ * @param comp_id   The component, must be a regular or double buffered
+ *                  component of the layout.
+ * @param pData     The value, the size of the comp is copied.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid, or the layout doesn't
+ *                         have the comp.
+ * @return PRP_ERR_OOM if allocation fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Defaults can also be declared in the world file, see
+ *  FECS_CompDefaultRegister.
+ * -Once a layout has a default, every component without one starts zeroed.
+ *  Layouts without defaults leave new entities uninitialized.
+ * -Applies to entities spawned afterwards, existing entities are untouched.
+ *  Group spawns fill the whole run of new slots column by column.
+ * -Double buffered comps start with the default in the previous copy too.
+ */
+PRP_API PRP_Result PRP_CALL FECS_LayoutSetDefault(FECS_WorldId world_id,
                                                   FECS_LayoutId layout_id,
-                                                  PRP_Size entity_count,
-                                                  FECS_EntityGroupId **ppGroup);
-
+                                                  FECS_CompId comp_id,
+                                                  const void *pData);
 /**
- * Checks if the given entity is valid.
+ * Moves the chunks of a layout into a memory mapped file, so that chunks of
+ * dormant entities can be paged out of RAM with FECS_LayoutPageOut.
  *
- * @param world_id The world in which the entity exists.
- * @param entity   The entity to check the validity of.
- * @param pRslt    The pointer to where the result is stored.
+ * @param world_id   The id of the world the layout belongs to.
+ * @param layout_id  The id of the layout.
+ * @param pFile_path The path to create the backing file at, e.g. on a disk
+ *                   with room to spare.
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_INV_STATE if the layout already has a backing file holding
+ *                           all its chunks.
+ * @return PRP_ERR_BUSY if spawn contexts of the layout are alive.
+ * @return PRP_ERR_ALREADY_EXISTS if a file exists at the path.
+ * @return PRP_ERR_IO if the file can't be created or grown, chunks moved
+ *                    before the failure stay in the file.
+ * @return PRP_ERR_UNSUPPORTED if the platform can't map files.
+ * @return PRP_ERR_OOM if allocation fails.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -On PRP_ERR_IO or PRP_ERR_OOM after the file is created, the layout keeps
+ *  it with the chunks moved so far and works as usual. Calling again moves
+ *  the rest into the same file, pFile_path is ignored then.
+ * -The file is created exclusively and unlinked right away, it is scratch
+ *  storage for the running process and not a save of the layout.
+ * -Chunks created afterwards are mapped from the file too, its disk space is
+ *  allocated up front so a full disk fails the allocation, not the access.
+ * -Chunks shared with a fork are copied, the fork keeps its own copy.
+ * -Must not be called while a system instance of the world is executing.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntityIsValid(FECS_WorldId world_id,
-                                               const FECS_EntityId entity,
-                                               PRP_Bool *pRslt);
+PRP_API PRP_Result PRP_CALL FECS_LayoutSetBackingFile(
+    FECS_WorldId world_id, FECS_LayoutId layout_id,
+    const PRP_Char8 *pFile_path);
 /**
- * Checks if the given entity group is valid.
+ * Writes the chunks of a layout out to its backing file and drops them from
+ * RAM, they are faulted back in transparently on the next access.
  *
- * @param world_id The world in which the entity group exists.
- * @param pGroup   The entity group to check the validity of.
- * @param pRslt    The pointer to where the result is stored.
+ * @param world_id  The id of the world the layout belongs to.
+ * @param layout_id The id of the layout.
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_BUSY if spawn contexts of the layout are alive.
+ * @return PRP_ERR_IO if a chunk can't be written out or dropped, it stays
+ *                    resident as it was and the rest are still paged out.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -The first page of every chunk, holding the generations and the free and
+ *  enabled slot masks, stays resident, so entity validity checks and empty
+ *  chunk skips never fault. Chunks that fit in a single page gain nothing.
+ * -Chunks not mapped from a backing file are skipped, a layout without one is
+ *  a no-op. See FECS_LayoutSetBackingFile.
+ * -Only pages of chunks accessed afterwards come back, e.g. by a system
+ *  instance iterating the layout or FECS_EntityGetComp.
+ * -Must not be called while a system instance of the world is executing.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntityGroupIsValid(
-    FECS_WorldId world_id, const FECS_EntityGroupId *pGroup, PRP_Bool *pRslt);
-
+PRP_API PRP_Result PRP_CALL FECS_LayoutPageOut(FECS_WorldId world_id,
+                                               FECS_LayoutId layout_id);
 /**
- * Kills the given entity and corrupts the entity struct.
+ * Enables compression of the chunks of a layout that go unaccessed for a
+ * number of frames, see FECS_WorldCompressIdleChunks.
  *
- * @param world_id The world in which the entity exists.
- * @param pEntity  Pointer to the entity to kill.
+ * @param world_id    The id of the world the layout belongs to.
+ * @param layout_id   The id of the layout.
+ * @param idle_frames The frames a chunk must go unaccessed to be compressed,
+ *                    0 to disable compression.
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_OOM if allocation fails, or decompressing a chunk fails when
+ *                     disabling, compression stays enabled then.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -Only the plain column components are compressed, a column at a time with
+ *  the bytes of its values regrouped so that similar values compress well.
+ *  Tags, shared, sparse and double buffered comps stay as they are, so
+ *  validity checks, tag filters and FECS_WorldSwapBuffers never decompress.
+ * -A chunk is decompressed on its first access that may write it: a system
+ *  instance running on it, FECS_EntitySetComp and scatters.
+ *  FECS_EntityGetComp, gathers, column scans and spatial updates only
+ *  decompress the column they read into a scratch and leave the chunk as is,
+ *  the chunks they read are decompressed for good by the next
+ *  FECS_WorldCompressIdleChunks.
+ * -Chunks shared with a world fork and chunks mapped from a backing file are
+ *  not compressed. Forks share compressed chunks as they are, layout merges
+ *  decompress first.
+ * -Disabling decompresses every chunk of the layout.
+ * -The compression ratio is reported by FECS_LayoutGetMemoryStats.
+ * -Must not be called while a system instance of the world is executing.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntityKill(FECS_WorldId world_id,
-                                            FECS_EntityId *pEntity);
-
+PRP_API PRP_Result PRP_CALL FECS_LayoutSetCompression(FECS_WorldId world_id,
+                                                      FECS_LayoutId layout_id,
+                                                      PRP_U32 idle_frames);
 /**
- * Kills the given entity group and nullifies it.
+ * Ends the frame of the double buffered components of a world, their current
+ * values become the values read via FECS_SystemInstanceFetchPrevComp.
  *
- * @param world_id The world in which the entity group exists.
- * @param ppGroup  Pointer to the entity group to kill.
+ * @param world_id The id of the world.
  *
  * @return PRP_OK on success.
- * @return PRP_ERR_INV_ARG if arguments are invalid or *ppGroup is invalid
- *                         internally.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -The current values are kept, so entities not written during the next frame
+ *  still read the same value from both copies.
+ * -Must not be called while a system instance of the world is executing.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntityGroupKill(FECS_WorldId world_id,
-                                                 FECS_EntityGroupId **ppGroup);
-
+PRP_API PRP_Result PRP_CALL FECS_WorldSwapBuffers(FECS_WorldId world_id);
 /**
- * Fetches the specified component's pointer that belongs to the entity.
+ * Ends the frame of the compressing layouts of a world, compressing the chunks
+ * that went unaccessed for as many frames as set by FECS_LayoutSetCompression.
  *
- * @param world_id   The world in which the entity exists.
- * @param entity     The entity to get comp ptr from.
- * @param comp_id    The id of the component to fetch.
- * @param ppComp_ptr Output pointer to store the pointer of the component.
+ * @param world_id The id of the world.
  *
  * @return PRP_OK on success.
- * @return PRP_ERR_INV_ARG if arguments are invalid or entity doesn't have the
- *                         specified component.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_OOM if a chunk can't be allocated, the chunk is left as it
+ *                     was and the rest are still processed.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -Frames are counted by the calls, so it is meant to be called once a frame.
+ * -Compressed chunks read by FECS_EntityGetComp, gathers, column scans or
+ *  spatial updates during the frame are decompressed.
+ * -Chunks that don't shrink to at most 7/8th are left uncompressed, and only
+ *  retried once idle for as many frames again.
+ * -Must not be called while a system instance of the world is executing.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntityGetComp(FECS_WorldId world_id,
-                                               const FECS_EntityId entity,
-                                               FECS_CompId comp_id,
-                                               void **ppComp_ptr);
+PRP_API PRP_Result PRP_CALL FECS_WorldCompressIdleChunks(
+    FECS_WorldId world_id);
 /**
- * Sets the specified component's pointer that belongs to the entity.
+ * Reorders the entities of a layout by a key computed from one of their comps,
+ * so that systems iterate them in ascending key order.
  *
- * @param world_id   The world in which the entity exists.
- * @param entity     The entity to set comp of.
- * @param comp_id    The id of the component to fetch.
- * @param pComp_data Pointer to the data that will be set.
+ * @param world_id    The id of the world the layout belongs to.
+ * @param layout_id   The id of the layout to sort.
+ * @param key_comp_id The comp the key is computed from.
+ * @param key_fn      Computes the key from a pointer to the key comp.
+ * @param pUser_data  Passed to key_fn untouched.
+ * @param ppRemap     Optional output pointer to the handle remap, may be NULL.
  *
  * @return PRP_OK on success.
- * @return PRP_ERR_INV_ARG if arguments are invalid or entity doesn't have the
- *                         specified component.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or the key comp is not a
+ *                         column or double buffered comp of the layout.
+ * @return PRP_ERR_UNSUPPORTED if the layout has shared comps.
+ * @return PRP_ERR_BUSY if the layout has live spawn contexts.
+ * @return PRP_ERR_OOM if memory allocation fails, the layout is untouched.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -Uses a stable radix sort, entities with equal keys keep their order.
+ * -Alive entities are packed into the leading chunks of the layout.
+ * -Ids of entities that moved become invalid, FECS_EntityRemapApply updates
+ *  them from the remap. Entity groups of the layout should be considered
+ *  invalid after a sort.
+ * -The remap must be deleted with FECS_EntityRemapDelete.
+ * -Must not be called while a system instance of the world is executing.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntitySetComp(FECS_WorldId world_id,
-                                               FECS_EntityId entity,
-                                               FECS_CompId comp_id,
-                                               const void *pComp_data);
-
+PRP_API PRP_Result PRP_CALL FECS_LayoutSort(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, FECS_CompId key_comp_id,
+    FECS_LayoutSortKeyFunc key_fn, void *pUser_data,
+    FECS_EntityRemap **ppRemap);
 /**
- * Iterates over the specified component belonging to entities of the group.
+ * Moves every entity of a layout of one world into a layout of another world,
+ * e.g. from a streamed in sector into the live world.
  *
- * @param world_id   The world in which the entity exists.
- * @param pGroup     The group of entities to iterate over.
- * @param comp_id    The id of the component to iterate.
- * @param cb         Callback invoked per element.
- * @param pUser_data User-provided context.
+ * @param dst_world_id  The id of the world to move the entities into.
+ * @param dst_layout_id The id of the layout to move the entities into.
+ * @param src_world_id  The id of the world to move the entities out of.
+ * @param src_layout_id The id of the layout to move the entities out of.
+ * @param ppRemap       Optional output pointer to the handle remap, may be
+ *                      NULL.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or both layouts are the
+ *                         same layout.
+ * @return PRP_ERR_BUSY if either layout has live spawn contexts.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if memory allocation fails, no entity is moved.
  *
- * @return PRP_OK if iteration completes.
- * @return Callback error if cb returns non-PRP_OK.
- * @return PRP_ERR_INV_ARG if arguments are invalid or *ppGroup is invalid
- *                         internally or the entities don't have the specified
- *                         component.
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -Layouts with the same comp set move whole chunks by pointer, no comp data
+ *  is copied. Otherwise comps both layouts have are copied a column at a time,
+ *  comps only the destination has get its defaults and comps only the source
+ *  has are dropped. Compressed source chunks are decompressed first.
+ * -A destination with a backing file always copies, into chunks mapped from
+ *  its file. See FECS_LayoutSetBackingFile.
+ * -Every id of the source layout becomes invalid, FECS_EntityRemapApply
+ *  updates them from the remap. The source layout is left empty and its ids
+ *  may be reused by entities spawned into it later.
+ * -Entity groups of the source layout must not be used across a merge.
+ * -The remap must be deleted with FECS_EntityRemapDelete.
  */
-PRP_API PRP_Result PRP_CALL FECS_EntityGroupForEach(
-    FECS_WorldId world_id, FECS_EntityGroupId *pGroup, FECS_CompId comp_id,
-    PRP_Result (*cb)(void *pComp_data, void *pUser_data), void *pUser_data);
-
-/* ----  SYSTEM INSTANCE ---- */
-
+PRP_API PRP_Result PRP_CALL FECS_WorldMergeLayout(FECS_WorldId dst_world_id,
+                                                  FECS_LayoutId dst_layout_id,
+                                                  FECS_WorldId src_world_id,
+                                                  FECS_LayoutId src_layout_id,
+                                                  FECS_EntityRemap **ppRemap);
 /**
- * Executes the given system instance.
+ * Updates an entity id taken before a FECS_LayoutSort or FECS_WorldMergeLayout
+ * to where the entity lives after it.
  *
- * @param world_id          The world in which the system instance id exists.
- * @param system_instane_id The id of the system instance to execute.
- * @param pUser_data        User-provided context.
+ * @param pRemap  The remap returned by FECS_LayoutSort/FECS_WorldMergeLayout.
+ * @param pEntity The entity id to update.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid, or the entity is not of the
+ *                         sorted/merged layout or was not alive at that time.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityRemapApply(
+    const FECS_EntityRemap *pRemap, FECS_EntityId *pEntity);
+/**
+ * Deletes a remap returned by FECS_LayoutSort or FECS_WorldMergeLayout.
+ *
+ * @param ppRemap The remap to delete, set to NULL.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityRemapDelete(FECS_EntityRemap **ppRemap);
+/**
+ * Forks the entities of a world, to later roll the world back to this point
+ * with FECS_WorldRestore, e.g. for rollback netcode or speculative simulation.
+ *
+ * @param world_id The id of the world.
+ * @param ppFork   Output pointer to the fork.
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_OOM if allocation fails.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -Chunks are shared copy on write, a fork costs a pointer and a ref count
+ *  bump per chunk plus a copy of the sparse component values. A chunk is
+ *  copied the first time it is written after the fork, by the world or by a
+ *  restore.
+ * -Systems don't declare which components they only read, so every chunk a
+ *  system runs on is copied. FECS_EntityGetComp only reads and doesn't copy,
+ *  see its notes.
+ * -Only entities are forked. The hierarchy and system stats are not.
+ * -Compressed chunks are shared compressed, the world and restores decompress
+ *  them on their first write. See FECS_LayoutSetCompression.
+ * -The fork must be deleted with FECS_ForkDelete.
  */
-PRP_API PRP_Result PRP_CALL FECS_SystemInstanceExec(
-    FECS_WorldId world_id, FECS_SystemInstanceId system_instance_id,
-    void *pUser_data);
+PRP_API PRP_Result PRP_CALL FECS_WorldFork(FECS_WorldId world_id,
+                                           FECS_Fork **ppFork);
 /**
- * Fetches an component array inside the system function.
+ * Rolls the entities of a world back to a fork of it.
  *
- * @param pExec_internals The internal data provided during system instance
- *                        execution.
- * @param idx             The index into the strides array to fetch comp array.
- *                        This index corresponds to the user provided
- *                        pComp_ids_needed array during system registration.
- * @param ppComp_arr      Output pointer to the component array.
+ * @param world_id The id of the world.
+ * @param pFork    The fork, must come from this world.
  *
  * @return PRP_OK on success.
- * @return PRP_ERR_OOB if give idx is out of bound to the system required
- *                     strides array.
  * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_BUSY if a layout has live spawn contexts.
+ * @return PRP_ERR_OOM if allocation fails, the world is left untouched.
  *
  * @note:
  * -Panics and exits if FECS not initialized correctly.
+ * -The fork stays valid, so the same fork can be restored any number of times.
+ * -Entity ids from the time of the fork are valid again, ids and entity groups
+ *  created after it should be considered invalid.
+ * -A bound spatial grid picks the restored positions up at the next
+ *  FECS_SpatialUpdate.
+ * -Must not be called while a system instance of the world is executing.
  */
-PRP_API PRP_Result PRP_CALL
-FECS_SystemInstanceFetchComp(const FECS_SystemExecInternalData *pExec_internals,
-                             PRP_Size idx, void **ppComp_arr);
+PRP_API PRP_Result PRP_CALL FECS_WorldRestore(FECS_WorldId world_id,
+                                              const FECS_Fork *pFork);
+/**
+ * Deletes a fork returned by FECS_WorldFork.
+ *
+ * @param ppFork The fork to delete, set to NULL.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ */
+PRP_API PRP_Result PRP_CALL FECS_ForkDelete(FECS_Fork **ppFork);
+/**
+ * Writes the entities of a world that changed since the last delta, e.g. once
+ * per tick for replay recording or state sync.
+ *
+ * @param world_id   The id of the world.
+ * @param ppBase     In/out fork the receiver is at. NULL on the first call,
+ *                   which writes every chunk. Replaced by a fork of the
+ *                   current state on success.
+ * @param write_fn   Writes the encoded bytes, e.g. into a file.
+ * @param pUser_data Passed to write_fn.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_BUSY if a layout has live spawn contexts.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return Error of write_fn if it fails, *ppBase is left as is.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Chunks the world didn't write since the base are skipped without being
+ *  looked at, they are still shared copy on write with the base. Written
+ *  chunks are compared against the base per segment: the chunk header, each
+ *  tag mask, shared value, sparse map and column. Only changed segments are
+ *  written.
+ * -Compressed chunks are compared decompressed into scratch, they stay
+ *  compressed in the world and the forks.
+ * -Sparse component values are written whole for the sparse comps that
+ *  changed.
+ * -Nothing is buffered, memory use is bounded by a fork of the world.
+ * -The stream is in native byte order, deltas are meant to be applied to a
+ *  world loaded from the same world file on the same platform.
+ * -*ppBase must be deleted with FECS_ForkDelete once done.
+ */
+PRP_API PRP_Result PRP_CALL FECS_WorldDeltaWrite(FECS_WorldId world_id,
+                                                 FECS_Fork **ppBase,
+                                                 FECS_DeltaWriteFunc write_fn,
+                                                 void *pUser_data);
+/**
+ * Patches a world forward with the next delta written by
+ * FECS_WorldDeltaWrite.
+ *
+ * @param world_id   The id of the world.
+ * @param read_fn    Reads the encoded bytes, e.g. from a file.
+ * @param pUser_data Passed to read_fn.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_BUSY if a layout has live spawn contexts.
+ * @return PRP_ERR_CORRUPTED if the stream isn't a delta of this world.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return Error of read_fn if it fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Deltas must be applied in the order they were written, starting with the
+ *  first one, to a world that has not been changed otherwise.
+ * -On failure the world is left as it was before the call, it is rolled back
+ *  to a fork taken before the delta is read. Only if that rollback runs out
+ *  of memory too is the world left partially patched, its state is then
+ *  undefined till it is reloaded.
+ * -Entity ids are carried over, entity groups and the hierarchy are not.
+ * -Must not be called while a system instance of the world is executing.
+ */
+PRP_API PRP_Result PRP_CALL FECS_WorldDeltaApply(FECS_WorldId world_id,
+                                                 FECS_DeltaReadFunc read_fn,
+                                                 void *pUser_data);
+
+/* ----  ENTITIES  ---- */
+
+/**
+ * Spawns a new entity inside the given world and layout.
+ *
+ * @param world_id  The id to the world in which the layout lies.
+ * @param layout_id The id to the layout in which to spawn the entity.
+ * @param pEntity   Output pointer to the entity filled with data on success.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntitySpawn(FECS_WorldId world_id,
+                                             FECS_LayoutId layout_id,
+                                             FECS_EntityId *pEntity);
+/**
+ * Spawns a new group of entities inside the given world and layout.
+ *
+ * @param world_id     The id to the world in which the layout lies.
+ * @param layout_id    The id to the layout in which to spawn the entities.
+ * @param entity_count The number of entities to spawn.
+ * @param ppGroup      Output pointer to the group filled with data on success.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Every full chunk worth of entities gets an empty or fresh chunk of its own,
+ * only the remainder is placed into partially occupied chunks.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupSpawn(FECS_WorldId world_id,
+                                                  FECS_LayoutId layout_id,
+                                                  PRP_Size entity_count,
+                                                  FECS_EntityGroupId **ppGroup);
+
+/**
+ * Spawns a new entity inside the given world and layout with the given shared
+ * component values. The entity is placed in a chunk holding the same shared
+ * values.
+ *
+ * @param world_id         The id to the world in which the layout lies.
+ * @param layout_id        The id to the layout in which to spawn the entity.
+ * @param shared_count     The len of pShared_comp_ids and ppShared_data.
+ * @param pShared_comp_ids The shared components to set, the ones of the layout
+ *                         not given here are zeroed.
+ * @param ppShared_data    Pointers to the values of the shared components.
+ * @param pEntity          Output pointer to the entity filled with data on
+ *                         success.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or a component is not a
+ *                         shared component of the layout.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntitySpawnShared(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size shared_count,
+    const FECS_CompId *pShared_comp_ids, const void *const *ppShared_data,
+    FECS_EntityId *pEntity);
+/**
+ * Spawns a new group of entities inside the given world and layout with the
+ * given shared component values.
+ *
+ * @param world_id         The id to the world in which the layout lies.
+ * @param layout_id        The id to the layout in which to spawn the entities.
+ * @param entity_count     The number of entities to spawn.
+ * @param shared_count     The len of pShared_comp_ids and ppShared_data.
+ * @param pShared_comp_ids The shared components to set, the ones of the layout
+ *                         not given here are zeroed.
+ * @param ppShared_data    Pointers to the values of the shared components.
+ * @param ppGroup          Output pointer to the group filled with data on
+ *                         success.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or a component is not a
+ *                         shared component of the layout.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupSpawnShared(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size entity_count,
+    PRP_Size shared_count, const FECS_CompId *pShared_comp_ids,
+    const void *const *ppShared_data, FECS_EntityGroupId **ppGroup);
+/**
+ * Reserves a fixed number of whole chunks of a layout up front, for spawning
+ * entities into them from a worker thread, e.g. one context per job of a
+ * parallel spawn.
+ *
+ * @param world_id         The id to the world in which the layout lies.
+ * @param layout_id        The id to the layout in which to spawn the entities.
+ * @param entity_count     The number of entities the context can spawn,
+ *                         rounded up to whole chunks of 64.
+ * @param shared_count     The len of pShared_comp_ids and ppShared_data.
+ * @param pShared_comp_ids The shared components to set, the ones of the layout
+ *                         not given here are zeroed.
+ * @param ppShared_data    Pointers to the values of the shared components.
+ * @param ppSpawn_ctx      Output pointer to the context.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or a component is not a
+ *                         shared component of the layout.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Must be created and deleted on the thread owning the world. Only
+ *  FECS_SpawnCtxSpawn may run on other threads, each context on one thread
+ *  at a time.
+ * -The capacity is fixed at creation. Every chunk is reserved here, a context
+ *  never grows and workers can't reserve more, FECS_SpawnCtxSpawn returns
+ *  PRP_ERR_RES_EXHAUSTED once the chunks are full. Size each context for the
+ *  whole job.
+ * -Empty chunks of the layout are reused before new ones are created. Chunks
+ *  shared with a world fork are copied here, so spawning never allocates.
+ * -Every entity of the context gets the same shared comp values.
+ * -While contexts of a layout are alive FECS_WorldFork, FECS_WorldRestore,
+ *  FECS_WorldDeltaWrite and FECS_WorldDeltaApply return PRP_ERR_BUSY, so do
+ *  FECS_LayoutSort, FECS_WorldMergeLayout and backing file calls on the
+ *  layout. FECS_WorldCompressIdleChunks skips the layout.
+ * -Until the contexts are deleted nothing else may touch the layout while they
+ *  are spawning.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpawnCtxCreate(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size entity_count,
+    PRP_Size shared_count, const FECS_CompId *pShared_comp_ids,
+    const void *const *ppShared_data, FECS_SpawnCtx **ppSpawn_ctx);
+/**
+ * Spawns a new entity into the chunks reserved by a spawn context, without
+ * locking or touching anything other contexts use.
+ *
+ * @param pSpawn_ctx The context to spawn from.
+ * @param pEntity    Output pointer to the entity.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if the reserved chunks are full, the context
+ *                               can't grow.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Entities are spawned exactly like FECS_EntitySpawn, with the defaults of
+ *  the layout.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpawnCtxSpawn(FECS_SpawnCtx *pSpawn_ctx,
+                                               FECS_EntityId *pEntity);
+/**
+ * Returns the chunks reserved by a spawn context to the layout, the partially
+ * used ones become available to every spawn again. Meant to be called at the
+ * sync point after the worker threads are done.
+ *
+ * @param ppSpawn_ctx The context to delete, set to NULL.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpawnCtxDelete(FECS_SpawnCtx **ppSpawn_ctx);
+
+/**
+ * Checks if the given entity is valid.
+ *
+ * @param world_id The world in which the entity exists.
+ * @param entity   The entity to check the validity of.
+ * @param pRslt    The pointer to where the result is stored.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityIsValid(FECS_WorldId world_id,
+                                               const FECS_EntityId entity,
+                                               PRP_Bool *pRslt);
+/**
+ * Checks if the given entity group is valid.
+ *
+ * @param world_id The world in which the entity group exists.
+ * @param pGroup   The entity group to check the validity of.
+ * @param pRslt    The pointer to where the result is stored.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupIsValid(
+    FECS_WorldId world_id, const FECS_EntityGroupId *pGroup, PRP_Bool *pRslt);
+
+/**
+ * Kills the given entity and corrupts the entity struct.
+ *
+ * @param world_id The world in which the entity exists.
+ * @param pEntity  Pointer to the entity to kill.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityKill(FECS_WorldId world_id,
+                                            FECS_EntityId *pEntity);
+
+/**
+ * Kills the given entity group and nullifies it.
+ *
+ * @param world_id The world in which the entity group exists.
+ * @param ppGroup  Pointer to the entity group to kill.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or *ppGroup is invalid
+ *                         internally.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupKill(FECS_WorldId world_id,
+                                                 FECS_EntityGroupId **ppGroup);
+
+/**
+ * Fetches the specified component's pointer that belongs to the entity.
+ *
+ * @param world_id   The world in which the entity exists.
+ * @param entity     The entity to get comp ptr from.
+ * @param comp_id    The id of the component to fetch.
+ * @param ppComp_ptr Output pointer to store the pointer of the component.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or entity doesn't have the
+ *                         specified component or the component is a tag.
+ * @return PRP_ERR_NOT_FOUND if the sparse component isn't currently added to
+ *                           the entity.
+ * @return PRP_ERR_OOM if reading a compressed chunk needs a scratch that can't
+ *                     be allocated, once per layout.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -The pointer of a sparse component is only valid until the next add/remove
+ *  of the same sparse component in the entity's layout.
+ * -The entity's chunk is only read, a chunk shared with a world fork isn't
+ *  copied and a compressed one isn't decompressed. The value of a compressed
+ *  chunk is read into a scratch of the layout, the pointer is then only valid
+ *  until the next FECS_EntityGetComp in the layout.
+ * -Only sparse component values may be written through the pointer, they
+ *  aren't stored in chunks. Write the others with FECS_EntitySetComp.
+ * -Not safe to call from several threads at once, calls in a layout share
+ *  its scratch.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGetComp(FECS_WorldId world_id,
+                                               const FECS_EntityId entity,
+                                               FECS_CompId comp_id,
+                                               void **ppComp_ptr);
+/**
+ * Sets the specified component's pointer that belongs to the entity.
+ *
+ * @param world_id   The world in which the entity exists.
+ * @param entity     The entity to set comp of.
+ * @param comp_id    The id of the component to fetch.
+ * @param pComp_data Pointer to the data that will be set.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or entity doesn't have the
+ *                         specified component or the component is a
+ *                         tag/shared/sparse component.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntitySetComp(FECS_WorldId world_id,
+                                               FECS_EntityId entity,
+                                               FECS_CompId comp_id,
+                                               const void *pComp_data);
+/**
+ * Copies the specified component of a list of entities into a dense buffer,
+ * e.g. for the targets or collision pairs of a frame.
+ * Equivalent to a FECS_EntityGetComp + memcpy per entity, but the world and
+ * component are validated once and upcoming entities are prefetched.
+ *
+ * @param world_id  The world in which the entities exist.
+ * @param pEntities The entities to gather from, may span layouts.
+ * @param count     The number of entities.
+ * @param comp_id   The id of the component to gather.
+ * @param pOut      Buffer of count * size of the component bytes, value i
+ *                  belongs to pEntities[i].
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or an entity is invalid or
+ *                         doesn't have the specified component or the
+ *                         component is a tag.
+ * @return PRP_ERR_NOT_FOUND if the sparse component isn't currently added to
+ *                           an entity.
+ * @return PRP_ERR_OOM if the scratch for a compressed column can't be
+ *                     allocated.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Only reads, chunks shared with a world fork are not copied and compressed
+ *  chunks stay compressed. Gathers, FECS_LayoutFilter and FECS_LayoutReduce
+ *  may run on any number of threads at once, as long as nothing else uses
+ *  the world meanwhile.
+ * -pOut is partially written on failure.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGatherComp(
+    FECS_WorldId world_id, const FECS_EntityId *pEntities, PRP_Size count,
+    FECS_CompId comp_id, void *pOut);
+/**
+ * Copies a dense buffer into the specified component of a list of entities,
+ * the inverse of FECS_EntityGatherComp.
+ *
+ * @param world_id  The world in which the entities exist.
+ * @param pEntities The entities to scatter to, may span layouts.
+ * @param count     The number of entities.
+ * @param comp_id   The id of the component to scatter.
+ * @param pIn       Buffer of count * size of the component bytes, value i
+ *                  goes to pEntities[i].
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or an entity is invalid or
+ *                         doesn't have the specified component or the
+ *                         component is a tag/shared/sparse component. Nothing
+ *                         is written.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -An entity listed more than once ends up with the last of its values.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityScatterComp(
+    FECS_WorldId world_id, const FECS_EntityId *pEntities, PRP_Size count,
+    FECS_CompId comp_id, const void *pIn);
+
+/**
+ * Iterates over the specified component belonging to entities of the group.
+ *
+ * @param world_id   The world in which the entity exists.
+ * @param pGroup     The group of entities to iterate over.
+ * @param comp_id    The id of the component to iterate.
+ * @param cb         Callback invoked per element.
+ * @param pUser_data User-provided context.
+ *
+ * @return PRP_OK if iteration completes.
+ * @return Callback error if cb returns non-PRP_OK.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or *ppGroup is invalid
+ *                         internally or the entities don't have the specified
+ *                         component.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupForEach(
+    FECS_WorldId world_id, FECS_EntityGroupId *pGroup, FECS_CompId comp_id,
+    PRP_Result (*cb)(void *pComp_data, void *pUser_data), void *pUser_data);
+
+/**
+ * Adds a sparse component to the entity, overwriting the value if the entity
+ * already has it.
+ *
+ * @param world_id   The world in which the entity exists.
+ * @param entity     The entity to add the sparse comp to.
+ * @param comp_id    The id of the sparse component.
+ * @param pComp_data Pointer to the data that will be set.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or entity's layout doesn't
+ *                         have the specified sparse component.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityAddSparse(FECS_WorldId world_id,
+                                                 FECS_EntityId entity,
+                                                 FECS_CompId comp_id,
+                                                 const void *pComp_data);
+/**
+ * Removes a sparse component from the entity, no-op if the entity doesn't have
+ * it.
+ *
+ * @param world_id The world in which the entity exists.
+ * @param entity   The entity to remove the sparse comp from.
+ * @param comp_id  The id of the sparse component.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or entity's layout doesn't
+ *                         have the specified sparse component.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityRemoveSparse(FECS_WorldId world_id,
+                                                    FECS_EntityId entity,
+                                                    FECS_CompId comp_id);
+
+/**
+ * Adds or removes a tag from the entity.
+ *
+ * @param world_id The world in which the entity exists.
+ * @param entity   The entity to set the tag of.
+ * @param tag_id   The id of the tag component.
+ * @param value    PRP_True to add the tag, PRP_False to remove it.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or entity's layout doesn't
+ *                         have the specified tag.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntitySetTag(FECS_WorldId world_id,
+                                              FECS_EntityId entity,
+                                              FECS_CompId tag_id,
+                                              PRP_Bool value);
+/**
+ * Checks if the entity has the tag.
+ *
+ * @param world_id The world in which the entity exists.
+ * @param entity   The entity to check the tag of.
+ * @param tag_id   The id of the tag component.
+ * @param pRslt    The pointer to where the result is stored.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or entity's layout doesn't
+ *                         have the specified tag.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityHasTag(FECS_WorldId world_id,
+                                              const FECS_EntityId entity,
+                                              FECS_CompId tag_id,
+                                              PRP_Bool *pRslt);
+/**
+ * Adds or removes a tag from all entities of the group.
+ *
+ * @param world_id The world in which the entity group exists.
+ * @param pGroup   The group of entities to set the tag of.
+ * @param tag_id   The id of the tag component.
+ * @param value    PRP_True to add the tag, PRP_False to remove it.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or *pGroup is invalid
+ *                         internally or the entities don't have the specified
+ *                         tag.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupSetTag(FECS_WorldId world_id,
+                                                   FECS_EntityGroupId *pGroup,
+                                                   FECS_CompId tag_id,
+                                                   PRP_Bool value);
+/**
+ * Enables or disables the entity. Disabled entities keep their slot and data
+ * but are skipped by every system instance.
+ *
+ * @param world_id The world in which the entity exists.
+ * @param entity   The entity to enable/disable.
+ * @param value    PRP_True to enable, PRP_False to disable.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Entities are enabled on spawn. Toggling is not a structural change, the
+ *  entity never moves.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntitySetEnabled(FECS_WorldId world_id,
+                                                  FECS_EntityId entity,
+                                                  PRP_Bool value);
+/**
+ * Checks if the entity is enabled.
+ *
+ * @param world_id The world in which the entity exists.
+ * @param entity   The entity to check.
+ * @param pRslt    The pointer to where the result is stored.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityIsEnabled(FECS_WorldId world_id,
+                                                 const FECS_EntityId entity,
+                                                 PRP_Bool *pRslt);
+/**
+ * Enables or disables all entities of the group, a single mask op per chunk.
+ *
+ * @param world_id The world in which the entity group exists.
+ * @param pGroup   The group of entities to enable/disable.
+ * @param value    PRP_True to enable, PRP_False to disable.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or *pGroup is invalid
+ *                         internally.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupSetEnabled(
+    FECS_WorldId world_id, FECS_EntityGroupId *pGroup, PRP_Bool value);
+
+/* ----  HIERARCHY ---- */
+
+/**
+ * Adds a node to the transform hierarchy of the world.
+ *
+ * @param world_id The world to add the node to.
+ * @param parent   The parent node or FECS_INVALID_ID to add a root.
+ * @param pLocal   The local transform of the node.
+ * @param pNode    Output pointer to the node id.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -The world transform of the node is only valid after the next
+ *  FECS_HierarchyPropagate.
+ */
+PRP_API PRP_Result PRP_CALL FECS_HierarchyAddNode(FECS_WorldId world_id,
+                                                  FECS_HierarchyNodeId parent,
+                                                  const MATH_Mat4 *pLocal,
+                                                  FECS_HierarchyNodeId *pNode);
+/**
+ * Removes a node from the transform hierarchy of the world, its children
+ * become roots.
+ *
+ * @param world_id The world the node belongs to.
+ * @param node     The node to remove.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -The children keep their place in the world: their local transform is set
+ *  to their world transform as of the last FECS_HierarchyPropagate, so
+ *  changes made to them or their ancestors since are dropped. Children added
+ *  since keep their local transform.
+ */
+PRP_API PRP_Result PRP_CALL FECS_HierarchyRemoveNode(FECS_WorldId world_id,
+                                                     FECS_HierarchyNodeId node);
+/**
+ * Reparents a node of the transform hierarchy.
+ *
+ * @param world_id The world the node belongs to.
+ * @param node     The node to reparent.
+ * @param parent   The new parent node or FECS_INVALID_ID to make it a root.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or parent is the node
+ *                         itself or one of its descendants.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_HierarchySetParent(
+    FECS_WorldId world_id, FECS_HierarchyNodeId node,
+    FECS_HierarchyNodeId parent);
+/**
+ * Sets the local transform of a node, marking its subtree for recomputation.
+ *
+ * @param world_id The world the node belongs to.
+ * @param node     The node to set the local transform of.
+ * @param pLocal   The local transform.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_HierarchySetLocal(FECS_WorldId world_id,
+                                                   FECS_HierarchyNodeId node,
+                                                   const MATH_Mat4 *pLocal);
+/**
+ * Fetches the world transform of a node as of the last propagation.
+ *
+ * @param world_id   The world the node belongs to.
+ * @param node       The node to fetch the world transform of.
+ * @param pWorld_mat Output pointer to the world transform.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_HierarchyGetWorld(FECS_WorldId world_id,
+                                                   FECS_HierarchyNodeId node,
+                                                   MATH_Mat4 *pWorld_mat);
+/**
+ * Propagates the local transforms of the hierarchy into world transforms.
+ *
+ * @param world_id The world whose hierarchy to propagate.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, nothing is propagated.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Nodes are kept in breadth first level order so every level is swept as one
+ *  contiguous batch, parents always being in the previous level.
+ * -Only the subtrees of nodes whose local transform changed (or that were
+ *  added/reparented) are recomputed, a clean hierarchy is a no-op.
+ */
+PRP_API PRP_Result PRP_CALL FECS_HierarchyPropagate(FECS_WorldId world_id);
+
+/* ----  SPATIAL ---- */
+
+/**
+ * Binds a uniform hash grid over a position comp to the world, accelerating
+ * AABB and radius queries over every layout that has the comp.
+ *
+ * @param world_id    The world to bind the grid to.
+ * @param pos_comp_id A column or double buffered comp that starts with a
+ *                    MATH_Vec3 position.
+ * @param cell_size   The edge length of a grid cell, finite and > 0.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, a previously bound grid is kept.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Replaces the grid bound previously, if any.
+ * -The grid is empty till the next FECS_SpatialUpdate.
+ * -Cell size should be around the typical query radius, queries touch every
+ *  cell overlapping their AABB.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpatialBind(FECS_WorldId world_id,
+                                             FECS_CompId pos_comp_id,
+                                             PRP_F32 cell_size);
+/**
+ * Unbinds and deletes the grid of the world.
+ *
+ * @param world_id The world to unbind the grid from.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or no grid is bound.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpatialUnbind(FECS_WorldId world_id);
+/**
+ * Marks the position of an entity as changed, it is re-read at the next
+ * FECS_SpatialUpdate.
+ *
+ * @param world_id The world the entity belongs to.
+ * @param entity   The entity to mark.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or no grid is bound.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Entities of layouts without the position comp are ignored.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpatialMarkDirty(FECS_WorldId world_id,
+                                                  const FECS_EntityId entity);
+/**
+ * Marks the positions of every entity of a layout as changed, for layouts
+ * whose entities move every frame.
+ *
+ * @param world_id  The world the layout belongs to.
+ * @param layout_id The layout to mark.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or no grid is bound.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL
+FECS_SpatialMarkLayoutDirty(FECS_WorldId world_id, FECS_LayoutId layout_id);
+/**
+ * Syncs the grid of the world: spawned entities are inserted, killed ones are
+ * removed and dirty ones are moved to the cell of their current position.
+ *
+ * @param world_id The world to update the grid of.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, entities that couldn't be inserted
+ *                     are retried at the next update.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or no grid is bound.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Spawns and kills are detected without marking, the cost is a pass over the
+ *  chunk headers plus the work for changed entities.
+ * -Must not be called while a system instance of the world is executing.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpatialUpdate(FECS_WorldId world_id);
+/**
+ * Finds the entities whose position lies inside an AABB.
+ *
+ * @param world_id The world to query.
+ * @param pMin     The min corner of the AABB.
+ * @param pMax     The max corner of the AABB.
+ * @param pOut     Output array of entity ids, may be NULL if out_cap is 0.
+ * @param out_cap  The number of ids pOut fits.
+ * @param pCount   Output pointer to the number of entities found.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or no grid is bound.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Results are as of the last FECS_SpatialUpdate, entities killed since are
+ *  returned with ids that are no longer valid.
+ * -*pCount can exceed out_cap, only the first out_cap ids are written. Query
+ *  again with a bigger array to get all of them.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpatialQueryAABB(
+    FECS_WorldId world_id, const MATH_Vec3 *pMin, const MATH_Vec3 *pMax,
+    FECS_EntityId *pOut, PRP_Size out_cap, PRP_Size *pCount);
+/**
+ * Finds the entities whose position lies inside a sphere.
+ *
+ * @param world_id The world to query.
+ * @param pCenter  The center of the sphere.
+ * @param radius   The radius of the sphere.
+ * @param pOut     Output array of entity ids, may be NULL if out_cap is 0.
+ * @param out_cap  The number of ids pOut fits.
+ * @param pCount   Output pointer to the number of entities found.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or no grid is bound.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Same result rules as FECS_SpatialQueryAABB.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SpatialQueryRadius(
+    FECS_WorldId world_id, const MATH_Vec3 *pCenter, PRP_F32 radius,
+    FECS_EntityId *pOut, PRP_Size out_cap, PRP_Size *pCount);
+
+/* ----  COLUMN SCANS ---- */
+
+/**
+ * Finds the entities of a layout matching every given predicate, e.g. the ones
+ * with health < 0, as one occupancy mask per chunk.
+ *
+ * @param world_id     The world in which the layout exists.
+ * @param layout_id    The layout to scan.
+ * @param pred_count   The number of predicates.
+ * @param pPreds       The predicates, ANDed. May be NULL if pred_count is 0,
+ *                     every alive entity matches then.
+ * @param pMasks       Output masks, pMasks[i] are the matching slots of chunk
+ *                     i. May be NULL if mask_cap is 0.
+ * @param mask_cap     The number of masks pMasks fits.
+ * @param pChunk_count Output pointer to the number of chunks of the layout.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or a predicate's field is
+ *                         out of its component or isn't in a column/shared
+ *                         component of the layout.
+ * @return PRP_ERR_OOM if the scratch for a compressed column can't be
+ *                     allocated.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Disabled entities are scanned too.
+ * -*pChunk_count can exceed mask_cap, only the first mask_cap chunks are
+ *  scanned.
+ * -Only reads, chunks shared with a world fork are not copied and compressed
+ *  chunks stay compressed. Filters, FECS_LayoutReduce and
+ *  FECS_EntityGatherComp may run on any number of threads at once, as long as
+ *  nothing else uses the world meanwhile.
+ * -The masks can be passed to FECS_LayoutReduce until the next spawn or kill
+ *  in the layout.
+ */
+PRP_API PRP_Result PRP_CALL FECS_LayoutFilter(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size pred_count,
+    const FECS_ScanPredicate *pPreds, FECS_SystemExecOccupancyMask *pMasks,
+    PRP_Size mask_cap, PRP_Size *pChunk_count);
+/**
+ * FECS_LayoutFilter, returning the matching entities as an entity group.
+ *
+ * @param world_id   The world in which the layout exists.
+ * @param layout_id  The layout to scan.
+ * @param pred_count The number of predicates.
+ * @param pPreds     The predicates, ANDed. May be NULL if pred_count is 0.
+ * @param ppGroup    Output pointer to the group, empty if nothing matched.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid, same as FECS_LayoutFilter.
+ * @return PRP_ERR_OOM if allocation fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -The group is owned by the caller exactly like a spawned one, killing it
+ *  kills the matched entities.
+ * -Creates a group in the world, so unlike FECS_LayoutFilter it must run on
+ *  the thread owning the world.
+ */
+PRP_API PRP_Result PRP_CALL FECS_LayoutFilterGroup(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size pred_count,
+    const FECS_ScanPredicate *pPreds, FECS_EntityGroupId **ppGroup);
+/**
+ * Reduces a field over the entities of a layout, e.g. the total mass.
+ *
+ * @param world_id   The world in which the layout exists.
+ * @param layout_id  The layout to scan.
+ * @param pField     The field to reduce, may be NULL for
+ *                   FECS_SCAN_REDUCE_COUNT.
+ * @param op         The reduction.
+ * @param pMasks     Occupancy masks per chunk restricting the entities, e.g.
+ *                   from FECS_LayoutFilter. NULL for every alive entity.
+ * @param mask_count The number of masks, chunks past it are skipped.
+ * @param pResult    Output pointer to the result.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid or the field is out of its
+ *                         component or isn't in a column/shared component of
+ *                         the layout.
+ * @return PRP_ERR_OOM if the scratch for a compressed column can't be
+ *                     allocated.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -Disabled entities are reduced too, dead slots in pMasks are ignored.
+ * -Integer sums wrap around on overflow, signed ones included.
+ * -Only reads, chunks shared with a world fork are not copied and compressed
+ *  chunks stay compressed. Safe on other threads like FECS_LayoutFilter.
+ */
+PRP_API PRP_Result PRP_CALL FECS_LayoutReduce(
+    FECS_WorldId world_id, FECS_LayoutId layout_id,
+    const FECS_ScanField *pField, FECS_ScanReduceOp op,
+    const FECS_SystemExecOccupancyMask *pMasks, PRP_Size mask_count,
+    FECS_ScanReduceResult *pResult);
+
+/* ----  SYSTEM INSTANCE ---- */
+
+/**
+ * Executes the given system instance.
+ *
+ * @param world_id          The world in which the system instance id exists.
+ * @param system_instane_id The id of the system instance to execute.
+ * @param pUser_data        User-provided context.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ * @return PRP_ERR_OOM if copying a chunk shared with a world fork fails.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceExec(
+    FECS_WorldId world_id, FECS_SystemInstanceId system_instance_id,
+    void *pUser_data);
+/**
+ * Fetches the execution counters of the given system instance.
+ *
+ * @param world_id           The world in which the system instance id exists.
+ * @param system_instance_id The id of the system instance.
+ * @param pStats             Output pointer to the counters.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_UNSUPPORTED if not built with PRP_FECS_SYSTEM_STATS, *pStats
+ *                             is zeroed.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_WorldGetSystemStats(
+    FECS_WorldId world_id, FECS_SystemInstanceId system_instance_id,
+    FECS_SystemStats *pStats);
+/**
+ * Fetches an component array inside the system function.
+ *
+ * @param pExec_internals The internal data provided during system instance
+ *                        execution.
+ * @param idx             The index into the strides array to fetch comp array.
+ *                        This index corresponds to the user provided
+ *                        pComp_ids_needed array during system registration.
+ * @param ppComp_arr      Output pointer to the component array.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOB if give idx is out of bound to the system required
+ *                     strides array.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -For shared components *ppComp_arr points to the single value of the chunk,
+ *  so it can be read once outside of the per entity loop.
+ * -For tags *ppComp_arr points to the FECS_SystemExecOccupancyMask of entities
+ *  having the tag.
+ */
+PRP_API PRP_Result PRP_CALL
+FECS_SystemInstanceFetchComp(const FECS_SystemExecInternalData *pExec_internals,
+                             PRP_Size idx, void **ppComp_arr);
+
+/**
+ * Fetches an component array of a chunk inside a batched system function.
+ *
+ * @param pExec_internals The internal data provided during system instance
+ *                        execution.
+ * @param chunk_idx       The index of the chunk in the current batch, same as
+ *                        the index into pOccupancy_masks.
+ * @param idx             The index into the strides array to fetch comp array,
+ *                        same as FECS_SystemInstanceFetchComp.
+ * @param ppComp_arr      Output pointer to the component array.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOB if chunk_idx is out of bounds to the batch or idx is out
+ *                     of bound to the system required strides array.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceFetchBatchComp(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size chunk_idx,
+    PRP_Size idx, void **ppComp_arr);
+
+/**
+ * Fetches the previous frame component array of a double buffered component
+ * inside the system function.
+ *
+ * @param pExec_internals The internal data provided during system instance
+ *                        execution.
+ * @param idx             The index into the strides array to fetch comp array,
+ *                        same as FECS_SystemInstanceFetchComp.
+ * @param ppComp_arr      Output pointer to the component array.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOB if idx is out of bound to the system required strides
+ *                     array or the component isn't double buffered.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ * -The array holds the values as of the last FECS_WorldSwapBuffers, it is
+ *  never written during system execution so it can be read for any entity of
+ *  the chunk while the current array is being written.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceFetchPrevComp(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size idx,
+    void **ppComp_arr);
+
+/**
+ * Batched variant of FECS_SystemInstanceFetchPrevComp.
+ *
+ * @param pExec_internals The internal data provided during system instance
+ *                        execution.
+ * @param chunk_idx       The index of the chunk in the current batch.
+ * @param idx             The index into the strides array to fetch comp array.
+ * @param ppComp_arr      Output pointer to the component array.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOB if chunk_idx or idx is out of bounds or the component
+ *                     isn't double buffered.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceFetchBatchPrevComp(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size chunk_idx,
+    PRP_Size idx, void **ppComp_arr);
+
+/**
+ * Fetches the sparse component value of an entity inside the system function.
+ *
+ * @param pExec_internals The internal data provided during system instance
+ *                        execution.
+ * @param idx             The index into the strides array of the sparse
+ *                        component, same as FECS_SystemInstanceFetchComp.
+ * @param slot            The idx of the entity given by
+ *                        FECS_SYSTEM_EXEC_FOREACH_OCCUPIED.
+ * @param ppComp          Output pointer to the component value.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_NOT_FOUND if idx/slot is out of bounds, the component is not
+ *                           sparse or the entity doesn't have it.
+ * @return PRP_ERR_INV_ARG if arguments are invalid.
+ *
+ * @note:
+ * -Panics and exits if FECS not initialized correctly.
+ */
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceFetchSparse(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size idx,
+    PRP_Size slot, void **ppComp);
 
 /* ----  FECS ---- */
 
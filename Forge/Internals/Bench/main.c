@@ -0,0 +1,544 @@
+#include "Core/Time/Time.h"
+#include "Forge/FECS.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__GLIBC__) &&                                                      \
+    ((__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_HAS_MALLINFO2 1
+#endif
+
+/*
+ * FECS benchmark suite.
+ *
+ * Usage: Bench [path/to/Bench.world]
+ *
+ * Every result is a single csv line on stdout:
+ * scenario,param,entities,ns_per_op,entities_per_s,bytes
+ *
+ * - param:  Scenario specific knob (group size, comp count, occupancy %).
+ * - bytes:  Heap growth over the scenario's setup, -1 where the heap can't be
+ *           queried. Chunks freed by kills are kept by the layout, so a
+ *           scenario reusing them reports less than a cold run.
+ */
+
+#define BENCH_DEFAULT_WORLD_PATH ("Forge/Internals/Bench/Bench.world")
+
+#define BENCH_EXEC_ENTITY_COUNT (1 << 20)
+#define BENCH_EXEC_REPS (32)
+
+#define BENCH_CHURN_ENTITY_COUNT (1 << 16)
+#define BENCH_CHURN_REPS (16)
+
+#define BENCH_GET_COMP_OPS (1 << 22)
+
+#define BENCH_GROUP_MAX_COUNT (1 << 20)
+#define BENCH_GROUP_REPS (8)
+
+#define BENCH_WIDE_MAX_COMPS (16)
+#define BENCH_WIDE_ENTITY_COUNT (1 << 17)
+#define BENCH_WIDE_REPS (16)
+
+typedef struct Vec3 {
+    PRP_F32 x, y, z;
+} Vec3;
+
+// Payload of every CN comp of the Wide layouts.
+typedef struct Vec4 {
+    PRP_F32 x, y, z, w;
+} Vec4;
+
+typedef struct BenchCtx {
+    FECS_WorldId world_id;
+    FECS_LayoutId particle_id;
+    FECS_CompId pos_id, vel_id;
+    FECS_CompId wide_comp_ids[BENCH_WIDE_MAX_COMPS];
+    FECS_EntityId *pEntities;
+    PRP_U64 rng;
+} BenchCtx;
+
+/**
+ * Example system using the per entity occupancy mask iteration.
+ */
+static void IntegrateMask(const FECS_SystemExecInternalData *pExec_internals,
+                          FECS_SystemExecOccupancyMask occupancy_mask,
+                          void *pUser_data);
+/**
+ * Example system using the full chunk and dense run fast paths, the inner
+ * loops carry no per entity bit ops so the compiler can vectorize them.
+ */
+static void IntegrateRuns(const FECS_SystemExecInternalData *pExec_internals,
+                          FECS_SystemExecOccupancyMask occupancy_mask,
+                          void *pUser_data);
+/**
+ * Example batched system, same as IntegrateRuns but one call covers upto
+ * FECS_SYSTEM_EXEC_BATCH_CAP chunks.
+ */
+static void
+IntegrateBatched(const FECS_SystemExecInternalData *pExec_internals,
+                 PRP_Size chunk_count,
+                 const FECS_SystemExecOccupancyMask *pOccupancy_masks,
+                 void *pUser_data);
+/**
+ * Touches every comp column the system needs, the comp count is passed as
+ * *(PRP_Size *)pUser_data.
+ */
+static void Touch(const FECS_SystemExecInternalData *pExec_internals,
+                  FECS_SystemExecOccupancyMask occupancy_mask,
+                  void *pUser_data);
+/**
+ * Fetches the current heap usage.
+ *
+ * @return The bytes in use, -1 if it can't be queried on this platform.
+ */
+static PRP_I64 HeapBytes(void);
+/**
+ * Advances the xorshift rng of the ctx.
+ *
+ * @param pCtx The bench ctx.
+ *
+ * @return The next random number.
+ */
+static PRP_U64 Rand(BenchCtx *pCtx);
+/**
+ * Prints a single result line.
+ *
+ * @param pScenario The scenario name.
+ * @param param     The scenario specific knob.
+ * @param entities  The number of entities involved.
+ * @param ticks     The total ticks spent.
+ * @param ops       The number of ops performed in those ticks.
+ * @param bytes     The bytes allocated for the scenario or -1.
+ */
+static void Report(const PRP_Char8 *pScenario, PRP_Size param,
+                   PRP_Size entities, PRP_TimeTicks ticks, PRP_Size ops,
+                   PRP_I64 bytes);
+/**
+ * Times BENCH_EXEC_REPS execs of a system instance and reports per entity.
+ *
+ * @param pCtx        The bench ctx.
+ * @param pName       The system instance name.
+ * @param name_len    The len of the name.
+ * @param pScenario   The scenario name reported.
+ * @param param       The scenario specific knob reported.
+ * @param alive_count The number of alive entities the system visits.
+ * @param reps        The number of execs.
+ * @param bytes       The bytes allocated for the scenario or -1.
+ */
+static void BenchExec(BenchCtx *pCtx, PRP_Char8 *pName, PRP_Size name_len,
+                      const PRP_Char8 *pScenario, PRP_Size param,
+                      PRP_Size alive_count, PRP_Size reps, PRP_I64 bytes);
+/**
+ * Mask vs run vs batched exec over full and partially killed chunks, also
+ * leaves BENCH_EXEC_ENTITY_COUNT particles for BenchGetComp.
+ *
+ * @param pCtx The bench ctx.
+ */
+static void BenchExecPaths(BenchCtx *pCtx);
+/**
+ * Random access through FECS_EntityGetComp over the alive particles.
+ *
+ * @param pCtx The bench ctx.
+ */
+static void BenchGetComp(BenchCtx *pCtx);
+/**
+ * Spawns and kills BENCH_CHURN_ENTITY_COUNT entities one by one, repeatedly.
+ *
+ * @param pCtx The bench ctx.
+ */
+static void BenchChurn(BenchCtx *pCtx);
+/**
+ * Group spawn and group kill at 1k to 1M entities.
+ *
+ * @param pCtx The bench ctx.
+ */
+static void BenchGroups(BenchCtx *pCtx);
+/**
+ * Exec over layouts of 1 to 16 comps at 100%, 50% and 10% occupancy.
+ *
+ * @param pCtx The bench ctx.
+ */
+static void BenchWideExec(BenchCtx *pCtx);
+
+static void IntegrateMask(const FECS_SystemExecInternalData *pExec_internals,
+                          FECS_SystemExecOccupancyMask occupancy_mask,
+                          void *pUser_data) {
+    (void)pUser_data;
+    Vec3 *pPos, *pVel;
+    FECS_SystemInstanceFetchComp(pExec_internals, 0, (void **)&pPos);
+    FECS_SystemInstanceFetchComp(pExec_internals, 1, (void **)&pVel);
+
+    PRP_Size i;
+    FECS_SYSTEM_EXEC_FOREACH_OCCUPIED(occupancy_mask, i) {
+        pPos[i].x += pVel[i].x;
+        pPos[i].y += pVel[i].y;
+        pPos[i].z += pVel[i].z;
+    }
+}
+
+static void IntegrateRuns(const FECS_SystemExecInternalData *pExec_internals,
+                          FECS_SystemExecOccupancyMask occupancy_mask,
+                          void *pUser_data) {
+    (void)pUser_data;
+    Vec3 *PRP_RESTRICT pPos;
+    Vec3 *PRP_RESTRICT pVel;
+    FECS_SystemInstanceFetchComp(pExec_internals, 0, (void **)&pPos);
+    FECS_SystemInstanceFetchComp(pExec_internals, 1, (void **)&pVel);
+
+    if (FECS_SYSTEM_EXEC_IS_FULL(occupancy_mask)) {
+        for (PRP_Size i = 0; i < FECS_SYSTEM_EXEC_SLOT_COUNT; i++) {
+            pPos[i].x += pVel[i].x;
+            pPos[i].y += pVel[i].y;
+            pPos[i].z += pVel[i].z;
+        }
+        return;
+    }
+    PRP_Size begin, end;
+    FECS_SYSTEM_EXEC_FOREACH_RUN(occupancy_mask, begin, end) {
+        for (PRP_Size i = begin; i < end; i++) {
+            pPos[i].x += pVel[i].x;
+            pPos[i].y += pVel[i].y;
+            pPos[i].z += pVel[i].z;
+        }
+    }
+}
+
+static void
+IntegrateBatched(const FECS_SystemExecInternalData *pExec_internals,
+                 PRP_Size chunk_count,
+                 const FECS_SystemExecOccupancyMask *pOccupancy_masks,
+                 void *pUser_data) {
+    (void)pUser_data;
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        Vec3 *PRP_RESTRICT pPos;
+        Vec3 *PRP_RESTRICT pVel;
+        FECS_SystemInstanceFetchBatchComp(pExec_internals, c, 0,
+                                          (void **)&pPos);
+        FECS_SystemInstanceFetchBatchComp(pExec_internals, c, 1,
+                                          (void **)&pVel);
+
+        FECS_SystemExecOccupancyMask occupancy_mask = pOccupancy_masks[c];
+        PRP_Size begin, end;
+        FECS_SYSTEM_EXEC_FOREACH_RUN(occupancy_mask, begin, end) {
+            for (PRP_Size i = begin; i < end; i++) {
+                pPos[i].x += pVel[i].x;
+                pPos[i].y += pVel[i].y;
+                pPos[i].z += pVel[i].z;
+            }
+        }
+    }
+}
+
+static void Touch(const FECS_SystemExecInternalData *pExec_internals,
+                  FECS_SystemExecOccupancyMask occupancy_mask,
+                  void *pUser_data) {
+    PRP_Size comp_count = *(PRP_Size *)pUser_data;
+
+    for (PRP_Size c = 0; c < comp_count; c++) {
+        Vec4 *pComps;
+        FECS_SystemInstanceFetchComp(pExec_internals, c, (void **)&pComps);
+        FECS_SystemExecOccupancyMask mask = occupancy_mask;
+        PRP_Size begin, end;
+        FECS_SYSTEM_EXEC_FOREACH_RUN(mask, begin, end) {
+            for (PRP_Size i = begin; i < end; i++) {
+                pComps[i].x += 1.0f;
+            }
+        }
+    }
+}
+
+static PRP_I64 HeapBytes(void) {
+#ifdef BENCH_HAS_MALLINFO2
+    struct mallinfo2 info = mallinfo2();
+
+    return (PRP_I64)(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+static PRP_U64 Rand(BenchCtx *pCtx) {
+    pCtx->rng ^= pCtx->rng << 13;
+    pCtx->rng ^= pCtx->rng >> 7;
+    pCtx->rng ^= pCtx->rng << 17;
+
+    return pCtx->rng;
+}
+
+static void Report(const PRP_Char8 *pScenario, PRP_Size param,
+                   PRP_Size entities, PRP_TimeTicks ticks, PRP_Size ops,
+                   PRP_I64 bytes) {
+    PRP_F64 ns = PRP_TimeTicksToTimeUnits(ticks, PRP_TIME_UNIT_NS);
+    PRP_F64 ns_per_op = ops ? ns / (PRP_F64)ops : 0.0;
+    PRP_F64 per_s = ns > 0.0 ? ((PRP_F64)ops * 1e9) / ns : 0.0;
+
+    printf("%s,%zu,%zu,%.3f,%.0f,%lld\n", pScenario, param, entities,
+           ns_per_op, per_s, (long long)bytes);
+}
+
+static void BenchExec(BenchCtx *pCtx, PRP_Char8 *pName, PRP_Size name_len,
+                      const PRP_Char8 *pScenario, PRP_Size param,
+                      PRP_Size alive_count, PRP_Size reps, PRP_I64 bytes) {
+    FECS_SystemInstanceId system_instance_id;
+    if (FECS_WorldFindSystemInstanceId(pCtx->world_id, pName, name_len,
+                                       &system_instance_id) != PRP_OK) {
+        fprintf(stderr, "Missing system instance %s.\n", pName);
+        return;
+    }
+
+    // Warm up so the first rep doesn't pay for cold caches.
+    FECS_SystemInstanceExec(pCtx->world_id, system_instance_id, &param);
+    PRP_TimeTicks start = PRP_TimeNow();
+    for (PRP_Size i = 0; i < reps; i++) {
+        FECS_SystemInstanceExec(pCtx->world_id, system_instance_id, &param);
+    }
+    Report(pScenario, param, alive_count, PRP_TimeNow() - start,
+           alive_count * reps, bytes);
+}
+
+static void BenchExecPaths(BenchCtx *pCtx) {
+    PRP_I64 heap_start = HeapBytes();
+    Vec3 zero = {0}, one = {1.0f, 1.0f, 1.0f};
+    for (PRP_Size i = 0; i < BENCH_EXEC_ENTITY_COUNT; i++) {
+        FECS_EntitySpawn(pCtx->world_id, pCtx->particle_id,
+                         &pCtx->pEntities[i]);
+        FECS_EntitySetComp(pCtx->world_id, pCtx->pEntities[i], pCtx->pos_id,
+                           &zero);
+        FECS_EntitySetComp(pCtx->world_id, pCtx->pEntities[i], pCtx->vel_id,
+                           &one);
+    }
+    PRP_I64 bytes = heap_start < 0 ? -1 : HeapBytes() - heap_start;
+
+    BenchExec(pCtx, "IntegrateMaskAll", 16, "exec_mask", 100,
+              BENCH_EXEC_ENTITY_COUNT, BENCH_EXEC_REPS, bytes);
+    BenchExec(pCtx, "IntegrateRunsAll", 16, "exec_runs", 100,
+              BENCH_EXEC_ENTITY_COUNT, BENCH_EXEC_REPS, bytes);
+    BenchExec(pCtx, "IntegrateBatchedAll", 19, "exec_batched", 100,
+              BENCH_EXEC_ENTITY_COUNT, BENCH_EXEC_REPS, bytes);
+
+    // Killing every 8th entity leaves 7 long runs per chunk.
+    PRP_Size alive_count = BENCH_EXEC_ENTITY_COUNT;
+    for (PRP_Size i = 0; i < BENCH_EXEC_ENTITY_COUNT; i += 8) {
+        FECS_EntityKill(pCtx->world_id, &pCtx->pEntities[i]);
+        alive_count--;
+    }
+    BenchExec(pCtx, "IntegrateMaskAll", 16, "exec_mask", 87, alive_count,
+              BENCH_EXEC_REPS, bytes);
+    BenchExec(pCtx, "IntegrateRunsAll", 16, "exec_runs", 87, alive_count,
+              BENCH_EXEC_REPS, bytes);
+    BenchExec(pCtx, "IntegrateBatchedAll", 19, "exec_batched", 87,
+              alive_count, BENCH_EXEC_REPS, bytes);
+
+    // Refill the holes so the get comp bench sees every entity alive.
+    for (PRP_Size i = 0; i < BENCH_EXEC_ENTITY_COUNT; i += 8) {
+        FECS_EntitySpawn(pCtx->world_id, pCtx->particle_id,
+                         &pCtx->pEntities[i]);
+    }
+}
+
+static void BenchGetComp(BenchCtx *pCtx) {
+    PRP_Size *pIdxs = malloc(sizeof(PRP_Size) * BENCH_GET_COMP_OPS);
+    if (!pIdxs) {
+        return;
+    }
+    for (PRP_Size i = 0; i < BENCH_GET_COMP_OPS; i++) {
+        pIdxs[i] = (PRP_Size)(Rand(pCtx) % BENCH_EXEC_ENTITY_COUNT);
+    }
+
+    PRP_F32 sum = 0.0f;
+    PRP_TimeTicks start = PRP_TimeNow();
+    for (PRP_Size i = 0; i < BENCH_GET_COMP_OPS; i++) {
+        Vec3 *pPos;
+        FECS_EntityGetComp(pCtx->world_id, pCtx->pEntities[pIdxs[i]],
+                           pCtx->pos_id, (void **)&pPos);
+        sum += pPos->x;
+    }
+    Report("get_comp_random", 0, BENCH_EXEC_ENTITY_COUNT,
+           PRP_TimeNow() - start, BENCH_GET_COMP_OPS, 0);
+    // Keeps the loop from being optimized out.
+    if (sum < 0.0f) {
+        fprintf(stderr, "Unexpected sum.\n");
+    }
+
+    free(pIdxs);
+}
+
+static void BenchChurn(BenchCtx *pCtx) {
+    FECS_LayoutId layout_id;
+    FECS_WorldFindLayoutId(pCtx->world_id, "Churn", 5, &layout_id);
+
+    PRP_I64 heap_start = HeapBytes();
+    PRP_I64 bytes = -1;
+    PRP_TimeTicks start = PRP_TimeNow();
+    for (PRP_Size r = 0; r < BENCH_CHURN_REPS; r++) {
+        for (PRP_Size i = 0; i < BENCH_CHURN_ENTITY_COUNT; i++) {
+            FECS_EntitySpawn(pCtx->world_id, layout_id, &pCtx->pEntities[i]);
+        }
+        if (!r && heap_start >= 0) {
+            bytes = HeapBytes() - heap_start;
+        }
+        for (PRP_Size i = 0; i < BENCH_CHURN_ENTITY_COUNT; i++) {
+            FECS_EntityKill(pCtx->world_id, &pCtx->pEntities[i]);
+        }
+    }
+    Report("spawn_kill_churn", 0, BENCH_CHURN_ENTITY_COUNT,
+           PRP_TimeNow() - start,
+           (PRP_Size)2 * BENCH_CHURN_ENTITY_COUNT * BENCH_CHURN_REPS, bytes);
+}
+
+static void BenchGroups(BenchCtx *pCtx) {
+    FECS_LayoutId layout_id;
+    FECS_WorldFindLayoutId(pCtx->world_id, "Group", 5, &layout_id);
+
+    for (PRP_Size count = 1000; count <= BENCH_GROUP_MAX_COUNT; count *= 10) {
+        PRP_TimeTicks spawn_ticks = 0, kill_ticks = 0;
+        PRP_I64 bytes = -1;
+        for (PRP_Size r = 0; r < BENCH_GROUP_REPS; r++) {
+            FECS_EntityGroupId *pGroup;
+            PRP_I64 heap_start = HeapBytes();
+            PRP_TimeTicks start = PRP_TimeNow();
+            if (FECS_EntityGroupSpawn(pCtx->world_id, layout_id, count,
+                                      &pGroup) != PRP_OK) {
+                fprintf(stderr, "Group spawn of %zu failed.\n", count);
+                return;
+            }
+            PRP_TimeTicks mid = PRP_TimeNow();
+            if (!r && heap_start >= 0) {
+                bytes = HeapBytes() - heap_start;
+            }
+            FECS_EntityGroupKill(pCtx->world_id, &pGroup);
+            kill_ticks += PRP_TimeNow() - mid;
+            spawn_ticks += mid - start;
+        }
+        Report("group_spawn", count, count, spawn_ticks,
+               count * BENCH_GROUP_REPS, bytes);
+        Report("group_kill", count, count, kill_ticks,
+               count * BENCH_GROUP_REPS, bytes);
+    }
+}
+
+static void BenchWideExec(BenchCtx *pCtx) {
+    static const PRP_Size occupancies[] = {100, 50, 10};
+    PRP_Char8 name[32];
+
+    for (PRP_Size comp_count = 1; comp_count <= BENCH_WIDE_MAX_COMPS;
+         comp_count *= 2) {
+        FECS_LayoutId layout_id;
+        PRP_I32 name_len =
+            snprintf(name, sizeof(name), "Wide%zu", comp_count);
+        FECS_WorldFindLayoutId(pCtx->world_id, name, (PRP_Size)name_len,
+                               &layout_id);
+
+        PRP_I64 heap_start = HeapBytes();
+        for (PRP_Size i = 0; i < BENCH_WIDE_ENTITY_COUNT; i++) {
+            FECS_EntitySpawn(pCtx->world_id, layout_id, &pCtx->pEntities[i]);
+        }
+        PRP_I64 bytes = heap_start < 0 ? -1 : HeapBytes() - heap_start;
+
+        name_len = snprintf(name, sizeof(name), "TouchWide%zu", comp_count);
+        PRP_Size alive_count = BENCH_WIDE_ENTITY_COUNT;
+        for (PRP_Size o = 0; o < sizeof(occupancies) / sizeof(*occupancies);
+             o++) {
+            // Randomly kill down to the target occupancy.
+            PRP_Size target = BENCH_WIDE_ENTITY_COUNT * occupancies[o] / 100;
+            while (alive_count > target) {
+                PRP_Size i = (PRP_Size)(Rand(pCtx) % BENCH_WIDE_ENTITY_COUNT);
+                PRP_Bool is_valid;
+                FECS_EntityIsValid(pCtx->world_id, pCtx->pEntities[i],
+                                   &is_valid);
+                if (is_valid) {
+                    FECS_EntityKill(pCtx->world_id, &pCtx->pEntities[i]);
+                    alive_count--;
+                }
+            }
+
+            PRP_Char8 scenario[32];
+            snprintf(scenario, sizeof(scenario), "exec_%zu_comps", comp_count);
+            FECS_SystemInstanceId system_instance_id;
+            FECS_WorldFindSystemInstanceId(pCtx->world_id, name,
+                                           (PRP_Size)name_len,
+                                           &system_instance_id);
+            PRP_Size param = comp_count;
+            FECS_SystemInstanceExec(pCtx->world_id, system_instance_id,
+                                    &param);
+            PRP_TimeTicks start = PRP_TimeNow();
+            for (PRP_Size r = 0; r < BENCH_WIDE_REPS; r++) {
+                FECS_SystemInstanceExec(pCtx->world_id, system_instance_id,
+                                        &param);
+            }
+            Report(scenario, occupancies[o], alive_count,
+                   PRP_TimeNow() - start, alive_count * BENCH_WIDE_REPS,
+                   bytes);
+        }
+
+        for (PRP_Size i = 0; i < BENCH_WIDE_ENTITY_COUNT; i++) {
+            PRP_Bool is_valid;
+            FECS_EntityIsValid(pCtx->world_id, pCtx->pEntities[i], &is_valid);
+            if (is_valid) {
+                FECS_EntityKill(pCtx->world_id, &pCtx->pEntities[i]);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const PRP_Char8 *pWorld_path =
+        argc > 1 ? argv[1] : BENCH_DEFAULT_WORLD_PATH;
+    BenchCtx ctx = {.rng = 0x9E3779B97F4A7C15ull};
+
+    if (FECS_Init() != PRP_OK) {
+        return EXIT_FAILURE;
+    }
+    FECS_CompRegister("Pos", 3, sizeof(Vec3), &ctx.pos_id);
+    FECS_CompRegister("Vel", 3, sizeof(Vec3), &ctx.vel_id);
+    for (PRP_Size i = 0; i < BENCH_WIDE_MAX_COMPS; i++) {
+        PRP_Char8 name[8];
+        PRP_I32 name_len = snprintf(name, sizeof(name), "C%zu", i);
+        FECS_CompRegister(name, (PRP_Size)name_len, sizeof(Vec4),
+                          &ctx.wide_comp_ids[i]);
+    }
+
+    FECS_CompId comp_ids[] = {ctx.pos_id, ctx.vel_id};
+    FECS_SystemId system_id;
+    FECS_SystemRegister("IntegrateMask", 13, IntegrateMask, 2, comp_ids,
+                        &system_id);
+    FECS_SystemRegister("IntegrateRuns", 13, IntegrateRuns, 2, comp_ids,
+                        &system_id);
+    FECS_SystemRegisterBatched("IntegrateBatched", 16, IntegrateBatched, 2,
+                               comp_ids, &system_id);
+    for (PRP_Size comp_count = 1; comp_count <= BENCH_WIDE_MAX_COMPS;
+         comp_count *= 2) {
+        PRP_Char8 name[16];
+        PRP_I32 name_len = snprintf(name, sizeof(name), "Touch%zu", comp_count);
+        FECS_SystemRegister(name, (PRP_Size)name_len, Touch, comp_count,
+                            ctx.wide_comp_ids, &system_id);
+    }
+
+    if (FECS_WorldLoad(pWorld_path, &ctx.world_id) != PRP_OK) {
+        fprintf(stderr, "Failed to load %s.\n", pWorld_path);
+        FECS_Exit();
+        return EXIT_FAILURE;
+    }
+    FECS_WorldFindLayoutId(ctx.world_id, "Particle", 8, &ctx.particle_id);
+
+    ctx.pEntities = malloc(sizeof(FECS_EntityId) * BENCH_EXEC_ENTITY_COUNT);
+    if (!ctx.pEntities) {
+        FECS_WorldUnload(&ctx.world_id);
+        FECS_Exit();
+        return EXIT_FAILURE;
+    }
+
+    printf("scenario,param,entities,ns_per_op,entities_per_s,bytes\n");
+    BenchExecPaths(&ctx);
+    BenchGetComp(&ctx);
+    BenchChurn(&ctx);
+    BenchGroups(&ctx);
+    BenchWideExec(&ctx);
+
+    free(ctx.pEntities);
+    FECS_WorldUnload(&ctx.world_id);
+    FECS_Exit();
+
+    return EXIT_SUCCESS;
+}
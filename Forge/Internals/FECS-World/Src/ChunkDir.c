@@ -0,0 +1,102 @@
+#include "Forge/Internals/FECS-World/World-Internals.h"
+
+/**
+ * Allocates the next segment and publishes it in the segment table.
+ *
+ * @param pDir The directory to add the segment to.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if every segment is allocated.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result ChunkDirAddSeg(FECS_ChunkDir *pDir);
+
+static PRP_Result ChunkDirAddSeg(FECS_ChunkDir *pDir) {
+    if (pDir->seg_count == CHUNK_DIR_MAX_SEGS) {
+        return PRP_ERR_RES_EXHAUSTED;
+    }
+    FECS_Chunk **ppSeg = malloc(sizeof(FECS_Chunk *) *
+                                (CHUNK_DIR_FIRST_SEG_CAP << pDir->seg_count));
+    if (!ppSeg) {
+        return PRP_ERR_OOM;
+    }
+    atomic_store_explicit(&pDir->ppSegs[pDir->seg_count++], ppSeg,
+                          memory_order_release);
+
+    return PRP_OK;
+}
+
+PRP_Result ChunkDirPush(FECS_ChunkDir *pDir, FECS_Chunk *pChunk) {
+    PRP_Size len = atomic_load_explicit(&pDir->len, memory_order_relaxed);
+    if (len == CHUNK_DIR_SEGS_CAP(pDir->seg_count)) {
+        PRP_Result code = ChunkDirAddSeg(pDir);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+    // The slot is written before len is published, so it is never read stale.
+    CHUNK_DIR_AT(pDir, len) = pChunk;
+    atomic_store_explicit(&pDir->len, len + 1, memory_order_release);
+
+    return PRP_OK;
+}
+
+PRP_Result ChunkDirReserve(FECS_ChunkDir *pDir, PRP_Size count) {
+    PRP_Size len = atomic_load_explicit(&pDir->len, memory_order_relaxed);
+    if (count > CHUNK_DIR_SEGS_CAP(CHUNK_DIR_MAX_SEGS) - len) {
+        return PRP_ERR_RES_EXHAUSTED;
+    }
+
+    while (CHUNK_DIR_SEGS_CAP(pDir->seg_count) < len + count) {
+        PRP_Result code = ChunkDirAddSeg(pDir);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return PRP_OK;
+}
+
+FECS_Chunk *ChunkDirPop(FECS_ChunkDir *pDir) {
+    PRP_Size len = atomic_load_explicit(&pDir->len, memory_order_relaxed);
+    PRP_DIAG_ASSERT(len > 0);
+
+    atomic_store_explicit(&pDir->len, len - 1, memory_order_release);
+
+    return CHUNK_DIR_AT(pDir, len - 1);
+}
+
+PRP_Result ChunkDirClone(const FECS_ChunkDir *pSrc, FECS_ChunkDir *pDest) {
+    *pDest = (FECS_ChunkDir){0};
+
+    // Only the segments in use are copied, spare ones stay with the source.
+    PRP_Size len = atomic_load_explicit(&pSrc->len, memory_order_relaxed);
+    while (CHUNK_DIR_SEGS_CAP(pDest->seg_count) < len) {
+        PRP_Size start = CHUNK_DIR_SEGS_CAP(pDest->seg_count);
+        PRP_Size seg_len = CHUNK_DIR_FIRST_SEG_CAP << pDest->seg_count;
+        if (seg_len > len - start) {
+            seg_len = len - start;
+        }
+        PRP_Result code = ChunkDirAddSeg(pDest);
+        if (code != PRP_OK) {
+            ChunkDirDelete(pDest);
+            return code;
+        }
+        memcpy(&CHUNK_DIR_AT(pDest, start), &CHUNK_DIR_AT(pSrc, start),
+               sizeof(FECS_Chunk *) * seg_len);
+    }
+    atomic_store_explicit(&pDest->len, len, memory_order_release);
+
+    return PRP_OK;
+}
+
+void ChunkDirDelete(FECS_ChunkDir *pDir) {
+    for (PRP_Size i = 0; i < pDir->seg_count; i++) {
+        free(atomic_load_explicit(&pDir->ppSegs[i], memory_order_relaxed));
+    }
+    *pDir = (FECS_ChunkDir){0};
+}
+
+PRP_Size ChunkDirMemoryBytes(const FECS_ChunkDir *pDir) {
+    return CHUNK_DIR_SEGS_CAP(pDir->seg_count) * sizeof(FECS_Chunk *);
+}
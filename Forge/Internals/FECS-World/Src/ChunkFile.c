@@ -0,0 +1,253 @@
+#include "Forge/Internals/FECS-World/World-Internals.h"
+
+#if defined(PRP_HAS_INCLUDE_SYS_MMAN) && defined(PRP_HAS_INCLUDE_FCNTL) &&     \
+    defined(PRP_HAS_INCLUDE_UNISTD)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define CHUNK_FILE_FIRST_SEGMENT_CAP (16)
+#define CHUNK_FILE_MAX_SEGMENTS (32)
+
+#define SEGMENT_CAP(segment_idx)                                               \
+    ((PRP_Size)CHUNK_FILE_FIRST_SEGMENT_CAP << (segment_idx))
+// Slots of all the segments before segment_idx, also its first slot idx.
+#define SEGMENT_FIRST_SLOT(segment_idx)                                        \
+    (SEGMENT_CAP(segment_idx) - CHUNK_FILE_FIRST_SEGMENT_CAP)
+
+/**
+ * The file is grown a segment at a time, each segment twice the slots of the
+ * previous one, and every segment is mapped on its own so mapped chunks never
+ * move. Slots are page aligned, so the pages of a chunk are never shared with
+ * another chunk.
+ */
+struct FECS_ChunkFile {
+    int fd;
+    PRP_Size page_size;
+    PRP_Size slot_size;
+    // Slots handed out from the segments so far, freed slots included.
+    PRP_Size slot_count;
+    PRP_Size segment_count;
+    PRP_U8 *ppSegments[CHUNK_FILE_MAX_SEGMENTS];
+    // Freed slots, linked through their first bytes.
+    void *pFree_list;
+    // The owning layout plus every allocated chunk.
+    PRP_Size ref_count;
+};
+
+/**
+ * Maps one more segment of the file, growing the file to fit it.
+ *
+ * @param pFile The chunk file to grow.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if CHUNK_FILE_MAX_SEGMENTS is reached.
+ * @return PRP_ERR_IO if the file can't be grown or mapped.
+ */
+static PRP_Result ChunkFileGrow(FECS_ChunkFile *pFile);
+/**
+ * Unmaps the segments, closes and frees the chunk file.
+ *
+ * @param pFile The chunk file to delete.
+ */
+static void ChunkFileDelete(FECS_ChunkFile *pFile);
+/**
+ * Finds the offset of a chunk of the file from the start of the file.
+ *
+ * @param pFile  The chunk file the chunk is mapped from.
+ * @param pChunk The chunk.
+ *
+ * @return The offset of the chunk in the file.
+ */
+static PRP_Size ChunkFileOffset(const FECS_ChunkFile *pFile,
+                                const FECS_Chunk *pChunk);
+
+static PRP_Result ChunkFileGrow(FECS_ChunkFile *pFile) {
+    PRP_Size segment_idx = pFile->segment_count;
+    if (segment_idx == CHUNK_FILE_MAX_SEGMENTS) {
+        return PRP_ERR_RES_EXHAUSTED;
+    }
+    PRP_Size ofs = SEGMENT_FIRST_SLOT(segment_idx) * pFile->slot_size;
+    PRP_Size size = SEGMENT_CAP(segment_idx) * pFile->slot_size;
+    /*
+     * Allocating the blocks up front instead of just truncating to size, a
+     * write to a sparse page of a mapping when the disk is full raises SIGBUS
+     * instead of an error.
+     */
+    if (posix_fallocate(pFile->fd, (off_t)ofs, (off_t)size)) {
+        return PRP_ERR_IO;
+    }
+    void *pSegment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          pFile->fd, (off_t)ofs);
+    if (pSegment == MAP_FAILED) {
+        return PRP_ERR_IO;
+    }
+    pFile->ppSegments[pFile->segment_count++] = pSegment;
+
+    return PRP_OK;
+}
+
+static void ChunkFileDelete(FECS_ChunkFile *pFile) {
+    for (PRP_Size i = 0; i < pFile->segment_count; i++) {
+        munmap(pFile->ppSegments[i], SEGMENT_CAP(i) * pFile->slot_size);
+    }
+    close(pFile->fd);
+    free(pFile);
+}
+
+static PRP_Size ChunkFileOffset(const FECS_ChunkFile *pFile,
+                                const FECS_Chunk *pChunk) {
+    uintptr_t addr = (uintptr_t)pChunk;
+    for (PRP_Size i = 0; i < pFile->segment_count; i++) {
+        uintptr_t start = (uintptr_t)pFile->ppSegments[i];
+        if (addr >= start && addr - start < SEGMENT_CAP(i) * pFile->slot_size) {
+            return SEGMENT_FIRST_SLOT(i) * pFile->slot_size +
+                   (PRP_Size)(addr - start);
+        }
+    }
+    PRP_DIAG_PANIC_MSG("The chunk is not mapped from the given chunk file.");
+
+    return 0;
+}
+
+PRP_Result ChunkFileCreate(const PRP_Char8 *pFile_path, PRP_Size chunk_size,
+                           FECS_ChunkFile **ppFile) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0) {
+        return PRP_ERR_UNSUPPORTED;
+    }
+    FECS_ChunkFile *pFile = malloc(sizeof(FECS_ChunkFile));
+    if (!pFile) {
+        return PRP_ERR_OOM;
+    }
+    *pFile = (FECS_ChunkFile){0};
+    pFile->page_size = (PRP_Size)page_size;
+    pFile->slot_size = (chunk_size + pFile->page_size - 1) /
+                       pFile->page_size * pFile->page_size;
+    pFile->ref_count = 1;
+
+    // Never clobbering an existing file, it likely isn't ours.
+    pFile->fd = open(pFile_path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (pFile->fd < 0) {
+        PRP_Result code =
+            (errno == EEXIST) ? PRP_ERR_ALREADY_EXISTS : PRP_ERR_IO;
+        free(pFile);
+        return code;
+    }
+    /*
+     * The contents are meaningless once the process is gone, unlinking right
+     * away gets the file cleaned up even if we crash.
+     */
+    unlink(pFile_path);
+    *ppFile = pFile;
+
+    return PRP_OK;
+}
+
+FECS_Chunk *ChunkFileAlloc(FECS_ChunkFile *pFile) {
+    FECS_Chunk *pChunk;
+    if (pFile->pFree_list) {
+        pChunk = pFile->pFree_list;
+        memcpy(&pFile->pFree_list, pChunk, sizeof(void *));
+    } else {
+        PRP_Size segment_idx = pFile->segment_count;
+        if (pFile->slot_count == SEGMENT_FIRST_SLOT(segment_idx) &&
+            ChunkFileGrow(pFile) != PRP_OK) {
+            return NULL;
+        }
+        // The slot count always falls in the last segment here.
+        segment_idx = pFile->segment_count - 1;
+        pChunk = (FECS_Chunk *)(pFile->ppSegments[segment_idx] +
+                                (pFile->slot_count -
+                                 SEGMENT_FIRST_SLOT(segment_idx)) *
+                                    pFile->slot_size);
+        pFile->slot_count++;
+    }
+    pFile->ref_count++;
+
+    return pChunk;
+}
+
+void ChunkFileFree(FECS_Chunk *pChunk) {
+    FECS_ChunkFile *pFile = pChunk->pFile;
+    memcpy(pChunk, &pFile->pFree_list, sizeof(void *));
+    pFile->pFree_list = pChunk;
+    ChunkFileRelease(pFile);
+}
+
+void ChunkFileRelease(FECS_ChunkFile *pFile) {
+    if (--pFile->ref_count == 0) {
+        ChunkFileDelete(pFile);
+    }
+}
+
+PRP_Result ChunkFilePageOut(FECS_Chunk *pChunk) {
+    FECS_ChunkFile *pFile = pChunk->pFile;
+    // The first page holding the gens and slot masks stays resident.
+    if (pFile->slot_size == pFile->page_size) {
+        return PRP_OK;
+    }
+    PRP_U8 *pStart = (PRP_U8 *)pChunk + pFile->page_size;
+    PRP_Size size = pFile->slot_size - pFile->page_size;
+    PRP_Size ofs = ChunkFileOffset(pFile, pChunk) + pFile->page_size;
+
+    if (msync(pStart, size, MS_SYNC)) {
+        return PRP_ERR_IO;
+    }
+    /*
+     * Mapping the same range of the file over itself drops the pages from the
+     * process, the next access faults them back in from the file. The file
+     * being written out just above, the page cache copy can then be dropped
+     * too.
+     */
+    void *pRemapped = mmap(pStart, size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_FIXED, pFile->fd, (off_t)ofs);
+    if (pRemapped == MAP_FAILED) {
+        /*
+         * Only EBADF, EINVAL and ENOTSUP guarantee the old mapping is left
+         * alone, any other failure may have unmapped part of it. The chunk
+         * was synced above, so mapping the file again puts it back as it was.
+         */
+        if (errno != EBADF && errno != EINVAL && errno != ENOTSUP) {
+            mmap(pStart, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                 pFile->fd, (off_t)ofs);
+        }
+        return PRP_ERR_IO;
+    }
+    posix_fadvise(pFile->fd, (off_t)ofs, (off_t)size, POSIX_FADV_DONTNEED);
+
+    return PRP_OK;
+}
+
+#else
+
+PRP_Result ChunkFileCreate(const PRP_Char8 *pFile_path, PRP_Size chunk_size,
+                           FECS_ChunkFile **ppFile) {
+    (void)pFile_path;
+    (void)chunk_size;
+    (void)ppFile;
+
+    return PRP_ERR_UNSUPPORTED;
+}
+
+// The rest are never reached, no chunk file can be created.
+FECS_Chunk *ChunkFileAlloc(FECS_ChunkFile *pFile) {
+    (void)pFile;
+
+    return NULL;
+}
+
+void ChunkFileFree(FECS_Chunk *pChunk) { (void)pChunk; }
+
+void ChunkFileRelease(FECS_ChunkFile *pFile) { (void)pFile; }
+
+PRP_Result ChunkFilePageOut(FECS_Chunk *pChunk) {
+    (void)pChunk;
+
+    return PRP_ERR_UNSUPPORTED;
+}
+
+#endif
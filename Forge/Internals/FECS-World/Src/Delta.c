@@ -0,0 +1,518 @@
+#include "Forge/Internals/FECS-World/World-Internals.h"
+#include "Forge/Internals/FECS/FECS-Internals.h"
+#include <stddef.h>
+
+/*
+ * Stream layout of a delta, every field in native byte order:
+ *
+ *   DeltaHeader
+ *   per layout:
+ *     DeltaLayoutHeader
+ *     per changed chunk: chunk_idx, then DeltaSegment + bytes per run, ended
+ *                        by a DeltaSegment of size 0
+ *     DELTA_END
+ *     per changed sparse set: sparse_idx, len, dense values, dense entity_idxs
+ *     DELTA_END
+ */
+#define DELTA_MAGIC ((PRP_U32)0x544C4446) // "FDLT"
+#define DELTA_VERSION ((PRP_U32)1)
+#define DELTA_END ((PRP_U64)(-1))
+
+/*
+ * Chunk header bytes that are streamed, the ref count and chunk file are local
+ * to the process.
+ */
+#define DELTA_HEADER_SIZE (offsetof(FECS_Chunk, ref_count))
+
+typedef struct DeltaHeader {
+    PRP_U32 magic;
+    PRP_U32 version;
+    PRP_U64 layout_count;
+} DeltaHeader;
+
+typedef struct DeltaLayoutHeader {
+    PRP_U64 chunk_count;
+    PRP_U64 chunk_total_size;
+} DeltaLayoutHeader;
+
+/**
+ * A run of changed bytes of a chunk, ofs is from the start of the FECS_Chunk.
+ */
+typedef struct DeltaSegment {
+    PRP_U64 ofs;
+    PRP_U64 size;
+} DeltaSegment;
+
+/**
+ * Compares two chunk offsets.
+ * Called via qsort.
+ *
+ * @param pA The first offset.
+ * @param pB The second offset.
+ *
+ * @return <0, 0 or >0 like memcmp.
+ */
+static int BoundCmp(const void *pA, const void *pB);
+/**
+ * Computes the sorted segment boundaries of the chunks of a layout, every
+ * segment being [pBounds[i], pBounds[i + 1]).
+ *
+ * @param pLayout The layout to compute the boundaries of.
+ * @param pBounds Output array, with room for 2 * comp_count + 4 entries.
+ *
+ * @return The number of boundaries written.
+ */
+static PRP_Size DeltaBounds(const FECS_Layout *pLayout, PRP_Size *pBounds);
+/**
+ * Writes the changed runs of a single chunk, nothing if no segment changed.
+ *
+ * @param pChunk      The chunk to write.
+ * @param pBase       The same chunk as the receiver has it, NULL if the
+ *                    receiver doesn't have it.
+ * @param chunk_idx   The idx of the chunk.
+ * @param pBounds     The segment boundaries of the layout.
+ * @param bound_count The len of pBounds.
+ * @param write_fn    Writes the encoded bytes.
+ * @param pUser_data  Passed to write_fn.
+ *
+ * @return PRP_OK on success.
+ * @return Error of write_fn if it fails.
+ */
+static PRP_Result DeltaWriteChunk(const FECS_Chunk *pChunk,
+                                  const FECS_Chunk *pBase, PRP_Size chunk_idx,
+                                  const PRP_Size *pBounds,
+                                  PRP_Size bound_count,
+                                  FECS_DeltaWriteFunc write_fn,
+                                  void *pUser_data);
+/**
+ * Writes the changed chunks and sparse sets of a single layout.
+ *
+ * @param pLayout    The layout the forks were taken of.
+ * @param pBase      The fork the receiver is at, NULL if it has nothing.
+ * @param pCurr      The fork to encode.
+ * @param pBounds    Scratch for the segment boundaries.
+ * @param write_fn   Writes the encoded bytes.
+ * @param pUser_data Passed to write_fn.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if a compressed chunk can't be decompressed.
+ * @return Error of write_fn if it fails.
+ */
+static PRP_Result DeltaWriteLayout(const FECS_Layout *pLayout,
+                                   const FECS_LayoutFork *pBase,
+                                   const FECS_LayoutFork *pCurr,
+                                   PRP_Size *pBounds,
+                                   FECS_DeltaWriteFunc write_fn,
+                                   void *pUser_data);
+/**
+ * Replaces the dense arrays of a sparse set with len values read from the
+ * stream.
+ *
+ * @param pSparse_set The sparse set to fill.
+ * @param len         The number of values.
+ * @param read_fn     Reads the encoded bytes.
+ * @param pUser_data  Passed to read_fn.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return Error of read_fn if it fails.
+ */
+static PRP_Result DeltaReadSparse(FECS_SparseSet *pSparse_set, PRP_Size len,
+                                  FECS_DeltaReadFunc read_fn,
+                                  void *pUser_data);
+/**
+ * Patches a single layout with its part of the stream.
+ *
+ * @param pLayout    The layout to patch.
+ * @param read_fn    Reads the encoded bytes.
+ * @param pUser_data Passed to read_fn.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_CORRUPTED if the stream doesn't match the layout.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return Error of read_fn if it fails.
+ */
+static PRP_Result DeltaApplyLayout(FECS_Layout *pLayout,
+                                   FECS_DeltaReadFunc read_fn,
+                                   void *pUser_data);
+
+static int BoundCmp(const void *pA, const void *pB) {
+    PRP_Size a = *(const PRP_Size *)pA;
+    PRP_Size b = *(const PRP_Size *)pB;
+
+    return (a > b) - (a < b);
+}
+
+static PRP_Size DeltaBounds(const FECS_Layout *pLayout, PRP_Size *pBounds) {
+    PRP_Size count = 0;
+    pBounds[count++] = 0;
+    pBounds[count++] = DELTA_HEADER_SIZE;
+    pBounds[count++] = sizeof(FECS_Chunk);
+    pBounds[count++] = pLayout->chunk_total_size;
+
+    PRP_Size comp_set_cap, _;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pLayout->pComp_set, &comp_set_cap, &_);
+    for (PRP_Size i = 0, j = 0; i < comp_set_cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            PRP_Size ofs =
+                sizeof(FECS_Chunk) + LayoutCompStride(pLayout, comp_id);
+            pBounds[count++] = ofs;
+            // The previous frame copy is a segment of its own.
+            if (COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_DOUBLE) {
+                pBounds[count++] = ofs + pLayout->double_size;
+            }
+            word &= word - 1;
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
+    qsort(pBounds, count, sizeof(PRP_Size), BoundCmp);
+
+    PRP_Size unique_count = 1;
+    for (PRP_Size i = 1; i < count; i++) {
+        if (pBounds[i] != pBounds[unique_count - 1]) {
+            pBounds[unique_count++] = pBounds[i];
+        }
+    }
+
+    return unique_count;
+}
+
+static PRP_Result DeltaWriteChunk(const FECS_Chunk *pChunk,
+                                  const FECS_Chunk *pBase, PRP_Size chunk_idx,
+                                  const PRP_Size *pBounds,
+                                  PRP_Size bound_count,
+                                  FECS_DeltaWriteFunc write_fn,
+                                  void *pUser_data) {
+    const PRP_U8 *pCurr_bytes = (const PRP_U8 *)pChunk;
+    const PRP_U8 *pBase_bytes = (const PRP_U8 *)pBase;
+    PRP_Bool is_started = PRP_False;
+    PRP_Result code;
+    for (PRP_Size i = 0; i + 1 < bound_count;) {
+        PRP_Size ofs = pBounds[i];
+        if (ofs == DELTA_HEADER_SIZE ||
+            (pBase && !memcmp(pCurr_bytes + ofs, pBase_bytes + ofs,
+                              pBounds[i + 1] - ofs))) {
+            i++;
+            continue;
+        }
+        // Extending the run over every following changed segment.
+        PRP_Size end = i + 1;
+        while (end + 1 < bound_count && pBounds[end] != DELTA_HEADER_SIZE &&
+               (!pBase || memcmp(pCurr_bytes + pBounds[end],
+                                 pBase_bytes + pBounds[end],
+                                 pBounds[end + 1] - pBounds[end]))) {
+            end++;
+        }
+
+        if (!is_started) {
+            PRP_U64 idx = chunk_idx;
+            code = write_fn(&idx, sizeof(idx), pUser_data);
+            if (code != PRP_OK) {
+                return code;
+            }
+            is_started = PRP_True;
+        }
+        DeltaSegment segment = {.ofs = ofs, .size = pBounds[end] - ofs};
+        code = write_fn(&segment, sizeof(segment), pUser_data);
+        if (code != PRP_OK) {
+            return code;
+        }
+        code = write_fn(pCurr_bytes + ofs, segment.size, pUser_data);
+        if (code != PRP_OK) {
+            return code;
+        }
+        i = end;
+    }
+    if (!is_started) {
+        return PRP_OK;
+    }
+    DeltaSegment end_segment = {0};
+
+    return write_fn(&end_segment, sizeof(end_segment), pUser_data);
+}
+
+static PRP_Result DeltaWriteLayout(const FECS_Layout *pLayout,
+                                   const FECS_LayoutFork *pBase,
+                                   const FECS_LayoutFork *pCurr,
+                                   PRP_Size *pBounds,
+                                   FECS_DeltaWriteFunc write_fn,
+                                   void *pUser_data) {
+    PRP_Size chunk_count = CHUNK_DIR_LEN(&pCurr->chunk_dir);
+    PRP_Size base_chunk_count = pBase ? CHUNK_DIR_LEN(&pBase->chunk_dir) : 0;
+    DeltaLayoutHeader header = {.chunk_count = chunk_count,
+                                .chunk_total_size = pLayout->chunk_total_size};
+    PRP_Result code = write_fn(&header, sizeof(header), pUser_data);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    PRP_Size bound_count = DeltaBounds(pLayout, pBounds);
+    // Compressed chunks are compared decompressed, each side in its scratch.
+    FECS_Chunk *pScratch = NULL;
+    FECS_Chunk *pBase_scratch = NULL;
+    for (PRP_Size i = 0; i < chunk_count; i++) {
+        const FECS_Chunk *pChunk = CHUNK_DIR_AT(&pCurr->chunk_dir, i);
+        const FECS_Chunk *pBase_chunk =
+            i < base_chunk_count ? CHUNK_DIR_AT(&pBase->chunk_dir, i) : NULL;
+        // Still shared, so neither side wrote to it since the base.
+        if (pChunk == pBase_chunk) {
+            continue;
+        }
+        pChunk = LayoutChunkUnpacked(pLayout, pChunk, &pScratch);
+        if (pChunk && pBase_chunk) {
+            pBase_chunk =
+                LayoutChunkUnpacked(pLayout, pBase_chunk, &pBase_scratch);
+        }
+        if (!pChunk || (i < base_chunk_count && !pBase_chunk)) {
+            code = PRP_ERR_OOM;
+            break;
+        }
+        code = DeltaWriteChunk(pChunk, pBase_chunk, i, pBounds,
+                               bound_count, write_fn, pUser_data);
+        if (code != PRP_OK) {
+            break;
+        }
+    }
+    free(pScratch);
+    free(pBase_scratch);
+    if (code != PRP_OK) {
+        return code;
+    }
+    PRP_U64 end = DELTA_END;
+    code = write_fn(&end, sizeof(end), pUser_data);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    for (PRP_Size i = 0; i < pCurr->sparse_count; i++) {
+        const FECS_SparseSet *pSparse_set = &pCurr->pSparse_sets[i];
+        if (pBase &&
+            CONT_ArrCmpUnchecked(pSparse_set->pDense,
+                                 pBase->pSparse_sets[i].pDense) &&
+            CONT_ArrCmpUnchecked(pSparse_set->pDense_entity_idxs,
+                                 pBase->pSparse_sets[i].pDense_entity_idxs)) {
+            continue;
+        }
+        PRP_Size len;
+        const void *pDense = CONT_ArrRawUnchecked(pSparse_set->pDense, &len);
+        const void *pDense_entity_idxs =
+            CONT_ArrRawUnchecked(pSparse_set->pDense_entity_idxs, &len);
+        PRP_U64 sparse_header[2] = {i, len};
+        code = write_fn(sparse_header, sizeof(sparse_header), pUser_data);
+        if (code == PRP_OK && len) {
+            code = write_fn(pDense, len * CONT_ArrMembSize(pSparse_set->pDense),
+                            pUser_data);
+        }
+        if (code == PRP_OK && len) {
+            code = write_fn(pDense_entity_idxs, len * sizeof(PRP_Size),
+                            pUser_data);
+        }
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return write_fn(&end, sizeof(end), pUser_data);
+}
+
+PRP_Result WorldDeltaWrite(const FECS_World *pWorld, const FECS_Fork *pBase,
+                           const FECS_Fork *pCurr, FECS_DeltaWriteFunc write_fn,
+                           void *pUser_data) {
+    // Sized for the layout with the most comps.
+    PRP_Size max_comp_count = 0;
+    for (PRP_Size i = 0; i < pWorld->layout_count; i++) {
+        PRP_Size comp_count =
+            CONT_BitmapSetCount(pWorld->pLayouts[i].pComp_set);
+        if (comp_count > max_comp_count) {
+            max_comp_count = comp_count;
+        }
+    }
+    PRP_Size *pBounds = malloc(sizeof(PRP_Size) * (2 * max_comp_count + 4));
+    if (!pBounds) {
+        return PRP_ERR_OOM;
+    }
+
+    DeltaHeader header = {.magic = DELTA_MAGIC,
+                          .version = DELTA_VERSION,
+                          .layout_count = pWorld->layout_count};
+    PRP_Result code = write_fn(&header, sizeof(header), pUser_data);
+    for (PRP_Size i = 0; i < pWorld->layout_count && code == PRP_OK; i++) {
+        code = DeltaWriteLayout(&pWorld->pLayouts[i],
+                                pBase ? &pBase->pLayouts[i] : NULL,
+                                &pCurr->pLayouts[i], pBounds, write_fn,
+                                pUser_data);
+    }
+    free(pBounds);
+
+    return code;
+}
+
+static PRP_Result DeltaReadSparse(FECS_SparseSet *pSparse_set, PRP_Size len,
+                                  FECS_DeltaReadFunc read_fn,
+                                  void *pUser_data) {
+    CONT_ArrResetUnchecked(pSparse_set->pDense);
+    CONT_ArrResetUnchecked(pSparse_set->pDense_entity_idxs);
+    if (!len) {
+        return PRP_OK;
+    }
+    PRP_Result code = CONT_ArrReserveUnchecked(pSparse_set->pDense, len);
+    if (code != PRP_OK) {
+        return code;
+    }
+    code = CONT_ArrReserveUnchecked(pSparse_set->pDense_entity_idxs, len);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    // Values are pushed one by one, so only a single value is ever buffered.
+    PRP_Size memb_size = CONT_ArrMembSize(pSparse_set->pDense);
+    PRP_U8 *pVal = malloc(memb_size);
+    if (!pVal) {
+        return PRP_ERR_OOM;
+    }
+    for (PRP_Size i = 0; i < len && code == PRP_OK; i++) {
+        code = read_fn(pVal, memb_size, pUser_data);
+        if (code == PRP_OK) {
+            code = CONT_ArrPushUnchecked(pSparse_set->pDense, pVal);
+        }
+    }
+    for (PRP_Size i = 0; i < len && code == PRP_OK; i++) {
+        PRP_Size entity_idx;
+        code = read_fn(&entity_idx, sizeof(entity_idx), pUser_data);
+        if (code == PRP_OK) {
+            code = CONT_ArrPushUnchecked(pSparse_set->pDense_entity_idxs,
+                                         &entity_idx);
+        }
+    }
+    free(pVal);
+
+    return code;
+}
+
+static PRP_Result DeltaApplyLayout(FECS_Layout *pLayout,
+                                   FECS_DeltaReadFunc read_fn,
+                                   void *pUser_data) {
+    DeltaLayoutHeader header;
+    PRP_Result code = read_fn(&header, sizeof(header), pUser_data);
+    if (code != PRP_OK) {
+        return code;
+    }
+    if (header.chunk_total_size != pLayout->chunk_total_size) {
+        return PRP_ERR_CORRUPTED;
+    }
+    code = LayoutResizeChunks(pLayout, header.chunk_count);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    PRP_U64 chunk_idx;
+    PRP_U64 prev_chunk_idx = DELTA_END;
+    while ((code = read_fn(&chunk_idx, sizeof(chunk_idx), pUser_data)) ==
+               PRP_OK &&
+           chunk_idx != DELTA_END) {
+        if (chunk_idx >= header.chunk_count ||
+            (prev_chunk_idx != DELTA_END && chunk_idx <= prev_chunk_idx)) {
+            return PRP_ERR_CORRUPTED;
+        }
+        prev_chunk_idx = chunk_idx;
+        code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+        if (code != PRP_OK) {
+            return code;
+        }
+        FECS_Chunk *pChunk = CHUNK_DIR_AT(&pLayout->chunk_dir, chunk_idx);
+
+        DeltaSegment segment;
+        while ((code = read_fn(&segment, sizeof(segment), pUser_data)) ==
+                   PRP_OK &&
+               segment.size) {
+            // Never into the ref count, never past the chunk.
+            if (segment.ofs > pLayout->chunk_total_size ||
+                segment.size > pLayout->chunk_total_size - segment.ofs ||
+                (segment.ofs < sizeof(FECS_Chunk) &&
+                 segment.ofs + segment.size > DELTA_HEADER_SIZE)) {
+                return PRP_ERR_CORRUPTED;
+            }
+            code = read_fn((PRP_U8 *)pChunk + segment.ofs, segment.size,
+                           pUser_data);
+            if (code != PRP_OK) {
+                return code;
+            }
+        }
+        if (code != PRP_OK) {
+            return code;
+        }
+        if (pChunk->free_slot_bitset) {
+            CONT_BitmapSetUnchecked(pLayout->pFree_chunk_bitset, chunk_idx);
+        } else {
+            CONT_BitmapClrUnchecked(pLayout->pFree_chunk_bitset, chunk_idx);
+        }
+    }
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    PRP_U64 sparse_header[2];
+    while ((code = read_fn(sparse_header, sizeof(PRP_U64), pUser_data)) ==
+               PRP_OK &&
+           sparse_header[0] != DELTA_END) {
+        if (sparse_header[0] >= pLayout->sparse_count) {
+            return PRP_ERR_CORRUPTED;
+        }
+        code = read_fn(&sparse_header[1], sizeof(PRP_U64), pUser_data);
+        if (code != PRP_OK) {
+            return code;
+        }
+        code = DeltaReadSparse(&pLayout->pSparse_sets[sparse_header[0]],
+                               sparse_header[1], read_fn, pUser_data);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return code;
+}
+
+PRP_Result WorldDeltaApply(FECS_World *pWorld, FECS_DeltaReadFunc read_fn,
+                           void *pUser_data) {
+    // Chunks are resized and overwritten under the idxs contexts reserved.
+    if (WorldHasSpawnCtxs(pWorld)) {
+        return PRP_ERR_BUSY;
+    }
+    DeltaHeader header;
+    PRP_Result code = read_fn(&header, sizeof(header), pUser_data);
+    if (code != PRP_OK) {
+        return code;
+    }
+    if (header.magic != DELTA_MAGIC || header.version != DELTA_VERSION ||
+        header.layout_count != pWorld->layout_count) {
+        return PRP_ERR_CORRUPTED;
+    }
+    /*
+     * The stream is applied as it is read, a fork taken first rolls back the
+     * layouts patched before a failure. Patched chunks are copied away from
+     * it like any other write.
+     */
+    FECS_Fork *pRollback;
+    code = WorldFork(pWorld, &pRollback);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    for (PRP_Size i = 0; i < pWorld->layout_count && code == PRP_OK; i++) {
+        code = DeltaApplyLayout(&pWorld->pLayouts[i], read_fn, pUser_data);
+        if (pWorld->pSpatial) {
+            SpatialMarkLayoutDirty(pWorld->pSpatial, i);
+        }
+    }
+    // Restoring only fails on OOM, the world then stays partially patched.
+    if (code != PRP_OK) {
+        WorldRestore(pWorld, pRollback);
+    }
+    ForkDelete(&pRollback);
+
+    return code;
+}
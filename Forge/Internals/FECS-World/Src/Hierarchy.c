@@ -0,0 +1,632 @@
+#include "Forge/Internals/FECS-World/World-Internals.h"
+#include <string.h>
+
+#define NODE_POS_FREE (PRP_U32_MAX)
+#define NODE_MAX_COUNT ((PRP_Size)PRP_U32_MAX - 1)
+#define HIERARCHY_DEFAULT_CAP (64)
+
+/**
+ * Grows all the level ordered arrays to fit atleast one more node.
+ *
+ * @param pHierarchy The hierarchy to grow.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result HierarchyGrow(FECS_Hierarchy *pHierarchy);
+/**
+ * Fetches the position of a valid node.
+ *
+ * @param pHierarchy The hierarchy the node belongs to.
+ * @param node       The node.
+ *
+ * @return The position of the node in the level ordered arrays.
+ */
+static PRP_U32 NodePos(const FECS_Hierarchy *pHierarchy,
+                       FECS_HierarchyNodeId node);
+/**
+ * Fetches the children links of a node.
+ *
+ * @param pHierarchy The hierarchy the node belongs to.
+ * @param node       The node, alive or being added.
+ *
+ * @return Pointer to the links of the node.
+ */
+static FECS_HierarchyLink *NodeLink(const FECS_Hierarchy *pHierarchy,
+                                    FECS_HierarchyNodeId node);
+/**
+ * Links a node as the first child of parent, a no-op for roots.
+ *
+ * @param pHierarchy The hierarchy the nodes belong to.
+ * @param node       The unlinked node.
+ * @param parent     The parent node or FECS_INVALID_ID.
+ */
+static void LinkChild(FECS_Hierarchy *pHierarchy, FECS_HierarchyNodeId node,
+                      FECS_HierarchyNodeId parent);
+/**
+ * Unlinks a node from the children of its parent, a no-op for roots.
+ *
+ * @param pHierarchy The hierarchy the nodes belong to.
+ * @param node       The node to unlink.
+ * @param parent     The current parent of node or FECS_INVALID_ID.
+ */
+static void UnlinkChild(FECS_Hierarchy *pHierarchy, FECS_HierarchyNodeId node,
+                        FECS_HierarchyNodeId parent);
+/**
+ * Marks the node at pos dirty, keeping the dirty count and min level in sync.
+ *
+ * @param pHierarchy The hierarchy the node belongs to.
+ * @param pos        The position of the node.
+ */
+static void MarkDirty(FECS_Hierarchy *pHierarchy, PRP_U32 pos);
+/**
+ * Rebuilds the breadth first level order: computes depths, counting sorts
+ * the positions by depth and permutes all the level ordered arrays.
+ *
+ * @param pHierarchy The hierarchy to reorder.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, the hierarchy is left untouched.
+ */
+static PRP_Result HierarchyReorder(FECS_Hierarchy *pHierarchy);
+/**
+ * Permutes an array in place as pArr[i] = pArr[pPerm[i]] via pScratch.
+ *
+ * @param pArr     The array to permute.
+ * @param memb_size The size of a single member.
+ * @param pPerm    The permutation, pPerm[new_pos] = old_pos.
+ * @param count    The number of members.
+ * @param pScratch Scratch memory of atleast memb_size * count bytes.
+ */
+static void Permute(void *pArr, PRP_Size memb_size, const PRP_U32 *pPerm,
+                    PRP_Size count, PRP_U8 *pScratch);
+/**
+ * pOut = a * b without going through by value copies, so a level can be swept
+ * as a tight batch.
+ *
+ * @param pOut Output matrix, must not alias a or b.
+ * @param pA   Left matrix.
+ * @param pB   Right matrix.
+ */
+static inline void Mat4MulInto(MATH_Mat4 *PRP_RESTRICT pOut,
+                               const MATH_Mat4 *PRP_RESTRICT pA,
+                               const MATH_Mat4 *PRP_RESTRICT pB);
+
+static PRP_Result HierarchyGrow(FECS_Hierarchy *pHierarchy) {
+    if (pHierarchy->node_count < pHierarchy->node_cap) {
+        return PRP_OK;
+    }
+    if (pHierarchy->node_cap >= NODE_MAX_COUNT) {
+        return PRP_ERR_RES_EXHAUSTED;
+    }
+    PRP_Size new_cap = pHierarchy->node_cap * 2;
+    if (new_cap > NODE_MAX_COUNT) {
+        new_cap = NODE_MAX_COUNT;
+    }
+
+    /*
+     * Each realloc that succeeds is kept even if a later one fails, the cap is
+     * only advanced once all of them succeed so nothing is ever out of bounds.
+     */
+#define GROW_ARR(pArr, type)                                                   \
+    do {                                                                       \
+        type *pNew = realloc(pArr, sizeof(type) * new_cap);                    \
+        if (!pNew) {                                                           \
+            return PRP_ERR_OOM;                                                \
+        }                                                                      \
+        pArr = pNew;                                                           \
+    } while (0)
+
+    GROW_ARR(pHierarchy->pNode_ids, FECS_HierarchyNodeId);
+    GROW_ARR(pHierarchy->pParent_ids, FECS_HierarchyNodeId);
+    GROW_ARR(pHierarchy->pParent_poss, PRP_U32);
+    GROW_ARR(pHierarchy->pDepths, PRP_U32);
+    GROW_ARR(pHierarchy->pLocals, MATH_Mat4);
+    GROW_ARR(pHierarchy->pWorlds, MATH_Mat4);
+    GROW_ARR(pHierarchy->pDirty, PRP_U8);
+
+#undef GROW_ARR
+
+    pHierarchy->node_cap = new_cap;
+
+    return PRP_OK;
+}
+
+static PRP_U32 NodePos(const FECS_Hierarchy *pHierarchy,
+                       FECS_HierarchyNodeId node) {
+    return *(PRP_U32 *)CONT_ArrGetUnchecked(pHierarchy->pNode_poss, node);
+}
+
+static FECS_HierarchyLink *NodeLink(const FECS_Hierarchy *pHierarchy,
+                                    FECS_HierarchyNodeId node) {
+    return CONT_ArrGetUnchecked(pHierarchy->pNode_links, node);
+}
+
+static void LinkChild(FECS_Hierarchy *pHierarchy, FECS_HierarchyNodeId node,
+                      FECS_HierarchyNodeId parent) {
+    FECS_HierarchyLink *pLink = NodeLink(pHierarchy, node);
+    pLink->prev_sibling = FECS_INVALID_ID;
+    pLink->next_sibling = FECS_INVALID_ID;
+    if (parent == FECS_INVALID_ID) {
+        return;
+    }
+    FECS_HierarchyLink *pParent_link = NodeLink(pHierarchy, parent);
+    pLink->next_sibling = pParent_link->first_child;
+    if (pLink->next_sibling != FECS_INVALID_ID) {
+        NodeLink(pHierarchy, pLink->next_sibling)->prev_sibling = node;
+    }
+    pParent_link->first_child = node;
+}
+
+static void UnlinkChild(FECS_Hierarchy *pHierarchy, FECS_HierarchyNodeId node,
+                        FECS_HierarchyNodeId parent) {
+    if (parent == FECS_INVALID_ID) {
+        return;
+    }
+    FECS_HierarchyLink *pLink = NodeLink(pHierarchy, node);
+    if (pLink->prev_sibling != FECS_INVALID_ID) {
+        NodeLink(pHierarchy, pLink->prev_sibling)->next_sibling =
+            pLink->next_sibling;
+    } else {
+        NodeLink(pHierarchy, parent)->first_child = pLink->next_sibling;
+    }
+    if (pLink->next_sibling != FECS_INVALID_ID) {
+        NodeLink(pHierarchy, pLink->next_sibling)->prev_sibling =
+            pLink->prev_sibling;
+    }
+    pLink->prev_sibling = FECS_INVALID_ID;
+    pLink->next_sibling = FECS_INVALID_ID;
+}
+
+static void MarkDirty(FECS_Hierarchy *pHierarchy, PRP_U32 pos) {
+    if (pHierarchy->pDirty[pos]) {
+        return;
+    }
+    pHierarchy->pDirty[pos] = 1;
+    pHierarchy->dirty_count++;
+    // When unordered the min level is recomputed during the reorder.
+    if (pHierarchy->is_ordered &&
+        pHierarchy->pDepths[pos] < pHierarchy->dirty_level_min) {
+        pHierarchy->dirty_level_min = pHierarchy->pDepths[pos];
+    }
+}
+
+static void Permute(void *pArr, PRP_Size memb_size, const PRP_U32 *pPerm,
+                    PRP_Size count, PRP_U8 *pScratch) {
+    PRP_U8 *pBytes = pArr;
+    for (PRP_Size i = 0; i < count; i++) {
+        memcpy(pScratch + (i * memb_size), pBytes + (pPerm[i] * memb_size),
+               memb_size);
+    }
+    memcpy(pBytes, pScratch, count * memb_size);
+}
+
+static inline void Mat4MulInto(MATH_Mat4 *PRP_RESTRICT pOut,
+                               const MATH_Mat4 *PRP_RESTRICT pA,
+                               const MATH_Mat4 *PRP_RESTRICT pB) {
+    const PRP_F32 *a = pA->membs;
+    const PRP_F32 *b = pB->membs;
+    PRP_F32 *o = pOut->membs;
+
+    // Column major, each output column is a linear combination of a's columns.
+    for (PRP_Size c = 0; c < MATH_MAT4_SIZE; c++) {
+        PRP_F32 b0 = b[(c * 4) + 0], b1 = b[(c * 4) + 1], b2 = b[(c * 4) + 2],
+                b3 = b[(c * 4) + 3];
+        for (PRP_Size r = 0; r < MATH_MAT4_SIZE; r++) {
+            o[(c * 4) + r] = (a[r] * b0) + (a[4 + r] * b1) + (a[8 + r] * b2) +
+                             (a[12 + r] * b3);
+        }
+    }
+}
+
+static PRP_Result HierarchyReorder(FECS_Hierarchy *pHierarchy) {
+    PRP_Size n = pHierarchy->node_count;
+    PRP_Result code = PRP_OK;
+
+    PRP_U32 *pDepths = malloc(sizeof(PRP_U32) * n);
+    PRP_U32 *pStack = malloc(sizeof(PRP_U32) * n);
+    PRP_U32 *pPerm = malloc(sizeof(PRP_U32) * n);
+    PRP_U8 *pScratch = malloc(sizeof(MATH_Mat4) * n);
+    PRP_Size *pLevel_ofss = NULL;
+    if (!pDepths || !pStack || !pPerm || !pScratch) {
+        code = PRP_ERR_OOM;
+        goto exit;
+    }
+
+    /*
+     * Depths via memoized parent walks, every node is pushed on the stack at
+     * most once overall so this is linear in the node count.
+     */
+    memset(pDepths, 0xFF, sizeof(PRP_U32) * n);
+    PRP_U32 max_depth = 0;
+    for (PRP_Size i = 0; i < n; i++) {
+        PRP_Size top = 0;
+        PRP_U32 pos = (PRP_U32)i;
+        PRP_U32 depth = 0;
+        while (pDepths[pos] == NODE_POS_FREE) {
+            FECS_HierarchyNodeId parent = pHierarchy->pParent_ids[pos];
+            if (parent == FECS_INVALID_ID) {
+                pDepths[pos] = 0;
+                break;
+            }
+            pStack[top++] = pos;
+            pos = NodePos(pHierarchy, parent);
+        }
+        depth = pDepths[pos];
+        while (top) {
+            pDepths[pStack[--top]] = ++depth;
+        }
+        if (pDepths[i] > max_depth) {
+            max_depth = pDepths[i];
+        }
+    }
+
+    PRP_Size level_count = n ? (PRP_Size)max_depth + 1 : 0;
+    pLevel_ofss = calloc(level_count + 1, sizeof(PRP_Size));
+    if (!pLevel_ofss) {
+        code = PRP_ERR_OOM;
+        goto exit;
+    }
+
+    // Counting sort, stable so siblings keep their relative order.
+    for (PRP_Size i = 0; i < n; i++) {
+        pLevel_ofss[pDepths[i] + 1]++;
+    }
+    for (PRP_Size l = 0; l < level_count; l++) {
+        pLevel_ofss[l + 1] += pLevel_ofss[l];
+    }
+    // pStack is reused as the per level write cursor.
+    for (PRP_Size l = 0; l < level_count; l++) {
+        pStack[l] = (PRP_U32)pLevel_ofss[l];
+    }
+    for (PRP_Size i = 0; i < n; i++) {
+        pPerm[pStack[pDepths[i]]++] = (PRP_U32)i;
+    }
+
+    // Nothing past this point can fail.
+    Permute(pHierarchy->pNode_ids, sizeof(FECS_HierarchyNodeId), pPerm, n,
+            pScratch);
+    Permute(pHierarchy->pParent_ids, sizeof(FECS_HierarchyNodeId), pPerm, n,
+            pScratch);
+    Permute(pHierarchy->pLocals, sizeof(MATH_Mat4), pPerm, n, pScratch);
+    Permute(pHierarchy->pWorlds, sizeof(MATH_Mat4), pPerm, n, pScratch);
+    Permute(pHierarchy->pDirty, sizeof(PRP_U8), pPerm, n, pScratch);
+    for (PRP_Size i = 0; i < n; i++) {
+        pHierarchy->pDepths[i] = pDepths[pPerm[i]];
+    }
+
+    for (PRP_Size i = 0; i < n; i++) {
+        PRP_U32 pos = (PRP_U32)i;
+        CONT_ArrSetUnchecked(pHierarchy->pNode_poss, pHierarchy->pNode_ids[i],
+                             &pos);
+    }
+    pHierarchy->dirty_level_min = PRP_INVALID_INDEX;
+    for (PRP_Size i = 0; i < n; i++) {
+        FECS_HierarchyNodeId parent = pHierarchy->pParent_ids[i];
+        pHierarchy->pParent_poss[i] =
+            (parent == FECS_INVALID_ID) ? NODE_POS_FREE
+                                        : NodePos(pHierarchy, parent);
+        if (pHierarchy->pDirty[i] &&
+            pHierarchy->pDepths[i] < pHierarchy->dirty_level_min) {
+            pHierarchy->dirty_level_min = pHierarchy->pDepths[i];
+        }
+    }
+
+    free(pHierarchy->pLevel_ofss);
+    pHierarchy->pLevel_ofss = pLevel_ofss;
+    pHierarchy->level_count = level_count;
+    pHierarchy->is_ordered = PRP_True;
+    pLevel_ofss = NULL;
+
+exit:
+    free(pDepths);
+    free(pStack);
+    free(pPerm);
+    free(pScratch);
+    free(pLevel_ofss);
+
+    return code;
+}
+
+PRP_Result HierarchyCreate(FECS_Hierarchy **ppHierarchy) {
+    FECS_Hierarchy *pHierarchy = calloc(1, sizeof(FECS_Hierarchy));
+    if (!pHierarchy) {
+        return PRP_ERR_OOM;
+    }
+    PRP_Result code =
+        CONT_ArrCreateUnchecked(sizeof(PRP_U32), CONT_ARR_DEFAULT_CAP,
+                                &pHierarchy->pNode_poss);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
+    code = CONT_ArrCreateUnchecked(sizeof(FECS_HierarchyNodeId),
+                                   CONT_ARR_DEFAULT_CAP,
+                                   &pHierarchy->pFree_node_ids);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
+    code = CONT_ArrCreateUnchecked(sizeof(FECS_HierarchyLink),
+                                   CONT_ARR_DEFAULT_CAP,
+                                   &pHierarchy->pNode_links);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
+    pHierarchy->pNode_ids =
+        malloc(sizeof(FECS_HierarchyNodeId) * HIERARCHY_DEFAULT_CAP);
+    pHierarchy->pParent_ids =
+        malloc(sizeof(FECS_HierarchyNodeId) * HIERARCHY_DEFAULT_CAP);
+    pHierarchy->pParent_poss = malloc(sizeof(PRP_U32) * HIERARCHY_DEFAULT_CAP);
+    pHierarchy->pDepths = malloc(sizeof(PRP_U32) * HIERARCHY_DEFAULT_CAP);
+    pHierarchy->pLocals = malloc(sizeof(MATH_Mat4) * HIERARCHY_DEFAULT_CAP);
+    pHierarchy->pWorlds = malloc(sizeof(MATH_Mat4) * HIERARCHY_DEFAULT_CAP);
+    pHierarchy->pDirty = malloc(sizeof(PRP_U8) * HIERARCHY_DEFAULT_CAP);
+    if (!pHierarchy->pNode_ids || !pHierarchy->pParent_ids ||
+        !pHierarchy->pParent_poss || !pHierarchy->pDepths ||
+        !pHierarchy->pLocals || !pHierarchy->pWorlds || !pHierarchy->pDirty) {
+        code = PRP_ERR_OOM;
+        goto err_path;
+    }
+    pHierarchy->node_cap = HIERARCHY_DEFAULT_CAP;
+    // An empty hierarchy is trivially ordered.
+    pHierarchy->is_ordered = PRP_True;
+    pHierarchy->dirty_level_min = PRP_INVALID_INDEX;
+    *ppHierarchy = pHierarchy;
+
+    return PRP_OK;
+
+err_path:
+    HierarchyDelete(&pHierarchy);
+
+    return code;
+}
+
+void HierarchyDelete(FECS_Hierarchy **ppHierarchy) {
+    FECS_Hierarchy *pHierarchy = *ppHierarchy;
+
+    if (pHierarchy->pNode_poss) {
+        CONT_ArrDeleteUnchecked(&pHierarchy->pNode_poss);
+    }
+    if (pHierarchy->pFree_node_ids) {
+        CONT_ArrDeleteUnchecked(&pHierarchy->pFree_node_ids);
+    }
+    if (pHierarchy->pNode_links) {
+        CONT_ArrDeleteUnchecked(&pHierarchy->pNode_links);
+    }
+    free(pHierarchy->pNode_ids);
+    free(pHierarchy->pParent_ids);
+    free(pHierarchy->pParent_poss);
+    free(pHierarchy->pDepths);
+    free(pHierarchy->pLocals);
+    free(pHierarchy->pWorlds);
+    free(pHierarchy->pDirty);
+    free(pHierarchy->pLevel_ofss);
+    free(pHierarchy);
+
+    *ppHierarchy = NULL;
+}
+
+PRP_Bool HierarchyNodeIsValid(const FECS_Hierarchy *pHierarchy,
+                              FECS_HierarchyNodeId node) {
+    if (node >= CONT_ArrLen(pHierarchy->pNode_poss)) {
+        return PRP_False;
+    }
+
+    return NodePos(pHierarchy, node) != NODE_POS_FREE;
+}
+
+PRP_Result HierarchyAddNode(FECS_Hierarchy *pHierarchy,
+                            FECS_HierarchyNodeId parent,
+                            const MATH_Mat4 *pLocal,
+                            FECS_HierarchyNodeId *pNode) {
+    PRP_Result code = HierarchyGrow(pHierarchy);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    PRP_U32 pos = (PRP_U32)pHierarchy->node_count;
+    FECS_HierarchyNodeId node;
+    FECS_HierarchyLink link = {.first_child = FECS_INVALID_ID};
+    if (CONT_ArrLen(pHierarchy->pFree_node_ids)) {
+        CONT_ArrPopUnchecked(pHierarchy->pFree_node_ids, &node);
+        CONT_ArrSetUnchecked(pHierarchy->pNode_poss, node, &pos);
+        CONT_ArrSetUnchecked(pHierarchy->pNode_links, node, &link);
+    } else {
+        node = CONT_ArrLen(pHierarchy->pNode_poss);
+        code = CONT_ArrPushUnchecked(pHierarchy->pNode_links, &link);
+        if (code != PRP_OK) {
+            return code;
+        }
+        code = CONT_ArrPushUnchecked(pHierarchy->pNode_poss, &pos);
+        if (code != PRP_OK) {
+            // Both arrays are indexed by node id, so they stay the same len.
+            CONT_ArrPopUnchecked(pHierarchy->pNode_links, NULL);
+            return code;
+        }
+    }
+    LinkChild(pHierarchy, node, parent);
+
+    pHierarchy->pNode_ids[pos] = node;
+    pHierarchy->pParent_ids[pos] = parent;
+    pHierarchy->pLocals[pos] = *pLocal;
+    pHierarchy->pWorlds[pos] = *pLocal;
+    pHierarchy->pDirty[pos] = 0;
+    pHierarchy->node_count++;
+    // The new node is not in the level order so the order is rebuilt lazily.
+    pHierarchy->is_ordered = PRP_False;
+    MarkDirty(pHierarchy, pos);
+    *pNode = node;
+
+    return PRP_OK;
+}
+
+void HierarchyRemoveNode(FECS_Hierarchy *pHierarchy,
+                         FECS_HierarchyNodeId node) {
+    PRP_U32 pos = NodePos(pHierarchy, node);
+    PRP_U32 last_pos = (PRP_U32)(pHierarchy->node_count - 1);
+
+    // Orphaned children become roots, their world becomes their local.
+    FECS_HierarchyLink *pLink = NodeLink(pHierarchy, node);
+    FECS_HierarchyNodeId child = pLink->first_child;
+    while (child != FECS_INVALID_ID) {
+        FECS_HierarchyLink *pChild_link = NodeLink(pHierarchy, child);
+        PRP_U32 child_pos = NodePos(pHierarchy, child);
+        pHierarchy->pLocals[child_pos] = pHierarchy->pWorlds[child_pos];
+        pHierarchy->pParent_ids[child_pos] = FECS_INVALID_ID;
+        MarkDirty(pHierarchy, child_pos);
+        child = pChild_link->next_sibling;
+        pChild_link->prev_sibling = FECS_INVALID_ID;
+        pChild_link->next_sibling = FECS_INVALID_ID;
+    }
+    pLink->first_child = FECS_INVALID_ID;
+    UnlinkChild(pHierarchy, node, pHierarchy->pParent_ids[pos]);
+    if (pHierarchy->pDirty[pos]) {
+        pHierarchy->dirty_count--;
+    }
+
+    if (pos != last_pos) {
+        FECS_HierarchyNodeId moved = pHierarchy->pNode_ids[last_pos];
+        pHierarchy->pNode_ids[pos] = moved;
+        pHierarchy->pParent_ids[pos] = pHierarchy->pParent_ids[last_pos];
+        pHierarchy->pDepths[pos] = pHierarchy->pDepths[last_pos];
+        pHierarchy->pLocals[pos] = pHierarchy->pLocals[last_pos];
+        pHierarchy->pWorlds[pos] = pHierarchy->pWorlds[last_pos];
+        pHierarchy->pDirty[pos] = pHierarchy->pDirty[last_pos];
+        CONT_ArrSetUnchecked(pHierarchy->pNode_poss, moved, &pos);
+    }
+    pHierarchy->node_count--;
+    // Level ranges and possibly the depths of the orphans changed.
+    pHierarchy->is_ordered = PRP_False;
+
+    PRP_U32 free_pos = NODE_POS_FREE;
+    CONT_ArrSetUnchecked(pHierarchy->pNode_poss, node, &free_pos);
+    /*
+     * Pushing can only fail on OOM, in that case the id is leaked rather than
+     * reused, which is harmless.
+     */
+    CONT_ArrPushUnchecked(pHierarchy->pFree_node_ids, &node);
+}
+
+PRP_Result HierarchySetParent(FECS_Hierarchy *pHierarchy,
+                              FECS_HierarchyNodeId node,
+                              FECS_HierarchyNodeId parent) {
+    // Walk up from the new parent, hitting node means a cycle would form.
+    for (FECS_HierarchyNodeId ancestor = parent; ancestor != FECS_INVALID_ID;
+         ancestor = pHierarchy->pParent_ids[NodePos(pHierarchy, ancestor)]) {
+        if (ancestor == node) {
+            return PRP_ERR_INV_ARG;
+        }
+    }
+
+    PRP_U32 pos = NodePos(pHierarchy, node);
+    if (pHierarchy->pParent_ids[pos] == parent) {
+        return PRP_OK;
+    }
+    UnlinkChild(pHierarchy, node, pHierarchy->pParent_ids[pos]);
+    LinkChild(pHierarchy, node, parent);
+    pHierarchy->pParent_ids[pos] = parent;
+    pHierarchy->is_ordered = PRP_False;
+    MarkDirty(pHierarchy, pos);
+
+    return PRP_OK;
+}
+
+void HierarchySetLocal(FECS_Hierarchy *pHierarchy, FECS_HierarchyNodeId node,
+                       const MATH_Mat4 *pLocal) {
+    PRP_U32 pos = NodePos(pHierarchy, node);
+
+    pHierarchy->pLocals[pos] = *pLocal;
+    MarkDirty(pHierarchy, pos);
+}
+
+const MATH_Mat4 *HierarchyGetWorld(const FECS_Hierarchy *pHierarchy,
+                                   FECS_HierarchyNodeId node) {
+    return &pHierarchy->pWorlds[NodePos(pHierarchy, node)];
+}
+
+PRP_Result HierarchyPropagate(FECS_Hierarchy *pHierarchy) {
+    if (!pHierarchy->dirty_count) {
+        return PRP_OK;
+    }
+    if (!pHierarchy->is_ordered) {
+        PRP_Result code = HierarchyReorder(pHierarchy);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    const PRP_U32 *PRP_RESTRICT pParent_poss = pHierarchy->pParent_poss;
+    const MATH_Mat4 *PRP_RESTRICT pLocals = pHierarchy->pLocals;
+    MATH_Mat4 *PRP_RESTRICT pWorlds = pHierarchy->pWorlds;
+    PRP_U8 *PRP_RESTRICT pDirty = pHierarchy->pDirty;
+    const PRP_Size *pLevel_ofss = pHierarchy->pLevel_ofss;
+
+    /*
+     * pDirty doubles as the propagation flag, a node recomputed in this sweep
+     * is flagged so its children in the next level pick it up. Levels above
+     * dirty_level_min have nothing dirty and are skipped entirely.
+     */
+    PRP_Size self_dirty_left = pHierarchy->dirty_count;
+    PRP_Size l = pHierarchy->dirty_level_min;
+    PRP_Size prev_begin = pLevel_ofss[l], prev_end = pLevel_ofss[l];
+    for (; l < pHierarchy->level_count; l++) {
+        PRP_Size begin = pLevel_ofss[l];
+        PRP_Size end = pLevel_ofss[l + 1];
+        PRP_Size level_dirty = 0;
+
+        if (!l) {
+            // Roots, world is the local.
+            for (PRP_Size i = begin; i < end; i++) {
+                if (pDirty[i]) {
+                    pWorlds[i] = pLocals[i];
+                    level_dirty++;
+                }
+            }
+            self_dirty_left -= level_dirty;
+        } else {
+            for (PRP_Size i = begin; i < end; i++) {
+                PRP_U32 parent_pos = pParent_poss[i];
+                PRP_U8 self_dirty = pDirty[i];
+                self_dirty_left -= self_dirty;
+                if (self_dirty | pDirty[parent_pos]) {
+                    Mat4MulInto(&pWorlds[i], &pWorlds[parent_pos],
+                                &pLocals[i]);
+                    pDirty[i] = 1;
+                    level_dirty++;
+                }
+            }
+        }
+        // The previous level's flags are no longer needed by anyone.
+        memset(pDirty + prev_begin, 0, prev_end - prev_begin);
+        prev_begin = begin;
+        prev_end = end;
+
+        if (!level_dirty && !self_dirty_left) {
+            break;
+        }
+    }
+    memset(pDirty + prev_begin, 0, prev_end - prev_begin);
+
+    pHierarchy->dirty_count = 0;
+    pHierarchy->dirty_level_min = PRP_INVALID_INDEX;
+
+    return PRP_OK;
+}
+
+PRP_Size HierarchyMemoryBytes(const FECS_Hierarchy *pHierarchy) {
+    PRP_Size per_node_size =
+        sizeof(FECS_HierarchyNodeId) * 2 + sizeof(PRP_U32) * 2 +
+        sizeof(MATH_Mat4) * 2 + sizeof(PRP_U8);
+    PRP_Size bytes = sizeof(FECS_Hierarchy) +
+                     pHierarchy->node_cap * per_node_size +
+                     CONT_ArrCap(pHierarchy->pNode_poss) * sizeof(PRP_U32) +
+                     CONT_ArrCap(pHierarchy->pFree_node_ids) *
+                         sizeof(FECS_HierarchyNodeId) +
+                     CONT_ArrCap(pHierarchy->pNode_links) *
+                         sizeof(FECS_HierarchyLink);
+    if (pHierarchy->pLevel_ofss) {
+        bytes += (pHierarchy->level_count + 1) * sizeof(PRP_Size);
+    }
+
+    return bytes;
+}
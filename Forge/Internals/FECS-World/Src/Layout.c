@@ -1,6 +1,25 @@
 #include "Core/Logging/Log.h"
 #include "Forge/Internals/FECS-World/World-Internals.h"
 #include "Forge/Internals/FECS/FECS-Internals.h"
+#include <stddef.h>
+
+// Size of FECS_Layout::pTemplate, a single slot of every column.
+#define TEMPLATE_SIZE(pLayout)                                                 \
+    (((pLayout)->chunk_total_size - sizeof(FECS_Chunk) -                       \
+      (pLayout)->double_ofs) /                                                 \
+     CHUNK_CAP)
+
+#define CHUNK(pLayout, chunk_idx) CHUNK_DIR_AT(&(pLayout)->chunk_dir, chunk_idx)
+
+// Size of the plain columns of a chunk, the part that is compressed.
+#define COLUMNS_SIZE(pLayout)                                                  \
+    ((pLayout)->chunk_total_size - sizeof(FECS_Chunk) -                        \
+     LAYOUT_COLUMNS_OFS(pLayout))
+
+// The fewest chunks the shared index of a layout is sized for.
+#define SHARED_INDEX_MIN_CAP ((PRP_Size)16)
+// The chain of the shared index holding the empty chunks, after the buckets.
+#define SHARED_EMPTY_CHAIN(pLayout) ((pLayout)->shared_bucket_count)
 
 /**
  * Adds new chunk to layout.
@@ -12,6 +31,73 @@
  * @return PRP_ERR_OOM if allocation fails.
  */
 static PRP_Result CreateChunk(FECS_Layout *pLayout);
+/**
+ * Makes room for count more chunks in a layout, in its chunk directory, its
+ * free chunk bitset and its shared index, so that pushing them can't fail.
+ *
+ * @param pLayout Layout instance.
+ * @param count   The number of chunks to make room for.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result LayoutReserveChunks(FECS_Layout *pLayout, PRP_Size count);
+/**
+ * Hashes a shared comp key into a bucket of the shared index of a layout.
+ *
+ * @param pLayout Layout instance, must have shared comps.
+ * @param pKey    The key, shared_size bytes.
+ *
+ * @return The bucket of the key.
+ */
+static PRP_Size SharedKeyBucket(const FECS_Layout *pLayout,
+                                const PRP_U8 *pKey);
+/**
+ * Grows the shared index of a layout to cover at least chunk_count chunks and
+ * marks it stale, so that the next rebuild rehashes the chunks.
+ *
+ * @param pLayout     Layout instance, must have shared comps.
+ * @param chunk_count The number of chunks to cover.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, the index is left as is.
+ */
+static PRP_Result SharedIndexGrow(FECS_Layout *pLayout, PRP_Size chunk_count);
+/**
+ * Moves a chunk into a chain of the shared index of a layout, at its head.
+ *
+ * @param pLayout   Layout instance, its shared index must not be stale.
+ * @param chunk_idx The chunk to move, must be < shared_link_cap.
+ * @param chain     The chain to move into, PRP_INVALID_INDEX to unlink.
+ */
+static void SharedIndexMove(FECS_Layout *pLayout, PRP_Size chunk_idx,
+                            PRP_Size chain);
+/**
+ * Moves a chunk into the chain of the shared index it belongs in: none if it
+ * is popped or has no free slot, the empty chain if every slot is free and the
+ * chain of its key otherwise.
+ *
+ * @param pLayout   Layout instance, its shared index must not be stale.
+ * @param chunk_idx The chunk to place, must be < shared_link_cap.
+ */
+static void SharedIndexPlace(FECS_Layout *pLayout, PRP_Size chunk_idx);
+/**
+ * Rebuilds the stale shared index of a layout from its free chunk bitset.
+ *
+ * @param pLayout Layout instance, must have shared comps.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if growing the index fails, it stays stale.
+ */
+static PRP_Result SharedIndexRebuild(FECS_Layout *pLayout);
+/**
+ * Marks a chunk as having a free slot, and places it in the shared index.
+ *
+ * @param pLayout   Layout instance.
+ * @param chunk_idx The chunk that gained a free slot.
+ */
+static void LayoutMarkChunkFree(FECS_Layout *pLayout, PRP_Size chunk_idx);
 /**
  * Initializes internals of a new layout given the mem objects have been
  * inited.
@@ -24,43 +110,123 @@ static PRP_Result CreateChunk(FECS_Layout *pLayout);
  */
 static PRP_Result LayoutInitInternals(FECS_Layout *pLayout);
 /**
- * Deletes the chunks inside layout.
- * Called via CONT_ArrForEach_...
+ * Creates the sparse sets of all the sparse comps of a layout, given
+ * LayoutInitInternals has run.
+ *
+ * @param pLayout Layout instance.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result LayoutCreateSparseSets(FECS_Layout *pLayout);
+/**
+ * Fetches the entry of a component in FECS_Layout::pComps by its rank in the
+ * comp set.
+ *
+ * @param pLayout The layout to fetch from.
+ * @param comp_id The component, must be present in the layout.
+ *
+ * @return The entry of the component.
+ */
+static const FECS_LayoutComp *LayoutComp(const FECS_Layout *pLayout,
+                                         FECS_CompId comp_id);
+/**
+ * Deletes the sparse sets of a layout, handles partially created sets.
+ *
+ * @param pLayout Layout instance.
+ */
+static void LayoutDeleteSparseSets(FECS_Layout *pLayout);
+/**
+ * Releases a chunk of a layout or fork, freeing it if no one else holds it.
+ *
+ * @param pChunk The chunk to release.
+ */
+static void ChunkRelease(FECS_Chunk *pChunk);
+/**
+ * Allocates the memory of a chunk of the layout, from the layout's chunk file
+ * if it has one. FECS_Chunk::pFile is left for the caller to set.
+ *
+ * @param pLayout Layout instance.
+ *
+ * @return The uninitialized chunk, NULL if allocation fails.
+ */
+static FECS_Chunk *ChunkAlloc(FECS_Layout *pLayout);
+/**
+ * LayoutChunkMakeUnique without the access, for writes that don't count as
+ * one.
+ *
+ * @param pLayout   Layout instance.
+ * @param chunk_idx The chunk to make unique.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, the chunk stays shared.
+ */
+static PRP_Result ChunkUnshare(FECS_Layout *pLayout, PRP_Size chunk_idx);
+/**
+ * Decompresses a compressed chunk into a new chunk of the layout.
  *
- * @param ppChunk Chunk** to free.
+ * @param pLayout   Layout instance.
+ * @param chunk_idx The compressed chunk.
  *
  * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, the chunk stays compressed.
+ *
+ * @note:
+ * - Works with compression disabled too, chunks restored from a fork may
+ *   still be compressed.
  */
-static PRP_Result ChunkPtrDelCb(void *ppChunk, void *_);
+static PRP_Result ChunkUnpack(FECS_Layout *pLayout, PRP_Size chunk_idx);
+/**
+ * Releases every chunk of a directory and deletes the directory.
+ *
+ * @param pDir The directory of a layout or fork.
+ */
+static void ChunkDirRelease(FECS_ChunkDir *pDir);
 
-static PRP_Result CreateChunk(FECS_Layout *pLayout) {
-    FECS_Chunk *pChunk = malloc(pLayout->chunk_total_size);
-    if (!pChunk) {
-        return PRP_ERR_OOM;
-    }
-    PRP_Size push_idx = CONT_ArrLen(pLayout->pChunk_ptrs);
+static PRP_Result LayoutReserveChunks(FECS_Layout *pLayout, PRP_Size count) {
     PRP_Size bit_cap = CONT_BitmapBitCap(pLayout->pFree_chunk_bitset);
-    if (push_idx >= bit_cap) {
+    if (count > CONT_BITMAP_MAX_BIT_CAP - CHUNK_DIR_LEN(&pLayout->chunk_dir)) {
+        return PRP_ERR_RES_EXHAUSTED;
+    }
+    PRP_Size needed = CHUNK_DIR_LEN(&pLayout->chunk_dir) + count;
+    if (needed > bit_cap) {
         PRP_Size new_bit_cap;
         if (CONT_BITMAP_MAX_BIT_CAP / 2 < bit_cap) {
             new_bit_cap = CONT_BITMAP_MAX_BIT_CAP;
         } else {
-            new_bit_cap = bit_cap * 2;
+            new_bit_cap = PRP_MAX(bit_cap * 2, needed);
         }
         PRP_Result code = CONT_BitmapChangeSizeUnchecked(
             pLayout->pFree_chunk_bitset, new_bit_cap);
         if (code != PRP_OK) {
-            free(pChunk);
             return code;
         }
     }
-    PRP_Result code = CONT_ArrPushUnchecked(pLayout->pChunk_ptrs, &pChunk);
+    if (pLayout->shared_size && needed > pLayout->shared_link_cap) {
+        PRP_Result code = SharedIndexGrow(pLayout, needed);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return ChunkDirReserve(&pLayout->chunk_dir, count);
+}
+
+static PRP_Result CreateChunk(FECS_Layout *pLayout) {
+    PRP_Result code = LayoutReserveChunks(pLayout, 1);
     if (code != PRP_OK) {
-        free(pChunk);
         return code;
     }
+    FECS_Chunk *pChunk = ChunkAlloc(pLayout);
+    if (!pChunk) {
+        return PRP_ERR_OOM;
+    }
+    PRP_Size push_idx = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+    // Can't fail, the room was just reserved.
+    ChunkDirPush(&pLayout->chunk_dir, pChunk);
     /*
-     * Sets all the gens to u8 max. And the free_slot's all the bits to 1.
+     * Sets all the gens to u8 max. And the free_slot's and enabled_slot's all
+     * the bits to 1.
      * Essentially initializing in a single optimized call instead of manual
      * assigning.
      *
@@ -72,7 +238,18 @@ static PRP_Result CreateChunk(FECS_Layout *pLayout) {
      * and doesn't count in the size of struct.
      */
     memset(pChunk, 0XFF, sizeof(FECS_Chunk));
-    CONT_BitmapSetUnchecked(pLayout->pFree_chunk_bitset, push_idx);
+    pChunk->ref_count = 1;
+    pChunk->pFile = pLayout->pChunk_file;
+    atomic_store_explicit(&pChunk->access_frame, pLayout->frame,
+                          memory_order_relaxed);
+    pChunk->packed_size = 0;
+    for (PRP_Size i = 0; i < pLayout->sparse_count; i++) {
+        FECS_ChunkSparseMap *pMap =
+            (FECS_ChunkSparseMap *)(pChunk->pChunk_mem +
+                                    pLayout->pSparse_sets[i].stride);
+        pMap->presence_bitset = 0;
+    }
+    LayoutMarkChunkFree(pLayout, push_idx);
 
     return PRP_OK;
 }
@@ -81,12 +258,59 @@ static PRP_Result LayoutInitInternals(FECS_Layout *pLayout) {
     PRP_Size comps_len, comp_set_cap, comp_set_bit_cap;
     const PRP_Size *pComp_sizes =
         CONT_ArrRawUnchecked(g_ctx->pComp_sizes, &comps_len);
+    const FECS_CompStorage *pComp_storages =
+        CONT_ArrRawUnchecked(g_ctx->pComp_storages, &comps_len);
     const CONT_Bitword *pBitwords = CONT_BitmapRawUnchecked(
         pLayout->pComp_set, &comp_set_cap, &comp_set_bit_cap);
 
+    /*
+     * Tag masks and shared values are packed before the comp arrays, so they
+     * are counted first. Shared values are padded to keep every block after
+     * them aligned.
+     */
+    pLayout->tag_count = 0;
+    pLayout->shared_size = 0;
+    pLayout->sparse_count = 0;
+    pLayout->double_size = 0;
+    for (PRP_Size i = 0, j = 0; i < comp_set_cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            switch (pComp_storages[comp_id]) {
+            case FECS_COMP_STORAGE_TAG:
+                pLayout->tag_count++;
+                break;
+            case FECS_COMP_STORAGE_SHARED:
+                pLayout->shared_size +=
+                    PRP_ALIGN_UP(pComp_sizes[comp_id], sizeof(PRP_Size));
+                break;
+            case FECS_COMP_STORAGE_SPARSE:
+                pLayout->sparse_count++;
+                break;
+            case FECS_COMP_STORAGE_DOUBLE:
+                pLayout->double_size += pComp_sizes[comp_id] * CHUNK_CAP;
+                break;
+            case FECS_COMP_STORAGE_COLUMN:
+                break;
+            }
+
+            word &= word - 1;
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
+    pLayout->shared_ofs = pLayout->tag_count * sizeof(FECS_ChunkFreeSlotType);
+
     pLayout->pWord_prefix_popcnts[0] = 0;
-    PRP_Size *pStride_dest = &pLayout->pComp_arr_strides[0];
-    PRP_Size stride = 0;
+    FECS_LayoutComp *pComp_dest = &pLayout->pComps[0];
+    PRP_Size sparse_idx = 0;
+    PRP_Size tag_stride = 0;
+    PRP_Size shared_stride = pLayout->shared_ofs;
+    PRP_Size sparse_stride = pLayout->shared_ofs + pLayout->shared_size;
+    pLayout->double_ofs =
+        sparse_stride + pLayout->sparse_count * sizeof(FECS_ChunkSparseMap);
+    PRP_Size double_stride = pLayout->double_ofs;
+    // Room is left for the previous frame copy of the double block.
+    PRP_Size stride = pLayout->double_ofs + pLayout->double_size * 2;
     for (PRP_Size i = 0, j = 0; i < comp_set_cap; i++) {
         CONT_Bitword word = pBitwords[i];
         if (i < comp_set_cap - 1) {
@@ -96,9 +320,33 @@ static PRP_Result LayoutInitInternals(FECS_Layout *pLayout) {
         }
         while (word) {
             PRP_Size comp_id = CONT_BitwordFFS(word) + j;
-            *pStride_dest = stride;
-            pStride_dest++;
-            stride += pComp_sizes[comp_id] * CHUNK_CAP;
+            pComp_dest->sparse_idx = PRP_INVALID_INDEX;
+            switch (pComp_storages[comp_id]) {
+            case FECS_COMP_STORAGE_TAG:
+                pComp_dest->stride = tag_stride;
+                tag_stride += sizeof(FECS_ChunkFreeSlotType);
+                break;
+            case FECS_COMP_STORAGE_SHARED:
+                pComp_dest->stride = shared_stride;
+                shared_stride +=
+                    PRP_ALIGN_UP(pComp_sizes[comp_id], sizeof(PRP_Size));
+                break;
+            case FECS_COMP_STORAGE_SPARSE:
+                pComp_dest->stride = sparse_stride;
+                sparse_stride += sizeof(FECS_ChunkSparseMap);
+                // Sparse sets are created in the same comp id order.
+                pComp_dest->sparse_idx = sparse_idx++;
+                break;
+            case FECS_COMP_STORAGE_DOUBLE:
+                pComp_dest->stride = double_stride;
+                double_stride += pComp_sizes[comp_id] * CHUNK_CAP;
+                break;
+            case FECS_COMP_STORAGE_COLUMN:
+                pComp_dest->stride = stride;
+                stride += pComp_sizes[comp_id] * CHUNK_CAP;
+                break;
+            }
+            pComp_dest++;
 
             word &= word - 1;
         }
@@ -109,32 +357,105 @@ static PRP_Result LayoutInitInternals(FECS_Layout *pLayout) {
     return PRP_OK;
 }
 
-static PRP_Result ChunkPtrDelCb(void *ppChunk, void *_) {
-    (void)_;
-    FECS_Chunk *pChunk = *(FECS_Chunk **)ppChunk;
+static PRP_Result LayoutCreateSparseSets(FECS_Layout *pLayout) {
+    if (!pLayout->sparse_count) {
+        return PRP_OK;
+    }
+    pLayout->pSparse_sets =
+        calloc(pLayout->sparse_count, sizeof(FECS_SparseSet));
+    if (!pLayout->pSparse_sets) {
+        return PRP_ERR_OOM;
+    }
 
-    free(pChunk);
+    PRP_Size cap, bit_cap;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pLayout->pComp_set, &cap, &bit_cap);
+    FECS_SparseSet *pSparse_set = pLayout->pSparse_sets;
+    for (PRP_Size i = 0, j = 0; i < cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            word &= word - 1;
+            if (COMP_STORAGE(comp_id) != FECS_COMP_STORAGE_SPARSE) {
+                continue;
+            }
+
+            pSparse_set->comp_id = comp_id;
+            pSparse_set->stride = LayoutCompStride(pLayout, comp_id);
+            PRP_Result code = CONT_ArrCreateUnchecked(
+                COMP_SIZE(comp_id), CONT_ARR_DEFAULT_CAP, &pSparse_set->pDense);
+            if (code != PRP_OK) {
+                return code;
+            }
+            code = CONT_ArrCreateUnchecked(sizeof(PRP_Size),
+                                           CONT_ARR_DEFAULT_CAP,
+                                           &pSparse_set->pDense_entity_idxs);
+            if (code != PRP_OK) {
+                return code;
+            }
+            pSparse_set++;
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
 
     return PRP_OK;
 }
 
+static void LayoutDeleteSparseSets(FECS_Layout *pLayout) {
+    if (!pLayout->pSparse_sets) {
+        return;
+    }
+    for (PRP_Size i = 0; i < pLayout->sparse_count; i++) {
+        FECS_SparseSet *pSparse_set = &pLayout->pSparse_sets[i];
+        if (pSparse_set->pDense) {
+            CONT_ArrDeleteUnchecked(&pSparse_set->pDense);
+        }
+        if (pSparse_set->pDense_entity_idxs) {
+            CONT_ArrDeleteUnchecked(&pSparse_set->pDense_entity_idxs);
+        }
+    }
+    free(pLayout->pSparse_sets);
+    pLayout->pSparse_sets = NULL;
+}
+
+static void ChunkRelease(FECS_Chunk *pChunk) {
+    if (--pChunk->ref_count != 0) {
+        return;
+    }
+    if (pChunk->pFile) {
+        ChunkFileFree(pChunk);
+    } else {
+        free(pChunk);
+    }
+}
+
+static FECS_Chunk *ChunkAlloc(FECS_Layout *pLayout) {
+    if (pLayout->pChunk_file) {
+        return ChunkFileAlloc(pLayout->pChunk_file);
+    }
+
+    return malloc(pLayout->chunk_total_size);
+}
+
+static void ChunkDirRelease(FECS_ChunkDir *pDir) {
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(pDir); i++) {
+        ChunkRelease(CHUNK_DIR_AT(pDir, i));
+    }
+    ChunkDirDelete(pDir);
+}
+
 PRP_Result LayoutCreate(CONT_Bitmap *pCreate_info, FECS_Layout *pLayout) {
     *pLayout = (FECS_Layout){0};
     pLayout->pComp_set = pCreate_info;
 
-    PRP_Result code = CONT_ArrCreateUnchecked(
-        sizeof(FECS_Chunk *), CONT_ARR_DEFAULT_CAP, &pLayout->pChunk_ptrs);
+    PRP_Result code = CONT_BitmapCreateUnchecked(CONT_ARR_DEFAULT_CAP,
+                                                 &pLayout->pFree_chunk_bitset);
     if (code != PRP_OK) {
         goto err_path;
     }
-    code = CONT_BitmapCreateUnchecked(CONT_ARR_DEFAULT_CAP,
-                                      &pLayout->pFree_chunk_bitset);
-    if (code != PRP_OK) {
-        goto err_path;
-    }
-    pLayout->pComp_arr_strides =
-        malloc(sizeof(PRP_Size) * CONT_BitmapSetCount(pCreate_info));
-    if (!pLayout->pComp_arr_strides) {
+    pLayout->pComps =
+        malloc(sizeof(FECS_LayoutComp) * CONT_BitmapSetCount(pCreate_info));
+    if (!pLayout->pComps) {
         code = PRP_ERR_OOM;
         goto err_path;
     }
@@ -148,25 +469,41 @@ PRP_Result LayoutCreate(CONT_Bitmap *pCreate_info, FECS_Layout *pLayout) {
     if (code != PRP_OK) {
         goto err_path;
     }
+    if (pLayout->shared_size) {
+        pLayout->pShared_key = malloc(pLayout->shared_size);
+        if (!pLayout->pShared_key) {
+            code = PRP_ERR_OOM;
+            goto err_path;
+        }
+        // Built by the first spawn.
+        pLayout->is_shared_index_stale = PRP_True;
+    }
+    code = LayoutCreateSparseSets(pLayout);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
 
     return PRP_OK;
 
 err_path:
-    if (pLayout->pChunk_ptrs) {
-        // If chunk were created it frees it.
-        CONT_ArrForEachUnchecked(pLayout->pChunk_ptrs, ChunkPtrDelCb, NULL);
-        CONT_ArrDeleteUnchecked(&pLayout->pChunk_ptrs);
-    }
+    // If chunk were created it frees it.
+    ChunkDirRelease(&pLayout->chunk_dir);
     if (pLayout->pFree_chunk_bitset) {
         CONT_BitmapDeleteUnchecked(&pLayout->pFree_chunk_bitset);
     }
     CONT_BitmapDeleteUnchecked(&pLayout->pComp_set);
-    if (pLayout->pComp_arr_strides) {
-        free(pLayout->pComp_arr_strides);
+    if (pLayout->pComps) {
+        free(pLayout->pComps);
     }
     if (pLayout->pWord_prefix_popcnts) {
         free(pLayout->pWord_prefix_popcnts);
     }
+    if (pLayout->pShared_key) {
+        free(pLayout->pShared_key);
+    }
+    free(pLayout->pShared_heads);
+    free(pLayout->pShared_links);
+    LayoutDeleteSparseSets(pLayout);
 
     return code;
 }
@@ -177,411 +514,3460 @@ void LayoutDelete(FECS_Layout *pLayout) {
     CONT_BitmapDeleteUnchecked(&pLayout->pComp_set);
     CONT_BitmapDeleteUnchecked(&pLayout->pFree_chunk_bitset);
 
-    CONT_ArrForEachUnchecked(pLayout->pChunk_ptrs, ChunkPtrDelCb, NULL);
-    CONT_ArrDeleteUnchecked(&pLayout->pChunk_ptrs);
+    ChunkDirRelease(&pLayout->chunk_dir);
+    if (pLayout->pChunk_file) {
+        ChunkFileRelease(pLayout->pChunk_file);
+    }
 
-    free(pLayout->pComp_arr_strides);
+    free(pLayout->pComps);
     free(pLayout->pWord_prefix_popcnts);
+    free(pLayout->pShared_key);
+    free(pLayout->pShared_heads);
+    free(pLayout->pShared_links);
+    free(pLayout->pTemplate);
+    free(pLayout->pPack_scratch);
+    free(pLayout->pRead_scratch);
+    LayoutDeleteSparseSets(pLayout);
 
 #ifdef PRP_DEBUG_MODE
-    pLayout->pComp_arr_strides = NULL;
+    pLayout->pComps = NULL;
     pLayout->pWord_prefix_popcnts = NULL;
+    pLayout->pShared_key = NULL;
+    pLayout->pShared_heads = NULL;
+    pLayout->pShared_links = NULL;
+    pLayout->pTemplate = NULL;
+    pLayout->pChunk_file = NULL;
+    pLayout->pPack_scratch = NULL;
+    pLayout->pRead_scratch = NULL;
 #endif
 }
 
-/* ----  ENTITIES ---- */
+static const FECS_LayoutComp *LayoutComp(const FECS_Layout *pLayout,
+                                         FECS_CompId comp_id) {
+    PRP_Size _;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pLayout->pComp_set, &_, &_);
+    PRP_Size word_i = WORD_I(comp_id);
+    PRP_Size prefix_popcnt = pLayout->pWord_prefix_popcnts[word_i];
+    PRP_U16 rank_in_word = (PRP_U16)CONT_BitwordPopCnt(pBitwords[word_i] &
+                                                       (BIT_MASK(comp_id) - 1));
 
-#define CHUNK(pLayout, chunk_idx)                                              \
-    (*(FECS_Chunk **)CONT_ArrGetUnchecked((pLayout)->pChunk_ptrs, (chunk_idx)))
+    return &pLayout->pComps[prefix_popcnt + rank_in_word];
+}
 
-#define ENTITY_SLOT_MASK ((PRP_Size)63)
-#define ENTITY_SLOT_BITS (6)
-// Explicit encoding instead of just multiplying, to show intent.
-#define ENTITY_IDX(chunk_idx, slot_idx)                                        \
-    (((PRP_Size)(chunk_idx) << ENTITY_SLOT_BITS) |                             \
-     ((PRP_Size)(slot_idx) & ENTITY_SLOT_MASK))
+PRP_Size LayoutCompStride(const FECS_Layout *pLayout, FECS_CompId comp_id) {
+    return LayoutComp(pLayout, comp_id)->stride;
+}
 
-#define MAX_ENTITY_CAP(pLayout) (CONT_ArrLen(pLayout->pChunk_ptrs) * CHUNK_CAP)
+FECS_SparseSet *LayoutFindSparseSet(const FECS_Layout *pLayout,
+                                    FECS_CompId comp_id) {
+    if (comp_id >= CONT_BitmapBitCap(pLayout->pComp_set) ||
+        !CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id)) {
+        return NULL;
+    }
+    PRP_Size sparse_idx = LayoutComp(pLayout, comp_id)->sparse_idx;
 
-/**
- * A chunk view is data upon a chunk's entire free slots allocated at once.
- */
-typedef struct ChunkView {
-    PRP_Size chunk_idx;
-    FECS_ChunkFreeSlotType occupied_slots;
-    PRP_U32 gens[CHUNK_CAP];
-} ChunkView;
+    return sparse_idx == PRP_INVALID_INDEX ? NULL
+                                           : &pLayout->pSparse_sets[sparse_idx];
+}
 
-/**
- * Checks if the chunk view of a entity group is valid.
- *
- * @param pVal       A chunk view from entity group.
- * @param pUser_data The layout the entities/chunk_views belong to.
- *
- * @return PRP_OK on success.
- * @return PRP_ERR_INV_STATE if the chunk view contains invlaid entities.
- */
-static PRP_Result EntityGroupValidityCb(void *pVal, void *pUser_data);
-/**
- * Kills entities of a chunk view of a entity group.
- *
- * @param pVal       A chunk view from entity batch.
- * @param pUser_data The layout the entities/chunk_views belong to.
- *
- * @return PRP_OK on success.
- * @return PRP_ERR_INV_ARG if the chunk view contains invlaid entities.
- */
-static PRP_Result EntityGroupKillCb(void *pVal, void *pUser_data);
-/**
- * Iterates over entities of a chunk view of a entity group.
- *
- * @param pVal       A chunk view from entity batch.
- * @param pUser_data The iteration data containing all the context.
- *
- * @return PRP_OK on success.
- * @return PRP_ERR_INV_ARG if the chunk view contains invlaid entities.
- */
-static PRP_Result EntityGroupIterationCb(void *pVal, void *pUser_data);
+PRP_Result LayoutBuildSharedKey(FECS_Layout *pLayout, PRP_Size shared_count,
+                                const FECS_CompId *pShared_comp_ids,
+                                const void *const *ppShared_data,
+                                const PRP_U8 **ppKey) {
+    *ppKey = NULL;
+    if (!pLayout->shared_size) {
+        return shared_count ? PRP_ERR_INV_ARG : PRP_OK;
+    }
 
-PRP_Result EntitySpawn(FECS_World *pWorld, FECS_LayoutId layout_id,
-                       FECS_EntityId *pEntity) {
-    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
-    PRP_Size free_chunk_idx = CONT_BitmapFFS(pLayout->pFree_chunk_bitset);
-    if (free_chunk_idx == PRP_INVALID_INDEX) {
-        PRP_Result code = CreateChunk(pLayout);
-        if (code != PRP_OK) {
-            return code;
+    memset(pLayout->pShared_key, 0, pLayout->shared_size);
+    for (PRP_Size i = 0; i < shared_count; i++) {
+        FECS_CompId comp_id = pShared_comp_ids[i];
+        if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id) ||
+            COMP_STORAGE(comp_id) != FECS_COMP_STORAGE_SHARED) {
+            return PRP_ERR_INV_ARG;
         }
-        free_chunk_idx = CONT_BitmapFFS(pLayout->pFree_chunk_bitset);
-    }
-    FECS_Chunk *pChunk = CHUNK(pLayout, free_chunk_idx);
-    FECS_ChunkFreeSlotType free_slot_idx =
-        (FECS_ChunkFreeSlotType)CONT_BitwordFFS(
-            (CONT_Bitword)pChunk->free_slot_bitset);
-    pEntity->layout_id = layout_id;
-    pEntity->gen = pChunk->gens[free_chunk_idx];
-    pEntity->entity_idx = ENTITY_IDX(free_chunk_idx, free_slot_idx);
-    PRP_BIT_CLR(pChunk->free_slot_bitset, BIT_MASK(free_chunk_idx));
-    if (!pChunk->free_slot_bitset) {
-        CONT_BitmapClrUnchecked(pLayout->pFree_chunk_bitset, free_chunk_idx);
+        memcpy(pLayout->pShared_key + LayoutCompStride(pLayout, comp_id) -
+                   pLayout->shared_ofs,
+               ppShared_data[i], COMP_SIZE(comp_id));
     }
+    *ppKey = pLayout->pShared_key;
 
     return PRP_OK;
 }
 
-PRP_Result EntityGroupSpawn(FECS_World *pWorld, FECS_LayoutId layout_id,
-                            PRP_Size entity_count,
-                            FECS_EntityGroupId **ppGroup) {
-    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
-
-    PRP_Size min_cap = (entity_count + CHUNK_CAP - 1) / CHUNK_CAP;
-    FECS_EntityGroupId *pGroup = malloc(sizeof(FECS_EntityGroupId));
-    if (!pGroup) {
-        return PRP_ERR_OOM;
+void LayoutGetMemoryStats(const FECS_Layout *pLayout,
+                          FECS_LayoutMemoryStats *pStats) {
+    *pStats = (FECS_LayoutMemoryStats){0};
+
+    PRP_Size chunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+    for (PRP_Size i = 0; i < chunk_count; i++) {
+        PRP_Size alive = CONT_BitwordPopCnt(
+            (CONT_Bitword)(~CHUNK(pLayout, i)->free_slot_bitset));
+        pStats->alive_entity_count += alive;
+        pStats->empty_chunk_count += (alive == 0);
+        pStats->full_chunk_count += (alive == CHUNK_CAP);
+        pStats->file_chunk_count += (CHUNK(pLayout, i)->pFile != NULL);
+        if (CHUNK(pLayout, i)->packed_size) {
+            pStats->compressed_chunk_count++;
+            pStats->compressed_bytes += CHUNK(pLayout, i)->packed_size;
+        }
     }
-    PRP_Result code = CONT_ArrCreateUnchecked(sizeof(ChunkView), min_cap,
-                                              &pGroup->pChunk_views);
-    if (code != PRP_OK) {
-        free(pGroup);
-        return code;
+    pStats->chunk_count = chunk_count;
+    pStats->slot_count = chunk_count * CHUNK_CAP;
+
+    PRP_Size sparse_maps_ofs = pLayout->shared_ofs + pLayout->shared_size;
+    PRP_Size columns_ofs = pLayout->double_ofs + pLayout->double_size * 2;
+    pStats->chunk_header_bytes = chunk_count * sizeof(FECS_Chunk);
+    pStats->tag_mask_bytes = chunk_count * pLayout->shared_ofs;
+    pStats->shared_bytes = chunk_count * pLayout->shared_size;
+    pStats->sparse_map_bytes =
+        chunk_count * (pLayout->double_ofs - sparse_maps_ofs);
+    pStats->double_buffer_bytes = chunk_count * pLayout->double_size * 2;
+    pStats->column_bytes =
+        chunk_count *
+        (pLayout->chunk_total_size - sizeof(FECS_Chunk) - columns_ofs);
+    pStats->compressed_raw_bytes =
+        pStats->compressed_chunk_count * COLUMNS_SIZE(pLayout);
+    pStats->column_bytes +=
+        pStats->compressed_bytes - pStats->compressed_raw_bytes;
+    if (pStats->compressed_bytes) {
+        pStats->compression_ratio = (PRP_F32)pStats->compressed_raw_bytes /
+                                    (PRP_F32)pStats->compressed_bytes;
     }
 
-    pGroup->layout_id = layout_id;
-    PRP_Size alloc_count = 0;
-    while (alloc_count != entity_count) {
-        PRP_Size free_chunk_idx = CONT_BitmapFFS(pLayout->pFree_chunk_bitset);
-        if (free_chunk_idx == PRP_INVALID_INDEX) {
-            code = CreateChunk(pLayout);
-            if (code != PRP_OK) {
-                goto err_path;
-            }
-            free_chunk_idx = CONT_BitmapFFS(pLayout->pFree_chunk_bitset);
-        }
-        FECS_Chunk *pChunk = CHUNK(pLayout, free_chunk_idx);
-
-        // This is correct since every free slot will now become occupied.
-        FECS_ChunkFreeSlotType occupied_slots_mask = pChunk->free_slot_bitset;
-        PRP_Size left = entity_count - alloc_count;
-        FECS_ChunkFreeSlotType pop =
-            (FECS_ChunkFreeSlotType)CONT_BitwordPopCnt(occupied_slots_mask);
-        for (; pop > left; pop--) {
-            occupied_slots_mask &= occupied_slots_mask - 1;
-        }
+    for (PRP_Size i = 0; i < pLayout->sparse_count; i++) {
+        const FECS_SparseSet *pSparse_set = &pLayout->pSparse_sets[i];
+        pStats->sparse_dense_bytes +=
+            CONT_ArrCap(pSparse_set->pDense) *
+                CONT_ArrMembSize(pSparse_set->pDense) +
+            CONT_ArrCap(pSparse_set->pDense_entity_idxs) *
+                CONT_ArrMembSize(pSparse_set->pDense_entity_idxs);
+    }
 
-        ChunkView view = {.chunk_idx = free_chunk_idx,
-                          .occupied_slots = occupied_slots_mask};
-        // Easier to copy the entire thing than parse it.
-        memcpy(view.gens, pChunk->gens, CHUNK_CAP * sizeof(PRP_U32));
+    PRP_Size comp_set_cap, free_chunk_cap, _;
+    CONT_BitmapRawUnchecked(pLayout->pComp_set, &comp_set_cap, &_);
+    CONT_BitmapRawUnchecked(pLayout->pFree_chunk_bitset, &free_chunk_cap, &_);
+    pStats->metadata_bytes =
+        (comp_set_cap + free_chunk_cap) * sizeof(CONT_Bitword) +
+        CONT_BitmapSetCount(pLayout->pComp_set) * sizeof(FECS_LayoutComp) +
+        (WORD_I(CONT_BitmapBitCap(pLayout->pComp_set)) + 1) *
+            sizeof(PRP_U16) +
+        ChunkDirMemoryBytes(&pLayout->chunk_dir) +
+        pLayout->shared_size +
+        (pLayout->pShared_heads
+             ? (pLayout->shared_bucket_count + 1) * sizeof(PRP_Size) +
+                   pLayout->shared_link_cap * sizeof(FECS_SharedLink)
+             : 0) +
+        pLayout->sparse_count * sizeof(FECS_SparseSet) +
+        (pLayout->pTemplate ? TEMPLATE_SIZE(pLayout) : 0) +
+        (pLayout->pPack_scratch ? COLUMNS_SIZE(pLayout) * 2 : 0) +
+        (pLayout->pRead_scratch ? COLUMNS_SIZE(pLayout) * 2 : 0);
+
+    pStats->total_bytes = pStats->chunk_header_bytes +
+                          pStats->tag_mask_bytes + pStats->shared_bytes +
+                          pStats->sparse_map_bytes +
+                          pStats->double_buffer_bytes + pStats->column_bytes +
+                          pStats->sparse_dense_bytes + pStats->metadata_bytes;
+}
 
-        code = CONT_ArrPushUnchecked(pGroup->pChunk_views, &view);
+PRP_Result LayoutSwapBuffers(FECS_Layout *pLayout) {
+    if (!pLayout->double_size) {
+        return PRP_OK;
+    }
+    // Swapping every frame is no access, the double block is never compressed.
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pLayout->chunk_dir); i++) {
+        PRP_Result code = ChunkUnshare(pLayout, i);
         if (code != PRP_OK) {
-            goto err_path;
-        }
-        alloc_count += CONT_BitwordPopCnt(occupied_slots_mask);
-        PRP_BIT_CLR(pChunk->free_slot_bitset, occupied_slots_mask);
-        if (!pChunk->free_slot_bitset) {
-            CONT_BitmapClrUnchecked(pLayout->pFree_chunk_bitset,
-                                    free_chunk_idx);
+            return code;
         }
+        PRP_U8 *pCurr = CHUNK(pLayout, i)->pChunk_mem + pLayout->double_ofs;
+        memcpy(pCurr + pLayout->double_size, pCurr, pLayout->double_size);
     }
-    *ppGroup = pGroup;
 
     return PRP_OK;
+}
 
-err_path:
+PRP_Result LayoutChunkMakeUnique(FECS_Layout *pLayout, PRP_Size chunk_idx) {
+    PRP_Result code = LayoutChunkAccess(pLayout, chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    return ChunkUnshare(pLayout, chunk_idx);
+}
+
+PRP_Result LayoutChunkAccess(FECS_Layout *pLayout, PRP_Size chunk_idx) {
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    atomic_store_explicit(&pChunk->access_frame, pLayout->frame,
+                          memory_order_relaxed);
+    if (!pChunk->packed_size) {
+        return PRP_OK;
+    }
+
+    return ChunkUnpack(pLayout, chunk_idx);
+}
+
+static PRP_Result ChunkUnshare(FECS_Layout *pLayout, PRP_Size chunk_idx) {
+    FECS_Chunk **ppChunk = &CHUNK(pLayout, chunk_idx);
+    FECS_Chunk *pShared = *ppChunk;
+    if (pShared->ref_count == 1) {
+        return PRP_OK;
+    }
+
+    // Compressed chunks live on the heap, they are copied as they are.
+    FECS_Chunk *pChunk;
+    PRP_Size size;
+    if (pShared->packed_size) {
+        size = sizeof(FECS_Chunk) + LAYOUT_COLUMNS_OFS(pLayout) +
+               pShared->packed_size;
+        pChunk = malloc(size);
+    } else {
+        size = pLayout->chunk_total_size;
+        pChunk = ChunkAlloc(pLayout);
+    }
+    if (!pChunk) {
+        return PRP_ERR_OOM;
+    }
+    memcpy(pChunk, pShared, size);
+    pChunk->ref_count = 1;
+    pChunk->pFile = pShared->packed_size ? NULL : pLayout->pChunk_file;
+    pShared->ref_count--;
+    *ppChunk = pChunk;
+
+    return PRP_OK;
+}
+
+PRP_Result LayoutResizeChunks(FECS_Layout *pLayout, PRP_Size chunk_count) {
+    while (CHUNK_DIR_LEN(&pLayout->chunk_dir) < chunk_count) {
+        PRP_Result code = CreateChunk(pLayout);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+    while (CHUNK_DIR_LEN(&pLayout->chunk_dir) > chunk_count) {
+        FECS_Chunk *pChunk = ChunkDirPop(&pLayout->chunk_dir);
+        CONT_BitmapClrUnchecked(pLayout->pFree_chunk_bitset,
+                                CHUNK_DIR_LEN(&pLayout->chunk_dir));
+        ChunkRelease(pChunk);
+    }
+    // The caller rewrites the chunks, keys included.
+    pLayout->is_shared_index_stale = PRP_True;
+
+    return PRP_OK;
+}
+
+PRP_Result LayoutSetDefault(FECS_Layout *pLayout, FECS_CompId comp_id,
+                            const void *pData) {
+    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id) ||
+        !COMP_HAS_COLUMN(comp_id)) {
+        return PRP_ERR_INV_ARG;
+    }
+    if (!pLayout->pTemplate) {
+        pLayout->pTemplate = calloc(1, TEMPLATE_SIZE(pLayout));
+        if (!pLayout->pTemplate) {
+            return PRP_ERR_OOM;
+        }
+    }
+
+    PRP_Size ofs =
+        (LayoutCompStride(pLayout, comp_id) - pLayout->double_ofs) / CHUNK_CAP;
+    memcpy(pLayout->pTemplate + ofs, pData, COMP_SIZE(comp_id));
+    if (COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_DOUBLE) {
+        memcpy(pLayout->pTemplate + ofs + pLayout->double_size / CHUNK_CAP,
+               pData, COMP_SIZE(comp_id));
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result LayoutSetBackingFile(FECS_Layout *pLayout,
+                                const PRP_Char8 *pFile_path) {
+    PRP_Result code;
+    if (pLayout->pChunk_file) {
+        // Resuming a move cut short by a failure, a chunk has to be left.
+        PRP_Size chunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir), i = 0;
+        while (i < chunk_count && CHUNK(pLayout, i)->pFile) {
+            i++;
+        }
+        if (i == chunk_count) {
+            return PRP_ERR_INV_STATE;
+        }
+    } else {
+        code = ChunkFileCreate(pFile_path, pLayout->chunk_total_size,
+                               &pLayout->pChunk_file);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    /*
+     * Chunks shared with forks are copied like LayoutChunkMakeUnique does,
+     * the forks keep the heap copy.
+     */
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pLayout->chunk_dir); i++) {
+        FECS_Chunk **ppChunk = &CHUNK(pLayout, i);
+        FECS_Chunk *pOld = *ppChunk;
+        if (pOld->pFile) {
+            continue;
+        }
+        // Decompressing allocates from the file already.
+        if (pOld->packed_size) {
+            code = ChunkUnpack(pLayout, i);
+            if (code != PRP_OK) {
+                return code;
+            }
+            continue;
+        }
+        FECS_Chunk *pChunk = ChunkFileAlloc(pLayout->pChunk_file);
+        if (!pChunk) {
+            return PRP_ERR_IO;
+        }
+        memcpy(pChunk, pOld, pLayout->chunk_total_size);
+        pChunk->ref_count = 1;
+        pChunk->pFile = pLayout->pChunk_file;
+        *ppChunk = pChunk;
+        ChunkRelease(pOld);
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result LayoutPageOut(FECS_Layout *pLayout) {
+    PRP_Result code = PRP_OK;
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pLayout->chunk_dir); i++) {
+        FECS_Chunk *pChunk = CHUNK(pLayout, i);
+        if (!pChunk->pFile) {
+            continue;
+        }
+        PRP_Result page_code = ChunkFilePageOut(pChunk);
+        if (page_code != PRP_OK) {
+            code = page_code;
+        }
+    }
+
+    return code;
+}
+
+/* ----  ENTITIES ---- */
+
+#define ENTITY_SLOT_MASK ((PRP_Size)63)
+#define ENTITY_SLOT_BITS (6)
+// Explicit encoding instead of just multiplying, to show intent.
+#define ENTITY_IDX(chunk_idx, slot_idx)                                        \
+    (((PRP_Size)(chunk_idx) << ENTITY_SLOT_BITS) |                             \
+     ((PRP_Size)(slot_idx) & ENTITY_SLOT_MASK))
+
+#define MAX_ENTITY_CAP(pLayout)                                                \
+    (CHUNK_DIR_LEN(&(pLayout)->chunk_dir) * CHUNK_CAP)
+
+#define CHUNK_TAG_MASKS(pChunk) ((FECS_ChunkFreeSlotType *)(pChunk)->pChunk_mem)
+
+/**
+ * A chunk view is data upon a chunk's entire free slots allocated at once.
+ */
+typedef struct ChunkView {
+    PRP_Size chunk_idx;
+    FECS_ChunkFreeSlotType occupied_slots;
+    PRP_U32 gens[CHUNK_CAP];
+} ChunkView;
+
+/**
+ * Finds a chunk with free slots for entities with the given shared comp key.
+ * Prefers a chunk already keyed with the same values, then an empty chunk that
+ * gets re-keyed, and creates a new chunk if neither exists. Keyed chunks are
+ * looked up in the shared index, only the chain of the key is compared.
+ *
+ * @param pLayout     Layout instance.
+ * @param pShared_key The shared comp key of the entities, NULL for zeroed
+ *                    shared comps.
+ * @param pChunk_idx  Output pointer to the idx of the chunk.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result AcquireFreeChunk(FECS_Layout *pLayout,
+                                   const PRP_U8 *pShared_key,
+                                   PRP_Size *pChunk_idx);
+/**
+ * Finds a chunk with every slot free, at or after the cursor, and keys it with
+ * the given shared comp key. Creates a new chunk once no such chunk is left.
+ *
+ * @param pLayout     Layout instance.
+ * @param pShared_key The shared comp key of the entities, must not be NULL if
+ *                    the layout has shared comps.
+ * @param pCursor     The chunk idx to resume the search from, advanced past
+ *                    the returned chunk. PRP_INVALID_INDEX once every empty
+ *                    chunk is taken, to skip straight to creating chunks.
+ * @param pChunk_idx  Output pointer to the idx of the chunk.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result AcquireEmptyChunk(FECS_Layout *pLayout,
+                                    const PRP_U8 *pShared_key,
+                                    PRP_Size *pCursor, PRP_Size *pChunk_idx);
+/**
+ * Occupies upto count free slots of a chunk for an entity group, recording
+ * them as a chunk view of the group.
+ *
+ * @param pLayout   The layout the chunk belongs to.
+ * @param pGroup    The group to add the slots to.
+ * @param chunk_idx The chunk to take slots of, must have a free slot.
+ * @param count     Max number of slots to take.
+ * @param pTaken    Output pointer to the number of slots taken.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, no slot is taken.
+ */
+static PRP_Result GroupTakeSlots(FECS_Layout *pLayout,
+                                 FECS_EntityGroupId *pGroup,
+                                 PRP_Size chunk_idx, PRP_Size count,
+                                 PRP_Size *pTaken);
+/**
+ * Fills the partially occupied chunks keyed with the given shared comp key
+ * with entities of a group, in a single pass over the free chunks, or over
+ * the chain of the key in the shared index.
+ *
+ * @param pLayout     The layout to spawn into.
+ * @param pGroup      The group to add the entities to.
+ * @param pShared_key The shared comp key of the entities, must not be NULL if
+ *                    the layout has shared comps.
+ * @param count       Max number of entities to place.
+ * @param pTaken      Output pointer to the number of entities placed.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result GroupFillPartialChunks(FECS_Layout *pLayout,
+                                         FECS_EntityGroupId *pGroup,
+                                         const PRP_U8 *pShared_key,
+                                         PRP_Size count, PRP_Size *pTaken);
+/**
+ * Swap removes the sparse comp value of a single entity from a sparse set.
+ *
+ * @param pLayout     The layout the sparse set belongs to.
+ * @param pSparse_set The sparse set to remove from.
+ * @param pMap        The chunk sparse map of the entity, its chunk must be
+ *                    unique.
+ * @param slot        The slot of the entity, must be present in pMap.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if copying the forked chunk of the moved value fails,
+ *                     nothing is removed.
+ */
+static PRP_Result SparseSetRemove(FECS_Layout *pLayout,
+                                  FECS_SparseSet *pSparse_set,
+                                  FECS_ChunkSparseMap *pMap, PRP_Size slot);
+/**
+ * Removes every sparse comp value of the given slots of a chunk.
+ *
+ * @param pLayout The layout the chunk belongs to.
+ * @param pChunk  The chunk to remove sparse comps of, must be unique.
+ * @param slots   The slots to remove.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if copying a forked chunk fails, the values removed
+ *                     till then stay removed.
+ */
+static PRP_Result ChunkRemoveSparse(FECS_Layout *pLayout, FECS_Chunk *pChunk,
+                                    FECS_ChunkFreeSlotType slots);
+/**
+ * Clears all the tags of the given slots of a chunk, so that newly spawned
+ * entities don't inherit tags of the previous occupant.
+ *
+ * @param pLayout The layout the chunk belongs to.
+ * @param pChunk  The chunk to clear tags of.
+ * @param slots   The slots to clear.
+ */
+static void ChunkClrTags(const FECS_Layout *pLayout, FECS_Chunk *pChunk,
+                         FECS_ChunkFreeSlotType slots);
+/**
+ * Copies the layout's default values into the given slots of a chunk, one
+ * column at a time. No-op for layouts without defaults.
+ *
+ * @param pLayout The layout the chunk belongs to.
+ * @param pChunk  The chunk to initialize the slots of, must be unique.
+ * @param slots   Mask of the slots to initialize.
+ */
+static void ChunkApplyTemplate(const FECS_Layout *pLayout, FECS_Chunk *pChunk,
+                               FECS_ChunkFreeSlotType slots);
+/**
+ * Checks if the chunk view of a entity group is valid.
+ *
+ * @param pVal       A chunk view from entity group.
+ * @param pUser_data The layout the entities/chunk_views belong to.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_STATE if the chunk view contains invlaid entities.
+ */
+static PRP_Result EntityGroupValidityCb(void *pVal, void *pUser_data);
+/**
+ * Kills entities of a chunk view of a entity group.
+ *
+ * @param pVal       A chunk view from entity batch.
+ * @param pUser_data The layout the entities/chunk_views belong to.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the chunk view contains invlaid entities.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+static PRP_Result EntityGroupKillCb(void *pVal, void *pUser_data);
+/**
+ * Iterates over entities of a chunk view of a entity group.
+ *
+ * @param pVal       A chunk view from entity batch.
+ * @param pUser_data The iteration data containing all the context.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the chunk view contains invlaid entities.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+static PRP_Result EntityGroupIterationCb(void *pVal, void *pUser_data);
+/**
+ * Sets/clears a tag for entities of a chunk view of a entity group.
+ *
+ * @param pVal       A chunk view from entity batch.
+ * @param pUser_data The tag data containing all the context.
+ *
+ * @return PRP_OK on success, the group is expected to be validated beforehand.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+static PRP_Result EntityGroupSetTagCb(void *pVal, void *pUser_data);
+/**
+ * Enables/disables entities of a chunk view of a entity group.
+ *
+ * @param pVal       A chunk view from entity batch.
+ * @param pUser_data The enabled data containing all the context.
+ *
+ * @return PRP_OK on success, the group is expected to be validated beforehand.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+static PRP_Result EntityGroupSetEnabledCb(void *pVal, void *pUser_data);
+
+static void ChunkClrTags(const FECS_Layout *pLayout, FECS_Chunk *pChunk,
+                         FECS_ChunkFreeSlotType slots) {
+    FECS_ChunkFreeSlotType *pTag_masks = CHUNK_TAG_MASKS(pChunk);
+    for (PRP_Size i = 0; i < pLayout->tag_count; i++) {
+        PRP_BIT_CLR(pTag_masks[i], slots);
+    }
+}
+
+static void ChunkApplyTemplate(const FECS_Layout *pLayout, FECS_Chunk *pChunk,
+                               FECS_ChunkFreeSlotType slots) {
+    if (!pLayout->pTemplate) {
+        return;
+    }
+
+    /*
+     * The template mirrors the column block slot for slot, so walking it
+     * comp by comp in stride order walks the columns. Runs of adjacent slots
+     * are filled by doubling, each copy sourcing from the values already
+     * placed.
+     */
+    PRP_Size cap, bit_cap;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pLayout->pComp_set, &cap, &bit_cap);
+    PRP_U8 *pColumns = pChunk->pChunk_mem + pLayout->double_ofs;
+    for (PRP_Size i = 0, j = 0; i < cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            word &= word - 1;
+            if (!COMP_HAS_COLUMN(comp_id)) {
+                continue;
+            }
+
+            PRP_Size size = COMP_SIZE(comp_id);
+            PRP_Size ofs = LayoutCompStride(pLayout, comp_id) -
+                           pLayout->double_ofs;
+            PRP_Size copies =
+                COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_DOUBLE ? 2 : 1;
+            for (PRP_Size k = 0; k < copies;
+                 k++, ofs += pLayout->double_size) {
+                PRP_U8 *pColumn = pColumns + ofs;
+                const PRP_U8 *pValue = pLayout->pTemplate + ofs / CHUNK_CAP;
+                FECS_ChunkFreeSlotType run_slots = slots;
+                while (run_slots) {
+                    PRP_Size start = CONT_BitwordCTZ(run_slots);
+                    FECS_ChunkFreeSlotType run = run_slots >> start;
+                    // Only a full chunk has no clear bit to stop at.
+                    PRP_Size len = ~run ? CONT_BitwordCTZ(~run) : CHUNK_CAP;
+                    PRP_U8 *pRun = pColumn + start * size;
+                    memcpy(pRun, pValue, size);
+                    for (PRP_Size filled = 1; filled < len;) {
+                        PRP_Size n = PRP_MIN(filled, len - filled);
+                        memcpy(pRun + filled * size, pRun, n * size);
+                        filled += n;
+                    }
+                    if (len == CHUNK_CAP) {
+                        break;
+                    }
+                    run_slots &= ~((((FECS_ChunkFreeSlotType)1 << len) - 1)
+                                   << start);
+                }
+            }
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
+}
+
+static PRP_Size SharedKeyBucket(const FECS_Layout *pLayout,
+                                const PRP_U8 *pKey) {
+    // FNV-1a, keys are a handful of values.
+    PRP_U64 hash = 0xCBF29CE484222325ull;
+    for (PRP_Size i = 0; i < pLayout->shared_size; i++) {
+        hash = (hash ^ pKey[i]) * 0x100000001B3ull;
+    }
+
+    return (PRP_Size)(hash ^ (hash >> 32)) &
+           (pLayout->shared_bucket_count - 1);
+}
+
+static PRP_Result SharedIndexGrow(FECS_Layout *pLayout, PRP_Size chunk_count) {
+    PRP_Size cap = PRP_MAX(pLayout->shared_link_cap, SHARED_INDEX_MIN_CAP);
+    while (cap < chunk_count) {
+        cap *= 2;
+    }
+    FECS_SharedLink *pLinks =
+        realloc(pLayout->pShared_links, sizeof(FECS_SharedLink) * cap);
+    if (!pLinks) {
+        return PRP_ERR_OOM;
+    }
+    pLayout->pShared_links = pLinks;
+    // A bucket per chunk, plus the empty chain.
+    PRP_Size *pHeads =
+        realloc(pLayout->pShared_heads, sizeof(PRP_Size) * (cap + 1));
+    if (!pHeads) {
+        return PRP_ERR_OOM;
+    }
+    pLayout->pShared_heads = pHeads;
+    pLayout->shared_link_cap = cap;
+    pLayout->shared_bucket_count = cap;
+    pLayout->is_shared_index_stale = PRP_True;
+
+    return PRP_OK;
+}
+
+static void SharedIndexMove(FECS_Layout *pLayout, PRP_Size chunk_idx,
+                            PRP_Size chain) {
+    FECS_SharedLink *pLinks = pLayout->pShared_links;
+    FECS_SharedLink *pLink = &pLinks[chunk_idx];
+    if (pLink->chain == chain) {
+        return;
+    }
+    if (pLink->chain != PRP_INVALID_INDEX) {
+        if (pLink->prev != PRP_INVALID_INDEX) {
+            pLinks[pLink->prev].next = pLink->next;
+        } else {
+            pLayout->pShared_heads[pLink->chain] = pLink->next;
+        }
+        if (pLink->next != PRP_INVALID_INDEX) {
+            pLinks[pLink->next].prev = pLink->prev;
+        }
+    }
+    pLink->chain = chain;
+    pLink->prev = PRP_INVALID_INDEX;
+    pLink->next = PRP_INVALID_INDEX;
+    if (chain != PRP_INVALID_INDEX) {
+        pLink->next = pLayout->pShared_heads[chain];
+        if (pLink->next != PRP_INVALID_INDEX) {
+            pLinks[pLink->next].prev = chunk_idx;
+        }
+        pLayout->pShared_heads[chain] = chunk_idx;
+    }
+}
+
+static void SharedIndexPlace(FECS_Layout *pLayout, PRP_Size chunk_idx) {
+    PRP_Size chain = PRP_INVALID_INDEX;
+    if (chunk_idx < CHUNK_DIR_LEN(&pLayout->chunk_dir) &&
+        CONT_BitmapIsSetUnchecked(pLayout->pFree_chunk_bitset, chunk_idx)) {
+        const FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+        chain = pChunk->free_slot_bitset == (FECS_ChunkFreeSlotType)(-1)
+                    ? SHARED_EMPTY_CHAIN(pLayout)
+                    : SharedKeyBucket(pLayout, pChunk->pChunk_mem +
+                                                   pLayout->shared_ofs);
+    }
+    SharedIndexMove(pLayout, chunk_idx, chain);
+}
+
+static PRP_Result SharedIndexRebuild(FECS_Layout *pLayout) {
+    PRP_Size chunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+    if (!pLayout->pShared_heads || chunk_count > pLayout->shared_link_cap) {
+        PRP_Result code = SharedIndexGrow(pLayout, chunk_count);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+    for (PRP_Size i = 0; i <= pLayout->shared_bucket_count; i++) {
+        pLayout->pShared_heads[i] = PRP_INVALID_INDEX;
+    }
+    for (PRP_Size i = 0; i < pLayout->shared_link_cap; i++) {
+        pLayout->pShared_links[i] = (FECS_SharedLink){
+            PRP_INVALID_INDEX, PRP_INVALID_INDEX, PRP_INVALID_INDEX};
+    }
+    pLayout->is_shared_index_stale = PRP_False;
+
+    PRP_Size cap, bit_cap;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pLayout->pFree_chunk_bitset, &cap, &bit_cap);
+    for (PRP_Size i = 0; i < cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size chunk_idx = CONT_BitwordFFS(word) + i * BITWORD_BITS;
+            if (chunk_idx >= chunk_count) {
+                break;
+            }
+            SharedIndexPlace(pLayout, chunk_idx);
+            word &= word - 1;
+        }
+    }
+
+    return PRP_OK;
+}
+
+static void LayoutMarkChunkFree(FECS_Layout *pLayout, PRP_Size chunk_idx) {
+    CONT_BitmapSetUnchecked(pLayout->pFree_chunk_bitset, chunk_idx);
+    if (pLayout->shared_size && !pLayout->is_shared_index_stale) {
+        SharedIndexPlace(pLayout, chunk_idx);
+    }
+}
+
+static PRP_Result AcquireFreeChunk(FECS_Layout *pLayout,
+                                   const PRP_U8 *pShared_key,
+                                   PRP_Size *pChunk_idx) {
+    PRP_Size free_chunk_idx;
+    if (!pLayout->shared_size) {
+        free_chunk_idx = CONT_BitmapFFS(pLayout->pFree_chunk_bitset);
+        if (free_chunk_idx == PRP_INVALID_INDEX) {
+            PRP_Result code = CreateChunk(pLayout);
+            if (code != PRP_OK) {
+                return code;
+            }
+            free_chunk_idx = CONT_BitmapFFS(pLayout->pFree_chunk_bitset);
+        }
+        *pChunk_idx = free_chunk_idx;
+
+        return LayoutChunkMakeUnique(pLayout, free_chunk_idx);
+    }
+
+    if (!pShared_key) {
+        memset(pLayout->pShared_key, 0, pLayout->shared_size);
+        pShared_key = pLayout->pShared_key;
+    }
+    PRP_Result code;
+    if (pLayout->is_shared_index_stale) {
+        code = SharedIndexRebuild(pLayout);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+    /*
+     * Chunks that filled up, emptied or got re-keyed since they were linked
+     * are placed where they belong as they are walked past.
+     */
+    PRP_Size bucket = SharedKeyBucket(pLayout, pShared_key);
+    free_chunk_idx = pLayout->pShared_heads[bucket];
+    while (free_chunk_idx != PRP_INVALID_INDEX) {
+        PRP_Size next_idx = pLayout->pShared_links[free_chunk_idx].next;
+        SharedIndexPlace(pLayout, free_chunk_idx);
+        if (pLayout->pShared_links[free_chunk_idx].chain == bucket &&
+            !memcmp(CHUNK(pLayout, free_chunk_idx)->pChunk_mem +
+                        pLayout->shared_ofs,
+                    pShared_key, pLayout->shared_size)) {
+            *pChunk_idx = free_chunk_idx;
+            return LayoutChunkMakeUnique(pLayout, free_chunk_idx);
+        }
+        free_chunk_idx = next_idx;
+    }
+
+    PRP_Size empty_chain = SHARED_EMPTY_CHAIN(pLayout);
+    PRP_Size empty_chunk_idx = pLayout->pShared_heads[empty_chain];
+    while (empty_chunk_idx != PRP_INVALID_INDEX) {
+        SharedIndexPlace(pLayout, empty_chunk_idx);
+        if (pLayout->pShared_links[empty_chunk_idx].chain == empty_chain) {
+            break;
+        }
+        empty_chunk_idx = pLayout->pShared_heads[empty_chain];
+    }
+    if (empty_chunk_idx == PRP_INVALID_INDEX) {
+        code = CreateChunk(pLayout);
+        if (code != PRP_OK) {
+            return code;
+        }
+        empty_chunk_idx = CHUNK_DIR_LEN(&pLayout->chunk_dir) - 1;
+        // Growing the index for the new chunk rehashes it.
+        if (pLayout->is_shared_index_stale) {
+            code = SharedIndexRebuild(pLayout);
+            if (code != PRP_OK) {
+                return code;
+            }
+        }
+    }
+    code = LayoutChunkMakeUnique(pLayout, empty_chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, empty_chunk_idx);
+    memcpy(pChunk->pChunk_mem + pLayout->shared_ofs, pShared_key,
+           pLayout->shared_size);
+    // Linked under its key right away, the caller takes a slot of it next.
+    SharedIndexMove(pLayout, empty_chunk_idx, bucket);
+    *pChunk_idx = empty_chunk_idx;
+
+    return PRP_OK;
+}
+
+static PRP_Result AcquireEmptyChunk(FECS_Layout *pLayout,
+                                    const PRP_U8 *pShared_key,
+                                    PRP_Size *pCursor, PRP_Size *pChunk_idx) {
+    PRP_Size empty_chunk_idx = PRP_INVALID_INDEX;
+    if (*pCursor != PRP_INVALID_INDEX) {
+        PRP_Size cap, bit_cap;
+        const CONT_Bitword *pBitwords = CONT_BitmapRawUnchecked(
+            pLayout->pFree_chunk_bitset, &cap, &bit_cap);
+        PRP_Size chunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+        // Bits below the cursor were already looked at.
+        CONT_Bitword below_cursor = BIT_MASK(*pCursor) - 1;
+        for (PRP_Size i = WORD_I(*pCursor);
+             i < cap && empty_chunk_idx == PRP_INVALID_INDEX; i++) {
+            CONT_Bitword word = pBitwords[i] & ~below_cursor;
+            below_cursor = 0;
+            while (word) {
+                PRP_Size chunk_idx = CONT_BitwordFFS(word) + i * BITWORD_BITS;
+                if (chunk_idx >= chunk_count) {
+                    break;
+                }
+                if (CHUNK(pLayout, chunk_idx)->free_slot_bitset ==
+                    (FECS_ChunkFreeSlotType)(-1)) {
+                    empty_chunk_idx = chunk_idx;
+                    break;
+                }
+                word &= word - 1;
+            }
+        }
+    }
+    if (empty_chunk_idx == PRP_INVALID_INDEX) {
+        // No empty chunk is left, so there is no point looking again.
+        *pCursor = PRP_INVALID_INDEX;
+        PRP_Result code = CreateChunk(pLayout);
+        if (code != PRP_OK) {
+            return code;
+        }
+        empty_chunk_idx = CHUNK_DIR_LEN(&pLayout->chunk_dir) - 1;
+    } else {
+        *pCursor = empty_chunk_idx + 1;
+        PRP_Result code = LayoutChunkMakeUnique(pLayout, empty_chunk_idx);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+    if (pLayout->shared_size) {
+        memcpy(CHUNK(pLayout, empty_chunk_idx)->pChunk_mem +
+                   pLayout->shared_ofs,
+               pShared_key, pLayout->shared_size);
+        if (!pLayout->is_shared_index_stale) {
+            SharedIndexMove(pLayout, empty_chunk_idx,
+                            SharedKeyBucket(pLayout, pShared_key));
+        }
+    }
+    *pChunk_idx = empty_chunk_idx;
+
+    return PRP_OK;
+}
+
+static PRP_Result GroupTakeSlots(FECS_Layout *pLayout,
+                                 FECS_EntityGroupId *pGroup,
+                                 PRP_Size chunk_idx, PRP_Size count,
+                                 PRP_Size *pTaken) {
+    PRP_Result code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+
+    // This is correct since every free slot will now become occupied.
+    FECS_ChunkFreeSlotType occupied_slots_mask = pChunk->free_slot_bitset;
+    PRP_Size pop = CONT_BitwordPopCnt(occupied_slots_mask);
+    for (; pop > count; pop--) {
+        occupied_slots_mask &= occupied_slots_mask - 1;
+    }
+
+    ChunkView view = {.chunk_idx = chunk_idx,
+                      .occupied_slots = occupied_slots_mask};
+    // Easier to copy the entire thing than parse it.
+    memcpy(view.gens, pChunk->gens, CHUNK_CAP * sizeof(PRP_U32));
+
+    code = CONT_ArrPushUnchecked(pGroup->pChunk_views, &view);
+    if (code != PRP_OK) {
+        return code;
+    }
+    PRP_BIT_CLR(pChunk->free_slot_bitset, occupied_slots_mask);
+    PRP_BIT_SET(pChunk->enabled_slot_bitset, occupied_slots_mask);
+    ChunkClrTags(pLayout, pChunk, occupied_slots_mask);
+    ChunkApplyTemplate(pLayout, pChunk, occupied_slots_mask);
+    if (!pChunk->free_slot_bitset) {
+        CONT_BitmapClrUnchecked(pLayout->pFree_chunk_bitset, chunk_idx);
+    }
+    *pTaken = pop;
+
+    return PRP_OK;
+}
+
+static PRP_Result GroupFillPartialChunks(FECS_Layout *pLayout,
+                                         FECS_EntityGroupId *pGroup,
+                                         const PRP_U8 *pShared_key,
+                                         PRP_Size count, PRP_Size *pTaken) {
+    *pTaken = 0;
+    if (pLayout->shared_size) {
+        if (pLayout->is_shared_index_stale) {
+            PRP_Result code = SharedIndexRebuild(pLayout);
+            if (code != PRP_OK) {
+                return code;
+            }
+        }
+        PRP_Size bucket = SharedKeyBucket(pLayout, pShared_key);
+        PRP_Size chunk_idx = pLayout->pShared_heads[bucket];
+        while (chunk_idx != PRP_INVALID_INDEX && *pTaken != count) {
+            PRP_Size next_idx = pLayout->pShared_links[chunk_idx].next;
+            SharedIndexPlace(pLayout, chunk_idx);
+            if (pLayout->pShared_links[chunk_idx].chain == bucket &&
+                !memcmp(CHUNK(pLayout, chunk_idx)->pChunk_mem +
+                            pLayout->shared_ofs,
+                        pShared_key, pLayout->shared_size)) {
+                PRP_Size taken;
+                PRP_Result code = GroupTakeSlots(pLayout, pGroup, chunk_idx,
+                                                 count - *pTaken, &taken);
+                if (code != PRP_OK) {
+                    return code;
+                }
+                *pTaken += taken;
+            }
+            chunk_idx = next_idx;
+        }
+
+        return PRP_OK;
+    }
+    PRP_Size cap, bit_cap;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pLayout->pFree_chunk_bitset, &cap, &bit_cap);
+    for (PRP_Size i = 0; i < cap && *pTaken != count; i++) {
+        // Local copy, taking slots may clear bits of this very word.
+        CONT_Bitword word = pBitwords[i];
+        while (word && *pTaken != count) {
+            PRP_Size chunk_idx = CONT_BitwordFFS(word) + i * BITWORD_BITS;
+            word &= word - 1;
+            if (CHUNK(pLayout, chunk_idx)->free_slot_bitset ==
+                (FECS_ChunkFreeSlotType)(-1)) {
+                continue;
+            }
+
+            PRP_Size taken;
+            PRP_Result code = GroupTakeSlots(pLayout, pGroup, chunk_idx,
+                                             count - *pTaken, &taken);
+            if (code != PRP_OK) {
+                return code;
+            }
+            *pTaken += taken;
+        }
+    }
+
+    return PRP_OK;
+}
+
+static PRP_Result SparseSetRemove(FECS_Layout *pLayout,
+                                  FECS_SparseSet *pSparse_set,
+                                  FECS_ChunkSparseMap *pMap, PRP_Size slot) {
+    PRP_Size dense_idx = pMap->dense_idxs[slot];
+    PRP_Size last_idx = CONT_ArrLen(pSparse_set->pDense) - 1;
+    if (dense_idx != last_idx) {
+        // Moving the last value into the hole and patching its map entry.
+        PRP_Size moved_entity_idx = *(PRP_Size *)CONT_ArrGetUnchecked(
+            pSparse_set->pDense_entity_idxs, last_idx);
+        PRP_Result code = LayoutChunkMakeUnique(
+            pLayout, moved_entity_idx >> ENTITY_SLOT_BITS);
+        if (code != PRP_OK) {
+            return code;
+        }
+        CONT_ArrSetUnchecked(pSparse_set->pDense, dense_idx,
+                             CONT_ArrGetUnchecked(pSparse_set->pDense,
+                                                  last_idx));
+        CONT_ArrSetUnchecked(pSparse_set->pDense_entity_idxs, dense_idx,
+                             &moved_entity_idx);
+        FECS_Chunk *pMoved_chunk =
+            CHUNK(pLayout, moved_entity_idx >> ENTITY_SLOT_BITS);
+        FECS_ChunkSparseMap *pMoved_map =
+            (FECS_ChunkSparseMap *)(pMoved_chunk->pChunk_mem +
+                                    pSparse_set->stride);
+        pMoved_map->dense_idxs[moved_entity_idx & ENTITY_SLOT_MASK] =
+            (PRP_U32)dense_idx;
+    }
+    CONT_ArrPopUnchecked(pSparse_set->pDense, NULL);
+    CONT_ArrPopUnchecked(pSparse_set->pDense_entity_idxs, NULL);
+    PRP_BIT_CLR(pMap->presence_bitset, BIT_MASK(slot));
+
+    return PRP_OK;
+}
+
+static PRP_Result ChunkRemoveSparse(FECS_Layout *pLayout, FECS_Chunk *pChunk,
+                                    FECS_ChunkFreeSlotType slots) {
+    for (PRP_Size i = 0; i < pLayout->sparse_count; i++) {
+        FECS_SparseSet *pSparse_set = &pLayout->pSparse_sets[i];
+        FECS_ChunkSparseMap *pMap =
+            (FECS_ChunkSparseMap *)(pChunk->pChunk_mem + pSparse_set->stride);
+        FECS_ChunkFreeSlotType mask = pMap->presence_bitset & slots;
+        while (mask) {
+            PRP_Result code = SparseSetRemove(pLayout, pSparse_set, pMap,
+                                              CONT_BitwordCTZ(mask));
+            if (code != PRP_OK) {
+                return code;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result EntitySpawn(FECS_World *pWorld, FECS_LayoutId layout_id,
+                       const PRP_U8 *pShared_key, FECS_EntityId *pEntity) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
+    PRP_Size free_chunk_idx;
+    PRP_Result code = AcquireFreeChunk(pLayout, pShared_key, &free_chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, free_chunk_idx);
+    FECS_ChunkFreeSlotType free_slot_idx =
+        (FECS_ChunkFreeSlotType)CONT_BitwordFFS(
+            (CONT_Bitword)pChunk->free_slot_bitset);
+    pEntity->layout_id = layout_id;
+    pEntity->gen = pChunk->gens[free_slot_idx];
+    pEntity->entity_idx = ENTITY_IDX(free_chunk_idx, free_slot_idx);
+    PRP_BIT_CLR(pChunk->free_slot_bitset, BIT_MASK(free_slot_idx));
+    PRP_BIT_SET(pChunk->enabled_slot_bitset, BIT_MASK(free_slot_idx));
+    ChunkClrTags(pLayout, pChunk, BIT_MASK(free_slot_idx));
+    ChunkApplyTemplate(pLayout, pChunk, BIT_MASK(free_slot_idx));
+    if (!pChunk->free_slot_bitset) {
+        CONT_BitmapClrUnchecked(pLayout->pFree_chunk_bitset, free_chunk_idx);
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result EntityGroupSpawn(FECS_World *pWorld, FECS_LayoutId layout_id,
+                            PRP_Size entity_count, const PRP_U8 *pShared_key,
+                            FECS_EntityGroupId **ppGroup) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
+
+    PRP_Size min_cap = (entity_count + CHUNK_CAP - 1) / CHUNK_CAP;
+    FECS_EntityGroupId *pGroup = malloc(sizeof(FECS_EntityGroupId));
+    if (!pGroup) {
+        return PRP_ERR_OOM;
+    }
+    PRP_Result code = CONT_ArrCreateUnchecked(sizeof(ChunkView), min_cap,
+                                              &pGroup->pChunk_views);
+    if (code != PRP_OK) {
+        free(pGroup);
+        return code;
+    }
+
+    pGroup->layout_id = layout_id;
+    if (pLayout->shared_size && !pShared_key) {
+        memset(pLayout->pShared_key, 0, pLayout->shared_size);
+        pShared_key = pLayout->pShared_key;
+    }
+
+    /*
+     * The bulk of the group goes into chunks of its own, either empty or
+     * fresh, so the group iterates densely and killing it frees whole chunks.
+     * Only the remainder shares chunks with other entities, filling the
+     * partially occupied ones first.
+     */
+    PRP_Size alloc_count = 0;
+    PRP_Size whole_chunk_count = entity_count / CHUNK_CAP;
+    PRP_Size cursor = 0;
+    for (PRP_Size i = 0; i < whole_chunk_count; i++) {
+        PRP_Size chunk_idx, taken;
+        code = AcquireEmptyChunk(pLayout, pShared_key, &cursor, &chunk_idx);
+        if (code != PRP_OK) {
+            goto err_path;
+        }
+        code = GroupTakeSlots(pLayout, pGroup, chunk_idx, CHUNK_CAP, &taken);
+        if (code != PRP_OK) {
+            goto err_path;
+        }
+        alloc_count += taken;
+    }
+    if (alloc_count != entity_count) {
+        PRP_Size taken;
+        code = GroupFillPartialChunks(pLayout, pGroup, pShared_key,
+                                      entity_count - alloc_count, &taken);
+        alloc_count += taken;
+        if (code != PRP_OK) {
+            goto err_path;
+        }
+    }
+    while (alloc_count != entity_count) {
+        PRP_Size chunk_idx, taken;
+        code = AcquireFreeChunk(pLayout, pShared_key, &chunk_idx);
+        if (code != PRP_OK) {
+            goto err_path;
+        }
+        code = GroupTakeSlots(pLayout, pGroup, chunk_idx,
+                              entity_count - alloc_count, &taken);
+        if (code != PRP_OK) {
+            goto err_path;
+        }
+        alloc_count += taken;
+    }
+    *ppGroup = pGroup;
+
+    return PRP_OK;
+
+err_path:
     if (alloc_count == 0) {
         CONT_ArrDeleteUnchecked(&pGroup->pChunk_views);
         free(pGroup);
         return code;
     }
-    PRP_LOG_WARN(PRP_LOG_DEFAULT_LOG_FILE,
-                 "Cannot create a batch of %zu entities, a batch "
-                 "with %zu entities is being created.",
-                 entity_count, alloc_count);
-    *ppGroup = pGroup;
+    PRP_LOG_WARN(PRP_LOG_DEFAULT_LOG_FILE,
+                 "Cannot create a batch of %zu entities, a batch "
+                 "with %zu entities is being created.",
+                 entity_count, alloc_count);
+    *ppGroup = pGroup;
+    return PRP_OK;
+}
+
+PRP_Bool EntityIsValid(FECS_World *pWorld, const FECS_EntityId entity) {
+    if (entity.layout_id >= pWorld->layout_count) {
+        return PRP_False;
+    }
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+
+    if (entity.entity_idx >= MAX_ENTITY_CAP(pLayout)) {
+        return PRP_False;
+    }
+    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    if (pChunk->gens[slot_idx] != entity.gen ||
+        PRP_BIT_IS_SET(pChunk->free_slot_bitset, BIT_MASK(slot_idx))) {
+        return PRP_False;
+    }
+
+    return PRP_True;
+}
+
+static PRP_Result EntityGroupValidityCb(void *pVal, void *pUser_data) {
+    ChunkView *pChunk_view = pVal;
+    FECS_Layout *pLayout = pUser_data;
+
+    if (pChunk_view->chunk_idx >= CHUNK_DIR_LEN(&pLayout->chunk_dir)) {
+        return PRP_ERR_INV_STATE;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, pChunk_view->chunk_idx);
+    FECS_ChunkFreeSlotType mask = pChunk_view->occupied_slots;
+    while (mask) {
+        FECS_ChunkFreeSlotType slot =
+            (FECS_ChunkFreeSlotType)CONT_BitwordCTZ(mask);
+        if (pChunk_view->gens[slot] != pChunk->gens[slot] ||
+            PRP_BIT_IS_SET(pChunk->free_slot_bitset, BIT_MASK(slot))) {
+            return PRP_ERR_INV_STATE;
+        }
+        mask &= mask - 1;
+    }
+
+    return PRP_OK;
+}
+
+PRP_Bool EntityGroupIsValid(FECS_World *pWorld,
+                            const FECS_EntityGroupId *pGroup) {
+    if (pGroup->layout_id >= pWorld->layout_count) {
+        return PRP_False;
+    }
+    FECS_Layout *pLayout = &pWorld->pLayouts[pGroup->layout_id];
+    PRP_Result code = CONT_ArrForEachUnchecked(pGroup->pChunk_views,
+                                               EntityGroupValidityCb, pLayout);
+
+    return code == PRP_OK;
+}
+
+PRP_Result EntityKill(FECS_World *pWorld, FECS_EntityId *pEntity) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[pEntity->layout_id];
+    PRP_Size chunk_idx = pEntity->entity_idx >> ENTITY_SLOT_BITS;
+    PRP_Result code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = pEntity->entity_idx & ENTITY_SLOT_MASK;
+
+    code = ChunkRemoveSparse(pLayout, pChunk, BIT_MASK(slot_idx));
+    if (code != PRP_OK) {
+        return code;
+    }
+    pChunk->gens[slot_idx]++;
+    PRP_BIT_SET(pChunk->free_slot_bitset, BIT_MASK(slot_idx));
+    LayoutMarkChunkFree(pLayout, chunk_idx);
+
+    pEntity->layout_id = PRP_INVALID_INDEX;
+    pEntity->entity_idx = PRP_INVALID_INDEX;
+
+    return PRP_OK;
+}
+
+static PRP_Result EntityGroupKillCb(void *pVal, void *pUser_data) {
+    ChunkView *pChunk_view = pVal;
+    FECS_Layout *pLayout = pUser_data;
+
+    if (pChunk_view->chunk_idx >= CHUNK_DIR_LEN(&pLayout->chunk_dir)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, pChunk_view->chunk_idx);
+    FECS_ChunkFreeSlotType slots = pChunk_view->occupied_slots;
+    // The whole view is validated first so a chunk is never half killed.
+    if (pChunk->free_slot_bitset & slots) {
+        return PRP_ERR_INV_ARG;
+    }
+    // Whole chunk views come from group spawns, validated in bulk.
+    PRP_Bool is_whole = slots == (FECS_ChunkFreeSlotType)(-1);
+    if (is_whole) {
+        if (memcmp(pChunk_view->gens, pChunk->gens,
+                   CHUNK_CAP * sizeof(PRP_U32))) {
+            return PRP_ERR_INV_ARG;
+        }
+    } else {
+        FECS_ChunkFreeSlotType mask = slots;
+        while (mask) {
+            PRP_Size slot = CONT_BitwordCTZ(mask);
+            if (pChunk_view->gens[slot] != pChunk->gens[slot]) {
+                return PRP_ERR_INV_ARG;
+            }
+            mask &= mask - 1;
+        }
+    }
+    PRP_Result code = LayoutChunkMakeUnique(pLayout, pChunk_view->chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    pChunk = CHUNK(pLayout, pChunk_view->chunk_idx);
+    code = ChunkRemoveSparse(pLayout, pChunk, slots);
+    if (code != PRP_OK) {
+        return code;
+    }
+    if (is_whole) {
+        for (PRP_Size i = 0; i < CHUNK_CAP; i++) {
+            pChunk->gens[i]++;
+        }
+    } else {
+        FECS_ChunkFreeSlotType mask = slots;
+        while (mask) {
+            pChunk->gens[CONT_BitwordCTZ(mask)]++;
+            mask &= mask - 1;
+        }
+    }
+    PRP_BIT_SET(pChunk->free_slot_bitset, slots);
+    LayoutMarkChunkFree(pLayout, pChunk_view->chunk_idx);
+
+    return PRP_OK;
+}
+
+PRP_Result EntityGroupKill(FECS_World *pWorld, FECS_EntityGroupId **ppGroup) {
+    FECS_EntityGroupId *pGroup = *ppGroup;
+    FECS_Layout *pLayout = &pWorld->pLayouts[pGroup->layout_id];
+    PRP_Result code = CONT_ArrForEachUnchecked(pGroup->pChunk_views,
+                                               EntityGroupKillCb, pLayout);
+    if (code != PRP_OK) {
+        return code;
+    }
+    CONT_ArrDeleteUnchecked(&pGroup->pChunk_views);
+    free(pGroup);
+    *ppGroup = NULL;
+
+    return PRP_OK;
+}
+
+PRP_Result EntityGroupFromMasks(FECS_World *pWorld, FECS_LayoutId layout_id,
+                                const FECS_ChunkFreeSlotType *pMasks,
+                                FECS_EntityGroupId **ppGroup) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
+    FECS_EntityGroupId *pGroup = malloc(sizeof(FECS_EntityGroupId));
+    if (!pGroup) {
+        return PRP_ERR_OOM;
+    }
+    PRP_Result code = CONT_ArrCreateUnchecked(
+        sizeof(ChunkView), CONT_ARR_DEFAULT_CAP, &pGroup->pChunk_views);
+    if (code != PRP_OK) {
+        free(pGroup);
+        return code;
+    }
+    pGroup->layout_id = layout_id;
+
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pLayout->chunk_dir); i++) {
+        const FECS_Chunk *pChunk = CHUNK(pLayout, i);
+        FECS_ChunkFreeSlotType slots = pMasks[i] & ~pChunk->free_slot_bitset;
+        if (!slots) {
+            continue;
+        }
+        ChunkView view = {.chunk_idx = i, .occupied_slots = slots};
+        memcpy(view.gens, pChunk->gens, CHUNK_CAP * sizeof(PRP_U32));
+        code = CONT_ArrPushUnchecked(pGroup->pChunk_views, &view);
+        if (code != PRP_OK) {
+            CONT_ArrDeleteUnchecked(&pGroup->pChunk_views);
+            free(pGroup);
+            return code;
+        }
+    }
+    *ppGroup = pGroup;
+
+    return PRP_OK;
+}
+
+PRP_Result EntityGetComp(FECS_World *pWorld, const FECS_EntityId entity,
+                         FECS_CompId comp_id, void **ppComp_ptr) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id) ||
+        COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_TAG) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    // Only read, so chunks shared with forks or compressed stay as they are.
+    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+    const FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    if (COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_SPARSE) {
+        FECS_SparseSet *pSparse_set = LayoutFindSparseSet(pLayout, comp_id);
+        if (!pSparse_set) {
+            return PRP_ERR_INV_ARG;
+        }
+        const FECS_ChunkSparseMap *pMap =
+            (const FECS_ChunkSparseMap *)(pChunk->pChunk_mem +
+                                          pSparse_set->stride);
+        if (!PRP_BIT_IS_SET(pMap->presence_bitset, BIT_MASK(slot_idx))) {
+            return PRP_ERR_NOT_FOUND;
+        }
+        *ppComp_ptr = CONT_ArrGetUnchecked(pSparse_set->pDense,
+                                           pMap->dense_idxs[slot_idx]);
+
+        return PRP_OK;
+    }
+    // Shared comps have a single value per chunk, so there is no slot offset.
+    PRP_Size comp_size = COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_SHARED
+                             ? 0
+                             : COMP_SIZE(comp_id);
+
+    // Sized for every plain column, as any of them may be read into it.
+    if (pChunk->packed_size && !pLayout->pRead_scratch) {
+        pLayout->pRead_scratch = malloc(COLUMNS_SIZE(pLayout) * 2);
+        if (!pLayout->pRead_scratch) {
+            return PRP_ERR_OOM;
+        }
+    }
+    const PRP_U8 *pData = LayoutChunkCompData(pLayout, chunk_idx, comp_id,
+                                              &pLayout->pRead_scratch);
+    *ppComp_ptr = (PRP_U8 *)pData + (slot_idx * comp_size);
+
+    return PRP_OK;
+}
+
+PRP_Result EntitySetComp(FECS_World *pWorld, FECS_EntityId entity,
+                         FECS_CompId comp_id, const void *pComp_data) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id) ||
+        !COMP_HAS_COLUMN(comp_id)) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+    PRP_Result code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    PRP_Size comp_size = COMP_SIZE(comp_id);
+
+    PRP_Size comp_stride = LayoutCompStride(pLayout, comp_id);
+
+    PRP_U8 *ptr =
+        (PRP_U8 *)pChunk->pChunk_mem + comp_stride + (slot_idx * comp_size);
+    memcpy(ptr, pComp_data, comp_size);
+
+    return PRP_OK;
+}
+
+// How many entities ahead of the copy a gather/scatter prefetches.
+#define GATHER_PREFETCH_DIST (8)
+
+/**
+ * Prefetches the chunk slot and the value of a component of an entity that
+ * is about to be gathered or scattered. Invalid entities are skipped, they
+ * are reported when reached.
+ *
+ * @param pWorld  World the entity belongs to.
+ * @param entity  The entity to prefetch.
+ * @param comp_id The component to prefetch.
+ */
+static void EntityCompPrefetch(FECS_World *pWorld, FECS_EntityId entity,
+                               FECS_CompId comp_id);
+
+static void EntityCompPrefetch(FECS_World *pWorld, FECS_EntityId entity,
+                               FECS_CompId comp_id) {
+    if (entity.layout_id >= pWorld->layout_count) {
+        return;
+    }
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    if (entity.entity_idx >= MAX_ENTITY_CAP(pLayout)) {
+        return;
+    }
+    const FECS_Chunk *pChunk =
+        CHUNK(pLayout, entity.entity_idx >> ENTITY_SLOT_BITS);
+    PRP_Size slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+    PRP_PREFETCH(&pChunk->gens[slot_idx]);
+    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id)) {
+        return;
+    }
+    switch (COMP_STORAGE(comp_id)) {
+    case FECS_COMP_STORAGE_COLUMN:
+    case FECS_COMP_STORAGE_DOUBLE:
+        // A column isn't there until the gather/scatter decompresses it.
+        if (COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_COLUMN &&
+            pChunk->packed_size) {
+            break;
+        }
+        PRP_PREFETCH(pChunk->pChunk_mem + LayoutCompStride(pLayout, comp_id) +
+                     slot_idx * COMP_SIZE(comp_id));
+        break;
+    case FECS_COMP_STORAGE_SHARED:
+        PRP_PREFETCH(pChunk->pChunk_mem + LayoutCompStride(pLayout, comp_id));
+        break;
+    case FECS_COMP_STORAGE_TAG:
+    case FECS_COMP_STORAGE_SPARSE:
+        break;
+    }
+}
+
+PRP_Result EntityGatherComp(FECS_World *pWorld, const FECS_EntityId *pEntities,
+                            PRP_Size count, FECS_CompId comp_id, void *pOut) {
+    FECS_CompStorage storage = COMP_STORAGE(comp_id);
+    if (storage == FECS_COMP_STORAGE_TAG) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Size comp_size = COMP_SIZE(comp_id);
+    // Shared comps have a single value per chunk, so there is no slot offset.
+    PRP_Size slot_size = storage == FECS_COMP_STORAGE_SHARED ? 0 : comp_size;
+
+    PRP_U8 *pDest = pOut;
+    FECS_LayoutId layout_id = PRP_INVALID_INDEX;
+    const FECS_Layout *pLayout = NULL;
+    FECS_SparseSet *pSparse_set = NULL;
+    // The comp data of the chunk of the previous entity.
+    PRP_Size data_chunk_idx = PRP_INVALID_INDEX;
+    const PRP_U8 *pData = NULL;
+    PRP_U8 *pScratch = NULL;
+    PRP_Result code = PRP_OK;
+    for (PRP_Size i = 0; i < count; i++, pDest += comp_size) {
+        if (i + GATHER_PREFETCH_DIST < count) {
+            EntityCompPrefetch(pWorld, pEntities[i + GATHER_PREFETCH_DIST],
+                               comp_id);
+        }
+        FECS_EntityId entity = pEntities[i];
+        if (!EntityIsValid(pWorld, entity)) {
+            code = PRP_ERR_INV_ARG;
+            break;
+        }
+        // Lists are mostly runs of one layout, resolve the comp once per run.
+        if (entity.layout_id != layout_id) {
+            layout_id = entity.layout_id;
+            pLayout = &pWorld->pLayouts[layout_id];
+            data_chunk_idx = PRP_INVALID_INDEX;
+            if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id)) {
+                code = PRP_ERR_INV_ARG;
+                break;
+            }
+            if (storage == FECS_COMP_STORAGE_SPARSE) {
+                pSparse_set = LayoutFindSparseSet(pLayout, comp_id);
+                if (!pSparse_set) {
+                    code = PRP_ERR_INV_ARG;
+                    break;
+                }
+            }
+        }
+        PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+        PRP_Size slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+        const void *pSrc;
+        if (pSparse_set) {
+            const FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+            const FECS_ChunkSparseMap *pMap =
+                (const FECS_ChunkSparseMap *)(pChunk->pChunk_mem +
+                                              pSparse_set->stride);
+            if (!PRP_BIT_IS_SET(pMap->presence_bitset, BIT_MASK(slot_idx))) {
+                code = PRP_ERR_NOT_FOUND;
+                break;
+            }
+            pSrc = CONT_ArrGetUnchecked(pSparse_set->pDense,
+                                        pMap->dense_idxs[slot_idx]);
+        } else {
+            // A compressed column is decompressed once per run of its chunk.
+            if (chunk_idx != data_chunk_idx) {
+                pData =
+                    LayoutChunkCompData(pLayout, chunk_idx, comp_id, &pScratch);
+                if (!pData) {
+                    code = PRP_ERR_OOM;
+                    break;
+                }
+                data_chunk_idx = chunk_idx;
+            }
+            pSrc = pData + slot_idx * slot_size;
+        }
+        memcpy(pDest, pSrc, comp_size);
+    }
+    free(pScratch);
+
+    return code;
+}
+
+PRP_Result EntityScatterComp(FECS_World *pWorld, const FECS_EntityId *pEntities,
+                             PRP_Size count, FECS_CompId comp_id,
+                             const void *pIn) {
+    if (!COMP_HAS_COLUMN(comp_id)) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    // Everything is validated up front, so a bad entity writes nothing.
+    FECS_LayoutId layout_id = PRP_INVALID_INDEX;
+    for (PRP_Size i = 0; i < count; i++) {
+        FECS_EntityId entity = pEntities[i];
+        if (!EntityIsValid(pWorld, entity)) {
+            return PRP_ERR_INV_ARG;
+        }
+        if (entity.layout_id != layout_id) {
+            layout_id = entity.layout_id;
+            if (!CONT_BitmapIsSetUnchecked(
+                    pWorld->pLayouts[layout_id].pComp_set, comp_id)) {
+                return PRP_ERR_INV_ARG;
+            }
+        }
+    }
+
+    PRP_Size comp_size = COMP_SIZE(comp_id);
+    const PRP_U8 *pSrc = pIn;
+    FECS_Layout *pLayout = NULL;
+    PRP_Size comp_stride = 0;
+    layout_id = PRP_INVALID_INDEX;
+    for (PRP_Size i = 0; i < count; i++, pSrc += comp_size) {
+        if (i + GATHER_PREFETCH_DIST < count) {
+            EntityCompPrefetch(pWorld, pEntities[i + GATHER_PREFETCH_DIST],
+                               comp_id);
+        }
+        FECS_EntityId entity = pEntities[i];
+        if (entity.layout_id != layout_id) {
+            layout_id = entity.layout_id;
+            pLayout = &pWorld->pLayouts[layout_id];
+            comp_stride = LayoutCompStride(pLayout, comp_id);
+        }
+        PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+        PRP_Result code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+        if (code != PRP_OK) {
+            return code;
+        }
+        PRP_Size slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+        memcpy(CHUNK(pLayout, chunk_idx)->pChunk_mem + comp_stride +
+                   slot_idx * comp_size,
+               pSrc, comp_size);
+    }
+
+    return PRP_OK;
+}
+
+typedef struct IterationData {
+    FECS_Layout *pLayout;
+    PRP_Size comp_size;
+    PRP_Size comp_stride;
+    PRP_Result (*cb)(void *pComp_data, void *pUser_data);
+    void *pUser_data;
+} IterationData;
+
+static PRP_Result EntityGroupIterationCb(void *pVal, void *pUser_data) {
+    ChunkView *pChunk_view = pVal;
+    IterationData *pI_data = pUser_data;
+
+    if (pChunk_view->chunk_idx >= CHUNK_DIR_LEN(&pI_data->pLayout->chunk_dir)) {
+        return PRP_ERR_INV_ARG;
+    }
+    // The callback gets writable comps.
+    PRP_Result code =
+        LayoutChunkMakeUnique(pI_data->pLayout, pChunk_view->chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pI_data->pLayout, pChunk_view->chunk_idx);
+    FECS_ChunkFreeSlotType mask = pChunk_view->occupied_slots;
+    while (mask) {
+        FECS_ChunkFreeSlotType slot =
+            (FECS_ChunkFreeSlotType)CONT_BitwordCTZ(mask);
+        if (pChunk_view->gens[slot] != pChunk->gens[slot] ||
+            PRP_BIT_IS_SET(pChunk->free_slot_bitset, BIT_MASK(slot))) {
+            if (mask != pChunk_view->occupied_slots) {
+                // We deleted not all entities but now chunk has free spot.
+                LayoutMarkChunkFree(pI_data->pLayout, pChunk_view->chunk_idx);
+            }
+            return PRP_ERR_INV_ARG;
+        }
+        mask &= mask - 1;
+
+        PRP_U8 *ptr = (PRP_U8 *)pChunk->pChunk_mem + pI_data->comp_stride +
+                      (slot * pI_data->comp_size);
+        code = pI_data->cb(ptr, pI_data->pUser_data);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result EntityGroupForEach(
+    FECS_World *pWorld, FECS_EntityGroupId *pGroup, FECS_CompId comp_id,
+    PRP_Result (*cb)(void *pComp_data, void *pUser_data), void *pUser_data) {
+    IterationData i_data = {.cb = cb, .pUser_data = pUser_data};
+    i_data.pLayout = &pWorld->pLayouts[pGroup->layout_id];
+    if (!CONT_BitmapIsSetUnchecked(i_data.pLayout->pComp_set, comp_id) ||
+        !COMP_HAS_COLUMN(comp_id)) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    i_data.comp_size = COMP_SIZE(comp_id);
+
+    i_data.comp_stride = LayoutCompStride(i_data.pLayout, comp_id);
+
+    return CONT_ArrForEachUnchecked(pGroup->pChunk_views,
+                                    EntityGroupIterationCb, &i_data);
+}
+
+PRP_Result EntityAddSparse(FECS_World *pWorld, FECS_EntityId entity,
+                           FECS_CompId comp_id, const void *pComp_data) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    FECS_SparseSet *pSparse_set = LayoutFindSparseSet(pLayout, comp_id);
+    if (!pSparse_set) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+    PRP_Result code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    FECS_ChunkSparseMap *pMap =
+        (FECS_ChunkSparseMap *)(pChunk->pChunk_mem + pSparse_set->stride);
+    if (PRP_BIT_IS_SET(pMap->presence_bitset, BIT_MASK(slot_idx))) {
+        CONT_ArrSetUnchecked(pSparse_set->pDense, pMap->dense_idxs[slot_idx],
+                             pComp_data);
+        return PRP_OK;
+    }
+
+    PRP_Size dense_idx = CONT_ArrLen(pSparse_set->pDense);
+    if (dense_idx >= PRP_U32_MAX) {
+        return PRP_ERR_RES_EXHAUSTED;
+    }
+    code = CONT_ArrPushUnchecked(pSparse_set->pDense, pComp_data);
+    if (code != PRP_OK) {
+        return code;
+    }
+    code = CONT_ArrPushUnchecked(pSparse_set->pDense_entity_idxs,
+                                 &entity.entity_idx);
+    if (code != PRP_OK) {
+        CONT_ArrPopUnchecked(pSparse_set->pDense, NULL);
+        return code;
+    }
+    pMap->dense_idxs[slot_idx] = (PRP_U32)dense_idx;
+    PRP_BIT_SET(pMap->presence_bitset, BIT_MASK(slot_idx));
+
+    return PRP_OK;
+}
+
+PRP_Result EntityRemoveSparse(FECS_World *pWorld, FECS_EntityId entity,
+                              FECS_CompId comp_id) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    FECS_SparseSet *pSparse_set = LayoutFindSparseSet(pLayout, comp_id);
+    if (!pSparse_set) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+    PRP_Result code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    FECS_ChunkSparseMap *pMap =
+        (FECS_ChunkSparseMap *)(pChunk->pChunk_mem + pSparse_set->stride);
+    if (PRP_BIT_IS_SET(pMap->presence_bitset, BIT_MASK(slot_idx))) {
+        code = SparseSetRemove(pLayout, pSparse_set, pMap, slot_idx);
+    }
+
+    return code;
+}
+
+PRP_Result EntitySetTag(FECS_World *pWorld, FECS_EntityId entity,
+                        FECS_CompId tag_id, PRP_Bool value) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, tag_id) ||
+        COMP_STORAGE(tag_id) != FECS_COMP_STORAGE_TAG) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+    PRP_Result code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    FECS_ChunkFreeSlotType *pTag_mask =
+        (FECS_ChunkFreeSlotType *)(pChunk->pChunk_mem +
+                                   LayoutCompStride(pLayout, tag_id));
+    if (value) {
+        PRP_BIT_SET(*pTag_mask, BIT_MASK(slot_idx));
+    } else {
+        PRP_BIT_CLR(*pTag_mask, BIT_MASK(slot_idx));
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result EntityHasTag(FECS_World *pWorld, const FECS_EntityId entity,
+                        FECS_CompId tag_id, PRP_Bool *pRslt) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, tag_id) ||
+        COMP_STORAGE(tag_id) != FECS_COMP_STORAGE_TAG) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    const FECS_ChunkFreeSlotType *pTag_mask =
+        (const FECS_ChunkFreeSlotType *)(pChunk->pChunk_mem +
+                                         LayoutCompStride(pLayout, tag_id));
+    *pRslt = PRP_BIT_IS_SET(*pTag_mask, BIT_MASK(slot_idx)) ? PRP_True
+                                                             : PRP_False;
+
+    return PRP_OK;
+}
+
+typedef struct TagData {
+    FECS_Layout *pLayout;
+    PRP_Size tag_stride;
+    PRP_Bool value;
+} TagData;
+
+static PRP_Result EntityGroupSetTagCb(void *pVal, void *pUser_data) {
+    ChunkView *pChunk_view = pVal;
+    TagData *pT_data = pUser_data;
+
+    // Group validity is checked once before iterating, so that a stale group
+    // doesn't get half of its tags set.
+    PRP_Result code =
+        LayoutChunkMakeUnique(pT_data->pLayout, pChunk_view->chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pT_data->pLayout, pChunk_view->chunk_idx);
+    FECS_ChunkFreeSlotType mask = pChunk_view->occupied_slots;
+    FECS_ChunkFreeSlotType *pTag_mask =
+        (FECS_ChunkFreeSlotType *)(pChunk->pChunk_mem + pT_data->tag_stride);
+    if (pT_data->value) {
+        PRP_BIT_SET(*pTag_mask, mask);
+    } else {
+        PRP_BIT_CLR(*pTag_mask, mask);
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result EntityGroupSetTag(FECS_World *pWorld, FECS_EntityGroupId *pGroup,
+                             FECS_CompId tag_id, PRP_Bool value) {
+    TagData t_data = {.value = value};
+    t_data.pLayout = &pWorld->pLayouts[pGroup->layout_id];
+    if (!CONT_BitmapIsSetUnchecked(t_data.pLayout->pComp_set, tag_id) ||
+        COMP_STORAGE(tag_id) != FECS_COMP_STORAGE_TAG) {
+        return PRP_ERR_INV_ARG;
+    }
+    if (!EntityGroupIsValid(pWorld, pGroup)) {
+        return PRP_ERR_INV_ARG;
+    }
+    t_data.tag_stride = LayoutCompStride(t_data.pLayout, tag_id);
+
+    return CONT_ArrForEachUnchecked(pGroup->pChunk_views, EntityGroupSetTagCb,
+                                    &t_data);
+}
+
+PRP_Result EntitySetEnabled(FECS_World *pWorld, FECS_EntityId entity,
+                            PRP_Bool value) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
+    PRP_Result code = LayoutChunkMakeUnique(pLayout, chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    if (value) {
+        PRP_BIT_SET(pChunk->enabled_slot_bitset, BIT_MASK(slot_idx));
+    } else {
+        PRP_BIT_CLR(pChunk->enabled_slot_bitset, BIT_MASK(slot_idx));
+    }
+
+    return PRP_OK;
+}
+
+PRP_Bool EntityIsEnabled(FECS_World *pWorld, const FECS_EntityId entity) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
+    FECS_Chunk *pChunk = CHUNK(pLayout, entity.entity_idx >> ENTITY_SLOT_BITS);
+    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+
+    return PRP_BIT_IS_SET(pChunk->enabled_slot_bitset, BIT_MASK(slot_idx))
+               ? PRP_True
+               : PRP_False;
+}
+
+typedef struct EnabledData {
+    FECS_Layout *pLayout;
+    PRP_Bool value;
+} EnabledData;
+
+static PRP_Result EntityGroupSetEnabledCb(void *pVal, void *pUser_data) {
+    ChunkView *pChunk_view = pVal;
+    EnabledData *pE_data = pUser_data;
+
+    PRP_Result code =
+        LayoutChunkMakeUnique(pE_data->pLayout, pChunk_view->chunk_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+    FECS_Chunk *pChunk = CHUNK(pE_data->pLayout, pChunk_view->chunk_idx);
+    if (pE_data->value) {
+        PRP_BIT_SET(pChunk->enabled_slot_bitset, pChunk_view->occupied_slots);
+    } else {
+        PRP_BIT_CLR(pChunk->enabled_slot_bitset, pChunk_view->occupied_slots);
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result EntityGroupSetEnabled(FECS_World *pWorld,
+                                 FECS_EntityGroupId *pGroup, PRP_Bool value) {
+    // Validated up front, so that a stale group doesn't get half toggled.
+    if (!EntityGroupIsValid(pWorld, pGroup)) {
+        return PRP_ERR_INV_ARG;
+    }
+    EnabledData e_data = {.pLayout = &pWorld->pLayouts[pGroup->layout_id],
+                          .value = value};
+
+    return CONT_ArrForEachUnchecked(pGroup->pChunk_views,
+                                    EntityGroupSetEnabledCb, &e_data);
+}
+
+/* ----  LAYOUT SORT ---- */
+
+#define SORT_RADIX_BITS (8)
+#define SORT_RADIX_SIZE ((PRP_Size)1 << SORT_RADIX_BITS)
+#define SORT_PASS_COUNT (sizeof(PRP_U64) * 8 / SORT_RADIX_BITS)
+
+// Offset of a FECS_Chunk::pChunk_mem stride from the start of the chunk.
+#define CHUNK_MEM_OFS(stride) (offsetof(FECS_Chunk, pChunk_mem) + (stride))
+#define CHUNK_MASK_AT(pChunk, ofs)                                             \
+    (*(FECS_ChunkFreeSlotType *)((PRP_U8 *)(pChunk) + (ofs)))
+
+/**
+ * Stable LSD radix sort of keys along with their values. Passes in which every
+ * key has the same digit are skipped.
+ *
+ * @param pKeys     The keys to sort, sorted in place.
+ * @param pVals     The values to reorder along with the keys.
+ * @param pKeys_tmp Scratch buffer of count keys.
+ * @param pVals_tmp Scratch buffer of count values.
+ * @param count     The number of keys.
+ */
+static void RadixSort(PRP_U64 *pKeys, PRP_Size *pVals, PRP_U64 *pKeys_tmp,
+                      PRP_Size *pVals_tmp, PRP_Size count);
+/**
+ * Moves a per slot array of every chunk so that the value of entity pSrcs[r]
+ * ends up in slot r of the layout, one column at a time.
+ *
+ * @param pChunk_dir The chunk directory of the layout.
+ * @param pSrcs      The old entity_idx of the entity for each new entity_idx.
+ * @param count      The number of alive entities.
+ * @param ofs        The offset of the array from the start of a chunk.
+ * @param size       The size of a single value in the array.
+ * @param pCol       Scratch buffer of count * size bytes.
+ */
+static void PermuteColumn(const FECS_ChunkDir *pChunk_dir,
+                          const PRP_Size *pSrcs, PRP_Size count, PRP_Size ofs,
+                          PRP_Size size, PRP_U8 *pCol);
+/**
+ * PermuteColumn for a slot mask of every chunk, bits past count are cleared.
+ *
+ * @param pChunk_dir  The chunk directory of the layout.
+ * @param chunk_count The number of chunks.
+ * @param pSrcs       The old entity_idx of the entity for each new entity_idx.
+ * @param count       The number of alive entities.
+ * @param ofs         The offset of the mask from the start of a chunk.
+ * @param pMasks      Scratch buffer of chunk_count masks.
+ */
+static void PermuteMask(const FECS_ChunkDir *pChunk_dir, PRP_Size chunk_count,
+                        const PRP_Size *pSrcs, PRP_Size count, PRP_Size ofs,
+                        FECS_ChunkFreeSlotType *pMasks);
+/**
+ * Permutes the sparse maps of a sparse comp and repoints its dense values to
+ * the new entity_idxs.
+ *
+ * @param pSparse_set The sparse set of the comp.
+ * @param pChunk_dir  The chunk directory of the layout.
+ * @param chunk_count The number of chunks.
+ * @param pSrcs       The old entity_idx of the entity for each new entity_idx.
+ * @param count       The number of alive entities.
+ * @param pMasks      Scratch buffer of chunk_count masks.
+ * @param pCol        Scratch buffer of count * sizeof(PRP_U32) bytes.
+ */
+static void PermuteSparse(FECS_SparseSet *pSparse_set,
+                          const FECS_ChunkDir *pChunk_dir, PRP_Size chunk_count,
+                          const PRP_Size *pSrcs, PRP_Size count,
+                          FECS_ChunkFreeSlotType *pMasks, PRP_U8 *pCol);
+
+static void RadixSort(PRP_U64 *pKeys, PRP_Size *pVals, PRP_U64 *pKeys_tmp,
+                      PRP_Size *pVals_tmp, PRP_Size count) {
+    PRP_Size hists[SORT_PASS_COUNT][SORT_RADIX_SIZE];
+    memset(hists, 0, sizeof(hists));
+    for (PRP_Size i = 0; i < count; i++) {
+        PRP_U64 key = pKeys[i];
+        for (PRP_Size p = 0; p < SORT_PASS_COUNT; p++) {
+            hists[p][(key >> (p * SORT_RADIX_BITS)) & (SORT_RADIX_SIZE - 1)]++;
+        }
+    }
+
+    PRP_U64 *pSrc_keys = pKeys, *pDst_keys = pKeys_tmp;
+    PRP_Size *pSrc_vals = pVals, *pDst_vals = pVals_tmp;
+    for (PRP_Size p = 0; p < SORT_PASS_COUNT; p++) {
+        PRP_Size shift = p * SORT_RADIX_BITS;
+        PRP_Size *pHist = hists[p];
+        // Every key has the same digit, the pass wouldn't move anything.
+        if (pHist[(pSrc_keys[0] >> shift) & (SORT_RADIX_SIZE - 1)] == count) {
+            continue;
+        }
+        PRP_Size ofs = 0;
+        for (PRP_Size d = 0; d < SORT_RADIX_SIZE; d++) {
+            PRP_Size digit_count = pHist[d];
+            pHist[d] = ofs;
+            ofs += digit_count;
+        }
+        for (PRP_Size i = 0; i < count; i++) {
+            PRP_Size pos =
+                pHist[(pSrc_keys[i] >> shift) & (SORT_RADIX_SIZE - 1)]++;
+            pDst_keys[pos] = pSrc_keys[i];
+            pDst_vals[pos] = pSrc_vals[i];
+        }
+
+        PRP_U64 *pKeys_swap = pSrc_keys;
+        pSrc_keys = pDst_keys;
+        pDst_keys = pKeys_swap;
+        PRP_Size *pVals_swap = pSrc_vals;
+        pSrc_vals = pDst_vals;
+        pDst_vals = pVals_swap;
+    }
+    if (pSrc_keys != pKeys) {
+        memcpy(pKeys, pSrc_keys, sizeof(PRP_U64) * count);
+        memcpy(pVals, pSrc_vals, sizeof(PRP_Size) * count);
+    }
+}
+
+static void PermuteColumn(const FECS_ChunkDir *pChunk_dir,
+                          const PRP_Size *pSrcs, PRP_Size count, PRP_Size ofs,
+                          PRP_Size size, PRP_U8 *pCol) {
+    for (PRP_Size r = 0; r < count; r++) {
+        PRP_Size src = pSrcs[r];
+        const FECS_Chunk *pSrc =
+            CHUNK_DIR_AT(pChunk_dir, src >> ENTITY_SLOT_BITS);
+        memcpy(pCol + r * size,
+               (const PRP_U8 *)pSrc + ofs + (src & ENTITY_SLOT_MASK) * size,
+               size);
+    }
+    // Destinations are dense, so each chunk is written with a single copy.
+    for (PRP_Size c = 0; c * CHUNK_CAP < count; c++) {
+        PRP_Size len = count - c * CHUNK_CAP;
+        if (len > CHUNK_CAP) {
+            len = CHUNK_CAP;
+        }
+        memcpy((PRP_U8 *)CHUNK_DIR_AT(pChunk_dir, c) + ofs,
+               pCol + c * CHUNK_CAP * size, len * size);
+    }
+}
+
+static void PermuteMask(const FECS_ChunkDir *pChunk_dir, PRP_Size chunk_count,
+                        const PRP_Size *pSrcs, PRP_Size count, PRP_Size ofs,
+                        FECS_ChunkFreeSlotType *pMasks) {
+    memset(pMasks, 0, sizeof(FECS_ChunkFreeSlotType) * chunk_count);
+    for (PRP_Size r = 0; r < count; r++) {
+        PRP_Size src = pSrcs[r];
+        FECS_Chunk *pSrc = CHUNK_DIR_AT(pChunk_dir, src >> ENTITY_SLOT_BITS);
+        FECS_ChunkFreeSlotType bit =
+            (CHUNK_MASK_AT(pSrc, ofs) >> (src & ENTITY_SLOT_MASK)) & 1;
+        pMasks[r >> ENTITY_SLOT_BITS] |= bit << (r & ENTITY_SLOT_MASK);
+    }
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        CHUNK_MASK_AT(CHUNK_DIR_AT(pChunk_dir, c), ofs) = pMasks[c];
+    }
+}
+
+static void PermuteSparse(FECS_SparseSet *pSparse_set,
+                          const FECS_ChunkDir *pChunk_dir, PRP_Size chunk_count,
+                          const PRP_Size *pSrcs, PRP_Size count,
+                          FECS_ChunkFreeSlotType *pMasks, PRP_U8 *pCol) {
+    PRP_Size map_ofs = CHUNK_MEM_OFS(pSparse_set->stride);
+    PermuteMask(pChunk_dir, chunk_count, pSrcs, count,
+                map_ofs + offsetof(FECS_ChunkSparseMap, presence_bitset),
+                pMasks);
+    PermuteColumn(pChunk_dir, pSrcs, count,
+                  map_ofs + offsetof(FECS_ChunkSparseMap, dense_idxs),
+                  sizeof(PRP_U32), pCol);
+
+    for (PRP_Size c = 0; c * CHUNK_CAP < count; c++) {
+        const PRP_U8 *pChunk = (const PRP_U8 *)CHUNK_DIR_AT(pChunk_dir, c);
+        const FECS_ChunkSparseMap *pMap =
+            (const FECS_ChunkSparseMap *)(pChunk + map_ofs);
+        FECS_ChunkFreeSlotType mask = pMap->presence_bitset;
+        while (mask) {
+            PRP_Size slot = CONT_BitwordCTZ(mask);
+            PRP_Size entity_idx = ENTITY_IDX(c, slot);
+            CONT_ArrSetUnchecked(pSparse_set->pDense_entity_idxs,
+                                 pMap->dense_idxs[slot], &entity_idx);
+            mask &= mask - 1;
+        }
+    }
+}
+
+PRP_Result LayoutSort(FECS_World *pWorld, FECS_LayoutId layout_id,
+                      FECS_CompId key_comp_id, FECS_LayoutSortKeyFunc key_fn,
+                      void *pUser_data, FECS_EntityRemap **ppRemap) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
+    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, key_comp_id) ||
+        !COMP_HAS_COLUMN(key_comp_id)) {
+        return PRP_ERR_INV_ARG;
+    }
+    if (pLayout->shared_size) {
+        return PRP_ERR_UNSUPPORTED;
+    }
+    // Repacking would hand the chunks reserved by contexts out again.
+    if (pLayout->spawn_ctx_count) {
+        return PRP_ERR_BUSY;
+    }
+
+    const FECS_ChunkDir *pChunk_dir = &pLayout->chunk_dir;
+    PRP_Size chunk_count = CHUNK_DIR_LEN(pChunk_dir);
+    PRP_Size slot_count = chunk_count * CHUNK_CAP;
+    PRP_Size count = 0;
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        count += CONT_BitwordPopCnt(
+            (CONT_Bitword)(~CHUNK_DIR_AT(pChunk_dir, c)->free_slot_bitset));
+    }
+    // Widest per slot value to be permuted, sizes the column scratch buffer.
+    PRP_Size max_size = sizeof(PRP_U32);
+    PRP_Size comp_set_cap, _;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pLayout->pComp_set, &comp_set_cap, &_);
+    for (PRP_Size i = 0, j = 0; i < comp_set_cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            if (COMP_HAS_COLUMN(comp_id) && COMP_SIZE(comp_id) > max_size) {
+                max_size = COMP_SIZE(comp_id);
+            }
+            word &= word - 1;
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
+
+    /*
+     * Everything is allocated up front so that running out of memory leaves
+     * the layout untouched. The +1s keep the sizes non zero for empty layouts.
+     */
+    PRP_Result code = PRP_OK;
+    FECS_EntityRemap *pRemap = NULL;
+    PRP_U64 *pKeys = malloc(sizeof(PRP_U64) * (count + 1));
+    PRP_U64 *pKeys_tmp = malloc(sizeof(PRP_U64) * (count + 1));
+    PRP_Size *pSrcs = malloc(sizeof(PRP_Size) * (count + 1));
+    PRP_Size *pSrcs_tmp = malloc(sizeof(PRP_Size) * (count + 1));
+    PRP_U32 *pNew_gens = malloc(sizeof(PRP_U32) * (slot_count + 1));
+    FECS_ChunkFreeSlotType *pMasks =
+        malloc(sizeof(FECS_ChunkFreeSlotType) * (chunk_count + 1));
+    PRP_U8 *pCol = malloc(max_size * (count + 1));
+    if (!pKeys || !pKeys_tmp || !pSrcs || !pSrcs_tmp || !pNew_gens ||
+        !pMasks || !pCol) {
+        code = PRP_ERR_OOM;
+        goto exit;
+    }
+    if (ppRemap) {
+        pRemap = malloc(sizeof(FECS_EntityRemap) +
+                        sizeof(FECS_EntityRemapEntry) * slot_count);
+        if (!pRemap) {
+            code = PRP_ERR_OOM;
+            goto exit;
+        }
+    }
+
+    // Every chunk gets rewritten, copies of forked chunks are still equal.
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        code = LayoutChunkMakeUnique(pLayout, c);
+        if (code != PRP_OK) {
+            goto exit;
+        }
+    }
+
+    PRP_Size key_stride = LayoutCompStride(pLayout, key_comp_id);
+    PRP_Size key_size = COMP_SIZE(key_comp_id);
+    for (PRP_Size c = 0, r = 0; c < chunk_count; c++) {
+        const FECS_Chunk *pChunk = CHUNK_DIR_AT(pChunk_dir, c);
+        FECS_ChunkFreeSlotType mask = ~pChunk->free_slot_bitset;
+        while (mask) {
+            PRP_Size slot = CONT_BitwordCTZ(mask);
+            pSrcs[r] = ENTITY_IDX(c, slot);
+            pKeys[r] = key_fn(pChunk->pChunk_mem + key_stride + slot * key_size,
+                              pUser_data);
+            r++;
+            mask &= mask - 1;
+        }
+    }
+    // Stable, so entities with equal keys keep their relative order.
+    RadixSort(pKeys, pSrcs, pKeys_tmp, pSrcs_tmp, count);
+
+    /*
+     * An entity that stays in its slot keeps its gen. Every other occupied
+     * slot gets its gen bumped, exactly like a kill, so that old ids into it
+     * go stale.
+     */
+    for (PRP_Size r = 0; r < slot_count; r++) {
+        const FECS_Chunk *pChunk =
+            CHUNK_DIR_AT(pChunk_dir, r >> ENTITY_SLOT_BITS);
+        PRP_Size slot = r & ENTITY_SLOT_MASK;
+        PRP_U32 gen = pChunk->gens[slot];
+        PRP_Bool was_occupied =
+            !PRP_BIT_IS_SET(pChunk->free_slot_bitset, BIT_MASK(slot));
+        pNew_gens[r] =
+            (r < count && pSrcs[r] == r) ? gen : gen + (PRP_U32)was_occupied;
+    }
+    if (pRemap) {
+        pRemap->layout_id = layout_id;
+        pRemap->new_layout_id = layout_id;
+        pRemap->entry_count = slot_count;
+        for (PRP_Size s = 0; s < slot_count; s++) {
+            pRemap->pEntries[s] = (FECS_EntityRemapEntry){
+                .old_gen = CHUNK_DIR_AT(pChunk_dir, s >> ENTITY_SLOT_BITS)
+                               ->gens[s & ENTITY_SLOT_MASK],
+                .new_entity_idx = PRP_INVALID_INDEX};
+        }
+        for (PRP_Size r = 0; r < count; r++) {
+            pRemap->pEntries[pSrcs[r]].new_entity_idx = r;
+            pRemap->pEntries[pSrcs[r]].new_gen = pNew_gens[r];
+        }
+    }
+
+    for (PRP_Size i = 0, j = 0; i < comp_set_cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            word &= word - 1;
+            PRP_Size ofs = CHUNK_MEM_OFS(LayoutCompStride(pLayout, comp_id));
+            switch (COMP_STORAGE(comp_id)) {
+            case FECS_COMP_STORAGE_DOUBLE:
+                PermuteColumn(pChunk_dir, pSrcs, count,
+                              ofs + pLayout->double_size, COMP_SIZE(comp_id),
+                              pCol);
+                PermuteColumn(pChunk_dir, pSrcs, count, ofs, COMP_SIZE(comp_id),
+                              pCol);
+                break;
+            case FECS_COMP_STORAGE_COLUMN:
+                PermuteColumn(pChunk_dir, pSrcs, count, ofs, COMP_SIZE(comp_id),
+                              pCol);
+                break;
+            case FECS_COMP_STORAGE_TAG:
+                PermuteMask(pChunk_dir, chunk_count, pSrcs, count, ofs, pMasks);
+                break;
+            case FECS_COMP_STORAGE_SPARSE: {
+                FECS_SparseSet *pSparse_set =
+                    LayoutFindSparseSet(pLayout, comp_id);
+                if (pSparse_set) {
+                    PermuteSparse(pSparse_set, pChunk_dir, chunk_count, pSrcs,
+                                  count, pMasks, pCol);
+                }
+                break;
+            }
+            case FECS_COMP_STORAGE_SHARED:
+                // Rejected above.
+                break;
+            }
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
+    PermuteMask(pChunk_dir, chunk_count, pSrcs, count,
+                offsetof(FECS_Chunk, enabled_slot_bitset), pMasks);
+
+    // Entities are now packed into the leading chunks.
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        FECS_Chunk *pChunk = CHUNK_DIR_AT(pChunk_dir, c);
+        memcpy(pChunk->gens, pNew_gens + c * CHUNK_CAP,
+               sizeof(PRP_U32) * CHUNK_CAP);
+        PRP_Size occupied =
+            count > c * CHUNK_CAP ? count - c * CHUNK_CAP : 0;
+        if (occupied >= CHUNK_CAP) {
+            pChunk->free_slot_bitset = 0;
+            CONT_BitmapClrUnchecked(pLayout->pFree_chunk_bitset, c);
+        } else {
+            pChunk->free_slot_bitset =
+                ~((FECS_ChunkFreeSlotType)BIT_MASK(occupied) - 1);
+            CONT_BitmapSetUnchecked(pLayout->pFree_chunk_bitset, c);
+        }
+    }
+    if (ppRemap) {
+        *ppRemap = pRemap;
+        pRemap = NULL;
+    }
+    goto exit;
+
+exit:
+    free(pKeys);
+    free(pKeys_tmp);
+    free(pSrcs);
+    free(pSrcs_tmp);
+    free(pNew_gens);
+    free(pMasks);
+    free(pCol);
+    free(pRemap);
+
+    return code;
+}
+
+PRP_Result EntityRemapApply(const FECS_EntityRemap *pRemap,
+                            FECS_EntityId *pEntity) {
+    if (pEntity->layout_id != pRemap->layout_id ||
+        pEntity->entity_idx >= pRemap->entry_count) {
+        return PRP_ERR_INV_ARG;
+    }
+    const FECS_EntityRemapEntry *pEntry =
+        &pRemap->pEntries[pEntity->entity_idx];
+    if (pEntry->new_entity_idx == PRP_INVALID_INDEX ||
+        pEntry->old_gen != pEntity->gen) {
+        return PRP_ERR_INV_ARG;
+    }
+    pEntity->layout_id = pRemap->new_layout_id;
+    pEntity->entity_idx = pEntry->new_entity_idx;
+    pEntity->gen = pEntry->new_gen;
+
+    return PRP_OK;
+}
+
+void EntityRemapDelete(FECS_EntityRemap **ppRemap) {
+    free(*ppRemap);
+    *ppRemap = NULL;
+}
+
+/* ----  LAYOUT MERGE ---- */
+
+#define CHUNK_IS_EMPTY(pChunk)                                                 \
+    ((pChunk)->free_slot_bitset == (FECS_ChunkFreeSlotType)(-1))
+
+/**
+ * Checks if a layout has a comp, comp ids past the layout's comp set are
+ * comps registered after its world was loaded.
+ *
+ * @param pLayout Layout instance.
+ * @param comp_id The comp to check.
+ *
+ * @return PRP_True if the layout has the comp.
+ */
+static PRP_Bool LayoutHasComp(const FECS_Layout *pLayout, FECS_CompId comp_id);
+/**
+ * Builds the shared comp key of the destination layout for the entities of a
+ * source chunk, inside the destination's key scratch buffer. Shared comps the
+ * source layout doesn't have are zero filled.
+ *
+ * @param pDst   The layout the key is for.
+ * @param pSrc   The layout the chunk belongs to.
+ * @param pChunk The source chunk.
+ *
+ * @return The built key, NULL if the destination has no shared comps.
+ */
+static const PRP_U8 *MergeBuildSharedKey(FECS_Layout *pDst,
+                                         const FECS_Layout *pSrc,
+                                         const FECS_Chunk *pChunk);
+/**
+ * Copies the entities of a source chunk into the same slots of an empty
+ * destination chunk, a whole column at a time. Comps only the destination has
+ * get its defaults, comps only the source has are dropped.
+ *
+ * @param pDst          The layout to copy into.
+ * @param dst_chunk_idx The empty chunk to copy into, must be unique and keyed.
+ * @param pSrc          The layout to copy from.
+ * @param src_chunk_idx The chunk to copy from.
+ * @param pRemap        The remap to record the new ids in.
+ */
+static void MergeCopyChunk(FECS_Layout *pDst, PRP_Size dst_chunk_idx,
+                           const FECS_Layout *pSrc, PRP_Size src_chunk_idx,
+                           FECS_EntityRemap *pRemap);
+/**
+ * Copies every entity of a layout into another one with a different comp set.
+ * Every chunk and sparse value needed is acquired before anything is copied.
+ *
+ * @param pDst   The layout to copy into.
+ * @param pSrc   The layout to copy from, left untouched.
+ * @param pRemap The remap to record the new ids in.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails, the destination may keep extra
+ *                     empty chunks.
+ */
+static PRP_Result MergeCopyChunks(FECS_Layout *pDst, const FECS_Layout *pSrc,
+                                  FECS_EntityRemap *pRemap);
+/**
+ * Hands every chunk with entities of a layout over to another one with the
+ * same comp set, by pointer. Only the sparse maps and sets are patched.
+ *
+ * @param pDst   The layout to move into.
+ * @param pSrc   The layout to move from, its chunk directory is left as is.
+ * @param pRemap The remap to record the new ids in.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails, nothing is moved.
+ */
+static PRP_Result MergeMoveChunks(FECS_Layout *pDst, FECS_Layout *pSrc,
+                                  FECS_EntityRemap *pRemap);
+
+static PRP_Bool LayoutHasComp(const FECS_Layout *pLayout, FECS_CompId comp_id) {
+    return comp_id < CONT_BitmapBitCap(pLayout->pComp_set) &&
+           CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id);
+}
+
+static const PRP_U8 *MergeBuildSharedKey(FECS_Layout *pDst,
+                                         const FECS_Layout *pSrc,
+                                         const FECS_Chunk *pChunk) {
+    if (!pDst->shared_size) {
+        return NULL;
+    }
+
+    memset(pDst->pShared_key, 0, pDst->shared_size);
+    PRP_Size cap, _;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pDst->pComp_set, &cap, &_);
+    for (PRP_Size i = 0, j = 0; i < cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            word &= word - 1;
+            if (COMP_STORAGE(comp_id) != FECS_COMP_STORAGE_SHARED ||
+                !LayoutHasComp(pSrc, comp_id)) {
+                continue;
+            }
+            memcpy(pDst->pShared_key +
+                       (LayoutCompStride(pDst, comp_id) - pDst->shared_ofs),
+                   pChunk->pChunk_mem + LayoutCompStride(pSrc, comp_id),
+                   COMP_SIZE(comp_id));
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
+
+    return pDst->pShared_key;
+}
+
+static void MergeCopyChunk(FECS_Layout *pDst, PRP_Size dst_chunk_idx,
+                           const FECS_Layout *pSrc, PRP_Size src_chunk_idx,
+                           FECS_EntityRemap *pRemap) {
+    FECS_Chunk *pDst_chunk = CHUNK(pDst, dst_chunk_idx);
+    const FECS_Chunk *pSrc_chunk = CHUNK(pSrc, src_chunk_idx);
+    FECS_ChunkFreeSlotType slots = ~pSrc_chunk->free_slot_bitset;
+
+    // Entities keep their slot, so every column is copied as a whole.
+    pDst_chunk->free_slot_bitset = pSrc_chunk->free_slot_bitset;
+    pDst_chunk->enabled_slot_bitset = pSrc_chunk->enabled_slot_bitset;
+    ChunkClrTags(pDst, pDst_chunk, slots);
+    ChunkApplyTemplate(pDst, pDst_chunk, slots);
+
+    PRP_Size cap, _;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pDst->pComp_set, &cap, &_);
+    for (PRP_Size i = 0, j = 0; i < cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            word &= word - 1;
+            if (!LayoutHasComp(pSrc, comp_id)) {
+                continue;
+            }
+
+            PRP_U8 *pDst_mem =
+                pDst_chunk->pChunk_mem + LayoutCompStride(pDst, comp_id);
+            const PRP_U8 *pSrc_mem =
+                pSrc_chunk->pChunk_mem + LayoutCompStride(pSrc, comp_id);
+            switch (COMP_STORAGE(comp_id)) {
+            case FECS_COMP_STORAGE_DOUBLE:
+                memcpy(pDst_mem + pDst->double_size,
+                       pSrc_mem + pSrc->double_size,
+                       CHUNK_CAP * COMP_SIZE(comp_id));
+                memcpy(pDst_mem, pSrc_mem, CHUNK_CAP * COMP_SIZE(comp_id));
+                break;
+            case FECS_COMP_STORAGE_COLUMN:
+                memcpy(pDst_mem, pSrc_mem, CHUNK_CAP * COMP_SIZE(comp_id));
+                break;
+            case FECS_COMP_STORAGE_TAG:
+                PRP_BIT_SET(*(FECS_ChunkFreeSlotType *)pDst_mem,
+                            *(const FECS_ChunkFreeSlotType *)pSrc_mem & slots);
+                break;
+            case FECS_COMP_STORAGE_SPARSE: {
+                FECS_SparseSet *pDst_set = LayoutFindSparseSet(pDst, comp_id);
+                const FECS_SparseSet *pSrc_set =
+                    LayoutFindSparseSet(pSrc, comp_id);
+                FECS_ChunkSparseMap *pDst_map = (FECS_ChunkSparseMap *)pDst_mem;
+                const FECS_ChunkSparseMap *pSrc_map =
+                    (const FECS_ChunkSparseMap *)pSrc_mem;
+                FECS_ChunkFreeSlotType mask = pSrc_map->presence_bitset & slots;
+                pDst_map->presence_bitset = mask;
+                while (mask) {
+                    PRP_Size slot = CONT_BitwordCTZ(mask);
+                    PRP_Size entity_idx = ENTITY_IDX(dst_chunk_idx, slot);
+                    pDst_map->dense_idxs[slot] =
+                        (PRP_U32)CONT_ArrLen(pDst_set->pDense);
+                    // Can't fail, the room was reserved.
+                    CONT_ArrPushUnchecked(
+                        pDst_set->pDense,
+                        CONT_ArrGetUnchecked(pSrc_set->pDense,
+                                             pSrc_map->dense_idxs[slot]));
+                    CONT_ArrPushUnchecked(pDst_set->pDense_entity_idxs,
+                                          &entity_idx);
+                    mask &= mask - 1;
+                }
+                break;
+            }
+            case FECS_COMP_STORAGE_SHARED:
+                // Part of the key the chunk was acquired with.
+                break;
+            }
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
+
+    FECS_ChunkFreeSlotType mask = slots;
+    while (mask) {
+        PRP_Size slot = CONT_BitwordCTZ(mask);
+        FECS_EntityRemapEntry *pEntry =
+            &pRemap->pEntries[ENTITY_IDX(src_chunk_idx, slot)];
+        pEntry->new_entity_idx = ENTITY_IDX(dst_chunk_idx, slot);
+        pEntry->new_gen = pDst_chunk->gens[slot];
+        mask &= mask - 1;
+    }
+    if (!pDst_chunk->free_slot_bitset) {
+        CONT_BitmapClrUnchecked(pDst->pFree_chunk_bitset, dst_chunk_idx);
+    }
+}
+
+static PRP_Result MergeCopyChunks(FECS_Layout *pDst, const FECS_Layout *pSrc,
+                                  FECS_EntityRemap *pRemap) {
+    PRP_Size chunk_count = CHUNK_DIR_LEN(&pSrc->chunk_dir);
+    PRP_Size *pDst_chunk_idxs = malloc(sizeof(PRP_Size) * (chunk_count + 1));
+    if (!pDst_chunk_idxs) {
+        return PRP_ERR_OOM;
+    }
+
+    PRP_Result code = PRP_OK;
+    PRP_Size cursor = 0;
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        const FECS_Chunk *pChunk = CHUNK(pSrc, c);
+        if (CHUNK_IS_EMPTY(pChunk)) {
+            continue;
+        }
+        code = AcquireEmptyChunk(pDst, MergeBuildSharedKey(pDst, pSrc, pChunk),
+                                 &cursor, &pDst_chunk_idxs[c]);
+        if (code != PRP_OK) {
+            goto exit;
+        }
+    }
+    for (PRP_Size i = 0; i < pDst->sparse_count; i++) {
+        FECS_SparseSet *pDst_set = &pDst->pSparse_sets[i];
+        const FECS_SparseSet *pSrc_set =
+            LayoutFindSparseSet(pSrc, pDst_set->comp_id);
+        PRP_Size len = pSrc_set ? CONT_ArrLen(pSrc_set->pDense) : 0;
+        if (!len) {
+            continue;
+        }
+        code = CONT_ArrReserveUnchecked(pDst_set->pDense, len);
+        if (code != PRP_OK) {
+            goto exit;
+        }
+        code = CONT_ArrReserveUnchecked(pDst_set->pDense_entity_idxs, len);
+        if (code != PRP_OK) {
+            goto exit;
+        }
+    }
+
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        if (!CHUNK_IS_EMPTY(CHUNK(pSrc, c))) {
+            MergeCopyChunk(pDst, pDst_chunk_idxs[c], pSrc, c, pRemap);
+        }
+    }
+    goto exit;
+
+exit:
+    free(pDst_chunk_idxs);
+
+    return code;
+}
+
+static PRP_Result MergeMoveChunks(FECS_Layout *pDst, FECS_Layout *pSrc,
+                                  FECS_EntityRemap *pRemap) {
+    PRP_Size chunk_count = CHUNK_DIR_LEN(&pSrc->chunk_dir);
+    PRP_Size move_count = 0;
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        move_count += !CHUNK_IS_EMPTY(CHUNK(pSrc, c));
+    }
+    if (!move_count) {
+        return PRP_OK;
+    }
+
+    // Room for everything is made first, so that the moves can't fail.
+    PRP_Result code = LayoutReserveChunks(pDst, move_count);
+    if (code != PRP_OK) {
+        return code;
+    }
+    for (PRP_Size i = 0; i < pDst->sparse_count; i++) {
+        PRP_Size len = CONT_ArrLen(pSrc->pSparse_sets[i].pDense);
+        if (!len) {
+            continue;
+        }
+        code = CONT_ArrReserveUnchecked(pDst->pSparse_sets[i].pDense, len);
+        if (code != PRP_OK) {
+            return code;
+        }
+        code = CONT_ArrReserveUnchecked(
+            pDst->pSparse_sets[i].pDense_entity_idxs, len);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+    // The sparse maps are patched in place, forked chunks are copied first.
+    for (PRP_Size c = 0; pDst->sparse_count && c < chunk_count; c++) {
+        if (CHUNK_IS_EMPTY(CHUNK(pSrc, c))) {
+            continue;
+        }
+        code = LayoutChunkMakeUnique(pSrc, c);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        FECS_Chunk *pChunk = CHUNK(pSrc, c);
+        if (CHUNK_IS_EMPTY(pChunk)) {
+            continue;
+        }
+        PRP_Size dst_chunk_idx = CHUNK_DIR_LEN(&pDst->chunk_dir);
+        // Can't fail, the room was reserved.
+        ChunkDirPush(&pDst->chunk_dir, pChunk);
+        atomic_store_explicit(&pChunk->access_frame, pDst->frame,
+                              memory_order_relaxed);
+        if (pChunk->free_slot_bitset) {
+            CONT_BitmapSetUnchecked(pDst->pFree_chunk_bitset, dst_chunk_idx);
+        } else {
+            CONT_BitmapClrUnchecked(pDst->pFree_chunk_bitset, dst_chunk_idx);
+        }
+
+        // The source values are appended after the destination's own.
+        for (PRP_Size i = 0; i < pDst->sparse_count; i++) {
+            PRP_U32 base = (PRP_U32)CONT_ArrLen(pDst->pSparse_sets[i].pDense);
+            FECS_ChunkSparseMap *pMap =
+                (FECS_ChunkSparseMap *)(pChunk->pChunk_mem +
+                                        pDst->pSparse_sets[i].stride);
+            FECS_ChunkFreeSlotType mask = pMap->presence_bitset;
+            while (mask) {
+                pMap->dense_idxs[CONT_BitwordCTZ(mask)] += base;
+                mask &= mask - 1;
+            }
+        }
+
+        FECS_ChunkFreeSlotType mask = ~pChunk->free_slot_bitset;
+        while (mask) {
+            PRP_Size slot = CONT_BitwordCTZ(mask);
+            FECS_EntityRemapEntry *pEntry =
+                &pRemap->pEntries[ENTITY_IDX(c, slot)];
+            pEntry->new_entity_idx = ENTITY_IDX(dst_chunk_idx, slot);
+            pEntry->new_gen = pChunk->gens[slot];
+            mask &= mask - 1;
+        }
+    }
+
+    for (PRP_Size i = 0; i < pDst->sparse_count; i++) {
+        FECS_SparseSet *pDst_set = &pDst->pSparse_sets[i];
+        const FECS_SparseSet *pSrc_set = &pSrc->pSparse_sets[i];
+        PRP_Size len = CONT_ArrLen(pSrc_set->pDense);
+        for (PRP_Size k = 0; k < len; k++) {
+            PRP_Size entity_idx = *(PRP_Size *)CONT_ArrGetUnchecked(
+                pSrc_set->pDense_entity_idxs, k);
+            entity_idx = pRemap->pEntries[entity_idx].new_entity_idx;
+            CONT_ArrPushUnchecked(pDst_set->pDense,
+                                  CONT_ArrGetUnchecked(pSrc_set->pDense, k));
+            CONT_ArrPushUnchecked(pDst_set->pDense_entity_idxs, &entity_idx);
+        }
+    }
+
     return PRP_OK;
 }
 
-PRP_Bool EntityIsValid(FECS_World *pWorld, const FECS_EntityId entity) {
-    if (entity.layout_id >= pWorld->layout_count) {
-        return PRP_False;
+PRP_Result LayoutMerge(FECS_World *pDst_world, FECS_LayoutId dst_layout_id,
+                       FECS_World *pSrc_world, FECS_LayoutId src_layout_id,
+                       FECS_EntityRemap **ppRemap) {
+    FECS_Layout *pDst = &pDst_world->pLayouts[dst_layout_id];
+    FECS_Layout *pSrc = &pSrc_world->pLayouts[src_layout_id];
+    // Source chunks are popped and destination chunks pushed under contexts.
+    if (pDst->spawn_ctx_count || pSrc->spawn_ctx_count) {
+        return PRP_ERR_BUSY;
     }
-    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
 
-    if (entity.entity_idx >= MAX_ENTITY_CAP(pLayout)) {
-        return PRP_False;
+    // Chunks are moved or read as is, neither works on compressed ones.
+    PRP_Result code = LayoutDecompressChunks(pSrc);
+    if (code != PRP_OK) {
+        return code;
+    }
+    PRP_Size slot_count = CHUNK_DIR_LEN(&pSrc->chunk_dir) * CHUNK_CAP;
+    FECS_EntityRemap *pRemap = malloc(
+        sizeof(FECS_EntityRemap) + sizeof(FECS_EntityRemapEntry) * slot_count);
+    if (!pRemap) {
+        return PRP_ERR_OOM;
+    }
+    pRemap->layout_id = src_layout_id;
+    pRemap->new_layout_id = dst_layout_id;
+    pRemap->entry_count = slot_count;
+    for (PRP_Size s = 0; s < slot_count; s++) {
+        pRemap->pEntries[s] = (FECS_EntityRemapEntry){
+            .old_gen =
+                CHUNK(pSrc, s >> ENTITY_SLOT_BITS)->gens[s & ENTITY_SLOT_MASK],
+            .new_entity_idx = PRP_INVALID_INDEX};
     }
-    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
-    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
-    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
 
-    if (pChunk->gens[slot_idx] != entity.gen ||
-        PRP_BIT_IS_SET(pChunk->free_slot_bitset, BIT_MASK(slot_idx))) {
-        return PRP_False;
+    /*
+     * Equal comp sets give equal chunk layouts, so chunks change hands as is.
+     * A destination with a backing file copies instead, every chunk it holds
+     * has to be mapped from the file.
+     */
+    PRP_Bool is_moved =
+        !pDst->pChunk_file &&
+        CONT_BitmapHasAllUnchecked(pDst->pComp_set, pSrc->pComp_set) &&
+        CONT_BitmapHasAllUnchecked(pSrc->pComp_set, pDst->pComp_set);
+    code = is_moved ? MergeMoveChunks(pDst, pSrc, pRemap)
+                    : MergeCopyChunks(pDst, pSrc, pRemap);
+    if (code != PRP_OK) {
+        free(pRemap);
+        return code;
+    }
+
+    // Moved chunks now belong to the destination, the rest are released.
+    while (CHUNK_DIR_LEN(&pSrc->chunk_dir)) {
+        FECS_Chunk *pChunk = ChunkDirPop(&pSrc->chunk_dir);
+        CONT_BitmapClrUnchecked(pSrc->pFree_chunk_bitset,
+                                CHUNK_DIR_LEN(&pSrc->chunk_dir));
+        if (!is_moved || CHUNK_IS_EMPTY(pChunk)) {
+            ChunkRelease(pChunk);
+        }
+    }
+    for (PRP_Size i = 0; i < pSrc->sparse_count; i++) {
+        CONT_ArrResetUnchecked(pSrc->pSparse_sets[i].pDense);
+        CONT_ArrResetUnchecked(pSrc->pSparse_sets[i].pDense_entity_idxs);
+    }
+    pDst->is_shared_index_stale = PRP_True;
+    pSrc->is_shared_index_stale = PRP_True;
+
+    if (ppRemap) {
+        *ppRemap = pRemap;
+    } else {
+        free(pRemap);
+    }
+
+    return PRP_OK;
+}
+
+/* ----  FORKS ---- */
+
+/**
+ * Clones the mutable state of a layout or fork into a fork, taking a
+ * reference to every chunk.
+ *
+ * @param pChunk_dir         The chunk directory to clone.
+ * @param pFree_chunk_bitset The free chunk bitset to clone.
+ * @param sparse_count       The len of pSparse_sets.
+ * @param pSparse_sets       The sparse sets to clone the dense arrays of.
+ * @param pFork              Output pointer to the fork.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, no chunk is referenced.
+ */
+static PRP_Result ForkCapture(const FECS_ChunkDir *pChunk_dir,
+                              const CONT_Bitmap *pFree_chunk_bitset,
+                              PRP_Size sparse_count,
+                              const FECS_SparseSet *pSparse_sets,
+                              FECS_LayoutFork *pFork);
+/**
+ * Deletes the containers of a fork without releasing its chunk references,
+ * handles partially captured forks.
+ *
+ * @param pFork The fork to delete the containers of.
+ */
+static void ForkDeleteContainers(FECS_LayoutFork *pFork);
+
+static PRP_Result ForkCapture(const FECS_ChunkDir *pChunk_dir,
+                              const CONT_Bitmap *pFree_chunk_bitset,
+                              PRP_Size sparse_count,
+                              const FECS_SparseSet *pSparse_sets,
+                              FECS_LayoutFork *pFork) {
+    *pFork = (FECS_LayoutFork){0};
+
+    PRP_Result code = ChunkDirClone(pChunk_dir, &pFork->chunk_dir);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
+    code = CONT_BitmapCloneUnchecked(pFree_chunk_bitset,
+                                     &pFork->pFree_chunk_bitset);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
+    if (sparse_count) {
+        pFork->pSparse_sets = calloc(sparse_count, sizeof(FECS_SparseSet));
+        if (!pFork->pSparse_sets) {
+            code = PRP_ERR_OOM;
+            goto err_path;
+        }
+        pFork->sparse_count = sparse_count;
+    }
+    for (PRP_Size i = 0; i < sparse_count; i++) {
+        const FECS_SparseSet *pSrc = &pSparse_sets[i];
+        FECS_SparseSet *pDest = &pFork->pSparse_sets[i];
+        pDest->comp_id = pSrc->comp_id;
+        pDest->stride = pSrc->stride;
+        code = CONT_ArrCloneUnchecked(pSrc->pDense, &pDest->pDense);
+        if (code != PRP_OK) {
+            goto err_path;
+        }
+        code = CONT_ArrCloneUnchecked(pSrc->pDense_entity_idxs,
+                                      &pDest->pDense_entity_idxs);
+        if (code != PRP_OK) {
+            goto err_path;
+        }
+    }
+
+    // Referenced last, so that the err path has no refs to give back.
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pFork->chunk_dir); i++) {
+        CHUNK_DIR_AT(&pFork->chunk_dir, i)->ref_count++;
+    }
+
+    return PRP_OK;
+
+err_path:
+    ForkDeleteContainers(pFork);
+
+    return code;
+}
+
+static void ForkDeleteContainers(FECS_LayoutFork *pFork) {
+    ChunkDirDelete(&pFork->chunk_dir);
+    if (pFork->pFree_chunk_bitset) {
+        CONT_BitmapDeleteUnchecked(&pFork->pFree_chunk_bitset);
+    }
+    for (PRP_Size i = 0; i < pFork->sparse_count; i++) {
+        FECS_SparseSet *pSparse_set = &pFork->pSparse_sets[i];
+        if (pSparse_set->pDense) {
+            CONT_ArrDeleteUnchecked(&pSparse_set->pDense);
+        }
+        if (pSparse_set->pDense_entity_idxs) {
+            CONT_ArrDeleteUnchecked(&pSparse_set->pDense_entity_idxs);
+        }
+    }
+    free(pFork->pSparse_sets);
+    *pFork = (FECS_LayoutFork){0};
+}
+
+PRP_Result LayoutFork(const FECS_Layout *pLayout, FECS_LayoutFork *pFork) {
+    return ForkCapture(&pLayout->chunk_dir, pLayout->pFree_chunk_bitset,
+                       pLayout->sparse_count, pLayout->pSparse_sets, pFork);
+}
+
+PRP_Result LayoutForkClone(const FECS_LayoutFork *pSrc,
+                           FECS_LayoutFork *pDest) {
+    return ForkCapture(&pSrc->chunk_dir, pSrc->pFree_chunk_bitset,
+                       pSrc->sparse_count, pSrc->pSparse_sets, pDest);
+}
+
+void LayoutForkDelete(FECS_LayoutFork *pFork) {
+    ChunkDirRelease(&pFork->chunk_dir);
+    ForkDeleteContainers(pFork);
+}
+
+void LayoutRestore(FECS_Layout *pLayout, FECS_LayoutFork *pFork) {
+    ChunkDirRelease(&pLayout->chunk_dir);
+    CONT_BitmapDeleteUnchecked(&pLayout->pFree_chunk_bitset);
+    pLayout->chunk_dir = pFork->chunk_dir;
+    pLayout->pFree_chunk_bitset = pFork->pFree_chunk_bitset;
+    pLayout->is_shared_index_stale = PRP_True;
+
+    // Only the dense arrays move, the layout keeps its own sparse set array.
+    for (PRP_Size i = 0; i < pLayout->sparse_count; i++) {
+        FECS_SparseSet *pSparse_set = &pLayout->pSparse_sets[i];
+        CONT_ArrDeleteUnchecked(&pSparse_set->pDense);
+        CONT_ArrDeleteUnchecked(&pSparse_set->pDense_entity_idxs);
+        pSparse_set->pDense = pFork->pSparse_sets[i].pDense;
+        pSparse_set->pDense_entity_idxs =
+            pFork->pSparse_sets[i].pDense_entity_idxs;
+    }
+    free(pFork->pSparse_sets);
+    *pFork = (FECS_LayoutFork){0};
+}
+
+/* ----  SPAWN CONTEXTS ---- */
+
+PRP_Result SpawnCtxCreate(FECS_World *pWorld, FECS_LayoutId layout_id,
+                          PRP_Size entity_count, const PRP_U8 *pShared_key,
+                          FECS_SpawnCtx **ppSpawn_ctx) {
+    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
+    PRP_Size chunk_count = (entity_count + CHUNK_CAP - 1) / CHUNK_CAP;
+    FECS_SpawnCtx *pSpawn_ctx =
+        malloc(sizeof(FECS_SpawnCtx) + sizeof(PRP_Size) * chunk_count);
+    if (!pSpawn_ctx) {
+        return PRP_ERR_OOM;
+    }
+    pSpawn_ctx->pLayout = pLayout;
+    pSpawn_ctx->layout_id = layout_id;
+    pSpawn_ctx->chunk_cursor = 0;
+    pSpawn_ctx->chunk_count = 0;
+    pLayout->spawn_ctx_count++;
+
+    /*
+     * Clearing the free bit is what reserves a chunk, no other spawn looks at
+     * a chunk without it. Kills still set it back, so the layout must be left
+     * alone while the contexts are spawning. Reused chunks are made unique by
+     * AcquireEmptyChunk, new ones are unique to begin with.
+     */
+    PRP_Size cursor = 0;
+    for (PRP_Size i = 0; i < chunk_count; i++) {
+        PRP_Size chunk_idx;
+        PRP_Result code =
+            AcquireEmptyChunk(pLayout, pShared_key, &cursor, &chunk_idx);
+        if (code != PRP_OK) {
+            SpawnCtxDelete(&pSpawn_ctx);
+            return code;
+        }
+        CONT_BitmapClrUnchecked(pLayout->pFree_chunk_bitset, chunk_idx);
+        pSpawn_ctx->pChunk_idxs[pSpawn_ctx->chunk_count++] = chunk_idx;
+    }
+    *ppSpawn_ctx = pSpawn_ctx;
+
+    return PRP_OK;
+}
+
+PRP_Result SpawnCtxSpawn(FECS_SpawnCtx *pSpawn_ctx, FECS_EntityId *pEntity) {
+    FECS_Layout *pLayout = pSpawn_ctx->pLayout;
+    FECS_Chunk *pChunk = NULL;
+    for (; pSpawn_ctx->chunk_cursor < pSpawn_ctx->chunk_count;
+         pSpawn_ctx->chunk_cursor++) {
+        pChunk =
+            CHUNK(pLayout, pSpawn_ctx->pChunk_idxs[pSpawn_ctx->chunk_cursor]);
+        // Forks and compression are held off while the context lives.
+        PRP_DIAG_ASSERT(pChunk->ref_count == 1 && !pChunk->packed_size);
+        if (pChunk->free_slot_bitset) {
+            break;
+        }
+    }
+    if (pSpawn_ctx->chunk_cursor == pSpawn_ctx->chunk_count) {
+        return PRP_ERR_RES_EXHAUSTED;
     }
 
-    return PRP_True;
+    PRP_Size chunk_idx = pSpawn_ctx->pChunk_idxs[pSpawn_ctx->chunk_cursor];
+    PRP_Size free_slot_idx =
+        CONT_BitwordFFS((CONT_Bitword)pChunk->free_slot_bitset);
+    pEntity->layout_id = pSpawn_ctx->layout_id;
+    pEntity->gen = pChunk->gens[free_slot_idx];
+    pEntity->entity_idx = ENTITY_IDX(chunk_idx, free_slot_idx);
+    PRP_BIT_CLR(pChunk->free_slot_bitset, BIT_MASK(free_slot_idx));
+    PRP_BIT_SET(pChunk->enabled_slot_bitset, BIT_MASK(free_slot_idx));
+    ChunkClrTags(pLayout, pChunk, BIT_MASK(free_slot_idx));
+    ChunkApplyTemplate(pLayout, pChunk, BIT_MASK(free_slot_idx));
+
+    return PRP_OK;
+}
+
+void SpawnCtxDelete(FECS_SpawnCtx **ppSpawn_ctx) {
+    FECS_SpawnCtx *pSpawn_ctx = *ppSpawn_ctx;
+    FECS_Layout *pLayout = pSpawn_ctx->pLayout;
+
+    for (PRP_Size i = 0; i < pSpawn_ctx->chunk_count; i++) {
+        PRP_Size chunk_idx = pSpawn_ctx->pChunk_idxs[i];
+        if (CHUNK(pLayout, chunk_idx)->free_slot_bitset) {
+            LayoutMarkChunkFree(pLayout, chunk_idx);
+        }
+    }
+    pLayout->spawn_ctx_count--;
+    free(pSpawn_ctx);
+    *ppSpawn_ctx = NULL;
 }
 
-static PRP_Result EntityGroupValidityCb(void *pVal, void *pUser_data) {
-    ChunkView *pChunk_view = pVal;
-    FECS_Layout *pLayout = pUser_data;
+/* ----  CHUNK COMPRESSION ---- */
 
-    if (pChunk_view->chunk_idx >= CONT_ArrLen(pLayout->pChunk_ptrs)) {
-        return PRP_ERR_INV_STATE;
+#define PACK_HASH_BITS (10)
+// Shortest back reference, anything shorter costs more than the literals.
+#define PACK_MIN_MATCH (4)
+#define PACK_MAX_OFS (0xFFFF)
+// A len nibble of this value is continued in the bytes after the token.
+#define PACK_LEN_EXT (15)
+
+/**
+ * Appends the extension bytes of a len that didn't fit its token nibble.
+ *
+ * @param pDst The compressed block.
+ * @param out  The write position in pDst.
+ * @param len  The len the nibble was written for.
+ *
+ * @return The write position after the extension bytes.
+ */
+static PRP_Size PackLenExt(PRP_U8 *pDst, PRP_Size out, PRP_Size len);
+/**
+ * Appends a sequence, a run of literals optionally followed by a back
+ * reference.
+ *
+ * @param pDst      The compressed block.
+ * @param cap       The capacity of pDst.
+ * @param out       The write position in pDst.
+ * @param pLits     The literals.
+ * @param lit_len   The number of literals.
+ * @param ofs       The distance of the back reference, 0 for none.
+ * @param match_len The len of the back reference.
+ *
+ * @return The write position after the sequence, 0 if it doesn't fit.
+ */
+static PRP_Size PackSequence(PRP_U8 *pDst, PRP_Size cap, PRP_Size out,
+                             const PRP_U8 *pLits, PRP_Size lit_len,
+                             PRP_Size ofs, PRP_Size match_len);
+/**
+ * Compresses a block with a byte oriented LZ77 codec in the spirit of LZ4,
+ * every sequence is encoded as:
+ *
+ *     token: literal len << 4 | (match len - PACK_MIN_MATCH)
+ *     extension bytes of the literal len
+ *     literals
+ *     offset: 2 bytes, little endian
+ *     extension bytes of the match len
+ *
+ * The last sequence stops after its literals, the block size is known to the
+ * decoder.
+ *
+ * @param pSrc The block to compress.
+ * @param size The size of the block.
+ * @param pDst Output pointer to the compressed block.
+ * @param cap  The capacity of pDst.
+ *
+ * @return The compressed size, 0 if it doesn't fit in cap.
+ */
+static PRP_Size PackBlock(const PRP_U8 *pSrc, PRP_Size size, PRP_U8 *pDst,
+                          PRP_Size cap);
+/**
+ * Decompresses a block compressed by PackBlock.
+ *
+ * @param pSrc The compressed block.
+ * @param pDst Output pointer to the block.
+ * @param size The size of the block.
+ *
+ * @return The end of the compressed block in pSrc.
+ */
+static const PRP_U8 *UnpackBlock(const PRP_U8 *pSrc, PRP_U8 *pDst,
+                                 PRP_Size size);
+/**
+ * The number of plain column comps of a layout with an id below comp_id, which
+ * is also the position of the block of comp_id in a compressed chunk.
+ *
+ * @param pLayout Layout instance.
+ * @param comp_id The comp, PRP_SIZE_MAX for the number of plain columns.
+ *
+ * @return The rank of the column.
+ */
+static PRP_Size ColumnRank(const FECS_Layout *pLayout, PRP_Size comp_id);
+/**
+ * Decompresses the block of a column and puts its byte planes back together.
+ *
+ * @param pSrc      The compressed block.
+ * @param pPlanes   Scratch of comp_size * CHUNK_CAP bytes.
+ * @param pColumn   Output pointer to the column.
+ * @param comp_size The size of the comp of the column.
+ *
+ * @return The end of the compressed block in pSrc.
+ */
+static const PRP_U8 *UnpackColumn(const PRP_U8 *pSrc, PRP_U8 *pPlanes,
+                                  PRP_U8 *pColumn, PRP_Size comp_size);
+/**
+ * Decompresses the plain columns of a compressed chunk into another chunk,
+ * the bytes before them are copied as they are.
+ *
+ * @param pLayout Layout instance.
+ * @param pPacked The compressed chunk.
+ * @param pChunk  Output pointer to the chunk of chunk_total_size bytes, its
+ *                ref count and file are copied from pPacked.
+ * @param pPlanes Scratch of COLUMNS_SIZE(pLayout) bytes.
+ */
+static void ChunkUnpackInto(const FECS_Layout *pLayout,
+                            const FECS_Chunk *pPacked, FECS_Chunk *pChunk,
+                            PRP_U8 *pPlanes);
+/**
+ * Compresses the plain columns of a chunk, a column at a time. Each column is
+ * split into byte planes first, so that the bytes of similar values, e.g. the
+ * exponents of floats, end up next to each other.
+ * The compressed columns start with a table of the U32 offsets of every
+ * column's block, in comp id order, so that a column can be read alone.
+ *
+ * @param pLayout   Layout instance.
+ * @param chunk_idx The chunk, must not be compressed, shared or file mapped.
+ *
+ * @return PRP_OK on success, the chunk is left as is if it doesn't compress
+ *         to at most 7/8th of its columns.
+ * @return PRP_ERR_OOM if the compressed chunk can't be allocated.
+ */
+static PRP_Result ChunkPack(FECS_Layout *pLayout, PRP_Size chunk_idx);
+
+static PRP_Size PackLenExt(PRP_U8 *pDst, PRP_Size out, PRP_Size len) {
+    if (len < PACK_LEN_EXT) {
+        return out;
     }
-    FECS_Chunk *pChunk = CHUNK(pLayout, pChunk_view->chunk_idx);
-    FECS_ChunkFreeSlotType mask = pChunk_view->occupied_slots;
-    while (mask) {
-        FECS_ChunkFreeSlotType slot =
-            (FECS_ChunkFreeSlotType)CONT_BitwordCTZ(mask);
-        if (pChunk_view->gens[slot] != pChunk->gens[slot] ||
-            PRP_BIT_IS_SET(pChunk->free_slot_bitset, BIT_MASK(slot))) {
-            return PRP_ERR_INV_STATE;
-        }
-        mask &= mask - 1;
+    for (len -= PACK_LEN_EXT; len >= 0xFF; len -= 0xFF) {
+        pDst[out++] = 0xFF;
     }
+    pDst[out++] = (PRP_U8)len;
 
-    return PRP_OK;
+    return out;
 }
 
-PRP_Bool EntityGroupIsValid(FECS_World *pWorld,
-                            const FECS_EntityGroupId *pGroup) {
-    if (pGroup->layout_id >= pWorld->layout_count) {
-        return PRP_False;
+static PRP_Size PackSequence(PRP_U8 *pDst, PRP_Size cap, PRP_Size out,
+                             const PRP_U8 *pLits, PRP_Size lit_len,
+                             PRP_Size ofs, PRP_Size match_len) {
+    match_len = ofs ? match_len - PACK_MIN_MATCH : 0;
+    // Token, offset and both lens with their extension bytes, at worst.
+    PRP_Size worst =
+        1 + lit_len / 0xFF + 1 + lit_len + 2 + match_len / 0xFF + 1;
+    if (worst > cap - out) {
+        return 0;
     }
-    FECS_Layout *pLayout = &pWorld->pLayouts[pGroup->layout_id];
-    PRP_Result code = CONT_ArrForEachUnchecked(pGroup->pChunk_views,
-                                               EntityGroupValidityCb, pLayout);
 
-    return code == PRP_OK;
-}
+    pDst[out++] = (PRP_U8)(PRP_MIN(lit_len, PACK_LEN_EXT) << 4 |
+                           PRP_MIN(match_len, PACK_LEN_EXT));
+    out = PackLenExt(pDst, out, lit_len);
+    memcpy(pDst + out, pLits, lit_len);
+    out += lit_len;
+    if (!ofs) {
+        return out;
+    }
+    pDst[out++] = (PRP_U8)ofs;
+    pDst[out++] = (PRP_U8)(ofs >> 8);
 
-void EntityKill(FECS_World *pWorld, FECS_EntityId *pEntity) {
-    FECS_Layout *pLayout = &pWorld->pLayouts[pEntity->layout_id];
-    PRP_Size chunk_idx = pEntity->entity_idx >> ENTITY_SLOT_BITS;
-    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
-    PRP_U8 slot_idx = pEntity->entity_idx & ENTITY_SLOT_MASK;
+    return PackLenExt(pDst, out, match_len);
+}
 
-    pChunk->gens[slot_idx]++;
-    PRP_BIT_SET(pChunk->free_slot_bitset, BIT_MASK(slot_idx));
-    CONT_BitmapSetUnchecked(pLayout->pFree_chunk_bitset, chunk_idx);
+static PRP_Size PackBlock(const PRP_U8 *pSrc, PRP_Size size, PRP_U8 *pDst,
+                          PRP_Size cap) {
+    // Last position of each hashed 4 byte prefix, stale entries are harmless.
+    PRP_U32 table[1 << PACK_HASH_BITS] = {0};
+    PRP_Size out = 0;
+    PRP_Size anchor = 0;
+    PRP_Size i = 0;
+    while (i + PACK_MIN_MATCH <= size) {
+        PRP_U32 prefix;
+        memcpy(&prefix, pSrc + i, sizeof(prefix));
+        PRP_U32 hash = (prefix * 2654435761U) >> (32 - PACK_HASH_BITS);
+        PRP_Size cand = table[hash];
+        table[hash] = (PRP_U32)i;
+        if (cand >= i || i - cand > PACK_MAX_OFS ||
+            memcmp(pSrc + cand, pSrc + i, PACK_MIN_MATCH)) {
+            i++;
+            continue;
+        }
+        PRP_Size len = PACK_MIN_MATCH;
+        while (i + len < size && pSrc[cand + len] == pSrc[i + len]) {
+            len++;
+        }
+        out = PackSequence(pDst, cap, out, pSrc + anchor, i - anchor, i - cand,
+                           len);
+        if (!out) {
+            return 0;
+        }
+        i += len;
+        anchor = i;
+    }
+    if (anchor < size) {
+        out = PackSequence(pDst, cap, out, pSrc + anchor, size - anchor, 0, 0);
+    }
 
-    pEntity->layout_id = PRP_INVALID_INDEX;
-    pEntity->entity_idx = PRP_INVALID_INDEX;
+    return out;
 }
 
-static PRP_Result EntityGroupKillCb(void *pVal, void *pUser_data) {
-    ChunkView *pChunk_view = pVal;
-    FECS_Layout *pLayout = pUser_data;
+static const PRP_U8 *UnpackBlock(const PRP_U8 *pSrc, PRP_U8 *pDst,
+                                 PRP_Size size) {
+    PRP_Size out = 0;
+    while (out < size) {
+        PRP_U8 token = *pSrc++;
+        PRP_Size lit_len = (PRP_Size)(token >> 4);
+        if (lit_len == PACK_LEN_EXT) {
+            while (*pSrc == 0xFF) {
+                lit_len += *pSrc++;
+            }
+            lit_len += *pSrc++;
+        }
+        memcpy(pDst + out, pSrc, lit_len);
+        pSrc += lit_len;
+        out += lit_len;
+        if (out == size) {
+            break;
+        }
 
-    if (pChunk_view->chunk_idx >= CONT_ArrLen(pLayout->pChunk_ptrs)) {
-        return PRP_ERR_INV_ARG;
-    }
-    FECS_Chunk *pChunk = CHUNK(pLayout, pChunk_view->chunk_idx);
-    FECS_ChunkFreeSlotType mask = pChunk_view->occupied_slots;
-    while (mask) {
-        FECS_ChunkFreeSlotType slot =
-            (FECS_ChunkFreeSlotType)CONT_BitwordCTZ(mask);
-        if (pChunk_view->gens[slot] != pChunk->gens[slot] ||
-            PRP_BIT_IS_SET(pChunk->free_slot_bitset, BIT_MASK(slot))) {
-            if (mask != pChunk_view->occupied_slots) {
-                // We deleted not all entities but now chunk has free spot.
-                CONT_BitmapSetUnchecked(pLayout->pFree_chunk_bitset,
-                                        pChunk_view->chunk_idx);
+        PRP_Size ofs = (PRP_Size)pSrc[0] | (PRP_Size)pSrc[1] << 8;
+        pSrc += 2;
+        PRP_Size match_len = (PRP_Size)(token & 0xF);
+        if (match_len == PACK_LEN_EXT) {
+            while (*pSrc == 0xFF) {
+                match_len += *pSrc++;
             }
-            return PRP_ERR_INV_ARG;
+            match_len += *pSrc++;
+        }
+        match_len += PACK_MIN_MATCH;
+        // A byte at a time, the reference may overlap the bytes it writes.
+        for (PRP_Size end = out + match_len; out < end; out++) {
+            pDst[out] = pDst[out - ofs];
         }
-        mask &= mask - 1;
-        PRP_BIT_SET(pChunk->free_slot_bitset, BIT_MASK(slot));
-        pChunk->gens[slot]++;
     }
-    CONT_BitmapSetUnchecked(pLayout->pFree_chunk_bitset,
-                            pChunk_view->chunk_idx);
 
-    return PRP_OK;
+    return pSrc;
 }
 
-PRP_Result EntityGroupKill(FECS_World *pWorld, FECS_EntityGroupId **ppGroup) {
-    FECS_EntityGroupId *pGroup = *ppGroup;
-    FECS_Layout *pLayout = &pWorld->pLayouts[pGroup->layout_id];
-    PRP_Result code = CONT_ArrForEachUnchecked(pGroup->pChunk_views,
-                                               EntityGroupKillCb, pLayout);
-    if (code != PRP_OK) {
-        return code;
+static PRP_Size ColumnRank(const FECS_Layout *pLayout, PRP_Size comp_id) {
+    PRP_Size comp_set_cap, _;
+    const CONT_Bitword *pBitwords =
+        CONT_BitmapRawUnchecked(pLayout->pComp_set, &comp_set_cap, &_);
+    PRP_Size rank = 0;
+    for (PRP_Size i = 0, j = 0; i < comp_set_cap && j < comp_id; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size id = CONT_BitwordFFS(word) + j;
+            word &= word - 1;
+            if (id >= comp_id) {
+                break;
+            }
+            if (COMP_STORAGE(id) == FECS_COMP_STORAGE_COLUMN) {
+                rank++;
+            }
+        }
+        j += sizeof(CONT_Bitword) * 8;
     }
-    CONT_ArrDeleteUnchecked(&pGroup->pChunk_views);
-    free(pGroup);
-    *ppGroup = NULL;
 
-    return PRP_OK;
+    return rank;
 }
 
-PRP_Result EntityGetComp(FECS_World *pWorld, const FECS_EntityId entity,
-                         FECS_CompId comp_id, void **ppComp_ptr) {
-    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
-    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id)) {
-        return PRP_ERR_INV_ARG;
+static const PRP_U8 *UnpackColumn(const PRP_U8 *pSrc, PRP_U8 *pPlanes,
+                                  PRP_U8 *pColumn, PRP_Size comp_size) {
+    pSrc = UnpackBlock(pSrc, pPlanes, comp_size * CHUNK_CAP);
+    for (PRP_Size b = 0; b < comp_size; b++) {
+        for (PRP_Size s = 0; s < CHUNK_CAP; s++) {
+            pColumn[s * comp_size + b] = pPlanes[b * CHUNK_CAP + s];
+        }
     }
 
-    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
-    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
-    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
+    return pSrc;
+}
 
-    PRP_Size comp_size =
-        (*(PRP_Size *)CONT_ArrGetUnchecked(g_ctx->pComp_sizes, comp_id));
+static PRP_Result ChunkPack(FECS_Layout *pLayout, PRP_Size chunk_idx) {
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    PRP_Size columns_ofs = LAYOUT_COLUMNS_OFS(pLayout);
+    PRP_Size columns_size = COLUMNS_SIZE(pLayout);
+    PRP_U8 *pPlanes = pLayout->pPack_scratch;
+    PRP_U8 *pPacked_columns = pPlanes + columns_size;
+    // Not worth the decompression otherwise.
+    PRP_Size cap = columns_size / 8 * 7;
+    PRP_Size table_size = sizeof(PRP_U32) * ColumnRank(pLayout, PRP_SIZE_MAX);
+    if (table_size >= cap) {
+        return PRP_OK;
+    }
 
-    PRP_Size _;
+    PRP_Size packed_size = table_size;
+    PRP_Size rank = 0;
+    PRP_Size comp_set_cap, _;
     const CONT_Bitword *pBitwords =
-        CONT_BitmapRawUnchecked(pLayout->pComp_set, &_, &_);
-    PRP_Size word_i = WORD_I(comp_id);
-    PRP_Size prefix_popcnt = pLayout->pWord_prefix_popcnts[word_i];
-    PRP_U16 rank_in_word = (PRP_U16)CONT_BitwordPopCnt(pBitwords[word_i] &
-                                                       (BIT_MASK(comp_id) - 1));
-    PRP_Size comp_stride =
-        pLayout->pComp_arr_strides[prefix_popcnt + rank_in_word];
+        CONT_BitmapRawUnchecked(pLayout->pComp_set, &comp_set_cap, &_);
+    // Plain columns are laid out back to back in comp id order.
+    PRP_Size ofs = 0;
+    for (PRP_Size i = 0, j = 0; i < comp_set_cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            word &= word - 1;
+            if (COMP_STORAGE(comp_id) != FECS_COMP_STORAGE_COLUMN) {
+                continue;
+            }
+            PRP_Size comp_size = COMP_SIZE(comp_id);
+            const PRP_U8 *pColumn = pChunk->pChunk_mem + columns_ofs + ofs;
+            PRP_U8 *pPlane = pPlanes + ofs;
+            for (PRP_Size b = 0; b < comp_size; b++) {
+                for (PRP_Size s = 0; s < CHUNK_CAP; s++) {
+                    pPlane[b * CHUNK_CAP + s] = pColumn[s * comp_size + b];
+                }
+            }
+            PRP_Size size = PackBlock(pPlane, comp_size * CHUNK_CAP,
+                                      pPacked_columns + packed_size,
+                                      cap - packed_size);
+            if (!size) {
+                return PRP_OK;
+            }
+            PRP_U32 block_ofs = (PRP_U32)packed_size;
+            memcpy(pPacked_columns + sizeof(PRP_U32) * rank++, &block_ofs,
+                   sizeof(block_ofs));
+            packed_size += size;
+            ofs += comp_size * CHUNK_CAP;
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
 
-    *ppComp_ptr =
-        (PRP_U8 *)pChunk->pChunk_mem + comp_stride + (slot_idx * comp_size);
+    FECS_Chunk *pPacked =
+        malloc(sizeof(FECS_Chunk) + columns_ofs + packed_size);
+    if (!pPacked) {
+        return PRP_ERR_OOM;
+    }
+    memcpy(pPacked, pChunk, sizeof(FECS_Chunk) + columns_ofs);
+    memcpy(pPacked->pChunk_mem + columns_ofs, pPacked_columns, packed_size);
+    pPacked->packed_size = (PRP_U32)packed_size;
+    CHUNK(pLayout, chunk_idx) = pPacked;
+    free(pChunk);
 
     return PRP_OK;
 }
 
-PRP_Result EntitySetComp(FECS_World *pWorld, FECS_EntityId entity,
-                         FECS_CompId comp_id, const void *pComp_data) {
-    FECS_Layout *pLayout = &pWorld->pLayouts[entity.layout_id];
-    if (!CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id)) {
-        return PRP_ERR_INV_ARG;
-    }
-
-    PRP_Size chunk_idx = entity.entity_idx >> ENTITY_SLOT_BITS;
-    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
-    PRP_U8 slot_idx = entity.entity_idx & ENTITY_SLOT_MASK;
-
-    PRP_Size comp_size =
-        (*(PRP_Size *)CONT_ArrGetUnchecked(g_ctx->pComp_sizes, comp_id));
-
-    PRP_Size _;
+static void ChunkUnpackInto(const FECS_Layout *pLayout,
+                            const FECS_Chunk *pPacked, FECS_Chunk *pChunk,
+                            PRP_U8 *pPlanes) {
+    PRP_Size columns_ofs = LAYOUT_COLUMNS_OFS(pLayout);
+    memcpy(pChunk, pPacked, sizeof(FECS_Chunk) + columns_ofs);
+    pChunk->packed_size = 0;
+
+    // The blocks follow each other, the offset table isn't needed here.
+    const PRP_U8 *pSrc = pPacked->pChunk_mem + columns_ofs +
+                         sizeof(PRP_U32) * ColumnRank(pLayout, PRP_SIZE_MAX);
+    PRP_Size comp_set_cap, _;
     const CONT_Bitword *pBitwords =
-        CONT_BitmapRawUnchecked(pLayout->pComp_set, &_, &_);
-    PRP_Size word_i = WORD_I(comp_id);
-    PRP_Size prefix_popcnt = pLayout->pWord_prefix_popcnts[word_i];
-    PRP_U16 rank_in_word = (PRP_U16)CONT_BitwordPopCnt(pBitwords[word_i] &
-                                                       (BIT_MASK(comp_id) - 1));
-    PRP_Size comp_stride =
-        pLayout->pComp_arr_strides[prefix_popcnt + rank_in_word];
+        CONT_BitmapRawUnchecked(pLayout->pComp_set, &comp_set_cap, &_);
+    PRP_Size ofs = 0;
+    for (PRP_Size i = 0, j = 0; i < comp_set_cap; i++) {
+        CONT_Bitword word = pBitwords[i];
+        while (word) {
+            PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+            word &= word - 1;
+            if (COMP_STORAGE(comp_id) != FECS_COMP_STORAGE_COLUMN) {
+                continue;
+            }
+            PRP_Size comp_size = COMP_SIZE(comp_id);
+            pSrc = UnpackColumn(pSrc, pPlanes + ofs,
+                                pChunk->pChunk_mem + columns_ofs + ofs,
+                                comp_size);
+            ofs += comp_size * CHUNK_CAP;
+        }
+        j += sizeof(CONT_Bitword) * 8;
+    }
+}
 
-    PRP_U8 *ptr =
-        (PRP_U8 *)pChunk->pChunk_mem + comp_stride + (slot_idx * comp_size);
-    memcpy(ptr, pComp_data, comp_size);
+static PRP_Result ChunkUnpack(FECS_Layout *pLayout, PRP_Size chunk_idx) {
+    FECS_Chunk *pPacked = CHUNK(pLayout, chunk_idx);
+    // Chunks restored from a fork can outlive the compression of the layout.
+    PRP_U8 *pPlanes = pLayout->pPack_scratch;
+    PRP_U8 *pOwned_planes = NULL;
+    if (!pPlanes) {
+        pPlanes = pOwned_planes = malloc(COLUMNS_SIZE(pLayout));
+        if (!pPlanes) {
+            return PRP_ERR_OOM;
+        }
+    }
+    FECS_Chunk *pChunk = ChunkAlloc(pLayout);
+    if (!pChunk) {
+        free(pOwned_planes);
+        return PRP_ERR_OOM;
+    }
+    ChunkUnpackInto(pLayout, pPacked, pChunk, pPlanes);
+    free(pOwned_planes);
+    pChunk->ref_count = 1;
+    pChunk->pFile = pLayout->pChunk_file;
+    CHUNK(pLayout, chunk_idx) = pChunk;
+    // Forks may still hold the compressed chunk.
+    ChunkRelease(pPacked);
 
     return PRP_OK;
 }
 
-typedef struct IterationData {
-    FECS_Layout *pLayout;
-    PRP_Size comp_size;
-    PRP_Size comp_stride;
-    PRP_Result (*cb)(void *pComp_data, void *pUser_data);
-    void *pUser_data;
-} IterationData;
+const FECS_Chunk *LayoutChunkUnpacked(const FECS_Layout *pLayout,
+                                      const FECS_Chunk *pChunk,
+                                      FECS_Chunk **ppScratch) {
+    if (!pChunk->packed_size) {
+        return pChunk;
+    }
+    // The chunk followed by the planes ChunkUnpackInto needs.
+    if (!*ppScratch) {
+        *ppScratch = malloc(pLayout->chunk_total_size + COLUMNS_SIZE(pLayout));
+        if (!*ppScratch) {
+            return NULL;
+        }
+    }
+    ChunkUnpackInto(pLayout, pChunk, *ppScratch,
+                    (PRP_U8 *)*ppScratch + pLayout->chunk_total_size);
 
-static PRP_Result EntityGroupIterationCb(void *pVal, void *pUser_data) {
-    ChunkView *pChunk_view = pVal;
-    IterationData *pI_data = pUser_data;
+    return *ppScratch;
+}
 
-    if (pChunk_view->chunk_idx >= CONT_ArrLen(pI_data->pLayout->pChunk_ptrs)) {
-        return PRP_ERR_INV_ARG;
+const PRP_U8 *LayoutChunkCompData(const FECS_Layout *pLayout,
+                                  PRP_Size chunk_idx, FECS_CompId comp_id,
+                                  PRP_U8 **ppScratch) {
+    FECS_Chunk *pChunk = CHUNK(pLayout, chunk_idx);
+    // Checked first, so that readers of a hot chunk don't keep writing it.
+    if (atomic_load_explicit(&pChunk->access_frame, memory_order_relaxed) !=
+        pLayout->frame) {
+        atomic_store_explicit(&pChunk->access_frame, pLayout->frame,
+                              memory_order_relaxed);
     }
-    FECS_Chunk *pChunk = CHUNK(pI_data->pLayout, pChunk_view->chunk_idx);
-    FECS_ChunkFreeSlotType mask = pChunk_view->occupied_slots;
-    while (mask) {
-        FECS_ChunkFreeSlotType slot =
-            (FECS_ChunkFreeSlotType)CONT_BitwordCTZ(mask);
-        if (pChunk_view->gens[slot] != pChunk->gens[slot] ||
-            PRP_BIT_IS_SET(pChunk->free_slot_bitset, BIT_MASK(slot))) {
-            if (mask != pChunk_view->occupied_slots) {
-                // We deleted not all entities but now chunk has free spot.
-                CONT_BitmapSetUnchecked(pI_data->pLayout->pFree_chunk_bitset,
-                                        pChunk_view->chunk_idx);
-            }
-            return PRP_ERR_INV_ARG;
+    if (!pChunk->packed_size ||
+        COMP_STORAGE(comp_id) != FECS_COMP_STORAGE_COLUMN) {
+        return pChunk->pChunk_mem + LayoutCompStride(pLayout, comp_id);
+    }
+
+    PRP_Size comp_size = COMP_SIZE(comp_id);
+    PRP_Size column_size = comp_size * CHUNK_CAP;
+    if (!*ppScratch) {
+        *ppScratch = malloc(column_size * 2);
+        if (!*ppScratch) {
+            return NULL;
         }
-        mask &= mask - 1;
+    }
+    const PRP_U8 *pPacked_columns =
+        pChunk->pChunk_mem + LAYOUT_COLUMNS_OFS(pLayout);
+    PRP_U32 block_ofs;
+    memcpy(&block_ofs,
+           pPacked_columns + sizeof(PRP_U32) * ColumnRank(pLayout, comp_id),
+           sizeof(block_ofs));
+    UnpackColumn(pPacked_columns + block_ofs, *ppScratch + column_size,
+                 *ppScratch, comp_size);
+
+    return *ppScratch;
+}
 
-        PRP_U8 *ptr = (PRP_U8 *)pChunk->pChunk_mem + pI_data->comp_stride +
-                      (slot * pI_data->comp_size);
-        PRP_Result code = pI_data->cb(ptr, pI_data->pUser_data);
+PRP_Result LayoutSetCompression(FECS_Layout *pLayout, PRP_U32 idle_frames) {
+    if (!idle_frames) {
+        PRP_Result code = LayoutDecompressChunks(pLayout);
         if (code != PRP_OK) {
             return code;
         }
+        free(pLayout->pPack_scratch);
+        free(pLayout->pRead_scratch);
+        pLayout->pPack_scratch = NULL;
+        pLayout->pRead_scratch = NULL;
+        pLayout->compress_idle_frames = 0;
+
+        return PRP_OK;
+    }
+
+    if (!pLayout->pPack_scratch) {
+        // The +1 keeps the size non zero for layouts without plain columns.
+        pLayout->pPack_scratch = malloc(COLUMNS_SIZE(pLayout) * 2 + 1);
+        if (!pLayout->pPack_scratch) {
+            return PRP_ERR_OOM;
+        }
+        // Chunks start idling when compression is enabled, not before.
+        for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pLayout->chunk_dir); i++) {
+            atomic_store_explicit(&CHUNK(pLayout, i)->access_frame,
+                                  pLayout->frame, memory_order_relaxed);
+        }
     }
+    pLayout->compress_idle_frames = idle_frames;
 
     return PRP_OK;
 }
 
-PRP_Result EntityGroupForEach(
-    FECS_World *pWorld, FECS_EntityGroupId *pGroup, FECS_CompId comp_id,
-    PRP_Result (*cb)(void *pComp_data, void *pUser_data), void *pUser_data) {
-    IterationData i_data = {.cb = cb, .pUser_data = pUser_data};
-    i_data.pLayout = &pWorld->pLayouts[pGroup->layout_id];
-    if (!CONT_BitmapIsSetUnchecked(i_data.pLayout->pComp_set, comp_id)) {
-        return PRP_ERR_INV_ARG;
+PRP_Result LayoutCompressIdleChunks(FECS_Layout *pLayout) {
+    // Spawn contexts may be writing to the layout from other threads.
+    if (!pLayout->compress_idle_frames || !COLUMNS_SIZE(pLayout) ||
+        pLayout->spawn_ctx_count) {
+        return PRP_OK;
+    }
+    PRP_U32 ending_frame = pLayout->frame++;
+
+    PRP_Result code = PRP_OK;
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pLayout->chunk_dir); i++) {
+        FECS_Chunk *pChunk = CHUNK(pLayout, i);
+        PRP_U32 access_frame =
+            atomic_load_explicit(&pChunk->access_frame, memory_order_relaxed);
+        /*
+         * Readers decompress a column into their own scratch on every read,
+         * a chunk read during the frame is decompressed for good here
+         * instead. Packing leaves access_frame behind, so only reads match.
+         */
+        if (pChunk->packed_size) {
+            if (access_frame == ending_frame) {
+                PRP_Result unpack_code = ChunkUnpack(pLayout, i);
+                if (unpack_code != PRP_OK) {
+                    code = unpack_code;
+                }
+            }
+            continue;
+        }
+        // Empty chunks only hold stale values, forks share their chunks.
+        if (pChunk->ref_count != 1 || pChunk->pFile ||
+            !(FECS_ChunkFreeSlotType)~pChunk->free_slot_bitset ||
+            pLayout->frame - access_frame < pLayout->compress_idle_frames) {
+            continue;
+        }
+        PRP_Result pack_code = ChunkPack(pLayout, i);
+        if (pack_code != PRP_OK) {
+            code = pack_code;
+        }
+        /*
+         * Restarting the idle count, so that a chunk that doesn't compress is
+         * only retried compress_idle_frames later.
+         */
+        pChunk = CHUNK(pLayout, i);
+        if (!pChunk->packed_size) {
+            atomic_store_explicit(&pChunk->access_frame, pLayout->frame,
+                                  memory_order_relaxed);
+        }
     }
 
-    i_data.comp_size =
-        (*(PRP_Size *)CONT_ArrGetUnchecked(g_ctx->pComp_sizes, comp_id));
+    return code;
+}
 
-    PRP_Size _;
-    const CONT_Bitword *pBitwords =
-        CONT_BitmapRawUnchecked(i_data.pLayout->pComp_set, &_, &_);
-    PRP_Size word_i = WORD_I(comp_id);
-    PRP_Size prefix_popcnt = i_data.pLayout->pWord_prefix_popcnts[word_i];
-    PRP_U16 rank_in_word = (PRP_U16)CONT_BitwordPopCnt(pBitwords[word_i] &
-                                                       (BIT_MASK(comp_id) - 1));
-    i_data.comp_stride =
-        i_data.pLayout->pComp_arr_strides[prefix_popcnt + rank_in_word];
+PRP_Result LayoutDecompressChunks(FECS_Layout *pLayout) {
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pLayout->chunk_dir); i++) {
+        if (!CHUNK(pLayout, i)->packed_size) {
+            continue;
+        }
+        PRP_Result code = ChunkUnpack(pLayout, i);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
 
-    return CONT_ArrForEachUnchecked(pGroup->pChunk_views,
-                                    EntityGroupIterationCb, &i_data);
+    return PRP_OK;
 }
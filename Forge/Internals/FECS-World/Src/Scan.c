@@ -0,0 +1,322 @@
+#include "Forge/Internals/FECS-World/World-Internals.h"
+#include "Forge/Internals/FECS/FECS-Internals.h"
+
+#define SCAN_TYPE_COUNT ((PRP_Size)FECS_SCAN_TYPE_U64 + 1)
+
+static const PRP_Size SCAN_TYPE_SIZES[SCAN_TYPE_COUNT] = {
+    sizeof(PRP_F32), sizeof(PRP_F64), sizeof(PRP_I32),
+    sizeof(PRP_U32), sizeof(PRP_I64), sizeof(PRP_U64),
+};
+
+/**
+ * Validates a field of a layout and resolves its slot size.
+ *
+ * @param pLayout    The layout to resolve the field in.
+ * @param pField     The field to resolve.
+ * @param pSlot_size Output pointer to the distance between the field of two
+ *                   slots, 0 for shared comps.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the field is malformed or isn't a column or
+ *                         shared comp of the layout.
+ */
+static PRP_Result ScanResolveField(const FECS_Layout *pLayout,
+                                   const FECS_ScanField *pField,
+                                   PRP_Size *pSlot_size);
+/**
+ * Gets the field of slot 0 of a chunk for reading, see LayoutChunkCompData.
+ *
+ * @param pLayout   The layout the chunk belongs to.
+ * @param chunk_idx The chunk to read.
+ * @param pField    A field resolved by ScanResolveField.
+ * @param ppScratch Scratch of the caller for pField->comp_id.
+ *
+ * @return The field of slot 0, NULL if the scratch can't be allocated.
+ */
+static const PRP_U8 *ScanFieldVals(const FECS_Layout *pLayout,
+                                   PRP_Size chunk_idx,
+                                   const FECS_ScanField *pField,
+                                   PRP_U8 **ppScratch);
+
+static PRP_Result ScanResolveField(const FECS_Layout *pLayout,
+                                   const FECS_ScanField *pField,
+                                   PRP_Size *pSlot_size) {
+    FECS_CompId comp_id = pField->comp_id;
+    if (comp_id >= CONT_ArrLen(g_ctx->pComp_sizes) ||
+        (PRP_Size)pField->type >= SCAN_TYPE_COUNT ||
+        !CONT_BitmapIsSetUnchecked(pLayout->pComp_set, comp_id)) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Size comp_size = COMP_SIZE(comp_id);
+    if (pField->ofs > comp_size ||
+        comp_size - pField->ofs < SCAN_TYPE_SIZES[pField->type]) {
+        return PRP_ERR_INV_ARG;
+    }
+    switch (COMP_STORAGE(comp_id)) {
+    case FECS_COMP_STORAGE_COLUMN:
+    case FECS_COMP_STORAGE_DOUBLE:
+        *pSlot_size = comp_size;
+        break;
+    case FECS_COMP_STORAGE_SHARED:
+        // A single value per chunk, every slot reads the same one.
+        *pSlot_size = 0;
+        break;
+    case FECS_COMP_STORAGE_TAG:
+    case FECS_COMP_STORAGE_SPARSE:
+    default:
+        return PRP_ERR_INV_ARG;
+    }
+
+    return PRP_OK;
+}
+
+static const PRP_U8 *ScanFieldVals(const FECS_Layout *pLayout,
+                                   PRP_Size chunk_idx,
+                                   const FECS_ScanField *pField,
+                                   PRP_U8 **ppScratch) {
+    const PRP_U8 *pData =
+        LayoutChunkCompData(pLayout, chunk_idx, pField->comp_id, ppScratch);
+
+    return pData ? pData + pField->ofs : NULL;
+}
+
+/*
+ * Per type chunk kernels. Values are copied out of the column first, so the
+ * compare and fold loops run over plain arrays the compiler can vectorize.
+ *
+ * ScanFilter<T>: The slot mask of the CHUNK_CAP values at pVals matching
+ *                pPred, regardless of which slots are alive.
+ * ScanReduce<T>: Folds the values of the slots in mask into pResult, mask
+ *                must not be 0. Sums accumulate in SumT, the unsigned type of
+ *                the same width for integers, so that they wrap instead of
+ *                overflowing.
+ */
+
+#define SCAN_MASK_LOOP(mask, cond)                                             \
+    for (PRP_Size i = 0; i < CHUNK_CAP; i++) {                                 \
+        (mask) |= (FECS_ChunkFreeSlotType)(cond) << i;                         \
+    }
+
+#define SCAN_RUN_LOOP(mask, stmt)                                              \
+    {                                                                          \
+        PRP_Size begin, end;                                                   \
+        FECS_SYSTEM_EXEC_FOREACH_RUN(mask, begin, end) {                       \
+            for (PRP_Size i = begin; i < end; i++) {                           \
+                stmt;                                                          \
+            }                                                                  \
+        }                                                                      \
+    }
+
+#define SCAN_DEFINE_KERNELS(suffix, T, SumT, memb)                             \
+    static FECS_ChunkFreeSlotType ScanFilter##suffix(                          \
+        const PRP_U8 *pVals, PRP_Size slot_size,                               \
+        const FECS_ScanPredicate *pPred) {                                     \
+        T vals[CHUNK_CAP];                                                     \
+        for (PRP_Size i = 0; i < CHUNK_CAP; i++) {                             \
+            memcpy(&vals[i], pVals + i * slot_size, sizeof(T));                \
+        }                                                                      \
+        T val = pPred->val.memb;                                               \
+        T hi = pPred->hi.memb;                                                 \
+        FECS_ChunkFreeSlotType mask = 0;                                       \
+        switch (pPred->cmp) {                                                  \
+        case FECS_SCAN_CMP_EQ:                                                 \
+            SCAN_MASK_LOOP(mask, vals[i] == val);                              \
+            break;                                                             \
+        case FECS_SCAN_CMP_NE:                                                 \
+            SCAN_MASK_LOOP(mask, vals[i] != val);                              \
+            break;                                                             \
+        case FECS_SCAN_CMP_LT:                                                 \
+            SCAN_MASK_LOOP(mask, vals[i] < val);                               \
+            break;                                                             \
+        case FECS_SCAN_CMP_LE:                                                 \
+            SCAN_MASK_LOOP(mask, vals[i] <= val);                              \
+            break;                                                             \
+        case FECS_SCAN_CMP_GT:                                                 \
+            SCAN_MASK_LOOP(mask, vals[i] > val);                               \
+            break;                                                             \
+        case FECS_SCAN_CMP_GE:                                                 \
+            SCAN_MASK_LOOP(mask, vals[i] >= val);                              \
+            break;                                                             \
+        case FECS_SCAN_CMP_RANGE:                                              \
+            SCAN_MASK_LOOP(mask, vals[i] >= val && vals[i] <= hi);             \
+            break;                                                             \
+        }                                                                      \
+                                                                               \
+        return mask;                                                           \
+    }                                                                          \
+                                                                               \
+    static void ScanReduce##suffix(const PRP_U8 *pVals, PRP_Size slot_size,    \
+                                   FECS_ScanReduceOp op,                       \
+                                   FECS_ChunkFreeSlotType mask,                \
+                                   FECS_ScanReduceResult *pResult) {           \
+        T vals[CHUNK_CAP];                                                     \
+        for (PRP_Size i = 0; i < CHUNK_CAP; i++) {                             \
+            memcpy(&vals[i], pVals + i * slot_size, sizeof(T));                \
+        }                                                                      \
+        T acc = pResult->val.memb;                                             \
+        /* Min/max start from a value actually reduced, sums from 0. */        \
+        if (!pResult->count && op != FECS_SCAN_REDUCE_SUM) {                   \
+            acc = vals[CONT_BitwordCTZ(mask)];                                 \
+        }                                                                      \
+        pResult->count += CONT_BitwordPopCnt(mask);                            \
+        switch (op) {                                                          \
+        case FECS_SCAN_REDUCE_SUM: {                                           \
+            SumT sum = (SumT)acc;                                              \
+            SCAN_RUN_LOOP(mask, sum += (SumT)vals[i]);                         \
+            acc = (T)sum;                                                      \
+            break;                                                             \
+        }                                                                      \
+        case FECS_SCAN_REDUCE_MIN:                                             \
+            SCAN_RUN_LOOP(mask, acc = vals[i] < acc ? vals[i] : acc);          \
+            break;                                                             \
+        case FECS_SCAN_REDUCE_MAX:                                             \
+            SCAN_RUN_LOOP(mask, acc = vals[i] > acc ? vals[i] : acc);          \
+            break;                                                             \
+        case FECS_SCAN_REDUCE_COUNT:                                           \
+            break;                                                             \
+        }                                                                      \
+        pResult->val.memb = acc;                                               \
+    }
+
+SCAN_DEFINE_KERNELS(F32, PRP_F32, PRP_F32, f32)
+SCAN_DEFINE_KERNELS(F64, PRP_F64, PRP_F64, f64)
+SCAN_DEFINE_KERNELS(I32, PRP_I32, PRP_U32, i32)
+SCAN_DEFINE_KERNELS(U32, PRP_U32, PRP_U32, u32)
+SCAN_DEFINE_KERNELS(I64, PRP_I64, PRP_U64, i64)
+SCAN_DEFINE_KERNELS(U64, PRP_U64, PRP_U64, u64)
+
+typedef FECS_ChunkFreeSlotType (*ScanFilterFunc)(
+    const PRP_U8 *pVals, PRP_Size slot_size, const FECS_ScanPredicate *pPred);
+typedef void (*ScanReduceFunc)(const PRP_U8 *pVals, PRP_Size slot_size,
+                               FECS_ScanReduceOp op,
+                               FECS_ChunkFreeSlotType mask,
+                               FECS_ScanReduceResult *pResult);
+
+// Indexed by FECS_ScanType.
+static const ScanFilterFunc SCAN_FILTER_FUNCS[SCAN_TYPE_COUNT] = {
+    ScanFilterF32, ScanFilterF64, ScanFilterI32,
+    ScanFilterU32, ScanFilterI64, ScanFilterU64,
+};
+static const ScanReduceFunc SCAN_REDUCE_FUNCS[SCAN_TYPE_COUNT] = {
+    ScanReduceF32, ScanReduceF64, ScanReduceI32,
+    ScanReduceU32, ScanReduceI64, ScanReduceU64,
+};
+
+PRP_Result LayoutScanFilter(const FECS_Layout *pLayout, PRP_Size pred_count,
+                            const FECS_ScanPredicate *pPreds,
+                            PRP_Size mask_count,
+                            FECS_ChunkFreeSlotType *pMasks) {
+    // Validated up front, so the masks are never left half filtered.
+    for (PRP_Size p = 0; p < pred_count; p++) {
+        PRP_Size _;
+        if ((PRP_Size)pPreds[p].cmp > FECS_SCAN_CMP_RANGE ||
+            ScanResolveField(pLayout, &pPreds[p].field, &_) != PRP_OK) {
+            return PRP_ERR_INV_ARG;
+        }
+    }
+
+    PRP_Size chunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+    if (chunk_count > mask_count) {
+        chunk_count = mask_count;
+    }
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        pMasks[c] = ~CHUNK_DIR_AT(&pLayout->chunk_dir, c)->free_slot_bitset;
+    }
+    // A predicate at a time, so each pass streams a single column.
+    PRP_Result code = PRP_OK;
+    for (PRP_Size p = 0; p < pred_count && code == PRP_OK; p++) {
+        const FECS_ScanPredicate *pPred = &pPreds[p];
+        PRP_Size slot_size;
+        ScanResolveField(pLayout, &pPred->field, &slot_size);
+        ScanFilterFunc filter = SCAN_FILTER_FUNCS[pPred->field.type];
+        PRP_U8 *pScratch = NULL;
+        for (PRP_Size c = 0; c < chunk_count; c++) {
+            // Chunks ruled out by an earlier predicate are not read again.
+            if (!pMasks[c]) {
+                continue;
+            }
+            const PRP_U8 *pVals =
+                ScanFieldVals(pLayout, c, &pPred->field, &pScratch);
+            if (!pVals) {
+                code = PRP_ERR_OOM;
+                break;
+            }
+            pMasks[c] &= filter(pVals, slot_size, pPred);
+        }
+        free(pScratch);
+    }
+
+    return code;
+}
+
+PRP_Result LayoutScanFilterGroup(FECS_World *pWorld, FECS_LayoutId layout_id,
+                                 PRP_Size pred_count,
+                                 const FECS_ScanPredicate *pPreds,
+                                 FECS_EntityGroupId **ppGroup) {
+    const FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
+    PRP_Size chunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+    // The +1 keeps the size non zero for layouts without chunks.
+    FECS_ChunkFreeSlotType *pMasks =
+        malloc(sizeof(FECS_ChunkFreeSlotType) * (chunk_count + 1));
+    if (!pMasks) {
+        return PRP_ERR_OOM;
+    }
+    PRP_Result code =
+        LayoutScanFilter(pLayout, pred_count, pPreds, chunk_count, pMasks);
+    if (code == PRP_OK) {
+        code = EntityGroupFromMasks(pWorld, layout_id, pMasks, ppGroup);
+    }
+    free(pMasks);
+
+    return code;
+}
+
+PRP_Result LayoutScanReduce(const FECS_Layout *pLayout,
+                            const FECS_ScanField *pField, FECS_ScanReduceOp op,
+                            PRP_Size mask_count,
+                            const FECS_ChunkFreeSlotType *pMasks,
+                            FECS_ScanReduceResult *pResult) {
+    *pResult = (FECS_ScanReduceResult){0};
+    if ((PRP_Size)op > FECS_SCAN_REDUCE_COUNT) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Size slot_size = 0;
+    ScanReduceFunc reduce = NULL;
+    if (op != FECS_SCAN_REDUCE_COUNT) {
+        if (!pField ||
+            ScanResolveField(pLayout, pField, &slot_size) != PRP_OK) {
+            return PRP_ERR_INV_ARG;
+        }
+        reduce = SCAN_REDUCE_FUNCS[pField->type];
+    }
+
+    PRP_Size chunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+    if (pMasks && chunk_count > mask_count) {
+        chunk_count = mask_count;
+    }
+    PRP_Result code = PRP_OK;
+    PRP_U8 *pScratch = NULL;
+    for (PRP_Size c = 0; c < chunk_count; c++) {
+        FECS_ChunkFreeSlotType mask =
+            ~CHUNK_DIR_AT(&pLayout->chunk_dir, c)->free_slot_bitset;
+        if (pMasks) {
+            mask &= pMasks[c];
+        }
+        if (!mask) {
+            continue;
+        }
+        if (!reduce) {
+            pResult->count += CONT_BitwordPopCnt(mask);
+            continue;
+        }
+        const PRP_U8 *pVals = ScanFieldVals(pLayout, c, pField, &pScratch);
+        if (!pVals) {
+            code = PRP_ERR_OOM;
+            break;
+        }
+        reduce(pVals, slot_size, op, mask, pResult);
+    }
+    free(pScratch);
+
+    return code;
+}
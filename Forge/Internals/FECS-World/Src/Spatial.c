@@ -0,0 +1,666 @@
+#include "Forge/Internals/FECS-World/World-Internals.h"
+#include "Forge/Internals/FECS/FECS-Internals.h"
+#include <string.h>
+
+#define SPATIAL_TABLE_EMPTY (PRP_U32_MAX)
+#define SPATIAL_DEFAULT_TABLE_CAP (64)
+#define SPATIAL_DEFAULT_CELL_ITEM_CAP (8)
+#define SLOT_MASK(slot) ((FECS_ChunkFreeSlotType)1 << (slot))
+
+/**
+ * Converts a coord to the coord of the cell it falls in, saturating at the
+ * PRP_I32 range so that far away or non finite positions still get a cell.
+ *
+ * @param v             The coord.
+ * @param inv_cell_size 1 / cell size.
+ *
+ * @return The cell coord.
+ */
+static PRP_I32 CellCoord(PRP_F32 v, PRP_F32 inv_cell_size);
+/**
+ * Hashes cell coords into a table position.
+ *
+ * @param x The x cell coord.
+ * @param y The y cell coord.
+ * @param z The z cell coord.
+ *
+ * @return The unmasked hash.
+ */
+static PRP_Size CellHash(PRP_I32 x, PRP_I32 y, PRP_I32 z);
+/**
+ * Finds the cell with the given coords.
+ *
+ * @param pSpatial The grid to search in.
+ * @param x        The x cell coord.
+ * @param y        The y cell coord.
+ * @param z        The z cell coord.
+ *
+ * @return The cell idx if found, SPATIAL_TABLE_EMPTY otherwise.
+ */
+static PRP_U32 FindCell(const FECS_Spatial *pSpatial, PRP_I32 x, PRP_I32 y,
+                        PRP_I32 z);
+/**
+ * Finds the cell with the given coords, adding an empty one if not found.
+ *
+ * @param pSpatial  The grid.
+ * @param x         The x cell coord.
+ * @param y         The y cell coord.
+ * @param z         The z cell coord.
+ * @param pCell_idx Output pointer to the cell idx.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result FindOrAddCell(FECS_Spatial *pSpatial, PRP_I32 x, PRP_I32 y,
+                                PRP_I32 z, PRP_U32 *pCell_idx);
+/**
+ * Doubles the hash table and reinserts every cell.
+ *
+ * @param pSpatial The grid.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, the table is left untouched.
+ */
+static PRP_Result TableGrow(FECS_Spatial *pSpatial);
+/**
+ * Grows the per slot and per chunk arrays of a tracked layout to fit
+ * chunk_count chunks, new slots start untracked and clean.
+ *
+ * @param pSpatial_layout The layout state to grow.
+ * @param chunk_count     The number of chunks to fit.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result SpatialLayoutGrow(FECS_SpatialLayout *pSpatial_layout,
+                                    PRP_Size chunk_count);
+/**
+ * Inserts an untracked entity into the cell of pos.
+ *
+ * @param pSpatial   The grid.
+ * @param layout_id  The layout of the entity.
+ * @param entity_idx The entity_idx of the entity.
+ * @param gen        The current gen of the entity.
+ * @param pPos       The position of the entity.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails, the entity stays untracked.
+ */
+static PRP_Result Insert(FECS_Spatial *pSpatial, FECS_LayoutId layout_id,
+                         PRP_Size entity_idx, PRP_U32 gen,
+                         const MATH_Vec3 *pPos);
+/**
+ * Swap removes a tracked entity from its cell and untracks it.
+ *
+ * @param pSpatial   The grid.
+ * @param layout_id  The layout of the entity.
+ * @param entity_idx The entity_idx of the entity.
+ */
+static void Remove(FECS_Spatial *pSpatial, FECS_LayoutId layout_id,
+                   PRP_Size entity_idx);
+/**
+ * Syncs a single chunk of a tracked layout with the grid.
+ *
+ * @param pSpatial  The grid.
+ * @param layout_id The layout the chunk belongs to.
+ * @param chunk_idx The idx of the chunk.
+ * @param pLayout   The layout the chunk belongs to.
+ * @param pos_size  The size of the position comp.
+ * @param ppScratch Scratch for the position column, see LayoutChunkCompData.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, entities that couldn't be inserted
+ *                     are left untracked. If the scratch for a compressed
+ *                     chunk can't be allocated it is left for the next update.
+ */
+static PRP_Result UpdateChunk(FECS_Spatial *pSpatial, FECS_LayoutId layout_id,
+                              PRP_Size chunk_idx, const FECS_Layout *pLayout,
+                              PRP_Size pos_size, PRP_U8 **ppScratch);
+/**
+ * Appends the entities of a cell that pass the query to pOut.
+ *
+ * @param pSpatial  The grid.
+ * @param pCell     The cell to test the entities of.
+ * @param pMin      The min corner of the AABB.
+ * @param pMax      The max corner of the AABB.
+ * @param pCenter   The sphere center or NULL.
+ * @param radius_sq The squared sphere radius.
+ * @param pOut      Output array of entity ids.
+ * @param out_cap   The number of ids pOut fits.
+ * @param count     The number of entities found so far.
+ *
+ * @return The number of entities found including this cell.
+ */
+static PRP_Size QueryCell(const FECS_Spatial *pSpatial,
+                          const FECS_SpatialCell *pCell, const MATH_Vec3 *pMin,
+                          const MATH_Vec3 *pMax, const MATH_Vec3 *pCenter,
+                          PRP_F32 radius_sq, FECS_EntityId *pOut,
+                          PRP_Size out_cap, PRP_Size count);
+
+static PRP_I32 CellCoord(PRP_F32 v, PRP_F32 inv_cell_size) {
+    PRP_F32 c = MATH_FloorF32(v * inv_cell_size);
+    // Also catches NaN.
+    if (!(c >= (PRP_F32)PRP_I32_MIN)) {
+        return PRP_I32_MIN;
+    }
+    if (c >= -(PRP_F32)PRP_I32_MIN) {
+        return PRP_I32_MAX;
+    }
+
+    return (PRP_I32)c;
+}
+
+static PRP_Size CellHash(PRP_I32 x, PRP_I32 y, PRP_I32 z) {
+    PRP_U64 h = (PRP_U64)(PRP_U32)x * 0x9E3779B185EBCA87ull ^
+                (PRP_U64)(PRP_U32)y * 0xC2B2AE3D27D4EB4Full ^
+                (PRP_U64)(PRP_U32)z * 0x165667B19E3779F9ull;
+
+    return (PRP_Size)(h ^ (h >> 32));
+}
+
+static PRP_U32 FindCell(const FECS_Spatial *pSpatial, PRP_I32 x, PRP_I32 y,
+                        PRP_I32 z) {
+    PRP_Size mask = pSpatial->table_cap - 1;
+    for (PRP_Size pos = CellHash(x, y, z) & mask;; pos = (pos + 1) & mask) {
+        PRP_U32 cell_idx = pSpatial->pTable[pos];
+        if (cell_idx == SPATIAL_TABLE_EMPTY) {
+            return SPATIAL_TABLE_EMPTY;
+        }
+        const FECS_SpatialCell *pCell = &pSpatial->pCells[cell_idx];
+        if (pCell->x == x && pCell->y == y && pCell->z == z) {
+            return cell_idx;
+        }
+    }
+}
+
+static PRP_Result TableGrow(FECS_Spatial *pSpatial) {
+    PRP_Size new_cap = pSpatial->table_cap * 2;
+    PRP_U32 *pTable = malloc(sizeof(PRP_U32) * new_cap);
+    if (!pTable) {
+        return PRP_ERR_OOM;
+    }
+    memset(pTable, 0xFF, sizeof(PRP_U32) * new_cap);
+
+    PRP_Size mask = new_cap - 1;
+    for (PRP_Size i = 0; i < pSpatial->cell_count; i++) {
+        const FECS_SpatialCell *pCell = &pSpatial->pCells[i];
+        PRP_Size pos = CellHash(pCell->x, pCell->y, pCell->z) & mask;
+        while (pTable[pos] != SPATIAL_TABLE_EMPTY) {
+            pos = (pos + 1) & mask;
+        }
+        pTable[pos] = (PRP_U32)i;
+    }
+    free(pSpatial->pTable);
+    pSpatial->pTable = pTable;
+    pSpatial->table_cap = new_cap;
+
+    return PRP_OK;
+}
+
+static PRP_Result FindOrAddCell(FECS_Spatial *pSpatial, PRP_I32 x, PRP_I32 y,
+                                PRP_I32 z, PRP_U32 *pCell_idx) {
+    PRP_U32 cell_idx = FindCell(pSpatial, x, y, z);
+    if (cell_idx != SPATIAL_TABLE_EMPTY) {
+        *pCell_idx = cell_idx;
+        return PRP_OK;
+    }
+    if (pSpatial->cell_count >= SPATIAL_TABLE_EMPTY) {
+        return PRP_ERR_RES_EXHAUSTED;
+    }
+
+    // Keep the load factor under 1/2 so probe chains stay short.
+    if ((pSpatial->cell_count + 1) * 2 > pSpatial->table_cap) {
+        PRP_Result code = TableGrow(pSpatial);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+    if (pSpatial->cell_count == pSpatial->cell_cap) {
+        PRP_Size new_cap =
+            pSpatial->cell_cap ? pSpatial->cell_cap * 2 : CONT_ARR_DEFAULT_CAP;
+        FECS_SpatialCell *pCells =
+            realloc(pSpatial->pCells, sizeof(FECS_SpatialCell) * new_cap);
+        if (!pCells) {
+            return PRP_ERR_OOM;
+        }
+        pSpatial->pCells = pCells;
+        pSpatial->cell_cap = new_cap;
+    }
+
+    cell_idx = (PRP_U32)pSpatial->cell_count++;
+    pSpatial->pCells[cell_idx] = (FECS_SpatialCell){.x = x, .y = y, .z = z};
+    PRP_Size mask = pSpatial->table_cap - 1;
+    PRP_Size pos = CellHash(x, y, z) & mask;
+    while (pSpatial->pTable[pos] != SPATIAL_TABLE_EMPTY) {
+        pos = (pos + 1) & mask;
+    }
+    pSpatial->pTable[pos] = cell_idx;
+    *pCell_idx = cell_idx;
+
+    return PRP_OK;
+}
+
+static PRP_Result SpatialLayoutGrow(FECS_SpatialLayout *pSpatial_layout,
+                                    PRP_Size chunk_count) {
+    PRP_Size slot_count = chunk_count * CHUNK_CAP;
+    /*
+     * Each array is only replaced once its realloc succeeds, so a failure
+     * midway leaves some arrays bigger than chunk_cap, which is harmless.
+     */
+    PRP_U32 *pGens =
+        realloc(pSpatial_layout->pGens, sizeof(PRP_U32) * slot_count);
+    if (!pGens) {
+        return PRP_ERR_OOM;
+    }
+    pSpatial_layout->pGens = pGens;
+    PRP_U32 *pCell_idxs =
+        realloc(pSpatial_layout->pCell_idxs, sizeof(PRP_U32) * slot_count);
+    if (!pCell_idxs) {
+        return PRP_ERR_OOM;
+    }
+    pSpatial_layout->pCell_idxs = pCell_idxs;
+    PRP_U32 *pItem_idxs =
+        realloc(pSpatial_layout->pItem_idxs, sizeof(PRP_U32) * slot_count);
+    if (!pItem_idxs) {
+        return PRP_ERR_OOM;
+    }
+    pSpatial_layout->pItem_idxs = pItem_idxs;
+    FECS_ChunkFreeSlotType *pTracked =
+        realloc(pSpatial_layout->pTracked,
+                sizeof(FECS_ChunkFreeSlotType) * chunk_count);
+    if (!pTracked) {
+        return PRP_ERR_OOM;
+    }
+    pSpatial_layout->pTracked = pTracked;
+    FECS_ChunkFreeSlotType *pDirty =
+        realloc(pSpatial_layout->pDirty,
+                sizeof(FECS_ChunkFreeSlotType) * chunk_count);
+    if (!pDirty) {
+        return PRP_ERR_OOM;
+    }
+    pSpatial_layout->pDirty = pDirty;
+
+    PRP_Size old_cap = pSpatial_layout->chunk_cap;
+    memset(pTracked + old_cap, 0,
+           sizeof(FECS_ChunkFreeSlotType) * (chunk_count - old_cap));
+    memset(pDirty + old_cap, 0,
+           sizeof(FECS_ChunkFreeSlotType) * (chunk_count - old_cap));
+    pSpatial_layout->chunk_cap = chunk_count;
+
+    return PRP_OK;
+}
+
+static PRP_Result Insert(FECS_Spatial *pSpatial, FECS_LayoutId layout_id,
+                         PRP_Size entity_idx, PRP_U32 gen,
+                         const MATH_Vec3 *pPos) {
+    PRP_F32 inv_cell_size = pSpatial->inv_cell_size;
+    PRP_U32 cell_idx;
+    PRP_Result code = FindOrAddCell(
+        pSpatial, CellCoord(pPos->x, inv_cell_size),
+        CellCoord(pPos->y, inv_cell_size), CellCoord(pPos->z, inv_cell_size),
+        &cell_idx);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    FECS_SpatialCell *pCell = &pSpatial->pCells[cell_idx];
+    if (pCell->item_count == pCell->item_cap) {
+        PRP_U32 new_cap = pCell->item_cap ? pCell->item_cap * 2
+                                          : SPATIAL_DEFAULT_CELL_ITEM_CAP;
+        FECS_SpatialItem *pItems =
+            realloc(pCell->pItems, sizeof(FECS_SpatialItem) * new_cap);
+        if (!pItems) {
+            return PRP_ERR_OOM;
+        }
+        pCell->pItems = pItems;
+        pCell->item_cap = new_cap;
+    }
+    PRP_U32 item_idx = pCell->item_count++;
+    pCell->pItems[item_idx] =
+        (FECS_SpatialItem){.pos = *pPos,
+                           .layout_id = (PRP_U32)layout_id,
+                           .entity_idx = (PRP_U32)entity_idx};
+
+    FECS_SpatialLayout *pSpatial_layout = &pSpatial->pLayouts[layout_id];
+    pSpatial_layout->pGens[entity_idx] = gen;
+    pSpatial_layout->pCell_idxs[entity_idx] = cell_idx;
+    pSpatial_layout->pItem_idxs[entity_idx] = item_idx;
+    PRP_BIT_SET(pSpatial_layout->pTracked[entity_idx / CHUNK_CAP],
+                SLOT_MASK(entity_idx % CHUNK_CAP));
+    pSpatial->item_count++;
+
+    return PRP_OK;
+}
+
+static void Remove(FECS_Spatial *pSpatial, FECS_LayoutId layout_id,
+                   PRP_Size entity_idx) {
+    FECS_SpatialLayout *pSpatial_layout = &pSpatial->pLayouts[layout_id];
+    FECS_SpatialCell *pCell =
+        &pSpatial->pCells[pSpatial_layout->pCell_idxs[entity_idx]];
+    PRP_U32 item_idx = pSpatial_layout->pItem_idxs[entity_idx];
+
+    // Swap remove, the item moved into the hole has its back index fixed.
+    PRP_U32 last_idx = --pCell->item_count;
+    if (item_idx != last_idx) {
+        const FECS_SpatialItem *pLast = &pCell->pItems[last_idx];
+        pSpatial->pLayouts[pLast->layout_id].pItem_idxs[pLast->entity_idx] =
+            item_idx;
+        pCell->pItems[item_idx] = *pLast;
+    }
+    PRP_BIT_CLR(pSpatial_layout->pTracked[entity_idx / CHUNK_CAP],
+                SLOT_MASK(entity_idx % CHUNK_CAP));
+    pSpatial->item_count--;
+}
+
+static PRP_Result UpdateChunk(FECS_Spatial *pSpatial, FECS_LayoutId layout_id,
+                              PRP_Size chunk_idx, const FECS_Layout *pLayout,
+                              PRP_Size pos_size, PRP_U8 **ppScratch) {
+    FECS_SpatialLayout *pSpatial_layout = &pSpatial->pLayouts[layout_id];
+    const FECS_Chunk *pChunk = CHUNK_DIR_AT(&pLayout->chunk_dir, chunk_idx);
+    PRP_Size base_idx = chunk_idx * CHUNK_CAP;
+    FECS_ChunkFreeSlotType occupied = ~pChunk->free_slot_bitset;
+    FECS_ChunkFreeSlotType tracked = pSpatial_layout->pTracked[chunk_idx];
+    FECS_ChunkFreeSlotType dirty = pSpatial_layout->pDirty[chunk_idx];
+
+    // Killed, or killed and respawned into the same slot since the last update.
+    FECS_ChunkFreeSlotType gone = tracked & ~occupied;
+    FECS_ChunkFreeSlotType kept = tracked & occupied;
+    if (kept && memcmp(pChunk->gens, pSpatial_layout->pGens + base_idx,
+                       sizeof(pChunk->gens))) {
+        FECS_ChunkFreeSlotType mask = kept;
+        while (mask) {
+            PRP_Size slot = CONT_BitwordCTZ(mask);
+            if (pChunk->gens[slot] != pSpatial_layout->pGens[base_idx + slot]) {
+                gone |= SLOT_MASK(slot);
+            }
+            mask &= mask - 1;
+        }
+    }
+    kept &= ~gone;
+    // Positions are about to be read, nothing is touched if they can't be.
+    const PRP_U8 *pPositions = NULL;
+    if ((dirty & kept) | (occupied & ~kept)) {
+        pPositions = LayoutChunkCompData(pLayout, chunk_idx,
+                                         pSpatial->pos_comp_id, ppScratch);
+        if (!pPositions) {
+            return PRP_ERR_OOM;
+        }
+    }
+    pSpatial_layout->pDirty[chunk_idx] = 0;
+
+    FECS_ChunkFreeSlotType mask = gone;
+    while (mask) {
+        Remove(pSpatial, layout_id, base_idx + CONT_BitwordCTZ(mask));
+        mask &= mask - 1;
+    }
+
+    PRP_Result code = PRP_OK;
+    PRP_F32 inv_cell_size = pSpatial->inv_cell_size;
+    MATH_Vec3 pos;
+    mask = dirty & kept;
+    while (mask) {
+        PRP_Size slot = CONT_BitwordCTZ(mask);
+        PRP_Size entity_idx = base_idx + slot;
+        memcpy(&pos, pPositions + slot * pos_size, sizeof(MATH_Vec3));
+        const FECS_SpatialCell *pCell =
+            &pSpatial->pCells[pSpatial_layout->pCell_idxs[entity_idx]];
+        if (pCell->x == CellCoord(pos.x, inv_cell_size) &&
+            pCell->y == CellCoord(pos.y, inv_cell_size) &&
+            pCell->z == CellCoord(pos.z, inv_cell_size)) {
+            pCell->pItems[pSpatial_layout->pItem_idxs[entity_idx]].pos = pos;
+        } else {
+            Remove(pSpatial, layout_id, entity_idx);
+            PRP_Result insert_code = Insert(pSpatial, layout_id, entity_idx,
+                                            pChunk->gens[slot], &pos);
+            if (insert_code != PRP_OK) {
+                code = insert_code;
+            }
+        }
+        mask &= mask - 1;
+    }
+
+    mask = occupied & ~kept;
+    while (mask) {
+        PRP_Size slot = CONT_BitwordCTZ(mask);
+        memcpy(&pos, pPositions + slot * pos_size, sizeof(MATH_Vec3));
+        PRP_Result insert_code = Insert(pSpatial, layout_id, base_idx + slot,
+                                        pChunk->gens[slot], &pos);
+        if (insert_code != PRP_OK) {
+            code = insert_code;
+        }
+        mask &= mask - 1;
+    }
+
+    return code;
+}
+
+static PRP_Size QueryCell(const FECS_Spatial *pSpatial,
+                          const FECS_SpatialCell *pCell, const MATH_Vec3 *pMin,
+                          const MATH_Vec3 *pMax, const MATH_Vec3 *pCenter,
+                          PRP_F32 radius_sq, FECS_EntityId *pOut,
+                          PRP_Size out_cap, PRP_Size count) {
+    for (PRP_U32 i = 0; i < pCell->item_count; i++) {
+        const FECS_SpatialItem *pItem = &pCell->pItems[i];
+        const MATH_Vec3 *pPos = &pItem->pos;
+        if (pPos->x < pMin->x || pPos->x > pMax->x || pPos->y < pMin->y ||
+            pPos->y > pMax->y || pPos->z < pMin->z || pPos->z > pMax->z) {
+            continue;
+        }
+        if (pCenter) {
+            PRP_F32 dx = pPos->x - pCenter->x;
+            PRP_F32 dy = pPos->y - pCenter->y;
+            PRP_F32 dz = pPos->z - pCenter->z;
+            if (dx * dx + dy * dy + dz * dz > radius_sq) {
+                continue;
+            }
+        }
+        if (count < out_cap) {
+            pOut[count] = (FECS_EntityId){
+                .layout_id = pItem->layout_id,
+                .entity_idx = pItem->entity_idx,
+                .gen = pSpatial->pLayouts[pItem->layout_id]
+                           .pGens[pItem->entity_idx]};
+        }
+        count++;
+    }
+
+    return count;
+}
+
+PRP_Result SpatialCreate(const FECS_Layout *pLayouts, PRP_Size layout_count,
+                         FECS_CompId pos_comp_id, PRP_F32 cell_size,
+                         FECS_Spatial **ppSpatial) {
+    FECS_Spatial *pSpatial = calloc(1, sizeof(FECS_Spatial));
+    if (!pSpatial) {
+        return PRP_ERR_OOM;
+    }
+    pSpatial->pos_comp_id = pos_comp_id;
+    pSpatial->cell_size = cell_size;
+    pSpatial->inv_cell_size = 1.0f / cell_size;
+
+    if (layout_count) {
+        pSpatial->pLayouts = calloc(layout_count, sizeof(FECS_SpatialLayout));
+        if (!pSpatial->pLayouts) {
+            goto err_path;
+        }
+        pSpatial->layout_count = layout_count;
+    }
+    for (PRP_Size i = 0; i < layout_count; i++) {
+        pSpatial->pLayouts[i].is_tracked =
+            CONT_BitmapIsSetUnchecked(pLayouts[i].pComp_set, pos_comp_id);
+    }
+
+    pSpatial->pTable = malloc(sizeof(PRP_U32) * SPATIAL_DEFAULT_TABLE_CAP);
+    if (!pSpatial->pTable) {
+        goto err_path;
+    }
+    memset(pSpatial->pTable, 0xFF, sizeof(PRP_U32) * SPATIAL_DEFAULT_TABLE_CAP);
+    pSpatial->table_cap = SPATIAL_DEFAULT_TABLE_CAP;
+    *ppSpatial = pSpatial;
+
+    return PRP_OK;
+
+err_path:
+    SpatialDelete(&pSpatial);
+
+    return PRP_ERR_OOM;
+}
+
+void SpatialDelete(FECS_Spatial **ppSpatial) {
+    FECS_Spatial *pSpatial = *ppSpatial;
+
+    for (PRP_Size i = 0; i < pSpatial->layout_count; i++) {
+        FECS_SpatialLayout *pSpatial_layout = &pSpatial->pLayouts[i];
+        free(pSpatial_layout->pGens);
+        free(pSpatial_layout->pCell_idxs);
+        free(pSpatial_layout->pItem_idxs);
+        free(pSpatial_layout->pTracked);
+        free(pSpatial_layout->pDirty);
+    }
+    free(pSpatial->pLayouts);
+    for (PRP_Size i = 0; i < pSpatial->cell_count; i++) {
+        free(pSpatial->pCells[i].pItems);
+    }
+    free(pSpatial->pCells);
+    free(pSpatial->pTable);
+    free(pSpatial);
+    *ppSpatial = NULL;
+}
+
+void SpatialMarkDirty(FECS_Spatial *pSpatial, FECS_EntityId entity) {
+    FECS_SpatialLayout *pSpatial_layout = &pSpatial->pLayouts[entity.layout_id];
+    PRP_Size chunk_idx = entity.entity_idx / CHUNK_CAP;
+    // Chunks the grid hasn't seen yet are fully read at the next update anyway.
+    if (!pSpatial_layout->is_tracked ||
+        chunk_idx >= pSpatial_layout->chunk_cap) {
+        return;
+    }
+    PRP_BIT_SET(pSpatial_layout->pDirty[chunk_idx],
+                SLOT_MASK(entity.entity_idx % CHUNK_CAP));
+}
+
+void SpatialMarkLayoutDirty(FECS_Spatial *pSpatial, FECS_LayoutId layout_id) {
+    FECS_SpatialLayout *pSpatial_layout = &pSpatial->pLayouts[layout_id];
+    if (!pSpatial_layout->is_tracked || !pSpatial_layout->chunk_cap) {
+        return;
+    }
+    memset(pSpatial_layout->pDirty, 0xFF,
+           sizeof(FECS_ChunkFreeSlotType) * pSpatial_layout->chunk_cap);
+}
+
+PRP_Result SpatialUpdate(FECS_Spatial *pSpatial, const FECS_Layout *pLayouts) {
+    PRP_Result code = PRP_OK;
+    PRP_Size pos_size = COMP_SIZE(pSpatial->pos_comp_id);
+    PRP_U8 *pScratch = NULL;
+
+    for (PRP_Size i = 0; i < pSpatial->layout_count; i++) {
+        FECS_SpatialLayout *pSpatial_layout = &pSpatial->pLayouts[i];
+        if (!pSpatial_layout->is_tracked) {
+            continue;
+        }
+        const FECS_Layout *pLayout = &pLayouts[i];
+        PRP_Size chunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+        if (chunk_count > pSpatial_layout->chunk_cap) {
+            PRP_Result grow_code =
+                SpatialLayoutGrow(pSpatial_layout, chunk_count);
+            if (grow_code != PRP_OK) {
+                code = grow_code;
+                continue;
+            }
+        }
+
+        for (PRP_Size c = 0; c < chunk_count; c++) {
+            PRP_Result chunk_code =
+                UpdateChunk(pSpatial, i, c, pLayout, pos_size, &pScratch);
+            if (chunk_code != PRP_OK) {
+                code = chunk_code;
+            }
+        }
+        // A world restore can leave the layout with fewer chunks than seen.
+        for (PRP_Size c = chunk_count; c < pSpatial_layout->chunk_cap; c++) {
+            FECS_ChunkFreeSlotType mask = pSpatial_layout->pTracked[c];
+            while (mask) {
+                Remove(pSpatial, i, c * CHUNK_CAP + CONT_BitwordCTZ(mask));
+                mask &= mask - 1;
+            }
+        }
+    }
+    free(pScratch);
+
+    return code;
+}
+
+void SpatialQuery(const FECS_Spatial *pSpatial, const MATH_Vec3 *pMin,
+                  const MATH_Vec3 *pMax, const MATH_Vec3 *pCenter,
+                  PRP_F32 radius, FECS_EntityId *pOut, PRP_Size out_cap,
+                  PRP_Size *pCount) {
+    PRP_Size count = 0;
+    PRP_F32 inv_cell_size = pSpatial->inv_cell_size;
+    PRP_I64 x0 = CellCoord(pMin->x, inv_cell_size);
+    PRP_I64 y0 = CellCoord(pMin->y, inv_cell_size);
+    PRP_I64 z0 = CellCoord(pMin->z, inv_cell_size);
+    PRP_I64 x1 = CellCoord(pMax->x, inv_cell_size);
+    PRP_I64 y1 = CellCoord(pMax->y, inv_cell_size);
+    PRP_I64 z1 = CellCoord(pMax->z, inv_cell_size);
+    PRP_F32 radius_sq = radius * radius;
+    if (x0 > x1 || y0 > y1 || z0 > z1) {
+        *pCount = 0;
+        return;
+    }
+
+    /*
+     * Boxes spanning more cells than the grid has are cheaper to answer by
+     * walking the cells themselves than by probing every coord in range.
+     */
+    PRP_F64 range_cell_count = (PRP_F64)(x1 - x0 + 1) *
+                               (PRP_F64)(y1 - y0 + 1) *
+                               (PRP_F64)(z1 - z0 + 1);
+    if (range_cell_count > (PRP_F64)pSpatial->cell_count) {
+        for (PRP_Size i = 0; i < pSpatial->cell_count; i++) {
+            const FECS_SpatialCell *pCell = &pSpatial->pCells[i];
+            if (pCell->x < x0 || pCell->x > x1 || pCell->y < y0 ||
+                pCell->y > y1 || pCell->z < z0 || pCell->z > z1) {
+                continue;
+            }
+            count = QueryCell(pSpatial, pCell, pMin, pMax, pCenter, radius_sq,
+                              pOut, out_cap, count);
+        }
+        *pCount = count;
+        return;
+    }
+
+    for (PRP_I64 z = z0; z <= z1; z++) {
+        for (PRP_I64 y = y0; y <= y1; y++) {
+            for (PRP_I64 x = x0; x <= x1; x++) {
+                PRP_U32 cell_idx = FindCell(pSpatial, (PRP_I32)x, (PRP_I32)y,
+                                            (PRP_I32)z);
+                if (cell_idx == SPATIAL_TABLE_EMPTY) {
+                    continue;
+                }
+                count = QueryCell(pSpatial, &pSpatial->pCells[cell_idx], pMin,
+                                  pMax, pCenter, radius_sq, pOut, out_cap,
+                                  count);
+            }
+        }
+    }
+    *pCount = count;
+}
+
+PRP_Size SpatialMemoryBytes(const FECS_Spatial *pSpatial) {
+    PRP_Size bytes = sizeof(FECS_Spatial) +
+                     sizeof(FECS_SpatialLayout) * pSpatial->layout_count +
+                     sizeof(FECS_SpatialCell) * pSpatial->cell_cap +
+                     sizeof(PRP_U32) * pSpatial->table_cap;
+    for (PRP_Size i = 0; i < pSpatial->layout_count; i++) {
+        PRP_Size chunk_cap = pSpatial->pLayouts[i].chunk_cap;
+        bytes += chunk_cap * (CHUNK_CAP * sizeof(PRP_U32) * 3 +
+                              sizeof(FECS_ChunkFreeSlotType) * 2);
+    }
+    for (PRP_Size i = 0; i < pSpatial->cell_count; i++) {
+        bytes += sizeof(FECS_SpatialItem) * pSpatial->pCells[i].item_cap;
+    }
+
+    return bytes;
+}
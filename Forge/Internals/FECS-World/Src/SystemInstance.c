@@ -1,27 +1,100 @@
 #include "Forge/Internals/FECS-World/World-Internals.h"
 #include "Forge/Internals/FECS/FECS-Internals.h"
 
+/*
+ * Counter bumps of the exec path, expand to nothing unless built with
+ * PRP_FECS_SYSTEM_STATS so the default build pays nothing.
+ */
+#ifdef PRP_FECS_SYSTEM_STATS
+#define STATS_ADD(pExec_internals, field, val)                                 \
+    ((pExec_internals)->pStats->field += (val))
+#else
+#define STATS_ADD(pExec_internals, field, val) ((void)0)
+#endif
+
 struct FECS_SystemExecInternalData {
     FECS_SystemFunc func;
+    FECS_SystemBatchFunc batch_func;
 
     PRP_Size stides_len;
+    const FECS_CompId *pComp_ids;
     PRP_Size *pComp_arr_strides;
+    FECS_SparseSet **ppSparse_dispatches;
+    // Distance from a double buffered column to its previous frame copy.
+    PRP_Size prev_ofs;
+
+    // Tag masks to filter the occupancy with, first inc then exc.
+    PRP_Size inc_tag_count;
+    PRP_Size tag_filter_count;
+    PRP_Size *pTag_filter_strides;
 
     void *pUser_data;
 
+    // The current chunk, NULL while a batch runs.
     PRP_U8 *pChunk_mem;
+    // The chunks of the current batch.
+    PRP_Size batch_count;
+    PRP_U8 *pBatch_chunk_mems[FECS_SYSTEM_EXEC_BATCH_CAP];
+
+#ifdef PRP_FECS_SYSTEM_STATS
+    FECS_SystemStats *pStats;
+#endif
 };
 
 /**
- * Acts as an intermediate chunk level dispatcher for the system function.
- * Called via CONT_ArrForEach_...
+ * Computes the occupancy mask of a chunk after applying the tag filters.
  *
- * @param pVal The FECS_Chunk ** we will revieve from the arrforeach function.
- * @param pUser_data The system data needed for execution of the system func.
+ * @param pExec_internals The system data needed for execution.
+ * @param pChunk          The chunk to compute the mask of.
+ *
+ * @return The filtered occupancy mask, 0 if nothing is to be processed.
+ */
+static inline FECS_SystemExecOccupancyMask
+ChunkExecMask(const FECS_SystemExecInternalData *pExec_internals,
+              const FECS_Chunk *pChunk);
+/**
+ * Prefetches the start of every column the system needs from a chunk.
+ *
+ * @param pExec_internals The system data needed for execution.
+ * @param pChunk          The chunk to prefetch.
+ */
+static inline void
+ChunkPrefetch(const FECS_SystemExecInternalData *pExec_internals,
+              const FECS_Chunk *pChunk);
+/**
+ * Executes a batched system over all the chunks of a layout, calling the
+ * system once per FECS_SYSTEM_EXEC_BATCH_CAP non empty chunks.
  *
- * @return PRP_OK on success or on an empty chunk.
+ * @param pExec_internals The system data needed for execution, strides
+ *                        already set for the layout.
+ * @param pLayout         The layout to execute over.
  */
-static PRP_Result ExecCb(void *pVal, void *pUser_data);
+static void ExecBatched(FECS_SystemExecInternalData *pExec_internals,
+                        const FECS_Layout *pLayout);
+/**
+ * Copies the chunks of a layout shared with a world fork that the system is
+ * about to run on.
+ *
+ * @param pExec_internals The system data needed for execution, strides
+ *                        already set for the layout.
+ * @param pLayout         The layout to execute over.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result
+ExecMakeUnique(const FECS_SystemExecInternalData *pExec_internals,
+               FECS_Layout *pLayout);
+
+/**
+ * Acts as an intermediate chunk level dispatcher for the system function.
+ *
+ * @param pExec_internals The system data needed for execution of the system
+ *                        func.
+ * @param pChunk          The chunk to run the system func on.
+ */
+static void ExecChunk(FECS_SystemExecInternalData *pExec_internals,
+                      FECS_Chunk *pChunk);
 
 PRP_Result SystemInstanceCreate(FECS_SystemInstanceCreateInfo *pCreate_info,
                                 FECS_SystemInstance *pSystem_instance) {
@@ -30,55 +103,190 @@ PRP_Result SystemInstanceCreate(FECS_SystemInstanceCreateInfo *pCreate_info,
     pSystem_instance->pStride_dispatches =
         malloc(sizeof(PRP_Size) * pCreate_info->stride_dispatch_count);
     if (!pSystem_instance->pStride_dispatches) {
-        // Cleans after itself. So the generic contract of WorldCreate is ok.
-        pCreate_info->layout_id_match_count = 0;
-        free(pCreate_info->pLayout_id_matches);
-        return PRP_ERR_OOM;
+        goto err_path;
+    }
+    pSystem_instance->ppSparse_dispatches =
+        malloc(sizeof(FECS_SparseSet *) * pCreate_info->stride_dispatch_count);
+    if (!pSystem_instance->ppSparse_dispatches) {
+        goto err_path;
+    }
+    if (pCreate_info->tag_filter_count) {
+        pSystem_instance->pTag_filter_strides =
+            malloc(sizeof(PRP_Size) * pCreate_info->tag_filter_count);
+        if (!pSystem_instance->pTag_filter_strides) {
+            goto err_path;
+        }
     }
     pSystem_instance->system_id = pCreate_info->system_id;
     pSystem_instance->layout_id_match_count =
         pCreate_info->layout_id_match_count;
     pSystem_instance->pLayout_id_matches = pCreate_info->pLayout_id_matches;
+    pSystem_instance->tag_filter_count = pCreate_info->tag_filter_count;
+    pSystem_instance->inc_tag_count = pCreate_info->inc_tag_count;
+    pSystem_instance->pTag_filter_ids = pCreate_info->pTag_filter_ids;
 
     // Invalidating to prevent access via caller again.
     pCreate_info->pLayout_id_matches = NULL;
+    pCreate_info->pTag_filter_ids = NULL;
 
     return PRP_OK;
+
+err_path:
+    // Cleans after itself. So the generic contract of WorldCreate is ok.
+    free(pSystem_instance->pStride_dispatches);
+    free(pSystem_instance->ppSparse_dispatches);
+    free(pSystem_instance->pTag_filter_strides);
+    pCreate_info->layout_id_match_count = 0;
+    free(pCreate_info->pLayout_id_matches);
+    pCreate_info->pLayout_id_matches = NULL;
+    pCreate_info->tag_filter_count = 0;
+    free(pCreate_info->pTag_filter_ids);
+    pCreate_info->pTag_filter_ids = NULL;
+
+    return PRP_ERR_OOM;
 }
 
 void SystemInstanceDelete(FECS_SystemInstance *pSystem_instance) {
     PRP_DIAG_ASSERT(pSystem_instance != NULL);
 
     free(pSystem_instance->pStride_dispatches);
+    free(pSystem_instance->ppSparse_dispatches);
     free(pSystem_instance->pLayout_id_matches);
+    free(pSystem_instance->pTag_filter_ids);
+    free(pSystem_instance->pTag_filter_strides);
 
 #ifdef PRP_DEBUG_MODE
     pSystem_instance->system_id = PRP_INVALID_INDEX;
     pSystem_instance->layout_id_match_count = 0;
     pSystem_instance->pLayout_id_matches = NULL;
     pSystem_instance->pStride_dispatches = NULL;
+    pSystem_instance->ppSparse_dispatches = NULL;
+    pSystem_instance->tag_filter_count = 0;
+    pSystem_instance->pTag_filter_ids = NULL;
+    pSystem_instance->pTag_filter_strides = NULL;
 #endif
 }
 
-static PRP_Result ExecCb(void *pVal, void *pUser_data) {
-    FECS_SystemExecInternalData *pExec_internals = pUser_data;
-    pExec_internals->pChunk_mem = (*(FECS_Chunk **)pVal)->pChunk_mem;
+static inline FECS_SystemExecOccupancyMask
+ChunkExecMask(const FECS_SystemExecInternalData *pExec_internals,
+              const FECS_Chunk *pChunk) {
     FECS_SystemExecOccupancyMask occupancy_mask =
-        (FECS_SystemExecOccupancyMask)(~(*(FECS_Chunk **)pVal)
-                                            ->free_slot_bitset);
+        (FECS_SystemExecOccupancyMask)(~pChunk->free_slot_bitset &
+                                       pChunk->enabled_slot_bitset);
+
+    PRP_Size i = 0;
+    for (; i < pExec_internals->inc_tag_count; i++) {
+        occupancy_mask &= *(const FECS_ChunkFreeSlotType *)(
+            pChunk->pChunk_mem + pExec_internals->pTag_filter_strides[i]);
+    }
+    for (; i < pExec_internals->tag_filter_count; i++) {
+        occupancy_mask &= ~*(const FECS_ChunkFreeSlotType *)(
+            pChunk->pChunk_mem + pExec_internals->pTag_filter_strides[i]);
+    }
+
+    return occupancy_mask;
+}
+
+static inline void
+ChunkPrefetch(const FECS_SystemExecInternalData *pExec_internals,
+              const FECS_Chunk *pChunk) {
+    PRP_PREFETCH(&pChunk->free_slot_bitset);
+    for (PRP_Size i = 0; i < pExec_internals->stides_len; i++) {
+        PRP_PREFETCH(pChunk->pChunk_mem +
+                     pExec_internals->pComp_arr_strides[i]);
+    }
+}
+
+static void ExecBatched(FECS_SystemExecInternalData *pExec_internals,
+                        const FECS_Layout *pLayout) {
+    FECS_SystemExecOccupancyMask occupancy_masks[FECS_SYSTEM_EXEC_BATCH_CAP];
+    const FECS_ChunkDir *pChunk_dir = &pLayout->chunk_dir;
+    PRP_Size chunk_count = CHUNK_DIR_LEN(pChunk_dir);
+
+    pExec_internals->pChunk_mem = NULL;
+    pExec_internals->batch_count = 0;
+    for (PRP_Size i = 0; i < chunk_count; i++) {
+        /*
+         * The next chunk is pulled in while this one's mask is computed or,
+         * if this chunk completes the batch, while the batch runs.
+         */
+        if (i + 1 < chunk_count) {
+            ChunkPrefetch(pExec_internals, CHUNK_DIR_AT(pChunk_dir, i + 1));
+        }
+        FECS_Chunk *pChunk = CHUNK_DIR_AT(pChunk_dir, i);
+        FECS_SystemExecOccupancyMask occupancy_mask =
+            ChunkExecMask(pExec_internals, pChunk);
+        STATS_ADD(pExec_internals, chunks_visited, 1);
+        if (!occupancy_mask) {
+            STATS_ADD(pExec_internals, chunks_skipped_empty, 1);
+            continue;
+        }
+        STATS_ADD(pExec_internals, entities_processed,
+                  CONT_BitwordPopCnt(occupancy_mask));
+        occupancy_masks[pExec_internals->batch_count] = occupancy_mask;
+        pExec_internals->pBatch_chunk_mems[pExec_internals->batch_count++] =
+            pChunk->pChunk_mem;
+        if (pExec_internals->batch_count == FECS_SYSTEM_EXEC_BATCH_CAP) {
+            pExec_internals->batch_func(pExec_internals,
+                                        pExec_internals->batch_count,
+                                        occupancy_masks,
+                                        pExec_internals->pUser_data);
+            pExec_internals->batch_count = 0;
+        }
+    }
+    if (pExec_internals->batch_count) {
+        pExec_internals->batch_func(pExec_internals,
+                                    pExec_internals->batch_count,
+                                    occupancy_masks,
+                                    pExec_internals->pUser_data);
+        pExec_internals->batch_count = 0;
+    }
+}
+
+static PRP_Result
+ExecMakeUnique(const FECS_SystemExecInternalData *pExec_internals,
+               FECS_Layout *pLayout) {
+    for (PRP_Size i = 0; i < CHUNK_DIR_LEN(&pLayout->chunk_dir); i++) {
+        const FECS_Chunk *pChunk = CHUNK_DIR_AT(&pLayout->chunk_dir, i);
+        /*
+         * Chunks the system skips stay shared and compressed, the rest are an
+         * access when compressing. Restored chunks may be compressed with
+         * compression disabled.
+         */
+        if ((pChunk->ref_count == 1 && !pChunk->packed_size &&
+             !pLayout->compress_idle_frames) ||
+            !ChunkExecMask(pExec_internals, pChunk)) {
+            continue;
+        }
+        PRP_Result code = LayoutChunkMakeUnique(pLayout, i);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return PRP_OK;
+}
+
+static void ExecChunk(FECS_SystemExecInternalData *pExec_internals,
+                      FECS_Chunk *pChunk) {
+    pExec_internals->pChunk_mem = pChunk->pChunk_mem;
+    FECS_SystemExecOccupancyMask occupancy_mask =
+        ChunkExecMask(pExec_internals, pChunk);
+    STATS_ADD(pExec_internals, chunks_visited, 1);
     if (occupancy_mask == 0) {
-        return PRP_OK;
+        STATS_ADD(pExec_internals, chunks_skipped_empty, 1);
+        return;
     }
+    STATS_ADD(pExec_internals, entities_processed,
+              CONT_BitwordPopCnt(occupancy_mask));
 
     pExec_internals->func(pExec_internals, occupancy_mask,
                           pExec_internals->pUser_data);
-
-    return PRP_OK;
 }
 
-void SystemInstanceExec(FECS_World *pWorld,
-                        FECS_SystemInstanceId system_instance_id,
-                        void *pUser_data) {
+PRP_Result SystemInstanceExec(FECS_World *pWorld,
+                              FECS_SystemInstanceId system_instance_id,
+                              void *pUser_data) {
     FECS_SystemInstance *pSystem_instance =
         &pWorld->pSystem_instances[system_instance_id];
     FECS_SystemInfo *pSystem_info =
@@ -87,39 +295,153 @@ void SystemInstanceExec(FECS_World *pWorld,
     FECS_LayoutId *pLayout_ids = pSystem_instance->pLayout_id_matches;
     FECS_SystemExecInternalData exec_internals = {
         .func = pSystem_info->systmem_func,
+        .batch_func = pSystem_info->system_batch_func,
         .pUser_data = pUser_data,
         .stides_len = pSystem_info->comp_ids_needed_count,
-        .pComp_arr_strides = pSystem_instance->pStride_dispatches};
+        .pComp_ids = pSystem_info->pComp_ids_needed,
+        .pComp_arr_strides = pSystem_instance->pStride_dispatches,
+        .ppSparse_dispatches = pSystem_instance->ppSparse_dispatches,
+        .inc_tag_count = pSystem_instance->inc_tag_count,
+        .pTag_filter_strides = pSystem_instance->pTag_filter_strides,
+#ifdef PRP_FECS_SYSTEM_STATS
+        .pStats = &pSystem_instance->stats,
+#endif
+    };
+#ifdef PRP_FECS_SYSTEM_STATS
+    PRP_TimeTicks start_ticks = PRP_TimeNow();
+#endif
 
     for (PRP_Size i = 0; i < pSystem_instance->layout_id_match_count; i++) {
         FECS_Layout *pLayout = &pWorld->pLayouts[pLayout_ids[i]];
-        PRP_Size _;
-        const CONT_Bitword *pBitwords =
-            CONT_BitmapRawUnchecked(pLayout->pComp_set, &_, &_);
 
         // Precomputing strides for the component that the system needs.
         for (PRP_Size j = 0; j < pSystem_info->comp_ids_needed_count; j++) {
-            PRP_Size comp_id = pSystem_info->pComp_ids_needed[j];
-            PRP_Size word_i = WORD_I(comp_id);
-            PRP_Size prefix_popcnt = pLayout->pWord_prefix_popcnts[word_i];
-            PRP_U16 rank_in_word = (PRP_U16)CONT_BitwordPopCnt(
-                pBitwords[word_i] & (BIT_MASK(comp_id) - 1));
-
+            FECS_CompId comp_id = pSystem_info->pComp_ids_needed[j];
             exec_internals.pComp_arr_strides[j] =
-                pLayout->pComp_arr_strides[prefix_popcnt + rank_in_word];
+                LayoutCompStride(pLayout, comp_id);
+            exec_internals.ppSparse_dispatches[j] =
+                COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_SPARSE
+                    ? LayoutFindSparseSet(pLayout, comp_id)
+                    : NULL;
+        }
+        exec_internals.prev_ofs = pLayout->double_size;
+        /*
+         * Inc tags are guaranteed to be in the layout, exc tags are not since
+         * they don't exclude a layout. Exc tags the layout lacks are skipped.
+         */
+        exec_internals.tag_filter_count = 0;
+        for (PRP_Size j = 0; j < pSystem_instance->tag_filter_count; j++) {
+            FECS_CompId tag_id = pSystem_instance->pTag_filter_ids[j];
+            if (CONT_BitmapIsSetUnchecked(pLayout->pComp_set, tag_id)) {
+                exec_internals
+                    .pTag_filter_strides[exec_internals.tag_filter_count++] =
+                    LayoutCompStride(pLayout, tag_id);
+            }
         }
 
-        CONT_ArrForEachUnchecked(pLayout->pChunk_ptrs, ExecCb, &exec_internals);
+        PRP_Result code = ExecMakeUnique(&exec_internals, pLayout);
+        if (code != PRP_OK) {
+            return code;
+        }
+        if (exec_internals.batch_func) {
+            ExecBatched(&exec_internals, pLayout);
+        } else {
+            for (PRP_Size c = 0; c < CHUNK_DIR_LEN(&pLayout->chunk_dir); c++) {
+                ExecChunk(&exec_internals,
+                          CHUNK_DIR_AT(&pLayout->chunk_dir, c));
+            }
+        }
     }
+#ifdef PRP_FECS_SYSTEM_STATS
+    PRP_TimeTicks exec_ticks = PRP_TimeNow() - start_ticks;
+    pSystem_instance->stats.exec_count++;
+    pSystem_instance->stats.last_exec_ticks = exec_ticks;
+    pSystem_instance->stats.total_exec_ticks += exec_ticks;
+#endif
+
+    return PRP_OK;
+}
+
+PRP_Result SystemInstanceGetStats(const FECS_World *pWorld,
+                                  FECS_SystemInstanceId system_instance_id,
+                                  FECS_SystemStats *pStats) {
+#ifdef PRP_FECS_SYSTEM_STATS
+    *pStats = pWorld->pSystem_instances[system_instance_id].stats;
+
+    return PRP_OK;
+#else
+    (void)pWorld;
+    (void)system_instance_id;
+    *pStats = (FECS_SystemStats){0};
+
+    return PRP_ERR_UNSUPPORTED;
+#endif
 }
 
 void *
 SystemInstanceFetchComp(const FECS_SystemExecInternalData *pExec_internals,
                         PRP_Size idx) {
-    if (idx >= pExec_internals->stides_len) {
+    if (idx >= pExec_internals->stides_len || !pExec_internals->pChunk_mem) {
         return NULL;
     }
 
     return pExec_internals->pChunk_mem +
            pExec_internals->pComp_arr_strides[idx];
 }
+
+void *SystemInstanceFetchBatchComp(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size chunk_idx,
+    PRP_Size idx) {
+    if (idx >= pExec_internals->stides_len ||
+        chunk_idx >= pExec_internals->batch_count) {
+        return NULL;
+    }
+
+    return pExec_internals->pBatch_chunk_mems[chunk_idx] +
+           pExec_internals->pComp_arr_strides[idx];
+}
+
+void *
+SystemInstanceFetchPrevComp(const FECS_SystemExecInternalData *pExec_internals,
+                            PRP_Size chunk_idx, PRP_Size idx) {
+    if (idx >= pExec_internals->stides_len ||
+        COMP_STORAGE(pExec_internals->pComp_ids[idx]) !=
+            FECS_COMP_STORAGE_DOUBLE) {
+        return NULL;
+    }
+    PRP_U8 *pChunk_mem;
+    if (chunk_idx == PRP_INVALID_INDEX) {
+        pChunk_mem = pExec_internals->pChunk_mem;
+    } else {
+        pChunk_mem = chunk_idx < pExec_internals->batch_count
+                         ? pExec_internals->pBatch_chunk_mems[chunk_idx]
+                         : NULL;
+    }
+    if (!pChunk_mem) {
+        return NULL;
+    }
+
+    return pChunk_mem + pExec_internals->pComp_arr_strides[idx] +
+           pExec_internals->prev_ofs;
+}
+
+void *
+SystemInstanceFetchSparse(const FECS_SystemExecInternalData *pExec_internals,
+                          PRP_Size idx, PRP_Size slot) {
+    if (idx >= pExec_internals->stides_len || slot >= CHUNK_CAP ||
+        !pExec_internals->pChunk_mem) {
+        return NULL;
+    }
+    FECS_SparseSet *pSparse_set = pExec_internals->ppSparse_dispatches[idx];
+    if (!pSparse_set) {
+        return NULL;
+    }
+    const FECS_ChunkSparseMap *pMap =
+        (const FECS_ChunkSparseMap *)(pExec_internals->pChunk_mem +
+                                      pExec_internals->pComp_arr_strides[idx]);
+    if (!PRP_BIT_IS_SET(pMap->presence_bitset, BIT_MASK(slot))) {
+        return NULL;
+    }
+
+    return CONT_ArrGetUnchecked(pSparse_set->pDense, pMap->dense_idxs[slot]);
+}
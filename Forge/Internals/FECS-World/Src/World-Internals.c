@@ -1,4 +1,5 @@
 #include "Forge/Internals/FECS-World/World-Internals.h"
+#include "Forge/Internals/FECS/FECS-Internals.h"
 
 /**
  * Initializes the world struct to accomodate for entire create info.
@@ -11,6 +12,17 @@
  */
 static PRP_Result WorldInit(FECS_WorldCreateInfo *pCreate_info,
                             FECS_World *pWorld);
+/**
+ * Sets the defaults a layout was declared with in the world file.
+ *
+ * @param pLayout      The layout to set the defaults of.
+ * @param pDefault_ids The FECS_CompDefaultId's to set.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result WorldSetLayoutDefaults(FECS_Layout *pLayout,
+                                         const CONT_Arr *pDefault_ids);
 
 PRP_Result WorldDeleteCb(void *pWorld) {
     FECS_World *pWorld_instance = pWorld;
@@ -33,6 +45,12 @@ PRP_Result WorldDeleteCb(void *pWorld) {
     if (pWorld_instance->pSystem_instance_names) {
         CONT_StrArrDeleteUnchecked(&pWorld_instance->pSystem_instance_names);
     }
+    if (pWorld_instance->pHierarchy) {
+        HierarchyDelete(&pWorld_instance->pHierarchy);
+    }
+    if (pWorld_instance->pSpatial) {
+        SpatialDelete(&pWorld_instance->pSpatial);
+    }
 #ifdef PRP_DEBUG_MODE
     pWorld_instance->pLayouts = NULL;
     pWorld_instance->pSystem_instances = NULL;
@@ -80,6 +98,24 @@ static PRP_Result WorldInit(FECS_WorldCreateInfo *pCreate_info,
     return PRP_OK;
 }
 
+static PRP_Result WorldSetLayoutDefaults(FECS_Layout *pLayout,
+                                         const CONT_Arr *pDefault_ids) {
+    PRP_Size len;
+    const FECS_CompDefaultId *pIds = CONT_ArrRawUnchecked(pDefault_ids, &len);
+    for (PRP_Size i = 0; i < len; i++) {
+        const FECS_CompDefault *pComp_default =
+            CONT_ArrGetUnchecked(g_ctx->pComp_defaults, pIds[i]);
+        // The resolver made sure the comp is a column comp of the layout.
+        PRP_Result code = LayoutSetDefault(pLayout, pComp_default->comp_id,
+                                           pComp_default->pData);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return PRP_OK;
+}
+
 PRP_Result WorldCreate(FECS_WorldCreateInfo *pCreate_info, FECS_World *pWorld) {
     PRP_Size layout_create_info_idx = 0;
     PRP_Size system_instance_create_info_idx = 0;
@@ -102,6 +138,18 @@ PRP_Result WorldCreate(FECS_WorldCreateInfo *pCreate_info, FECS_World *pWorld) {
                 layout_create_info_idx = i + 1;
                 goto free_create_info;
             }
+            if (pCreate_info->ppLayout_defaults[i]) {
+                code = WorldSetLayoutDefaults(
+                    &pLayouts[i], pCreate_info->ppLayout_defaults[i]);
+                if (code != PRP_OK) {
+                    // The layout took its create info, so it is deleted too.
+                    pWorld->layout_count = i + 1;
+                    WorldDeleteCb(pWorld);
+
+                    layout_create_info_idx = i + 1;
+                    goto free_create_info;
+                }
+            }
         }
         layout_create_info_idx = PRP_INVALID_INDEX;
         // If this point is reached all layouts are initializes.
@@ -138,10 +186,19 @@ free_create_info:
              i < pCreate_info->system_instance_count; i++) {
             free(pCreate_info->pSystem_instance_create_infos[i]
                      .pLayout_id_matches);
+            free(pCreate_info->pSystem_instance_create_infos[i]
+                     .pTag_filter_ids);
         }
     }
     // The names arrays are freed by the WorldDelCb.
     // This is always true regardless of where and when the failure occured.
+    for (PRP_Size i = 0; i < pCreate_info->layout_count; i++) {
+        if (pCreate_info->ppLayout_defaults[i]) {
+            CONT_ArrDeleteUnchecked(&pCreate_info->ppLayout_defaults[i]);
+        }
+    }
+    free(pCreate_info->ppLayout_defaults);
+    pCreate_info->ppLayout_defaults = NULL;
     free(pCreate_info->ppLayout_create_infos);
     pCreate_info->ppLayout_create_infos = NULL;
     free(pCreate_info->pSystem_instance_create_infos);
@@ -174,3 +231,158 @@ FECS_SystemInstanceId WorldFindSystemInstance(const FECS_World *pWorld,
 
     return (FECS_SystemInstanceId)idx;
 }
+
+void WorldGetMemoryStats(const FECS_World *pWorld,
+                         FECS_WorldMemoryStats *pStats) {
+    *pStats = (FECS_WorldMemoryStats){0};
+
+    pStats->layout_count = pWorld->layout_count;
+    pStats->layout_bytes = sizeof(FECS_Layout) * pWorld->layout_count;
+    for (PRP_Size i = 0; i < pWorld->layout_count; i++) {
+        FECS_LayoutMemoryStats layout_stats;
+        LayoutGetMemoryStats(&pWorld->pLayouts[i], &layout_stats);
+        pStats->chunk_count += layout_stats.chunk_count;
+        pStats->empty_chunk_count += layout_stats.empty_chunk_count;
+        pStats->alive_entity_count += layout_stats.alive_entity_count;
+        pStats->slot_count += layout_stats.slot_count;
+        pStats->layout_bytes += layout_stats.total_bytes;
+    }
+
+    pStats->system_instance_bytes =
+        sizeof(FECS_SystemInstance) * pWorld->system_instance_count;
+    for (PRP_Size i = 0; i < pWorld->system_instance_count; i++) {
+        const FECS_SystemInstance *pSystem_instance =
+            &pWorld->pSystem_instances[i];
+        const FECS_SystemInfo *pSystem_info = CONT_ArrGetUnchecked(
+            g_ctx->pSystem_infos, pSystem_instance->system_id);
+        pStats->system_instance_bytes +=
+            pSystem_info->comp_ids_needed_count *
+                (sizeof(PRP_Size) + sizeof(FECS_SparseSet *)) +
+            pSystem_instance->layout_id_match_count * sizeof(FECS_LayoutId) +
+            pSystem_instance->tag_filter_count *
+                (sizeof(FECS_CompId) + sizeof(PRP_Size));
+    }
+
+    if (pWorld->pHierarchy) {
+        pStats->hierarchy_bytes = HierarchyMemoryBytes(pWorld->pHierarchy);
+    }
+    if (pWorld->pSpatial) {
+        pStats->spatial_bytes = SpatialMemoryBytes(pWorld->pSpatial);
+    }
+    // Name arrays are freed at load when their section is empty.
+    if (pWorld->layout_count) {
+        pStats->name_bytes += CONT_StrArrAllocSize(pWorld->pLayout_names);
+    }
+    if (pWorld->system_instance_count) {
+        pStats->name_bytes +=
+            CONT_StrArrAllocSize(pWorld->pSystem_instance_names);
+    }
+
+    pStats->total_bytes = sizeof(FECS_World) + pStats->layout_bytes +
+                          pStats->system_instance_bytes +
+                          pStats->hierarchy_bytes + pStats->spatial_bytes +
+                          pStats->name_bytes;
+}
+
+PRP_Result WorldSwapBuffers(FECS_World *pWorld) {
+    for (PRP_Size i = 0; i < pWorld->layout_count; i++) {
+        PRP_Result code = LayoutSwapBuffers(&pWorld->pLayouts[i]);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return PRP_OK;
+}
+
+PRP_Result WorldCompressIdleChunks(FECS_World *pWorld) {
+    PRP_Result code = PRP_OK;
+    for (PRP_Size i = 0; i < pWorld->layout_count; i++) {
+        // A layout out of memory shouldn't keep the others from compressing.
+        PRP_Result layout_code = LayoutCompressIdleChunks(&pWorld->pLayouts[i]);
+        if (layout_code != PRP_OK) {
+            code = layout_code;
+        }
+    }
+
+    return code;
+}
+
+PRP_Bool WorldHasSpawnCtxs(const FECS_World *pWorld) {
+    for (PRP_Size i = 0; i < pWorld->layout_count; i++) {
+        if (pWorld->pLayouts[i].spawn_ctx_count) {
+            return PRP_True;
+        }
+    }
+
+    return PRP_False;
+}
+
+PRP_Result WorldFork(FECS_World *pWorld, FECS_Fork **ppFork) {
+    if (WorldHasSpawnCtxs(pWorld)) {
+        return PRP_ERR_BUSY;
+    }
+    FECS_Fork *pFork = malloc(sizeof(FECS_Fork) +
+                              sizeof(FECS_LayoutFork) * pWorld->layout_count);
+    if (!pFork) {
+        return PRP_ERR_OOM;
+    }
+    pFork->world_id = PRP_INVALID_INDEX;
+    pFork->layout_count = 0;
+    for (PRP_Size i = 0; i < pWorld->layout_count; i++) {
+        PRP_Result code =
+            LayoutFork(&pWorld->pLayouts[i], &pFork->pLayouts[i]);
+        if (code != PRP_OK) {
+            ForkDelete(&pFork);
+            return code;
+        }
+        pFork->layout_count++;
+    }
+    *ppFork = pFork;
+
+    return PRP_OK;
+}
+
+PRP_Result WorldRestore(FECS_World *pWorld, const FECS_Fork *pFork) {
+    // Restoring replaces the chunk dirs the contexts reserved chunks in.
+    if (WorldHasSpawnCtxs(pWorld)) {
+        return PRP_ERR_BUSY;
+    }
+    /*
+     * The fork is cloned first so it stays restorable, and so that running out
+     * of memory happens before the world is touched.
+     */
+    FECS_LayoutFork *pClones =
+        malloc(sizeof(FECS_LayoutFork) * (pFork->layout_count + 1));
+    if (!pClones) {
+        return PRP_ERR_OOM;
+    }
+    for (PRP_Size i = 0; i < pFork->layout_count; i++) {
+        PRP_Result code = LayoutForkClone(&pFork->pLayouts[i], &pClones[i]);
+        if (code != PRP_OK) {
+            while (i--) {
+                LayoutForkDelete(&pClones[i]);
+            }
+            free(pClones);
+            return code;
+        }
+    }
+    for (PRP_Size i = 0; i < pFork->layout_count; i++) {
+        LayoutRestore(&pWorld->pLayouts[i], &pClones[i]);
+        if (pWorld->pSpatial) {
+            SpatialMarkLayoutDirty(pWorld->pSpatial, i);
+        }
+    }
+    free(pClones);
+
+    return PRP_OK;
+}
+
+void ForkDelete(FECS_Fork **ppFork) {
+    FECS_Fork *pFork = *ppFork;
+    for (PRP_Size i = 0; i < pFork->layout_count; i++) {
+        LayoutForkDelete(&pFork->pLayouts[i]);
+    }
+    free(pFork);
+    *ppFork = NULL;
+}
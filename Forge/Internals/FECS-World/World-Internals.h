@@ -8,6 +8,10 @@ extern "C" {
 #include "Containers/StringArr.h"
 #include "Core/Diagnostics/Assert/Assert.h"
 #include "Forge/Internals/Typedefs.h"
+#include "Math/Matrix/Mat4/Defs.h"
+#include "Math/Vector/Vec3.h"
+
+#include <stdatomic.h>
 
 /**
  * All function declared in this header expect all the parameter to be valid and
@@ -27,6 +31,16 @@ typedef struct FECS_SystemInstanceCreateInfo {
      * in the FECS_SystemInfo.
      */
     PRP_Size stride_dispatch_count;
+    /*
+     * Tag components the system instance filters entities on. The first
+     * inc_tag_count entries are include tags, the rest are exclude tags.
+     * Sparse comps are filtered the exact same way since their
+     * FECS_ChunkSparseMap starts with a slot mask, so they are listed here too.
+     * Same ownership contract as pLayout_id_matches.
+     */
+    PRP_Size tag_filter_count;
+    PRP_Size inc_tag_count;
+    FECS_CompId *pTag_filter_ids;
 } FECS_SystemInstanceCreateInfo;
 
 typedef struct FECS_WorldCreateInfo {
@@ -36,6 +50,12 @@ typedef struct FECS_WorldCreateInfo {
     // These will be taken ownership of by the world.
     // Caller must not destroy or access after successful WorldCreate().
     CONT_StrArr *pLayout_names;
+    /*
+     * Parallel to ppLayout_create_infos, the FECS_CompDefaultId's each layout
+     * spawns its entities with, NULL for layouts without defaults.
+     * These will be freed.
+     */
+    CONT_Arr **ppLayout_defaults;
 
     PRP_Size system_instance_count;
     // These will be freed.
@@ -50,28 +70,280 @@ typedef struct FECS_WorldCreateInfo {
 #define CHUNK_CAP (64)
 typedef PRP_U64 FECS_ChunkFreeSlotType;
 
+typedef struct FECS_ChunkFile FECS_ChunkFile;
+
 typedef struct FECS_Chunk {
     PRP_U32 gens[CHUNK_CAP];
     FECS_ChunkFreeSlotType free_slot_bitset;
+    /*
+     * Set bits are slots systems run on, entities are enabled on spawn. Bits
+     * of free slots are meaningless, they are always masked by
+     * free_slot_bitset first.
+     */
+    FECS_ChunkFreeSlotType enabled_slot_bitset;
+    /*
+     * Number of layouts and world forks holding the chunk. A chunk held more
+     * than once is copied by LayoutChunkMakeUnique before being written.
+     */
+    PRP_Size ref_count;
+    /*
+     * The file the chunk is mapped from, NULL if it is on the heap. Local to
+     * the process like the ref count.
+     */
+    FECS_ChunkFile *pFile;
+    /*
+     * FECS_Layout::frame of the last access, local like the above. Atomic as
+     * concurrent readers stamp it via LayoutChunkCompData, relaxed is enough.
+     */
+    _Atomic PRP_U32 access_frame;
+    /*
+     * Size of the compressed plain columns that replace the columns after
+     * LAYOUT_COLUMNS_OFS, 0 if the chunk isn't compressed. A compressed chunk
+     * is never mapped from a chunk file. It may be shared with forks, it is
+     * then only read, writers decompress it into a chunk of their own.
+     */
+    PRP_U32 packed_size;
     PRP_U8 pChunk_mem[];
 } FECS_Chunk;
 
 PRP_DIAG_STATIC_ASSERT(CHUNK_CAP == sizeof(PRP_U64) * 8,
                        "free_slot bit width must match CHUNK_CAP");
 
+// The first segment of a chunk directory, each next one is twice the last.
+#define CHUNK_DIR_FIRST_SEG_BITS (4)
+#define CHUNK_DIR_FIRST_SEG_CAP ((PRP_Size)1 << CHUNK_DIR_FIRST_SEG_BITS)
+// Enough segments for every idx a PRP_Size can hold.
+#define CHUNK_DIR_MAX_SEGS (sizeof(PRP_Size) * 8 - CHUNK_DIR_FIRST_SEG_BITS)
+// The number of chunk pointers the first seg_count segments hold.
+#define CHUNK_DIR_SEGS_CAP(seg_count)                                          \
+    ((((PRP_Size)1 << (seg_count)) - 1) << CHUNK_DIR_FIRST_SEG_BITS)
+
+/**
+ * The chunk pointers of a layout or fork, stored as a two level directory.
+ *
+ * Pointers live in segments that never move once allocated, segment s holds
+ * CHUNK_DIR_FIRST_SEG_CAP << s of them. Their table is stored inline and
+ * covers every idx, so it never grows either. The segment of an idx is the
+ * highest set bit of idx + CHUNK_DIR_FIRST_SEG_CAP, a lookup is a bit scan,
+ * a shift and two loads. New segments and len are published with release
+ * stores, so other threads may look chunks up while the owning thread
+ * appends, as long as they bound idx by CHUNK_DIR_LEN().
+ *
+ * @note:
+ * - Segments are only freed by ChunkDirDelete(), never on pop.
+ * - A zeroed directory is a valid empty directory.
+ * - Only appends are safe against concurrent lookups. Replacing the chunk
+ *   pointer at an idx frees the old chunk (unsharing, compressing, moving to
+ *   a chunk file, see LayoutChunkMakeUnique()), so it must not race lookups
+ *   of that idx.
+ */
+typedef struct FECS_ChunkDir {
+    _Atomic PRP_Size len;
+    PRP_Size seg_count;
+    FECS_Chunk **_Atomic ppSegs[CHUNK_DIR_MAX_SEGS];
+} FECS_ChunkDir;
+
+// FECS_ChunkDir::len, safe to call while the owning thread appends.
+#define CHUNK_DIR_LEN(pDir)                                                    \
+    atomic_load_explicit(&(pDir)->len, memory_order_acquire)
+
+// The chunk pointer at idx, idx must be < CHUNK_DIR_LEN().
+#define CHUNK_DIR_AT(pDir, idx) (*ChunkDirSlot(pDir, idx))
+
+/**
+ * Finds the slot of the chunk pointer at an idx of a directory.
+ *
+ * @param pDir The directory.
+ * @param idx  The idx, must be < CHUNK_DIR_LEN().
+ *
+ * @return The slot in the segment of idx.
+ */
+static inline FECS_Chunk **ChunkDirSlot(const FECS_ChunkDir *pDir,
+                                        PRP_Size idx) {
+    PRP_Size pos = idx + CHUNK_DIR_FIRST_SEG_CAP;
+#ifdef PRP_COMPILER_MSVC
+    unsigned long msb;
+    _BitScanReverse64(&msb, pos);
+#else
+    PRP_Size msb = sizeof(PRP_Size) * 8 - 1 - (PRP_Size)__builtin_clzll(pos);
+#endif
+    FECS_Chunk **ppSeg = atomic_load_explicit(
+        &pDir->ppSegs[msb - CHUNK_DIR_FIRST_SEG_BITS], memory_order_acquire);
+
+    return &ppSeg[pos ^ ((PRP_Size)1 << msb)];
+}
+
+/**
+ * Appends a chunk pointer to the directory, allocating a segment if needed.
+ *
+ * @param pDir   The directory to push to.
+ * @param pChunk The chunk pointer to push.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result ChunkDirPush(FECS_ChunkDir *pDir, FECS_Chunk *pChunk);
+/**
+ * Allocates the segments for count more chunk pointers, so that pushing them
+ * can't fail.
+ *
+ * @param pDir  The directory to reserve in.
+ * @param count The number of pointers to make room for.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if len would overflow.
+ * @return PRP_ERR_OOM if allocation fails, the segments allocated are kept.
+ */
+PRP_Result ChunkDirReserve(FECS_ChunkDir *pDir, PRP_Size count);
+/**
+ * Removes the last chunk pointer of the directory, its segment is kept.
+ *
+ * @param pDir The directory to pop from, must not be empty.
+ *
+ * @return The popped chunk pointer.
+ */
+FECS_Chunk *ChunkDirPop(FECS_ChunkDir *pDir);
+/**
+ * Copies the chunk pointers of a directory into a new directory. The chunks
+ * themselves are not referenced.
+ *
+ * @param pSrc  The directory to clone.
+ * @param pDest Output pointer to the new directory.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, pDest is left empty.
+ */
+PRP_Result ChunkDirClone(const FECS_ChunkDir *pSrc, FECS_ChunkDir *pDest);
+/**
+ * Frees the segments of a directory and empties it. The chunks are not
+ * released.
+ *
+ * @param pDir The directory to delete.
+ */
+void ChunkDirDelete(FECS_ChunkDir *pDir);
+/**
+ * Finds the bytes the segments of a directory take.
+ *
+ * @param pDir The directory to measure.
+ *
+ * @return The size in bytes.
+ */
+PRP_Size ChunkDirMemoryBytes(const FECS_ChunkDir *pDir);
+
+/**
+ * Creates a file to map chunks of chunk_size from instead of the heap, so the
+ * kernel can write them out and drop them from RAM.
+ *
+ * @param pFile_path The path to create the file at.
+ * @param chunk_size FECS_Layout::chunk_total_size of the chunks.
+ * @param ppFile     Output pointer to the chunk file, holding one ref.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_ALREADY_EXISTS if a file exists at the path.
+ * @return PRP_ERR_IO if the file can't be created.
+ * @return PRP_ERR_UNSUPPORTED if the platform can't map files.
+ * @return PRP_ERR_OOM if allocation fails.
+ *
+ * @note:
+ * - The file is unlinked right away, it only lives as long as its chunks.
+ */
+PRP_Result ChunkFileCreate(const PRP_Char8 *pFile_path, PRP_Size chunk_size,
+                           FECS_ChunkFile **ppFile);
+/**
+ * Allocates a chunk in the file, growing the file if needed. Every allocated
+ * chunk holds a ref of the file.
+ *
+ * @param pFile The chunk file to allocate from.
+ *
+ * @return The uninitialized chunk, NULL if the file can't be grown.
+ */
+FECS_Chunk *ChunkFileAlloc(FECS_ChunkFile *pFile);
+/**
+ * Frees a chunk back to FECS_Chunk::pFile and releases its ref.
+ *
+ * @param pChunk The chunk to free.
+ */
+void ChunkFileFree(FECS_Chunk *pChunk);
+/**
+ * Releases a ref of a chunk file, deleting it once nothing holds it.
+ *
+ * @param pFile The chunk file to release.
+ */
+void ChunkFileRelease(FECS_ChunkFile *pFile);
+/**
+ * Writes a chunk out to FECS_Chunk::pFile and drops it from RAM, it is faulted
+ * back in on the next access.
+ *
+ * @param pChunk The chunk to page out.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_IO if the chunk can't be written out or remapped, it stays
+ *                    mapped as it was.
+ *
+ * @note:
+ * - The first page, holding the gens and slot masks, always stays resident.
+ */
+PRP_Result ChunkFilePageOut(FECS_Chunk *pChunk);
+
+/**
+ * Per chunk part of a sparse comp, this is the entity->dense index map keyed by
+ * the slot of the entity.
+ * The presence mask comes first so the stride of a sparse comp can be used as
+ * a slot mask exactly like a tag.
+ */
+typedef struct FECS_ChunkSparseMap {
+    FECS_ChunkFreeSlotType presence_bitset;
+    PRP_U32 dense_idxs[CHUNK_CAP];
+} FECS_ChunkSparseMap;
+
+/**
+ * Per layout part of a sparse comp.
+ * pDense stores the comp values packed, pDense_entity_idxs stores the
+ * entity_idx owning the value at the same index, used to patch the
+ * FECS_ChunkSparseMap on swap removal.
+ */
+typedef struct FECS_SparseSet {
+    FECS_CompId comp_id;
+    PRP_Size stride;
+    CONT_Arr *pDense;
+    CONT_Arr *pDense_entity_idxs;
+} FECS_SparseSet;
+
+/*
+ * Entry of a chunk in FECS_Layout::pShared_links. chain is the chain the chunk
+ * is linked in, prev and next its neighbours there, all PRP_INVALID_INDEX if
+ * none.
+ */
+typedef struct FECS_SharedLink {
+    PRP_Size chain;
+    PRP_Size prev;
+    PRP_Size next;
+} FECS_SharedLink;
+
+/*
+ * Entry of a component in FECS_Layout::pComps.
+ */
+typedef struct FECS_LayoutComp {
+    // Offset of the component's data from FECS_Chunk::pChunk_mem.
+    PRP_Size stride;
+    // Idx in FECS_Layout::pSparse_sets, PRP_INVALID_INDEX if not sparse.
+    PRP_Size sparse_idx;
+} FECS_LayoutComp;
+
 typedef struct FECS_Layout {
     CONT_Bitmap *pComp_set;
     /*
      * This stores the stride of each component's arrays the layout chunk
-     * stores. This is used to identify memory location of specific component
-     * arrays and component for entities.
+     * stores, and the sparse set of sparse comps. This is used to identify
+     * memory location of specific component arrays and component for
+     * entities.
      * Cap of this array is equal to:
      * CONT_BitmapSetCount(FECS_Layout::pComp_set);
      *
-     * And each stride entry corresponds to the corresponding bit set at that
+     * And each entry corresponds to the corresponding bit set at that
      * RANK in the pComp_set bitmap.
      */
-    PRP_Size *pComp_arr_strides;
+    FECS_LayoutComp *pComps;
     /**
      * Prefix population counts of FECS_Layout::pComp_set.
      *
@@ -93,11 +365,97 @@ typedef struct FECS_Layout {
      * max number of components that can be registered.
      */
     PRP_U16 *pWord_prefix_popcnts;
-    CONT_Arr *pChunk_ptrs;
+    FECS_ChunkDir chunk_dir;
     CONT_Bitmap *pFree_chunk_bitset;
     PRP_Size chunk_total_size;
+    // The file new chunks are mapped from, NULL if they go on the heap.
+    FECS_ChunkFile *pChunk_file;
+    /*
+     * Number of tag components in the layout. Tags don't get a component
+     * array, instead each tag gets a single FECS_ChunkFreeSlotType mask per
+     * chunk. All the tag masks are packed at the very start of
+     * FECS_Chunk::pChunk_mem, before any component array, so the stride of a
+     * tag is the offset of its mask.
+     */
+    PRP_Size tag_count;
+    /*
+     * Shared components are stored once per chunk, packed right after the tag
+     * masks in [shared_ofs, shared_ofs + shared_size). This block doubles as
+     * the key by which entities are grouped into chunks, every chunk holds
+     * entities with identical shared values.
+     * pShared_key is a scratch buffer of shared_size used to build the key of
+     * the entities being spawned, NULL if the layout has no shared comps.
+     * Keys are compared bytewise, so shared comps must not have padding.
+     */
+    PRP_Size shared_ofs;
+    PRP_Size shared_size;
+    PRP_U8 *pShared_key;
+    /*
+     * Free chunks of a layout with shared comps, chained by the hash of their
+     * key so that spawns find a chunk keyed with their values without
+     * comparing every free chunk. pShared_heads holds shared_bucket_count
+     * chain heads and a last one chaining the empty chunks, which any key may
+     * take. pShared_links has an entry per chunk below shared_link_cap.
+     * Chunks are linked as they gain a free slot or get keyed, and unlinked
+     * once found full. Calls that rewrite many chunks at once set
+     * is_shared_index_stale instead, the next spawn rebuilds the index.
+     */
+    PRP_Size *pShared_heads;
+    FECS_SharedLink *pShared_links;
+    PRP_Size shared_bucket_count;
+    PRP_Size shared_link_cap;
+    PRP_Bool is_shared_index_stale;
+    /*
+     * Sparse comps keep a FECS_ChunkSparseMap per chunk, packed after the
+     * shared values, and their values in the per layout sparse sets.
+     */
+    PRP_Size sparse_count;
+    FECS_SparseSet *pSparse_sets;
+    /*
+     * Double buffered comps keep their current columns packed after the
+     * sparse maps in [double_ofs, double_ofs + double_size), immediately
+     * followed by the previous frame copy of the whole block. The stride of a
+     * double buffered comp is its current column, the previous column is
+     * double_size past it, so a swap is a single copy per chunk.
+     */
+    PRP_Size double_ofs;
+    PRP_Size double_size;
+    /*
+     * Default values new entities are spawned with, laid out like a single
+     * slot of the column comps: every column in [double_ofs, chunk end) is
+     * CHUNK_CAP values long, so the default of a column at stride s lives at
+     * (s - double_ofs) / CHUNK_CAP. Double buffered comps keep their default
+     * in both copies.
+     * NULL until a default is set, spawned entities are uninitialized then.
+     */
+    PRP_U8 *pTemplate;
+    /*
+     * Live spawn contexts holding chunks of the layout. Their chunks must stay
+     * unique and uncompressed till they are deleted, so forks and compression
+     * wait for it to drop to 0.
+     */
+    PRP_Size spawn_ctx_count;
+    /*
+     * Chunk compression, see LayoutCompressIdleChunks. frame counts its calls,
+     * chunks not accessed for compress_idle_frames of them get their plain
+     * columns compressed, 0 if compression is disabled.
+     * pPack_scratch fits the plain columns twice, NULL while disabled.
+     * pRead_scratch is the same size and holds the column EntityGetComp last
+     * decompressed, allocated on its first compressed read.
+     */
+    PRP_U32 frame;
+    PRP_U32 compress_idle_frames;
+    PRP_U8 *pPack_scratch;
+    PRP_U8 *pRead_scratch;
 } FECS_Layout;
 
+/*
+ * Offset into FECS_Chunk::pChunk_mem of the plain columns, which run to the end
+ * of the chunk. Everything before them is never compressed.
+ */
+#define LAYOUT_COLUMNS_OFS(pLayout)                                            \
+    ((pLayout)->double_ofs + (pLayout)->double_size * 2)
+
 /**
  * Until entities are created, layouts have a relatively small memory footprint.
  * The primary factor affecting an empty layout's size is the number of
@@ -128,47 +486,633 @@ typedef struct FECS_Layout {
  */
 PRP_Result LayoutCreate(CONT_Bitmap *pCreate_info, FECS_Layout *pLayout);
 /**
- * Deletes internals-only of the existing layout.
+ * Deletes internals-only of the existing layout.
+ *
+ * @param pLayout The layout to delete internals of.
+ */
+void LayoutDelete(FECS_Layout *pLayout);
+/**
+ * Computes the stride of a component inside the chunks of a layout.
+ *
+ * @param pLayout The layout to compute the stride in.
+ * @param comp_id The component, must be present in the layout.
+ *
+ * @return The offset of the component's data from FECS_Chunk::pChunk_mem.
+ */
+PRP_Size LayoutCompStride(const FECS_Layout *pLayout, FECS_CompId comp_id);
+/**
+ * Finds the sparse set of a sparse comp inside a layout, in O(1) via the
+ * sparse idx of its entry in FECS_Layout::pComps.
+ *
+ * @param pLayout The layout to search in.
+ * @param comp_id The sparse comp to find.
+ *
+ * @return The sparse set, NULL if the layout doesn't have the sparse comp.
+ */
+FECS_SparseSet *LayoutFindSparseSet(const FECS_Layout *pLayout,
+                                    FECS_CompId comp_id);
+/**
+ * Builds the shared comp key for spawning entities inside the layout's key
+ * scratch buffer. Shared comps not provided are zero filled.
+ *
+ * @param pLayout           The layout to build the key for.
+ * @param shared_count      The len of pShared_comp_ids and ppShared_data.
+ * @param pShared_comp_ids  The shared comps to set.
+ * @param ppShared_data     The values of the shared comps.
+ * @param ppKey             Output pointer to the built key.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if a comp isn't a shared comp of the layout.
+ */
+PRP_Result LayoutBuildSharedKey(FECS_Layout *pLayout, PRP_Size shared_count,
+                                const FECS_CompId *pShared_comp_ids,
+                                const void *const *ppShared_data,
+                                const PRP_U8 **ppKey);
+/**
+ * Computes the memory footprint of a layout.
+ *
+ * @param pLayout The layout to compute the footprint of.
+ * @param pStats  Output pointer to the stats.
+ */
+void LayoutGetMemoryStats(const FECS_Layout *pLayout,
+                          FECS_LayoutMemoryStats *pStats);
+/**
+ * Copies the current values of every double buffered comp of a layout into
+ * their previous frame copies.
+ *
+ * @param pLayout The layout to swap.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+PRP_Result LayoutSwapBuffers(FECS_Layout *pLayout);
+/**
+ * Gives the layout its own copy of a chunk shared with a world fork, so that
+ * it can be written without the fork seeing the write. No-op for a chunk only
+ * the layout holds.
+ *
+ * @param pLayout   The layout the chunk belongs to.
+ * @param chunk_idx The chunk to make unique.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, the chunk stays shared.
+ *
+ * @note:
+ * - Also a LayoutChunkAccess, every write to a chunk goes through here.
+ */
+PRP_Result LayoutChunkMakeUnique(FECS_Layout *pLayout, PRP_Size chunk_idx);
+/**
+ * Marks a chunk accessed this frame of the layout and decompresses it if it
+ * is compressed, needed before writing its plain columns in place.
+ *
+ * @param pLayout   The layout the chunk belongs to.
+ * @param chunk_idx The chunk being accessed.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if decompressing fails, the chunk stays compressed.
+ *
+ * @note:
+ * - Decompressing replaces the chunk and uses FECS_Layout::pPack_scratch, so
+ *   it is only for the thread owning the world. Reads go through
+ *   LayoutChunkCompData.
+ */
+PRP_Result LayoutChunkAccess(FECS_Layout *pLayout, PRP_Size chunk_idx);
+/**
+ * Gets the values of a comp in a chunk for reading, slot 0 first, without
+ * changing the chunk. A compressed column is decompressed into *ppScratch.
+ *
+ * @param pLayout   The layout the chunk belongs to.
+ * @param chunk_idx The chunk being read.
+ * @param comp_id   A column, double buffered or shared comp of the layout.
+ * @param ppScratch Scratch of the caller, allocated here on the first
+ *                  compressed column. Freed by the caller and only reused for
+ *                  the same comp_id.
+ *
+ * @return The values of the comp, valid till the next call with the same
+ *         scratch. NULL if the scratch can't be allocated.
+ *
+ * @note:
+ * - The only write is a relaxed atomic store of the chunk's access_frame, so
+ *   any number of threads may read at once while the owning thread leaves
+ *   the world alone.
+ * - A compressed chunk read during a frame is decompressed for good by the
+ *   next LayoutCompressIdleChunks.
+ */
+const PRP_U8 *LayoutChunkCompData(const FECS_Layout *pLayout,
+                                  PRP_Size chunk_idx, FECS_CompId comp_id,
+                                  PRP_U8 **ppScratch);
+/**
+ * Gets a chunk of a layout, or of a fork of it, as it is decompressed,
+ * without changing it.
+ *
+ * @param pLayout   The layout the chunk belongs to.
+ * @param pChunk    The chunk to read.
+ * @param ppScratch Scratch of the caller, allocated here on the first
+ *                  compressed chunk. Freed by the caller and only reused for
+ *                  chunks of the same layout.
+ *
+ * @return pChunk if it isn't compressed, else its decompressed copy in
+ *         *ppScratch, valid till the next call with the same scratch. NULL if
+ *         the scratch can't be allocated.
+ */
+const FECS_Chunk *LayoutChunkUnpacked(const FECS_Layout *pLayout,
+                                      const FECS_Chunk *pChunk,
+                                      FECS_Chunk **ppScratch);
+/**
+ * Grows or shrinks the chunks of a layout to exactly chunk_count chunks. New
+ * chunks are empty, dropped chunks are released.
+ *
+ * @param pLayout     The layout to resize.
+ * @param chunk_count The number of chunks to end up with.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result LayoutResizeChunks(FECS_Layout *pLayout, PRP_Size chunk_count);
+/**
+ * Sets the default value entities of a layout are spawned with for a comp.
+ * Comps without a default start zeroed once the layout has any default.
+ *
+ * @param pLayout The layout to set the default of.
+ * @param comp_id The comp, must have a column.
+ * @param pData   The value, COMP_SIZE(comp_id) bytes are copied.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the layout doesn't have the comp.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result LayoutSetDefault(FECS_Layout *pLayout, FECS_CompId comp_id,
+                            const void *pData);
+/**
+ * Moves the chunks of a layout into a new chunk file, new chunks of the layout
+ * are mapped from it too.
+ *
+ * @param pLayout    The layout.
+ * @param pFile_path The path to create the file at, unused if the layout
+ *                   already has a chunk file.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_STATE if every chunk is in the layout's chunk file.
+ * @return PRP_ERR_ALREADY_EXISTS if a file exists at the path.
+ * @return PRP_ERR_IO if the file can't be created or grown, chunks moved
+ *                    before the failure stay in the file.
+ * @return PRP_ERR_UNSUPPORTED if the platform can't map files.
+ * @return PRP_ERR_OOM if allocation fails.
+ *
+ * @note:
+ * - A failure after the file is created leaves it set with the chunks moved
+ *   so far, calling again moves the rest into the same file.
+ */
+PRP_Result LayoutSetBackingFile(FECS_Layout *pLayout,
+                                const PRP_Char8 *pFile_path);
+/**
+ * Pages out every chunk of a layout that is mapped from a chunk file.
+ *
+ * @param pLayout The layout to page out.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_IO if a chunk can't be written out, the rest are still
+ *                    paged out.
+ */
+PRP_Result LayoutPageOut(FECS_Layout *pLayout);
+/**
+ * Enables or disables compression of the chunks of a layout that are not
+ * accessed for idle_frames calls to LayoutCompressIdleChunks.
+ *
+ * @param pLayout     The layout.
+ * @param idle_frames The number of frames, 0 to disable compression.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, disabling decompresses every chunk
+ *                     and may fail half way.
+ */
+PRP_Result LayoutSetCompression(FECS_Layout *pLayout, PRP_U32 idle_frames);
+/**
+ * Ends a frame of chunk compression, compressing the plain columns of every
+ * chunk idle for FECS_Layout::compress_idle_frames and decompressing the
+ * compressed chunks read during the frame. No-op if disabled.
+ *
+ * @param pLayout The layout.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if a chunk can't be allocated, it is left as it was.
+ *
+ * @note:
+ * - Skipped while spawn contexts of the layout are alive, the frame isn't
+ *   counted then.
+ */
+PRP_Result LayoutCompressIdleChunks(FECS_Layout *pLayout);
+/**
+ * Decompresses every compressed chunk of a layout.
+ *
+ * @param pLayout The layout.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails, chunks decompressed before the
+ *                     failure stay decompressed.
+ */
+PRP_Result LayoutDecompressChunks(FECS_Layout *pLayout);
+
+/* ----  FORKS ---- */
+
+/**
+ * The mutable state of a layout at the time it was forked. Chunks are held by
+ * reference, the sparse sets hold their own copy of the dense arrays.
+ */
+typedef struct FECS_LayoutFork {
+    FECS_ChunkDir chunk_dir;
+    CONT_Bitmap *pFree_chunk_bitset;
+    PRP_Size sparse_count;
+    FECS_SparseSet *pSparse_sets;
+} FECS_LayoutFork;
+
+/**
+ * Captures the mutable state of a layout, taking a reference to every chunk.
+ *
+ * @param pLayout The layout to fork.
+ * @param pFork   Output pointer to the fork.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result LayoutFork(const FECS_Layout *pLayout, FECS_LayoutFork *pFork);
+/**
+ * Clones a layout fork, taking another reference to every chunk.
+ *
+ * @param pSrc  The fork to clone.
+ * @param pDest Output pointer to the clone.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result LayoutForkClone(const FECS_LayoutFork *pSrc, FECS_LayoutFork *pDest);
+/**
+ * Deletes a layout fork, releasing its chunk references.
+ *
+ * @param pFork The fork to delete.
+ */
+void LayoutForkDelete(FECS_LayoutFork *pFork);
+/**
+ * Replaces the mutable state of a layout with a fork, releasing the current
+ * chunks. Takes ownership of the fork, never fails.
+ *
+ * @param pLayout The layout to restore.
+ * @param pFork   The fork to restore from, must come from this layout.
+ */
+void LayoutRestore(FECS_Layout *pLayout, FECS_LayoutFork *pFork);
+
+/* ----  SYSTEM INSTANCES ---- */
+
+typedef struct FECS_SystemInstance {
+    FECS_SystemId system_id;
+    PRP_Size layout_id_match_count;
+    FECS_LayoutId *pLayout_id_matches;
+    /**
+     * A preallocated buffer for all the strides of components to be loaded into
+     * at the start of each layout.
+     * This will be used during system execution to support how the user access
+     * the component.
+     *
+     * The len of this is exactly tied to system_id, and is exactly equal to the
+     * FECS_SystemInfo::comp_ids_needed_count.
+     */
+    PRP_Size *pStride_dispatches;
+    /*
+     * Same as pStride_dispatches, but stores the sparse set for sparse comps
+     * and NULL for every other comp.
+     */
+    FECS_SparseSet **ppSparse_dispatches;
+    /*
+     * Tag filter ids, first inc_tag_count are include tags, rest are exclude
+     * tags. pTag_filter_strides is a preallocated buffer of same len, loaded
+     * at the start of each layout like pStride_dispatches.
+     */
+    PRP_Size tag_filter_count;
+    PRP_Size inc_tag_count;
+    FECS_CompId *pTag_filter_ids;
+    PRP_Size *pTag_filter_strides;
+#ifdef PRP_FECS_SYSTEM_STATS
+    FECS_SystemStats stats;
+#endif
+} FECS_SystemInstance;
+
+/**
+ * Creates a fully defined system instance from the given create info.
+ *
+ * @param pCreate_info     The schema to what the system instance contains.
+ * @param pSystem_instance Output pointer to the newly created system instance.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if qllocation fails.
+ */
+PRP_Result SystemInstanceCreate(FECS_SystemInstanceCreateInfo *pCreate_info,
+                                FECS_SystemInstance *pSystem_instance);
+/**
+ * Deletes internals-only of the existing system instance.
+ *
+ * @param pSystem_instance The system instance to delete internals of.
+ */
+void SystemInstanceDelete(FECS_SystemInstance *pSystem_instance);
+
+/* ----  HIERARCHY ---- */
+
+/*
+ * Children links of a hierarchy node, all node ids, FECS_INVALID_ID if none.
+ */
+typedef struct FECS_HierarchyLink {
+    FECS_HierarchyNodeId first_child;
+    FECS_HierarchyNodeId prev_sibling;
+    FECS_HierarchyNodeId next_sibling;
+} FECS_HierarchyLink;
+
+/**
+ * A transform hierarchy of a world.
+ *
+ * Node ids are stable handles, pNode_poss maps them to their current position
+ * in the level ordered arrays. The level ordered arrays store the nodes sorted
+ * breadth first by depth, every level is a contiguous range
+ * [pLevel_ofss[l], pLevel_ofss[l + 1]), so parents of a level are always in
+ * the previous level and propagation is a linear sweep.
+ *
+ * Structural changes (add/remove/reparent) append/swap remove in the ordered
+ * arrays and clear is_ordered, the order is rebuilt once at the next
+ * propagation.
+ *
+ * pNode_links chains the children of every node by node id, since positions
+ * move on reorders and removals. Removing a node only walks its own children.
+ */
+typedef struct FECS_Hierarchy {
+    // Indexed by node id, NODE_POS_FREE if the id is free.
+    CONT_Arr *pNode_poss;
+    CONT_Arr *pFree_node_ids;
+    // Indexed by node id, a FECS_HierarchyLink each.
+    CONT_Arr *pNode_links;
+
+    PRP_Size node_count;
+    PRP_Size node_cap;
+    // Level ordered, indexed by position.
+    FECS_HierarchyNodeId *pNode_ids;
+    FECS_HierarchyNodeId *pParent_ids;
+    // Only valid while is_ordered.
+    PRP_U32 *pParent_poss;
+    PRP_U32 *pDepths;
+    MATH_Mat4 *pLocals;
+    MATH_Mat4 *pWorlds;
+    PRP_U8 *pDirty;
+
+    PRP_Size level_count;
+    PRP_Size *pLevel_ofss;
+    PRP_Bool is_ordered;
+
+    // Number of nodes marked dirty by the user and the min level among them.
+    PRP_Size dirty_count;
+    PRP_Size dirty_level_min;
+} FECS_Hierarchy;
+
+/**
+ * Creates an empty hierarchy.
+ *
+ * @param ppHierarchy Output pointer to the new hierarchy.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result HierarchyCreate(FECS_Hierarchy **ppHierarchy);
+/**
+ * Deletes a hierarchy and nullifies the pointer.
+ *
+ * @param ppHierarchy The hierarchy to delete.
+ */
+void HierarchyDelete(FECS_Hierarchy **ppHierarchy);
+/**
+ * Checks if the given node id is alive in the hierarchy.
+ *
+ * @param pHierarchy The hierarchy to check in.
+ * @param node       The node id to check.
+ *
+ * @return PRP_True if valid, PRP_False otherwise.
+ */
+PRP_Bool HierarchyNodeIsValid(const FECS_Hierarchy *pHierarchy,
+                              FECS_HierarchyNodeId node);
+/**
+ * Adds a new node to the hierarchy.
+ *
+ * @param pHierarchy The hierarchy to add to.
+ * @param parent     A valid parent node or FECS_INVALID_ID for a root.
+ * @param pLocal     The local transform of the node.
+ * @param pNode      Output pointer to the node id.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result HierarchyAddNode(FECS_Hierarchy *pHierarchy,
+                            FECS_HierarchyNodeId parent,
+                            const MATH_Mat4 *pLocal,
+                            FECS_HierarchyNodeId *pNode);
+/**
+ * Removes a valid node from the hierarchy, its children become roots with
+ * their cached world transform as their local.
+ *
+ * @param pHierarchy The hierarchy to remove from.
+ * @param node       The node to remove.
+ */
+void HierarchyRemoveNode(FECS_Hierarchy *pHierarchy, FECS_HierarchyNodeId node);
+/**
+ * Reparents a valid node.
+ *
+ * @param pHierarchy The hierarchy the node belongs to.
+ * @param node       The node to reparent.
+ * @param parent     A valid parent node or FECS_INVALID_ID to make it a root.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if parent is the node itself or its descendant.
+ */
+PRP_Result HierarchySetParent(FECS_Hierarchy *pHierarchy,
+                              FECS_HierarchyNodeId node,
+                              FECS_HierarchyNodeId parent);
+/**
+ * Sets the local transform of a valid node and marks its subtree dirty.
+ *
+ * @param pHierarchy The hierarchy the node belongs to.
+ * @param node       The node to set.
+ * @param pLocal     The local transform.
+ */
+void HierarchySetLocal(FECS_Hierarchy *pHierarchy, FECS_HierarchyNodeId node,
+                       const MATH_Mat4 *pLocal);
+/**
+ * Fetches the world transform of a valid node as of the last propagation.
+ *
+ * @param pHierarchy The hierarchy the node belongs to.
+ * @param node       The node to fetch.
+ *
+ * @return Pointer to the world transform, valid until the next structural
+ *         change or propagation.
+ */
+const MATH_Mat4 *HierarchyGetWorld(const FECS_Hierarchy *pHierarchy,
+                                   FECS_HierarchyNodeId node);
+/**
+ * Propagates local transforms into world transforms in level order,
+ * recomputing only the dirty subtrees.
+ *
+ * @param pHierarchy The hierarchy to propagate.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if rebuilding the level order fails, the hierarchy is
+ *                     left untouched.
+ */
+PRP_Result HierarchyPropagate(FECS_Hierarchy *pHierarchy);
+/**
+ * Computes the bytes allocated by a hierarchy.
+ *
+ * @param pHierarchy The hierarchy to compute the footprint of.
+ *
+ * @return The allocated bytes.
+ */
+PRP_Size HierarchyMemoryBytes(const FECS_Hierarchy *pHierarchy);
+
+/* ----  SPATIAL ---- */
+
+typedef struct FECS_SpatialItem {
+    // Position as of the last update, queries test against this.
+    MATH_Vec3 pos;
+    PRP_U32 layout_id;
+    PRP_U32 entity_idx;
+} FECS_SpatialItem;
+
+typedef struct FECS_SpatialCell {
+    PRP_I32 x, y, z;
+    PRP_U32 item_count;
+    PRP_U32 item_cap;
+    FECS_SpatialItem *pItems;
+} FECS_SpatialCell;
+
+/**
+ * Per layout tracking state of the grid, the per slot arrays are indexed by
+ * entity_idx and the per chunk masks by chunk idx.
+ */
+typedef struct FECS_SpatialLayout {
+    PRP_Bool is_tracked;
+    // Number of chunks the arrays below fit.
+    PRP_Size chunk_cap;
+    // Gen of the slot as of the last update, only valid if tracked.
+    PRP_U32 *pGens;
+    PRP_U32 *pCell_idxs;
+    PRP_U32 *pItem_idxs;
+    // Slots currently in the grid.
+    FECS_ChunkFreeSlotType *pTracked;
+    // Slots whose position has to be re-read at the next update.
+    FECS_ChunkFreeSlotType *pDirty;
+} FECS_SpatialLayout;
+
+/**
+ * A uniform hash grid over a position comp of a world.
+ *
+ * Cells are stored densely in pCells, pTable is an open addressing hash table
+ * of cell idxs keyed by cell coords. Cells are never removed, an emptied cell
+ * keeps its slot for the next entity moving in.
+ *
+ * The grid is synced lazily by SpatialUpdate: spawns and kills are found by
+ * comparing chunk occupancy and gens against the tracked state, position
+ * changes have to be marked dirty.
+ */
+typedef struct FECS_Spatial {
+    FECS_CompId pos_comp_id;
+    PRP_F32 cell_size;
+    PRP_F32 inv_cell_size;
+
+    // Indexed by layout id.
+    PRP_Size layout_count;
+    FECS_SpatialLayout *pLayouts;
+
+    PRP_Size cell_count;
+    PRP_Size cell_cap;
+    FECS_SpatialCell *pCells;
+    // Power of 2, SPATIAL_TABLE_EMPTY or a cell idx.
+    PRP_Size table_cap;
+    PRP_U32 *pTable;
+
+    PRP_Size item_count;
+} FECS_Spatial;
+
+/**
+ * Creates an empty grid over the given position comp, every layout with the
+ * comp is tracked from the next update.
+ *
+ * @param pLayouts     The layouts of the world to create the grid for.
+ * @param layout_count The number of layouts.
+ * @param pos_comp_id  A column or double buffered comp starting with a
+ *                     MATH_Vec3.
+ * @param cell_size    The edge length of a cell, finite and > 0.
+ * @param ppSpatial    Output pointer to the new grid.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result SpatialCreate(const FECS_Layout *pLayouts, PRP_Size layout_count,
+                         FECS_CompId pos_comp_id, PRP_F32 cell_size,
+                         FECS_Spatial **ppSpatial);
+/**
+ * Deletes a grid and nullifies the pointer.
+ *
+ * @param ppSpatial The grid to delete.
+ */
+void SpatialDelete(FECS_Spatial **ppSpatial);
+/**
+ * Marks a valid entity to have its position re-read at the next update.
+ *
+ * @param pSpatial The grid.
+ * @param entity   The entity to mark.
+ */
+void SpatialMarkDirty(FECS_Spatial *pSpatial, FECS_EntityId entity);
+/**
+ * Marks every entity of a layout to have its position re-read at the next
+ * update.
  *
- * @param pLayout The layout to delete internals of.
+ * @param pSpatial  The grid.
+ * @param layout_id The layout to mark.
  */
-void LayoutDelete(FECS_Layout *pLayout);
-
-/* ----  SYSTEM INSTANCES ---- */
-
-typedef struct FECS_SystemInstance {
-    FECS_SystemId system_id;
-    PRP_Size layout_id_match_count;
-    FECS_LayoutId *pLayout_id_matches;
-    /**
-     * A preallocated buffer for all the strides of components to be loaded into
-     * at the start of each layout.
-     * This will be used during system execution to support how the user access
-     * the component.
-     *
-     * The len of this is exactly tied to system_id, and is exactly equal to the
-     * FECS_SystemInfo::comp_ids_needed_count.
-     */
-    PRP_Size *pStride_dispatches;
-} FECS_SystemInstance;
-
+void SpatialMarkLayoutDirty(FECS_Spatial *pSpatial, FECS_LayoutId layout_id);
 /**
- * Creates a fully defined system instance from the given create info.
+ * Syncs the grid with the world: inserts spawned entities, removes killed ones
+ * and moves dirty ones between cells.
  *
- * @param pCreate_info     The schema to what the system instance contains.
- * @param pSystem_instance Output pointer to the newly created system instance.
+ * @param pSpatial The grid.
+ * @param pLayouts The layouts the grid was created for.
  *
  * @return PRP_OK on success.
- * @return PRP_ERR_OOM if qllocation fails.
+ * @return PRP_ERR_OOM if allocation fails, entities that couldn't be inserted
+ *                     or read from a compressed chunk are retried at the next
+ *                     update.
  */
-PRP_Result SystemInstanceCreate(FECS_SystemInstanceCreateInfo *pCreate_info,
-                                FECS_SystemInstance *pSystem_instance);
+PRP_Result SpatialUpdate(FECS_Spatial *pSpatial, const FECS_Layout *pLayouts);
 /**
- * Deletes internals-only of the existing system instance.
+ * Finds the entities inside an AABB, and optionally a sphere, as of the last
+ * update.
  *
- * @param pSystem_instance The system instance to delete internals of.
+ * @param pSpatial The grid.
+ * @param pMin     The min corner of the AABB.
+ * @param pMax     The max corner of the AABB.
+ * @param pCenter  The sphere center or NULL to only test the AABB.
+ * @param radius   The sphere radius, ignored if pCenter is NULL.
+ * @param pOut     Output array of entity ids, may be NULL if out_cap is 0.
+ * @param out_cap  The number of ids pOut fits.
+ * @param pCount   Output pointer to the number of entities found, which can
+ *                 be more than out_cap.
  */
-void SystemInstanceDelete(FECS_SystemInstance *pSystem_instance);
+void SpatialQuery(const FECS_Spatial *pSpatial, const MATH_Vec3 *pMin,
+                  const MATH_Vec3 *pMax, const MATH_Vec3 *pCenter,
+                  PRP_F32 radius, FECS_EntityId *pOut, PRP_Size out_cap,
+                  PRP_Size *pCount);
+/**
+ * Computes the bytes allocated by a grid.
+ *
+ * @param pSpatial The grid to compute the footprint of.
+ *
+ * @return The allocated bytes.
+ */
+PRP_Size SpatialMemoryBytes(const FECS_Spatial *pSpatial);
 
 /* ----  WORLD ---- */
 
@@ -180,6 +1124,11 @@ typedef struct FECS_World {
     PRP_Size system_instance_count;
     FECS_SystemInstance *pSystem_instances;
     CONT_StrArr *pSystem_instance_names;
+
+    // Created on first use, NULL till then.
+    FECS_Hierarchy *pHierarchy;
+    // NULL till FECS_SpatialBind.
+    FECS_Spatial *pSpatial;
 } FECS_World;
 
 /**
@@ -228,30 +1177,114 @@ FECS_LayoutId WorldFindLayout(const FECS_World *pWorld, const PRP_Char8 *pName,
 FECS_SystemInstanceId WorldFindSystemInstance(const FECS_World *pWorld,
                                               const PRP_Char8 *pName,
                                               PRP_Size name_len);
+/**
+ * Computes the memory footprint of a world.
+ *
+ * @param pWorld The world to compute the footprint of.
+ * @param pStats Output pointer to the stats.
+ */
+void WorldGetMemoryStats(const FECS_World *pWorld,
+                         FECS_WorldMemoryStats *pStats);
+/**
+ * Ends the frame of every double buffered comp of the world, the current
+ * values become the previous frame values.
+ *
+ * @param pWorld The world to swap.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+PRP_Result WorldSwapBuffers(FECS_World *pWorld);
+/**
+ * LayoutCompressIdleChunks over every layout of the world.
+ *
+ * @param pWorld The world.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if a compressed chunk can't be allocated, the rest are
+ *                     still compressed.
+ */
+PRP_Result WorldCompressIdleChunks(FECS_World *pWorld);
+/**
+ * Checks if any layout of the world has live spawn contexts. Calls that
+ * replace, pop or repack chunks return PRP_ERR_BUSY while one does, the
+ * contexts hold chunk idxs of their own.
+ *
+ * @param pWorld The world.
+ *
+ * @return PRP_True if a spawn context is alive, PRP_False otherwise.
+ */
+PRP_Bool WorldHasSpawnCtxs(const FECS_World *pWorld);
+
+struct FECS_Fork {
+    FECS_WorldId world_id;
+    PRP_Size layout_count;
+    FECS_LayoutFork pLayouts[];
+};
+
+/**
+ * Forks the entities of a world. Chunks are shared with the world until either
+ * side writes to them, so a fork costs the chunk pointer arrays, the sparse
+ * dense arrays and a ref count bump per chunk.
+ * Compressed chunks are shared as they are.
+ *
+ * @param pWorld The world to fork.
+ * @param ppFork Output pointer to the fork.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_BUSY if a layout has live spawn contexts, their chunks
+ *                      would become shared.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result WorldFork(FECS_World *pWorld, FECS_Fork **ppFork);
+/**
+ * Restores the entities of a world to a fork of it. The fork stays valid, so
+ * it can be restored again.
+ *
+ * @param pWorld The world to restore.
+ * @param pFork  The fork to restore from, must come from this world.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_BUSY if a layout has live spawn contexts.
+ * @return PRP_ERR_OOM if allocation fails, the world is left untouched.
+ */
+PRP_Result WorldRestore(FECS_World *pWorld, const FECS_Fork *pFork);
+/**
+ * Deletes a fork returned by WorldFork.
+ *
+ * @param ppFork The fork to delete, set to NULL.
+ */
+void ForkDelete(FECS_Fork **ppFork);
 
 /* ----  ENTITIES ---- */
 
 /**
  * Spawns a new entity into the given layout.
  *
- * @param pWorld    World, the layout belongs to.
- * @param layout_id The layout to spawn entity from.
- * @param pEntity   The pointer to where the entity will be stored.
+ * @param pWorld      World, the layout belongs to.
+ * @param layout_id   The layout to spawn entity from.
+ * @param pShared_key The shared comp key built by LayoutBuildSharedKey, NULL
+ *                    for zeroed shared comps.
+ * @param pEntity     The pointer to where the entity will be stored.
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
  * @return PRP_ERR_OOM if allocation fails.
  */
 PRP_Result EntitySpawn(FECS_World *pWorld, FECS_LayoutId layout_id,
-                       FECS_EntityId *pEntity);
+                       const PRP_U8 *pShared_key, FECS_EntityId *pEntity);
 /**
  * Spawns a group of entities at once into the given layout.
  *
  * Will return a group with less entities created if it fails mid allocation.
+ * Whole chunks worth of entities are placed into empty or new chunks, only the
+ * remainder goes into partially occupied chunks.
  *
  * @param pWorld       World, the layout belongs to.
  * @param layout_id    The layout to spawn entities from.
  * @param entity_count The number of entities to spawn.
+ * @param pShared_key  The shared comp key built by LayoutBuildSharedKey, NULL
+ *                     for zeroed shared comps.
  * @param ppGroup      The pointer to where the entities will be stored.
  *
  * @return PRP_OK on success.
@@ -259,7 +1292,7 @@ PRP_Result EntitySpawn(FECS_World *pWorld, FECS_LayoutId layout_id,
  * @return PRP_ERR_OOM if allocation fails.
  */
 PRP_Result EntityGroupSpawn(FECS_World *pWorld, FECS_LayoutId layout_id,
-                            PRP_Size entity_count,
+                            PRP_Size entity_count, const PRP_U8 *pShared_key,
                             FECS_EntityGroupId **ppGroup);
 /**
  * Checks if the given entity is valid.
@@ -287,8 +1320,11 @@ PRP_Bool EntityGroupIsValid(FECS_World *pWorld,
  *
  * @param pWorld World, the entity belongs to.
  * @param entity The entitiy to kill.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
  */
-void EntityKill(FECS_World *pWorld, FECS_EntityId *pEntity);
+PRP_Result EntityKill(FECS_World *pWorld, FECS_EntityId *pEntity);
 /**
  * Kills the given entity and nullifies the pointer.
  *
@@ -297,8 +1333,24 @@ void EntityKill(FECS_World *pWorld, FECS_EntityId *pEntity);
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_INV_ARG if entities is invalid INTERNALLY.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
  */
 PRP_Result EntityGroupKill(FECS_World *pWorld, FECS_EntityGroupId **ppGroup);
+/**
+ * Creates a group of the alive entities set in per chunk slot masks, e.g.
+ * the result of LayoutScanFilter. Nothing is spawned.
+ *
+ * @param pWorld    World, the layout belongs to.
+ * @param layout_id The layout of the entities.
+ * @param pMasks    Slot masks, one per chunk of the layout.
+ * @param ppGroup   Output pointer to the group.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result EntityGroupFromMasks(FECS_World *pWorld, FECS_LayoutId layout_id,
+                                const FECS_ChunkFreeSlotType *pMasks,
+                                FECS_EntityGroupId **ppGroup);
 /**
  * Fetches the pointer to the specific component of an entity.
  *
@@ -309,6 +1361,20 @@ PRP_Result EntityGroupKill(FECS_World *pWorld, FECS_EntityGroupId **ppGroup);
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_INV_ARG if entity doesn't have the component.
+ * @return PRP_ERR_NOT_FOUND if the sparse comp isn't added to the entity.
+ * @return PRP_ERR_OOM if the read scratch of the layout can't be allocated.
+ *
+ * @note:
+ * - For shared comps the pointer is to the value shared by the entire chunk.
+ * - For sparse comps the pointer is only valid until the next add/remove of
+ *   the same sparse comp in the layout.
+ * - The chunk is only read, chunks shared with forks aren't copied and
+ *   compressed chunks aren't decompressed. A compressed column is read into
+ *   FECS_Layout::pRead_scratch, the pointer is then valid till the next call
+ *   on the layout.
+ * - Only sparse values may be written through the pointer, they aren't stored
+ *   in chunks. Others are written with EntitySetComp.
+ * - Not safe to call from several threads at once, they share the scratch.
  */
 PRP_Result EntityGetComp(FECS_World *pWorld, const FECS_EntityId entity,
                          FECS_CompId comp_id, void **ppComp_ptr);
@@ -322,9 +1388,56 @@ PRP_Result EntityGetComp(FECS_World *pWorld, const FECS_EntityId entity,
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_INV_ARG if entity doesn't have the component.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
  */
 PRP_Result EntitySetComp(FECS_World *pWorld, FECS_EntityId entity,
                          FECS_CompId comp_id, const void *pComp_data);
+/**
+ * Copies a component of a list of entities into a dense buffer, in the order
+ * of the list.
+ *
+ * @param pWorld    World the entities belong to.
+ * @param pEntities The entities to gather from, they may be invalid.
+ * @param count     The len of pEntities.
+ * @param comp_id   The component to gather.
+ * @param pOut      Buffer of count * COMP_SIZE(comp_id) bytes.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if an entity is invalid or doesn't have the
+ *                         component, or the component is a tag.
+ * @return PRP_ERR_NOT_FOUND if a sparse comp isn't added to an entity.
+ * @return PRP_ERR_OOM if the scratch for a compressed column can't be
+ *                     allocated.
+ *
+ * @note:
+ * - Only reads, so chunks shared with a world fork stay shared.
+ * - pOut is left partially written on failure.
+ */
+PRP_Result EntityGatherComp(FECS_World *pWorld, const FECS_EntityId *pEntities,
+                            PRP_Size count, FECS_CompId comp_id, void *pOut);
+/**
+ * Copies a dense buffer into a component of a list of entities, the inverse
+ * of EntityGatherComp.
+ *
+ * @param pWorld    World the entities belong to.
+ * @param pEntities The entities to scatter to, they may be invalid.
+ * @param count     The len of pEntities.
+ * @param comp_id   The component to scatter.
+ * @param pIn       Buffer of count * COMP_SIZE(comp_id) bytes.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if an entity is invalid or doesn't have the
+ *                         component, or the component has no column. Nothing
+ *                         is written.
+ * @return PRP_ERR_OOM if copying a forked chunk fails, the values before the
+ *                     failing entity are written.
+ *
+ * @note:
+ * - An entity listed more than once gets the last of its values.
+ */
+PRP_Result EntityScatterComp(FECS_World *pWorld, const FECS_EntityId *pEntities,
+                             PRP_Size count, FECS_CompId comp_id,
+                             const void *pIn);
 /**
  * Iterates over all entities of a batch.
  *
@@ -338,21 +1451,406 @@ PRP_Result EntitySetComp(FECS_World *pWorld, FECS_EntityId entity,
  * @return Callback error if cb returns non-PRP_OK.
  * @return PRP_ERR_INV_ARG if the entities don't have the component or the batch
  *                         is invalid.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
  */
 PRP_Result EntityGroupForEach(
     FECS_World *pWorld, FECS_EntityGroupId *pGroup, FECS_CompId comp_id,
     PRP_Result (*cb)(void *pComp_data, void *pUser_data), void *pUser_data);
+/**
+ * Adds a sparse comp to an entity, overwriting the value if already added.
+ *
+ * @param pWorld     World the entity belongs to.
+ * @param entity     The entity to add the sparse comp to.
+ * @param comp_id    The sparse comp to add.
+ * @param pComp_data The pointer to the value to set.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the entity's layout doesn't have the sparse comp.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result EntityAddSparse(FECS_World *pWorld, FECS_EntityId entity,
+                           FECS_CompId comp_id, const void *pComp_data);
+/**
+ * Removes a sparse comp from an entity. Removing an absent comp is a no-op.
+ *
+ * @param pWorld  World the entity belongs to.
+ * @param entity  The entity to remove the sparse comp from.
+ * @param comp_id The sparse comp to remove.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the entity's layout doesn't have the sparse comp.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+PRP_Result EntityRemoveSparse(FECS_World *pWorld, FECS_EntityId entity,
+                              FECS_CompId comp_id);
+/**
+ * Adds or removes a tag from an entity.
+ *
+ * @param pWorld World the entity belongs to.
+ * @param entity The entity whose tag to set.
+ * @param tag_id The tag component to set.
+ * @param value  PRP_True to add the tag, PRP_False to remove it.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the entity's layout doesn't have the tag.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+PRP_Result EntitySetTag(FECS_World *pWorld, FECS_EntityId entity,
+                        FECS_CompId tag_id, PRP_Bool value);
+/**
+ * Checks if an entity has a tag.
+ *
+ * @param pWorld World the entity belongs to.
+ * @param entity The entity whose tag to check.
+ * @param tag_id The tag component to check.
+ * @param pRslt  Output pointer to the result.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the entity's layout doesn't have the tag.
+ */
+PRP_Result EntityHasTag(FECS_World *pWorld, const FECS_EntityId entity,
+                        FECS_CompId tag_id, PRP_Bool *pRslt);
+/**
+ * Adds or removes a tag from all entities of a group.
+ *
+ * @param pWorld World, the entities belongs to.
+ * @param pGroup The entities to operate on.
+ * @param tag_id The tag component to set.
+ * @param value  PRP_True to add the tag, PRP_False to remove it.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the entities don't have the tag or the group is
+ *                         invalid.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+PRP_Result EntityGroupSetTag(FECS_World *pWorld, FECS_EntityGroupId *pGroup,
+                             FECS_CompId tag_id, PRP_Bool value);
+/**
+ * Enables or disables a valid entity, systems skip disabled entities.
+ *
+ * @param pWorld World the entity belongs to.
+ * @param entity The entity to enable/disable.
+ * @param value  PRP_True to enable, PRP_False to disable.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+PRP_Result EntitySetEnabled(FECS_World *pWorld, FECS_EntityId entity,
+                            PRP_Bool value);
+/**
+ * Checks if a valid entity is enabled.
+ *
+ * @param pWorld World the entity belongs to.
+ * @param entity The entity to check.
+ *
+ * @return PRP_True if enabled, PRP_False otherwise.
+ */
+PRP_Bool EntityIsEnabled(FECS_World *pWorld, const FECS_EntityId entity);
+/**
+ * Enables or disables all entities of a group, one mask op per chunk.
+ *
+ * @param pWorld World, the entities belongs to.
+ * @param pGroup The entities to operate on.
+ * @param value  PRP_True to enable, PRP_False to disable.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the group is invalid.
+ * @return PRP_ERR_OOM if copying a forked chunk fails.
+ */
+PRP_Result EntityGroupSetEnabled(FECS_World *pWorld,
+                                 FECS_EntityGroupId *pGroup, PRP_Bool value);
+
+/* ----  LAYOUT SORT ---- */
+
+typedef struct FECS_EntityRemapEntry {
+    PRP_U32 old_gen;
+    PRP_U32 new_gen;
+    // PRP_INVALID_INDEX if the slot held no entity.
+    PRP_Size new_entity_idx;
+} FECS_EntityRemapEntry;
+
+/**
+ * Indexed by the entity_idx an entity had before the sort or merge.
+ */
+struct FECS_EntityRemap {
+    FECS_LayoutId layout_id;
+    // Same as layout_id for a sort, the destination layout for a merge.
+    FECS_LayoutId new_layout_id;
+    PRP_Size entry_count;
+    FECS_EntityRemapEntry pEntries[];
+};
+
+/**
+ * Reorders the entities of a layout by a key computed from one of their
+ * comps and packs them into the leading chunks.
+ *
+ * Keys are sorted with an LSD radix sort, then every column, tag mask, sparse
+ * map and gen array is permuted column by column. Entities that stay in their
+ * slot keep their id, every other id of the layout is invalidated.
+ *
+ * @param pWorld      World, the layout belongs to.
+ * @param layout_id   The layout to sort.
+ * @param key_comp_id The comp the key is computed from, must be a column comp
+ *                    of the layout.
+ * @param key_fn      Computes the key of an entity.
+ * @param pUser_data  Passed to key_fn.
+ * @param ppRemap     Output pointer to the id remap, NULL if not needed.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the comp isn't a column comp of the layout.
+ * @return PRP_ERR_UNSUPPORTED if the layout has shared comps, chunks are keyed
+ *                             by their values so entities can't move freely.
+ * @return PRP_ERR_BUSY if the layout has live spawn contexts.
+ * @return PRP_ERR_OOM if allocation fails, the layout is left untouched.
+ */
+PRP_Result LayoutSort(FECS_World *pWorld, FECS_LayoutId layout_id,
+                      FECS_CompId key_comp_id, FECS_LayoutSortKeyFunc key_fn,
+                      void *pUser_data, FECS_EntityRemap **ppRemap);
+/**
+ * Updates an entity id from before a sort or merge to its id after it.
+ *
+ * @param pRemap  The remap of the sort.
+ * @param pEntity The entity to update.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the entity wasn't alive in the sorted layout.
+ */
+PRP_Result EntityRemapApply(const FECS_EntityRemap *pRemap,
+                            FECS_EntityId *pEntity);
+/**
+ * Deletes a remap returned by LayoutSort or LayoutMerge.
+ *
+ * @param ppRemap The remap to delete, set to NULL.
+ */
+void EntityRemapDelete(FECS_EntityRemap **ppRemap);
+
+/* ----  LAYOUT MERGE ---- */
+
+/**
+ * Moves every entity of a layout into a layout of another (or the same) world.
+ *
+ * With equal comp sets the chunk layouts are equal too, so chunks holding
+ * entities are handed over by pointer and only their sparse maps are patched.
+ * Otherwise, or if the destination has a backing file, each chunk is copied
+ * into an empty destination chunk a column at a time, entities keep their
+ * slot. The source layout is left without chunks.
+ * Compressed source chunks are decompressed first.
+ *
+ * @param pDst_world    World, the destination layout belongs to.
+ * @param dst_layout_id The layout to move the entities into.
+ * @param pSrc_world    World, the source layout belongs to.
+ * @param src_layout_id The layout to move the entities out of, must not be the
+ *                      destination.
+ * @param ppRemap       Output pointer to the id remap, NULL if not needed.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_BUSY if either layout has live spawn contexts.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails, no entity is moved.
+ */
+PRP_Result LayoutMerge(FECS_World *pDst_world, FECS_LayoutId dst_layout_id,
+                       FECS_World *pSrc_world, FECS_LayoutId src_layout_id,
+                       FECS_EntityRemap **ppRemap);
+
+/* ----  DELTAS ---- */
+
+/**
+ * Encodes the difference between two forks of a world into a stream.
+ *
+ * Chunks held by both forks are unchanged by construction, chunks copied in
+ * between are compared segment by segment, a segment being the chunk header,
+ * a tag mask, a shared value, a sparse map or a column. Only changed segments
+ * are written, adjacent ones merged into a single run.
+ *
+ * @param pWorld     World, the forks belong to.
+ * @param pBase      The fork the receiver is at, NULL to write every chunk.
+ * @param pCurr      The fork to encode.
+ * @param write_fn   Writes the encoded bytes.
+ * @param pUser_data Passed to write_fn.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return Error of write_fn if it fails.
+ */
+PRP_Result WorldDeltaWrite(const FECS_World *pWorld, const FECS_Fork *pBase,
+                           const FECS_Fork *pCurr, FECS_DeltaWriteFunc write_fn,
+                           void *pUser_data);
+/**
+ * Patches a world forward with a single delta written by WorldDeltaWrite.
+ *
+ * @param pWorld     World to patch.
+ * @param read_fn    Reads the encoded bytes.
+ * @param pUser_data Passed to read_fn.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_BUSY if a layout has live spawn contexts.
+ * @return PRP_ERR_CORRUPTED if the stream isn't a delta of this world.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return Error of read_fn if it fails.
+ *
+ * @note:
+ * - The stream is applied as it is read over a fork of the world taken first,
+ *   on failure the world is restored from it and left as it was. Only if the
+ *   restore itself runs out of memory is it left partially patched.
+ * - Every chunk the delta patches is copied away from that fork.
+ */
+PRP_Result WorldDeltaApply(FECS_World *pWorld, FECS_DeltaReadFunc read_fn,
+                           void *pUser_data);
+
+/* ----  SPAWN CONTEXTS ---- */
+
+/**
+ * Whole chunks of a layout taken out of its free chunk bitset, so that only
+ * the context hands out their slots. Each context touches nothing but its own
+ * chunks, contexts can spawn on different threads without locking.
+ *
+ * @note:
+ * - The capacity is fixed, every chunk is reserved by SpawnCtxCreate on the
+ *   owning thread. Reserving creates, unshares and decompresses chunks, none
+ *   of which is safe off the owning thread, so a context never grows.
+ */
+struct FECS_SpawnCtx {
+    FECS_Layout *pLayout;
+    FECS_LayoutId layout_id;
+    // Reserved chunks before the cursor have no free slot left.
+    PRP_Size chunk_cursor;
+    PRP_Size chunk_count;
+    PRP_Size pChunk_idxs[];
+};
+
+/**
+ * Reserves enough whole chunks of a layout for entity_count entities, the
+ * fixed capacity of the context. Empty chunks are reused before new ones are
+ * created. Every reserved chunk is made unique and decompressed here, on the
+ * owning thread.
+ *
+ * @param pWorld       World, the layout belongs to.
+ * @param layout_id    The layout to reserve chunks of.
+ * @param entity_count The number of entities the context can spawn.
+ * @param pShared_key  The shared comp key built by LayoutBuildSharedKey, NULL
+ *                     if the layout has no shared comps.
+ * @param ppSpawn_ctx  Output pointer to the context.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
+ * @return PRP_ERR_OOM if allocation fails, nothing is reserved.
+ */
+PRP_Result SpawnCtxCreate(FECS_World *pWorld, FECS_LayoutId layout_id,
+                          PRP_Size entity_count, const PRP_U8 *pShared_key,
+                          FECS_SpawnCtx **ppSpawn_ctx);
+/**
+ * Spawns an entity into a reserved chunk of the context. Only writes slots of
+ * the chunks the context reserved, never allocates.
+ *
+ * @param pSpawn_ctx The context to spawn from.
+ * @param pEntity    Output pointer to the entity.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if every reserved slot is taken.
+ */
+PRP_Result SpawnCtxSpawn(FECS_SpawnCtx *pSpawn_ctx, FECS_EntityId *pEntity);
+/**
+ * Returns the chunks of a context to its layout, the ones with free slots
+ * left become available to every spawn again.
+ *
+ * @param ppSpawn_ctx The context to delete, set to NULL.
+ */
+void SpawnCtxDelete(FECS_SpawnCtx **ppSpawn_ctx);
+
+/* ----  COLUMN SCANS ---- */
+
+/**
+ * Evaluates predicates over the alive entities of a layout, a chunk at a
+ * time. Only reads, chunks shared with a world fork stay shared.
+ *
+ * @param pLayout    The layout to scan.
+ * @param pred_count The len of pPreds, the predicates are ANDed.
+ * @param pPreds     The predicates.
+ * @param mask_count The len of pMasks, chunks past it are not scanned.
+ * @param pMasks     Output slot masks of the matching entities per chunk.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if a predicate is malformed or its field isn't a
+ *                         column or shared comp of the layout.
+ * @return PRP_ERR_OOM if the scratch for a compressed column can't be
+ *                     allocated, pMasks is left partially written.
+ */
+PRP_Result LayoutScanFilter(const FECS_Layout *pLayout, PRP_Size pred_count,
+                            const FECS_ScanPredicate *pPreds,
+                            PRP_Size mask_count,
+                            FECS_ChunkFreeSlotType *pMasks);
+/**
+ * LayoutScanFilter over every chunk, collecting the matches into a group.
+ *
+ * @param pWorld     World, the layout belongs to.
+ * @param layout_id  The layout to scan.
+ * @param pred_count The len of pPreds, the predicates are ANDed.
+ * @param pPreds     The predicates.
+ * @param ppGroup    Output pointer to the group of matching entities.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if a predicate is malformed or its field isn't a
+ *                         column or shared comp of the layout.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result LayoutScanFilterGroup(FECS_World *pWorld, FECS_LayoutId layout_id,
+                                 PRP_Size pred_count,
+                                 const FECS_ScanPredicate *pPreds,
+                                 FECS_EntityGroupId **ppGroup);
+/**
+ * Reduces a field over the alive entities of a layout, optionally restricted
+ * to slot masks, e.g. from LayoutScanFilter.
+ *
+ * @param pLayout    The layout to scan.
+ * @param pField     The field to reduce, NULL for FECS_SCAN_REDUCE_COUNT.
+ * @param op         The reduction.
+ * @param mask_count The len of pMasks, chunks past it are skipped.
+ * @param pMasks     Slot masks per chunk, NULL for every alive entity.
+ * @param pResult    Output pointer to the result.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_INV_ARG if the op or field is malformed or the field isn't
+ *                         a column or shared comp of the layout.
+ * @return PRP_ERR_OOM if the scratch for a compressed column can't be
+ *                     allocated.
+ */
+PRP_Result LayoutScanReduce(const FECS_Layout *pLayout,
+                            const FECS_ScanField *pField, FECS_ScanReduceOp op,
+                            PRP_Size mask_count,
+                            const FECS_ChunkFreeSlotType *pMasks,
+                            FECS_ScanReduceResult *pResult);
 
 /* ----  SYSTEM INSTANCE EXEC ---- */
 
 /**
  * Executes the given system instance.
+ * Chunks the system runs on that are shared with a world fork are copied
+ * first, there is no telling which comps the system writes.
  *
  * @param pWorld World, the system instance belongs to.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if copying a forked chunk fails, the layouts before the
+ *                     failing one were already executed.
+ */
+PRP_Result SystemInstanceExec(FECS_World *pWorld,
+                              FECS_SystemInstanceId system_instance_id,
+                              void *pUser_data);
+/**
+ * Fetches the execution counters of the given system instance.
+ *
+ * @param pWorld             World, the system instance belongs to.
+ * @param system_instance_id The system instance to fetch the counters of.
+ * @param pStats             Output pointer to the counters.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_UNSUPPORTED if not built with PRP_FECS_SYSTEM_STATS.
  */
-void SystemInstanceExec(FECS_World *pWorld,
-                        FECS_SystemInstanceId system_instance_id,
-                        void *pUser_data);
+PRP_Result SystemInstanceGetStats(const FECS_World *pWorld,
+                                  FECS_SystemInstanceId system_instance_id,
+                                  FECS_SystemStats *pStats);
 /**
  * Fetches pointer of the component array during system exec using exec
  * internals.
@@ -372,6 +1870,52 @@ void SystemInstanceExec(FECS_World *pWorld,
 void *
 SystemInstanceFetchComp(const FECS_SystemExecInternalData *pExec_internals,
                         PRP_Size idx);
+/**
+ * Fetches pointer of a sparse comp value of an entity slot during system exec
+ * using exec internals.
+ *
+ * @param pExec_internals The internal data needed for system execution.
+ * @param idx             The index into the strides array of the sparse comp.
+ * @param slot            The slot of the entity in the current chunk.
+ *
+ * @return Valid component ptr on success.
+ * @return NULL if idx is out of bounds, the comp isn't sparse or the entity
+ *         doesn't have the sparse comp.
+ */
+void *
+SystemInstanceFetchSparse(const FECS_SystemExecInternalData *pExec_internals,
+                          PRP_Size idx, PRP_Size slot);
+/**
+ * Fetches pointer of the component array of a chunk of the current batch
+ * during batched system exec.
+ *
+ * @param pExec_internals The internal data needed for system execution.
+ * @param chunk_idx       The index of the chunk in the current batch.
+ * @param idx             The index into the strides array to fetch comp array.
+ *
+ * @return Valid component array ptr on success.
+ * @return NULL if chunk_idx or idx is out of bounds.
+ */
+void *SystemInstanceFetchBatchComp(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size chunk_idx,
+    PRP_Size idx);
+/**
+ * Fetches pointer of the previous frame component array of a double buffered
+ * comp during system exec.
+ *
+ * @param pExec_internals The internal data needed for system execution.
+ * @param chunk_idx       The index of the chunk in the current batch, or
+ *                        PRP_INVALID_INDEX for the current chunk of a non
+ *                        batched system.
+ * @param idx             The index into the strides array to fetch comp array.
+ *
+ * @return Valid component array ptr on success.
+ * @return NULL if chunk_idx or idx is out of bounds or the comp isn't double
+ *         buffered.
+ */
+void *
+SystemInstanceFetchPrevComp(const FECS_SystemExecInternalData *pExec_internals,
+                            PRP_Size chunk_idx, PRP_Size idx);
 
 #ifdef __cplusplus
 }
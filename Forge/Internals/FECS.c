@@ -22,7 +22,94 @@ PRP_API PRP_Result PRP_CALL FECS_CompRegister(PRP_Char8 *pName,
     }
     *pComp_id = FECS_INVALID_ID;
 
-    PRP_Result code = CompRegister(pName, name_len, comp_size, pComp_id);
+    FECS_CompStorage storage =
+        comp_size ? FECS_COMP_STORAGE_COLUMN : FECS_COMP_STORAGE_TAG;
+    PRP_Result code =
+        CompRegister(pName, name_len, comp_size, storage, pComp_id);
+    if (code == PRP_ERR_ALREADY_EXISTS) {
+        PRP_LOG_ERROR(PRP_LOG_DEFAULT_LOG_FILE,
+                      "The Component: %.*s, already exists.", (PRP_I32)name_len,
+                      pName);
+    }
+
+    return code;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_CompRegisterShared(PRP_Char8 *pName,
+                                                    PRP_Size name_len,
+                                                    PRP_Size comp_size,
+                                                    FECS_CompId *pComp_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pName != NULL);
+    PRP_DIAG_ASSERT(name_len > 0);
+    PRP_DIAG_ASSERT(comp_size > 0);
+    PRP_DIAG_ASSERT(pComp_id != NULL);
+
+    if (!pName || !name_len || !comp_size || !pComp_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    *pComp_id = FECS_INVALID_ID;
+
+    PRP_Result code = CompRegister(pName, name_len, comp_size,
+                                   FECS_COMP_STORAGE_SHARED, pComp_id);
+    if (code == PRP_ERR_ALREADY_EXISTS) {
+        PRP_LOG_ERROR(PRP_LOG_DEFAULT_LOG_FILE,
+                      "The Component: %.*s, already exists.", (PRP_I32)name_len,
+                      pName);
+    }
+
+    return code;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_CompRegisterSparse(PRP_Char8 *pName,
+                                                    PRP_Size name_len,
+                                                    PRP_Size comp_size,
+                                                    FECS_CompId *pComp_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pName != NULL);
+    PRP_DIAG_ASSERT(name_len > 0);
+    PRP_DIAG_ASSERT(comp_size > 0);
+    PRP_DIAG_ASSERT(pComp_id != NULL);
+
+    if (!pName || !name_len || !comp_size || !pComp_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    *pComp_id = FECS_INVALID_ID;
+
+    PRP_Result code = CompRegister(pName, name_len, comp_size,
+                                   FECS_COMP_STORAGE_SPARSE, pComp_id);
+    if (code == PRP_ERR_ALREADY_EXISTS) {
+        PRP_LOG_ERROR(PRP_LOG_DEFAULT_LOG_FILE,
+                      "The Component: %.*s, already exists.", (PRP_I32)name_len,
+                      pName);
+    }
+
+    return code;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_CompRegisterDouble(PRP_Char8 *pName,
+                                                    PRP_Size name_len,
+                                                    PRP_Size comp_size,
+                                                    FECS_CompId *pComp_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pName != NULL);
+    PRP_DIAG_ASSERT(name_len > 0);
+    PRP_DIAG_ASSERT(comp_size > 0);
+    PRP_DIAG_ASSERT(pComp_id != NULL);
+
+    if (!pName || !name_len || !comp_size || !pComp_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    *pComp_id = FECS_INVALID_ID;
+
+    PRP_Result code = CompRegister(pName, name_len, comp_size,
+                                   FECS_COMP_STORAGE_DOUBLE, pComp_id);
     if (code == PRP_ERR_ALREADY_EXISTS) {
         PRP_LOG_ERROR(PRP_LOG_DEFAULT_LOG_FILE,
                       "The Component: %.*s, already exists.", (PRP_I32)name_len,
@@ -32,6 +119,40 @@ PRP_API PRP_Result PRP_CALL FECS_CompRegister(PRP_Char8 *pName,
     return code;
 }
 
+PRP_API PRP_Result PRP_CALL FECS_CompDefaultRegister(
+    PRP_Char8 *pName, PRP_Size name_len, FECS_CompId comp_id,
+    const void *pData, FECS_CompDefaultId *pDefault_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pName != NULL);
+    PRP_DIAG_ASSERT(name_len > 0);
+    PRP_DIAG_ASSERT(pData != NULL);
+    PRP_DIAG_ASSERT(pDefault_id != NULL);
+    PRP_DIAG_ASSERT_MSG(comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+                        "The given comp id is not valid.");
+    if (!pName || !name_len || !pData || !pDefault_id ||
+        comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    *pDefault_id = FECS_INVALID_ID;
+    PRP_DIAG_ASSERT_MSG(COMP_HAS_COLUMN(comp_id),
+                        "Only comps with a column can have defaults.");
+    if (!COMP_HAS_COLUMN(comp_id)) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    PRP_Result code =
+        CompDefaultRegister(pName, name_len, comp_id, pData, pDefault_id);
+    if (code == PRP_ERR_ALREADY_EXISTS) {
+        PRP_LOG_ERROR(PRP_LOG_DEFAULT_LOG_FILE,
+                      "The Component Default: %.*s, already exists.",
+                      (PRP_I32)name_len, pName);
+    }
+
+    return code;
+}
+
 /* ----  SYSTEMS ---- */
 
 PRP_API PRP_Result PRP_CALL FECS_SystemRegister(PRP_Char8 *pName,
@@ -60,8 +181,37 @@ PRP_API PRP_Result PRP_CALL FECS_SystemRegister(PRP_Char8 *pName,
      * level, and that is intentional.
      */
     PRP_Result code =
-        SystemRegister(pName, name_len, system_func, comp_ids_needed_count,
-                       pComp_ids_needed, pSystem_id);
+        SystemRegister(pName, name_len, system_func, NULL,
+                       comp_ids_needed_count, pComp_ids_needed, pSystem_id);
+    if (code == PRP_ERR_ALREADY_EXISTS) {
+        PRP_LOG_ERROR(PRP_LOG_DEFAULT_LOG_FILE,
+                      "The System: %.*s, already exists.", (PRP_I32)name_len,
+                      pName);
+    }
+
+    return code;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_SystemRegisterBatched(
+    PRP_Char8 *pName, PRP_Size name_len, FECS_SystemBatchFunc system_func,
+    PRP_Size comp_ids_needed_count, FECS_CompId *pComp_ids_needed,
+    FECS_SystemId *pSystem_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pName != NULL);
+    PRP_DIAG_ASSERT(name_len > 0);
+    PRP_DIAG_ASSERT(system_func != NULL);
+    PRP_DIAG_ASSERT(pSystem_id != NULL);
+
+    if (!pName || !name_len || !system_func || !pSystem_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    *pSystem_id = FECS_INVALID_ID;
+
+    PRP_Result code =
+        SystemRegister(pName, name_len, NULL, system_func,
+                       comp_ids_needed_count, pComp_ids_needed, pSystem_id);
     if (code == PRP_ERR_ALREADY_EXISTS) {
         PRP_LOG_ERROR(PRP_LOG_DEFAULT_LOG_FILE,
                       "The System: %.*s, already exists.", (PRP_I32)name_len,
@@ -120,23 +270,1489 @@ PRP_API PRP_Result PRP_CALL FECS_WorldUnload(FECS_WorldId *pWorld_id) {
         return PRP_ERR_INV_ARG;
     }
 
-    return CONT_DSArrDelElemChecked(g_ctx->pWorlds, pWorld_id);
+    return CONT_DSArrDelElemChecked(g_ctx->pWorlds, pWorld_id);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldLoadAsync(const PRP_Char8 *pFile_path,
+                                                FECS_WorldLoadTask **ppTask) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pFile_path != NULL);
+    PRP_DIAG_ASSERT(ppTask != NULL);
+
+    if (!pFile_path || !ppTask) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    PRP_Result code = WorldLoadTaskCreate(pFile_path, ppTask);
+    if (code != PRP_OK) {
+        return code;
+    }
+    g_ctx->world_load_count++;
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldLoadPoll(FECS_WorldLoadTask *pTask,
+                                               PRP_Bool *pIs_done) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pTask != NULL);
+    PRP_DIAG_ASSERT(pIs_done != NULL);
+
+    if (!pTask || !pIs_done) {
+        return PRP_ERR_INV_ARG;
+    }
+    *pIs_done = WorldLoadTaskIsDone(pTask);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldLoadWait(FECS_WorldLoadTask **ppTask,
+                                               FECS_WorldId *pWorld_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppTask != NULL && *ppTask != NULL);
+    PRP_DIAG_ASSERT(pWorld_id != NULL);
+
+    if (!ppTask || !*ppTask || !pWorld_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    *pWorld_id = FECS_INVALID_ID;
+
+    FECS_World world;
+    PRP_Result code = WorldLoadTaskJoin(ppTask, &world);
+    g_ctx->world_load_count--;
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    code = CONT_DSArrAddUnchecked(g_ctx->pWorlds, &world, pWorld_id);
+    if (code != PRP_OK) {
+        WorldDeleteCb(&world);
+        return code;
+    }
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldFindLayoutId(FECS_WorldId world_id,
+                                                   const PRP_Char8 *pName,
+                                                   PRP_Size name_len,
+                                                   FECS_LayoutId *pLayout_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pName != NULL);
+    PRP_DIAG_ASSERT(name_len > 0);
+    PRP_DIAG_ASSERT(pLayout_id != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+
+    if (!pName || !name_len || !pLayout_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *pLayout_id = WorldFindLayout(pWorld, pName, name_len);
+    if (*pLayout_id == FECS_INVALID_ID) {
+        return PRP_ERR_NOT_FOUND;
+    }
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldFindSystemInstanceId(
+    FECS_WorldId world_id, const PRP_Char8 *pName, PRP_Size name_len,
+    FECS_SystemInstanceId *pSystem_instance_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pName != NULL);
+    PRP_DIAG_ASSERT(name_len > 0);
+    PRP_DIAG_ASSERT(pSystem_instance_id != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+
+    if (!pName || !name_len || !pSystem_instance_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *pSystem_instance_id = WorldFindSystemInstance(pWorld, pName, name_len);
+    if (*pSystem_instance_id == FECS_INVALID_ID) {
+        return PRP_ERR_NOT_FOUND;
+    }
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL
+FECS_WorldGetMemoryStats(FECS_WorldId world_id, FECS_WorldMemoryStats *pStats) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pStats != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+
+    if (!pStats) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    WorldGetMemoryStats(pWorld, pStats);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldGetLayoutMemoryStats(
+    FECS_WorldId world_id, FECS_LayoutId layout_id,
+    FECS_LayoutMemoryStats *pStats) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pStats != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+
+    if (!pStats) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(layout_id < pWorld->layout_count,
+                        "The given layout id is not a valid layout id in this "
+                        "world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    LayoutGetMemoryStats(&pWorld->pLayouts[layout_id], pStats);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_LayoutSetDefault(FECS_WorldId world_id,
+                                                  FECS_LayoutId layout_id,
+                                                  FECS_CompId comp_id,
+                                                  const void *pData) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pData != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    PRP_DIAG_ASSERT_MSG(comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+                        "The given comp id is not valid.");
+    if (!pData || comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(layout_id < pWorld->layout_count,
+                        "The given layout id is not a valid layout id in this "
+                        "world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return LayoutSetDefault(&pWorld->pLayouts[layout_id], comp_id, pData);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_LayoutSetBackingFile(
+    FECS_WorldId world_id, FECS_LayoutId layout_id,
+    const PRP_Char8 *pFile_path) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pFile_path != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pFile_path) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(layout_id < pWorld->layout_count,
+                        "The given layout id is not a valid layout id in this "
+                        "world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
+    if (pLayout->spawn_ctx_count) {
+        return PRP_ERR_BUSY;
+    }
+
+    return LayoutSetBackingFile(pLayout, pFile_path);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_LayoutPageOut(FECS_WorldId world_id,
+                                               FECS_LayoutId layout_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(layout_id < pWorld->layout_count,
+                        "The given layout id is not a valid layout id in this "
+                        "world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    if (pWorld->pLayouts[layout_id].spawn_ctx_count) {
+        return PRP_ERR_BUSY;
+    }
+
+    return LayoutPageOut(&pWorld->pLayouts[layout_id]);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_LayoutSetCompression(FECS_WorldId world_id,
+                                                      FECS_LayoutId layout_id,
+                                                      PRP_U32 idle_frames) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(layout_id < pWorld->layout_count,
+                        "The given layout id is not a valid layout id in this "
+                        "world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return LayoutSetCompression(&pWorld->pLayouts[layout_id], idle_frames);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldSwapBuffers(FECS_WorldId world_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return WorldSwapBuffers(pWorld);
+}
+
+PRP_API PRP_Result PRP_CALL
+FECS_WorldCompressIdleChunks(FECS_WorldId world_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return WorldCompressIdleChunks(pWorld);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_LayoutSort(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, FECS_CompId key_comp_id,
+    FECS_LayoutSortKeyFunc key_fn, void *pUser_data,
+    FECS_EntityRemap **ppRemap) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(key_fn != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    PRP_DIAG_ASSERT_MSG(key_comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+                        "The given comp id is not valid.");
+    if (!key_fn || key_comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(layout_id < pWorld->layout_count,
+                        "The given layout id is not a valid layout id in this "
+                        "world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return LayoutSort(pWorld, layout_id, key_comp_id, key_fn, pUser_data,
+                      ppRemap);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldMergeLayout(FECS_WorldId dst_world_id,
+                                                  FECS_LayoutId dst_layout_id,
+                                                  FECS_WorldId src_world_id,
+                                                  FECS_LayoutId src_layout_id,
+                                                  FECS_EntityRemap **ppRemap) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, dst_world_id),
+                        "The given world id is not valid.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, src_world_id),
+                        "The given world id is not valid.");
+
+    FECS_World *pDst_world, *pSrc_world;
+    PRP_Result code = CONT_DSIdToDataChecked(g_ctx->pWorlds, dst_world_id,
+                                             (void **)&pDst_world);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    code = CONT_DSIdToDataChecked(g_ctx->pWorlds, src_world_id,
+                                  (void **)&pSrc_world);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(dst_layout_id < pDst_world->layout_count &&
+                            src_layout_id < pSrc_world->layout_count,
+                        "The given layout id is not a valid layout id in this "
+                        "world.");
+    PRP_DIAG_ASSERT_MSG(pDst_world != pSrc_world ||
+                            dst_layout_id != src_layout_id,
+                        "A layout can't be merged into itself.");
+    if (dst_layout_id >= pDst_world->layout_count ||
+        src_layout_id >= pSrc_world->layout_count ||
+        (pDst_world == pSrc_world && dst_layout_id == src_layout_id)) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return LayoutMerge(pDst_world, dst_layout_id, pSrc_world, src_layout_id,
+                       ppRemap);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityRemapApply(
+    const FECS_EntityRemap *pRemap, FECS_EntityId *pEntity) {
+    PRP_DIAG_ASSERT(pRemap != NULL);
+    PRP_DIAG_ASSERT(pEntity != NULL);
+    if (!pRemap || !pEntity) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntityRemapApply(pRemap, pEntity);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityRemapDelete(FECS_EntityRemap **ppRemap) {
+    PRP_DIAG_ASSERT(ppRemap != NULL);
+    if (!ppRemap) {
+        return PRP_ERR_INV_ARG;
+    }
+    EntityRemapDelete(ppRemap);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldFork(FECS_WorldId world_id,
+                                           FECS_Fork **ppFork) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppFork != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!ppFork) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    code = WorldFork(pWorld, ppFork);
+    if (code != PRP_OK) {
+        return code;
+    }
+    (*ppFork)->world_id = world_id;
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldRestore(FECS_WorldId world_id,
+                                              const FECS_Fork *pFork) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pFork != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pFork) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(pFork->world_id == world_id,
+                        "The given fork is not a fork of this world.");
+    if (pFork->world_id != world_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return WorldRestore(pWorld, pFork);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_ForkDelete(FECS_Fork **ppFork) {
+    PRP_DIAG_ASSERT(ppFork != NULL && *ppFork != NULL);
+    if (!ppFork || !*ppFork) {
+        return PRP_ERR_INV_ARG;
+    }
+    ForkDelete(ppFork);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldDeltaWrite(FECS_WorldId world_id,
+                                                 FECS_Fork **ppBase,
+                                                 FECS_DeltaWriteFunc write_fn,
+                                                 void *pUser_data) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppBase != NULL);
+    PRP_DIAG_ASSERT(write_fn != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!ppBase || !write_fn) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(!*ppBase || (*ppBase)->world_id == world_id,
+                        "The given base is not a fork of this world.");
+    if (*ppBase && (*ppBase)->world_id != world_id) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    /*
+     * The current state is forked first and diffed against the base, the new
+     * fork becomes the base only once the whole delta is out.
+     */
+    FECS_Fork *pCurr;
+    code = WorldFork(pWorld, &pCurr);
+    if (code != PRP_OK) {
+        return code;
+    }
+    pCurr->world_id = world_id;
+    code = WorldDeltaWrite(pWorld, *ppBase, pCurr, write_fn, pUser_data);
+    if (code != PRP_OK) {
+        ForkDelete(&pCurr);
+        return code;
+    }
+    if (*ppBase) {
+        ForkDelete(ppBase);
+    }
+    *ppBase = pCurr;
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_WorldDeltaApply(FECS_WorldId world_id,
+                                                 FECS_DeltaReadFunc read_fn,
+                                                 void *pUser_data) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(read_fn != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!read_fn) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return WorldDeltaApply(pWorld, read_fn, pUser_data);
+}
+
+/* ----  ENTITIES  ---- */
+
+PRP_API PRP_Result PRP_CALL FECS_EntitySpawn(FECS_WorldId world_id,
+                                             FECS_LayoutId layout_id,
+                                             FECS_EntityId *pEntity) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pEntity != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pEntity) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        layout_id < pWorld->layout_count,
+        "The given layout id is not a valid layout id in this world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntitySpawn(pWorld, layout_id, NULL, pEntity);
+}
+
+PRP_API PRP_Result PRP_CALL
+FECS_EntityGroupSpawn(FECS_WorldId world_id, FECS_LayoutId layout_id,
+                      PRP_Size entity_count, FECS_EntityGroupId **ppGroup) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppGroup != NULL);
+    PRP_DIAG_ASSERT(entity_count > 0);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!ppGroup || !entity_count) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        layout_id < pWorld->layout_count,
+        "The given layout id is not a valid layout id in this world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntityGroupSpawn(pWorld, layout_id, entity_count, NULL, ppGroup);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntitySpawnShared(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size shared_count,
+    const FECS_CompId *pShared_comp_ids, const void *const *ppShared_data,
+    FECS_EntityId *pEntity) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pEntity != NULL);
+    PRP_DIAG_ASSERT(!shared_count ||
+                    (pShared_comp_ids != NULL && ppShared_data != NULL));
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pEntity || (shared_count && (!pShared_comp_ids || !ppShared_data))) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Size comps_len = CONT_ArrLen(g_ctx->pComp_sizes);
+    for (PRP_Size i = 0; i < shared_count; i++) {
+        PRP_DIAG_ASSERT(ppShared_data[i] != NULL);
+        PRP_DIAG_ASSERT_MSG(
+            pShared_comp_ids[i] < comps_len,
+            "The given comp_id is not a valid component in the FECS runtime.");
+        if (!ppShared_data[i] || pShared_comp_ids[i] >= comps_len) {
+            return PRP_ERR_INV_ARG;
+        }
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        layout_id < pWorld->layout_count,
+        "The given layout id is not a valid layout id in this world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    const PRP_U8 *pShared_key;
+    code = LayoutBuildSharedKey(&pWorld->pLayouts[layout_id], shared_count,
+                                pShared_comp_ids, ppShared_data, &pShared_key);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    return EntitySpawn(pWorld, layout_id, pShared_key, pEntity);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupSpawnShared(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size entity_count,
+    PRP_Size shared_count, const FECS_CompId *pShared_comp_ids,
+    const void *const *ppShared_data, FECS_EntityGroupId **ppGroup) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppGroup != NULL);
+    PRP_DIAG_ASSERT(entity_count > 0);
+    PRP_DIAG_ASSERT(!shared_count ||
+                    (pShared_comp_ids != NULL && ppShared_data != NULL));
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!ppGroup || !entity_count ||
+        (shared_count && (!pShared_comp_ids || !ppShared_data))) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Size comps_len = CONT_ArrLen(g_ctx->pComp_sizes);
+    for (PRP_Size i = 0; i < shared_count; i++) {
+        PRP_DIAG_ASSERT(ppShared_data[i] != NULL);
+        PRP_DIAG_ASSERT_MSG(
+            pShared_comp_ids[i] < comps_len,
+            "The given comp_id is not a valid component in the FECS runtime.");
+        if (!ppShared_data[i] || pShared_comp_ids[i] >= comps_len) {
+            return PRP_ERR_INV_ARG;
+        }
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        layout_id < pWorld->layout_count,
+        "The given layout id is not a valid layout id in this world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    const PRP_U8 *pShared_key;
+    code = LayoutBuildSharedKey(&pWorld->pLayouts[layout_id], shared_count,
+                                pShared_comp_ids, ppShared_data, &pShared_key);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    return EntityGroupSpawn(pWorld, layout_id, entity_count, pShared_key,
+                            ppGroup);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_SpawnCtxCreate(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size entity_count,
+    PRP_Size shared_count, const FECS_CompId *pShared_comp_ids,
+    const void *const *ppShared_data, FECS_SpawnCtx **ppSpawn_ctx) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppSpawn_ctx != NULL);
+    PRP_DIAG_ASSERT(entity_count > 0);
+    PRP_DIAG_ASSERT(!shared_count ||
+                    (pShared_comp_ids != NULL && ppShared_data != NULL));
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!ppSpawn_ctx || !entity_count ||
+        (shared_count && (!pShared_comp_ids || !ppShared_data))) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Size comps_len = CONT_ArrLen(g_ctx->pComp_sizes);
+    for (PRP_Size i = 0; i < shared_count; i++) {
+        PRP_DIAG_ASSERT(ppShared_data[i] != NULL);
+        PRP_DIAG_ASSERT_MSG(
+            pShared_comp_ids[i] < comps_len,
+            "The given comp_id is not a valid component in the FECS runtime.");
+        if (!ppShared_data[i] || pShared_comp_ids[i] >= comps_len) {
+            return PRP_ERR_INV_ARG;
+        }
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        layout_id < pWorld->layout_count,
+        "The given layout id is not a valid layout id in this world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    const PRP_U8 *pShared_key;
+    code = LayoutBuildSharedKey(&pWorld->pLayouts[layout_id], shared_count,
+                                pShared_comp_ids, ppShared_data, &pShared_key);
+    if (code != PRP_OK) {
+        return code;
+    }
+
+    return SpawnCtxCreate(pWorld, layout_id, entity_count, pShared_key,
+                          ppSpawn_ctx);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_SpawnCtxSpawn(FECS_SpawnCtx *pSpawn_ctx,
+                                               FECS_EntityId *pEntity) {
+    /*
+     * The FECS context is not checked here, this runs on worker threads and
+     * must not read anything other threads could be writing.
+     */
+    PRP_DIAG_ASSERT(pSpawn_ctx != NULL);
+    PRP_DIAG_ASSERT(pEntity != NULL);
+    if (!pSpawn_ctx || !pEntity) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return SpawnCtxSpawn(pSpawn_ctx, pEntity);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_SpawnCtxDelete(FECS_SpawnCtx **ppSpawn_ctx) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppSpawn_ctx != NULL && *ppSpawn_ctx != NULL);
+    if (!ppSpawn_ctx || !*ppSpawn_ctx) {
+        return PRP_ERR_INV_ARG;
+    }
+    SpawnCtxDelete(ppSpawn_ctx);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityIsValid(FECS_WorldId world_id,
+                                               const FECS_EntityId entity,
+                                               PRP_Bool *pRslt) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pRslt != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pRslt) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *pRslt = EntityIsValid(pWorld, entity);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupIsValid(
+    FECS_WorldId world_id, const FECS_EntityGroupId *pGroup, PRP_Bool *pRslt) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pRslt != NULL);
+    PRP_DIAG_ASSERT(pGroup != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pRslt || !pGroup) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *pRslt = EntityGroupIsValid(pWorld, pGroup);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityKill(FECS_WorldId world_id,
+                                            FECS_EntityId *pEntity) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pEntity != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pEntity) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, *pEntity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntityKill(pWorld, pEntity);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupKill(FECS_WorldId world_id,
+                                                 FECS_EntityGroupId **ppGroup) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppGroup != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!ppGroup) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        EntityGroupIsValid(pWorld, *ppGroup),
+        "The given entity group is not a valid entity group in this world.");
+
+    // This checks entity group validity internally so no need for extra checks.
+    return EntityGroupKill(pWorld, ppGroup);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityGetComp(FECS_WorldId world_id,
+                                               const FECS_EntityId entity,
+                                               FECS_CompId comp_id,
+                                               void **ppComp_ptr) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(ppComp_ptr != NULL);
+    PRP_DIAG_ASSERT_MSG(
+        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!ppComp_ptr || comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntityGetComp(pWorld, entity, comp_id, ppComp_ptr);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntitySetComp(FECS_WorldId world_id,
+                                               FECS_EntityId entity,
+                                               FECS_CompId comp_id,
+                                               const void *pComp_data) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pComp_data != NULL);
+    PRP_DIAG_ASSERT_MSG(
+        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pComp_data || comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntitySetComp(pWorld, entity, comp_id, pComp_data);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityGatherComp(
+    FECS_WorldId world_id, const FECS_EntityId *pEntities, PRP_Size count,
+    FECS_CompId comp_id, void *pOut) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(!count || pEntities != NULL);
+    PRP_DIAG_ASSERT(!count || pOut != NULL);
+    PRP_DIAG_ASSERT_MSG(
+        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if ((count && (!pEntities || !pOut)) ||
+        comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    // Entities are validated internally, one by one as they are reached.
+    return EntityGatherComp(pWorld, pEntities, count, comp_id, pOut);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityScatterComp(
+    FECS_WorldId world_id, const FECS_EntityId *pEntities, PRP_Size count,
+    FECS_CompId comp_id, const void *pIn) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(!count || pEntities != NULL);
+    PRP_DIAG_ASSERT(!count || pIn != NULL);
+    PRP_DIAG_ASSERT_MSG(
+        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if ((count && (!pEntities || !pIn)) ||
+        comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    // Entities are validated internally, all of them before any write.
+    return EntityScatterComp(pWorld, pEntities, count, comp_id, pIn);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupForEach(
+    FECS_WorldId world_id, FECS_EntityGroupId *pGroup, FECS_CompId comp_id,
+    PRP_Result (*cb)(void *pComp_data, void *pUser_data), void *pUser_data) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pGroup != NULL);
+    PRP_DIAG_ASSERT(cb != NULL);
+    PRP_DIAG_ASSERT_MSG(
+        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pGroup || !cb || comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        EntityGroupIsValid(pWorld, pGroup),
+        "The given entity group is not a valid entity group in this world.");
+
+    return EntityGroupForEach(pWorld, pGroup, comp_id, cb, pUser_data);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityAddSparse(FECS_WorldId world_id,
+                                                 FECS_EntityId entity,
+                                                 FECS_CompId comp_id,
+                                                 const void *pComp_data) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pComp_data != NULL);
+    PRP_DIAG_ASSERT_MSG(
+        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pComp_data || comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntityAddSparse(pWorld, entity, comp_id, pComp_data);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityRemoveSparse(FECS_WorldId world_id,
+                                                    FECS_EntityId entity,
+                                                    FECS_CompId comp_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(
+        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntityRemoveSparse(pWorld, entity, comp_id);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntitySetTag(FECS_WorldId world_id,
+                                              FECS_EntityId entity,
+                                              FECS_CompId tag_id,
+                                              PRP_Bool value) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(
+        tag_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given tag_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (tag_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntitySetTag(pWorld, entity, tag_id, value);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityHasTag(FECS_WorldId world_id,
+                                              const FECS_EntityId entity,
+                                              FECS_CompId tag_id,
+                                              PRP_Bool *pRslt) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pRslt != NULL);
+    PRP_DIAG_ASSERT_MSG(
+        tag_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given tag_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pRslt || tag_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntityHasTag(pWorld, entity, tag_id, pRslt);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupSetTag(FECS_WorldId world_id,
+                                                   FECS_EntityGroupId *pGroup,
+                                                   FECS_CompId tag_id,
+                                                   PRP_Bool value) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pGroup != NULL);
+    PRP_DIAG_ASSERT_MSG(
+        tag_id < CONT_ArrLen(g_ctx->pComp_sizes),
+        "The given tag_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pGroup || tag_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        EntityGroupIsValid(pWorld, pGroup),
+        "The given entity group is not a valid entity group in this world.");
+
+    // This checks entity group validity internally so no need for extra checks.
+    return EntityGroupSetTag(pWorld, pGroup, tag_id, value);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntitySetEnabled(FECS_WorldId world_id,
+                                                  FECS_EntityId entity,
+                                                  PRP_Bool value) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return EntitySetEnabled(pWorld, entity, value);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityIsEnabled(FECS_WorldId world_id,
+                                                 const FECS_EntityId entity,
+                                                 PRP_Bool *pRslt) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pRslt != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pRslt) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
+    PRP_DIAG_ASSERT_MSG(
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *pRslt = EntityIsEnabled(pWorld, entity);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_EntityGroupSetEnabled(
+    FECS_WorldId world_id, FECS_EntityGroupId *pGroup, PRP_Bool value) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pGroup != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pGroup) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(
+        EntityGroupIsValid(pWorld, pGroup),
+        "The given entity group is not a valid entity group in this world.");
+
+    // This checks entity group validity internally so no need for extra checks.
+    return EntityGroupSetEnabled(pWorld, pGroup, value);
+}
+
+/* ----  HIERARCHY ---- */
+
+PRP_API PRP_Result PRP_CALL FECS_HierarchyAddNode(FECS_WorldId world_id,
+                                                  FECS_HierarchyNodeId parent,
+                                                  const MATH_Mat4 *pLocal,
+                                                  FECS_HierarchyNodeId *pNode) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pLocal != NULL);
+    PRP_DIAG_ASSERT(pNode != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pLocal || !pNode) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    if (parent != FECS_INVALID_ID) {
+        PRP_Bool is_valid = pWorld->pHierarchy &&
+                            HierarchyNodeIsValid(pWorld->pHierarchy, parent);
+        PRP_DIAG_ASSERT_MSG(
+            is_valid, "The given parent is not a valid node in this world.");
+        if (!is_valid) {
+            return PRP_ERR_INV_ARG;
+        }
+    }
+    if (!pWorld->pHierarchy) {
+        code = HierarchyCreate(&pWorld->pHierarchy);
+        if (code != PRP_OK) {
+            return code;
+        }
+    }
+
+    return HierarchyAddNode(pWorld->pHierarchy, parent, pLocal, pNode);
+}
+
+PRP_API PRP_Result PRP_CALL
+FECS_HierarchyRemoveNode(FECS_WorldId world_id, FECS_HierarchyNodeId node) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = pWorld->pHierarchy &&
+                        HierarchyNodeIsValid(pWorld->pHierarchy, node);
+    PRP_DIAG_ASSERT_MSG(is_valid,
+                        "The given node is not a valid node in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    HierarchyRemoveNode(pWorld->pHierarchy, node);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_HierarchySetParent(
+    FECS_WorldId world_id, FECS_HierarchyNodeId node,
+    FECS_HierarchyNodeId parent) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = pWorld->pHierarchy &&
+                        HierarchyNodeIsValid(pWorld->pHierarchy, node);
+    PRP_DIAG_ASSERT_MSG(is_valid,
+                        "The given node is not a valid node in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_parent_valid =
+        parent == FECS_INVALID_ID ||
+        HierarchyNodeIsValid(pWorld->pHierarchy, parent);
+    PRP_DIAG_ASSERT_MSG(is_parent_valid,
+                        "The given parent is not a valid node in this world.");
+    if (!is_parent_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    return HierarchySetParent(pWorld->pHierarchy, node, parent);
+}
+
+PRP_API PRP_Result PRP_CALL FECS_HierarchySetLocal(FECS_WorldId world_id,
+                                                   FECS_HierarchyNodeId node,
+                                                   const MATH_Mat4 *pLocal) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pLocal != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pLocal) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = pWorld->pHierarchy &&
+                        HierarchyNodeIsValid(pWorld->pHierarchy, node);
+    PRP_DIAG_ASSERT_MSG(is_valid,
+                        "The given node is not a valid node in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    HierarchySetLocal(pWorld->pHierarchy, node, pLocal);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_HierarchyGetWorld(FECS_WorldId world_id,
+                                                   FECS_HierarchyNodeId node,
+                                                   MATH_Mat4 *pWorld_mat) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pWorld_mat != NULL);
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    if (!pWorld_mat) {
+        return PRP_ERR_INV_ARG;
+    }
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = pWorld->pHierarchy &&
+                        HierarchyNodeIsValid(pWorld->pHierarchy, node);
+    PRP_DIAG_ASSERT_MSG(is_valid,
+                        "The given node is not a valid node in this world.");
+    if (!is_valid) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *pWorld_mat = *HierarchyGetWorld(pWorld->pHierarchy, node);
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_HierarchyPropagate(FECS_WorldId world_id) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
+                        "The given world id is not valid.");
+    FECS_World *pWorld;
+    PRP_Result code =
+        CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
+    if (code != PRP_OK) {
+        return PRP_ERR_INV_ARG;
+    }
+    if (!pWorld->pHierarchy) {
+        return PRP_OK;
+    }
+
+    return HierarchyPropagate(pWorld->pHierarchy);
 }
 
-PRP_API PRP_Result PRP_CALL FECS_WorldFindLayoutId(FECS_WorldId world_id,
-                                                   const PRP_Char8 *pName,
-                                                   PRP_Size name_len,
-                                                   FECS_LayoutId *pLayout_id) {
+/* ----  SPATIAL ---- */
+
+PRP_API PRP_Result PRP_CALL FECS_SpatialBind(FECS_WorldId world_id,
+                                             FECS_CompId pos_comp_id,
+                                             PRP_F32 cell_size) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(pName != NULL);
-    PRP_DIAG_ASSERT(name_len > 0);
-    PRP_DIAG_ASSERT(pLayout_id != NULL);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-
-    if (!pName || !name_len || !pLayout_id) {
+    PRP_DIAG_ASSERT_MSG(pos_comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
+                        "The given comp id is not valid.");
+    if (pos_comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_pos = COMP_HAS_COLUMN(pos_comp_id) &&
+                      COMP_SIZE(pos_comp_id) >= sizeof(MATH_Vec3);
+    PRP_Bool is_cell_size = cell_size > 0 && !MATH_IsInfF32(cell_size);
+    PRP_DIAG_ASSERT_MSG(is_pos, "The given comp can't hold a MATH_Vec3 "
+                                "position.");
+    PRP_DIAG_ASSERT_MSG(is_cell_size, "The given cell size is not valid.");
+    if (!is_pos || !is_cell_size) {
         return PRP_ERR_INV_ARG;
     }
     FECS_World *pWorld;
@@ -146,137 +1762,137 @@ PRP_API PRP_Result PRP_CALL FECS_WorldFindLayoutId(FECS_WorldId world_id,
         return PRP_ERR_INV_ARG;
     }
 
-    *pLayout_id = WorldFindLayout(pWorld, pName, name_len);
-    if (*pLayout_id == FECS_INVALID_ID) {
-        return PRP_ERR_NOT_FOUND;
+    FECS_Spatial *pSpatial;
+    code = SpatialCreate(pWorld->pLayouts, pWorld->layout_count, pos_comp_id,
+                         cell_size, &pSpatial);
+    if (code != PRP_OK) {
+        return code;
     }
+    if (pWorld->pSpatial) {
+        SpatialDelete(&pWorld->pSpatial);
+    }
+    pWorld->pSpatial = pSpatial;
 
     return PRP_OK;
 }
 
-PRP_API PRP_Result PRP_CALL FECS_WorldFindSystemInstanceId(
-    FECS_WorldId world_id, const PRP_Char8 *pName, PRP_Size name_len,
-    FECS_SystemInstanceId *pSystem_instance_id) {
+PRP_API PRP_Result PRP_CALL FECS_SpatialUnbind(FECS_WorldId world_id) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(pName != NULL);
-    PRP_DIAG_ASSERT(name_len > 0);
-    PRP_DIAG_ASSERT(pSystem_instance_id != NULL);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-
-    if (!pName || !name_len || !pSystem_instance_id) {
-        return PRP_ERR_INV_ARG;
-    }
     FECS_World *pWorld;
     PRP_Result code =
         CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
-
-    *pSystem_instance_id = WorldFindSystemInstance(pWorld, pName, name_len);
-    if (*pSystem_instance_id == FECS_INVALID_ID) {
-        return PRP_ERR_NOT_FOUND;
+    PRP_DIAG_ASSERT_MSG(pWorld->pSpatial != NULL,
+                        "No spatial grid is bound to the given world.");
+    if (!pWorld->pSpatial) {
+        return PRP_ERR_INV_ARG;
     }
 
+    SpatialDelete(&pWorld->pSpatial);
+
     return PRP_OK;
 }
 
-/* ----  ENTITIES  ---- */
-
-PRP_API PRP_Result PRP_CALL FECS_EntitySpawn(FECS_WorldId world_id,
-                                             FECS_LayoutId layout_id,
-                                             FECS_EntityId *pEntity) {
+PRP_API PRP_Result PRP_CALL FECS_SpatialMarkDirty(FECS_WorldId world_id,
+                                                  const FECS_EntityId entity) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(pEntity != NULL);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!pEntity) {
-        return PRP_ERR_INV_ARG;
-    }
     FECS_World *pWorld;
     PRP_Result code =
         CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
+    PRP_DIAG_ASSERT_MSG(pWorld->pSpatial != NULL,
+                        "No spatial grid is bound to the given world.");
+    if (!pWorld->pSpatial) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
     PRP_DIAG_ASSERT_MSG(
-        layout_id < pWorld->layout_count,
-        "The given layout id is not a valid layout id in this world.");
-    if (layout_id >= pWorld->layout_count) {
+        is_valid, "The given entity is not a valid entity in this world.");
+    if (!is_valid) {
         return PRP_ERR_INV_ARG;
     }
 
-    return EntitySpawn(pWorld, layout_id, pEntity);
+    SpatialMarkDirty(pWorld->pSpatial, entity);
+
+    return PRP_OK;
 }
 
 PRP_API PRP_Result PRP_CALL
-FECS_EntityGroupSpawn(FECS_WorldId world_id, FECS_LayoutId layout_id,
-                      PRP_Size entity_count, FECS_EntityGroupId **ppGroup) {
+FECS_SpatialMarkLayoutDirty(FECS_WorldId world_id, FECS_LayoutId layout_id) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(ppGroup != NULL);
-    PRP_DIAG_ASSERT(entity_count > 0);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!ppGroup || !entity_count) {
-        return PRP_ERR_INV_ARG;
-    }
     FECS_World *pWorld;
     PRP_Result code =
         CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
-    PRP_DIAG_ASSERT_MSG(
-        layout_id < pWorld->layout_count,
-        "The given layout id is not a valid layout id in this world.");
+    PRP_DIAG_ASSERT_MSG(pWorld->pSpatial != NULL,
+                        "No spatial grid is bound to the given world.");
+    if (!pWorld->pSpatial) {
+        return PRP_ERR_INV_ARG;
+    }
+    PRP_DIAG_ASSERT_MSG(layout_id < pWorld->layout_count,
+                        "The given layout id is not a valid layout id in this "
+                        "world.");
     if (layout_id >= pWorld->layout_count) {
         return PRP_ERR_INV_ARG;
     }
 
-    return EntityGroupSpawn(pWorld, layout_id, entity_count, ppGroup);
+    SpatialMarkLayoutDirty(pWorld->pSpatial, layout_id);
+
+    return PRP_OK;
 }
 
-PRP_API PRP_Result PRP_CALL FECS_EntityIsValid(FECS_WorldId world_id,
-                                               const FECS_EntityId entity,
-                                               PRP_Bool *pRslt) {
+PRP_API PRP_Result PRP_CALL FECS_SpatialUpdate(FECS_WorldId world_id) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(pRslt != NULL);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!pRslt) {
-        return PRP_ERR_INV_ARG;
-    }
     FECS_World *pWorld;
     PRP_Result code =
         CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
+    PRP_DIAG_ASSERT_MSG(pWorld->pSpatial != NULL,
+                        "No spatial grid is bound to the given world.");
+    if (!pWorld->pSpatial) {
+        return PRP_ERR_INV_ARG;
+    }
 
-    *pRslt = EntityIsValid(pWorld, entity);
-
-    return PRP_OK;
+    return SpatialUpdate(pWorld->pSpatial, pWorld->pLayouts);
 }
 
-PRP_API PRP_Result PRP_CALL FECS_EntityGroupIsValid(
-    FECS_WorldId world_id, const FECS_EntityGroupId *pGroup, PRP_Bool *pRslt) {
+PRP_API PRP_Result PRP_CALL FECS_SpatialQueryAABB(
+    FECS_WorldId world_id, const MATH_Vec3 *pMin, const MATH_Vec3 *pMax,
+    FECS_EntityId *pOut, PRP_Size out_cap, PRP_Size *pCount) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(pRslt != NULL);
-    PRP_DIAG_ASSERT(pGroup != NULL);
+    PRP_DIAG_ASSERT(pMin != NULL);
+    PRP_DIAG_ASSERT(pMax != NULL);
+    PRP_DIAG_ASSERT(pCount != NULL);
+    PRP_DIAG_ASSERT(pOut != NULL || !out_cap);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!pRslt || !pGroup) {
+    if (!pMin || !pMax || !pCount || (!pOut && out_cap)) {
         return PRP_ERR_INV_ARG;
     }
     FECS_World *pWorld;
@@ -285,21 +1901,29 @@ PRP_API PRP_Result PRP_CALL FECS_EntityGroupIsValid(
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
+    PRP_DIAG_ASSERT_MSG(pWorld->pSpatial != NULL,
+                        "No spatial grid is bound to the given world.");
+    if (!pWorld->pSpatial) {
+        return PRP_ERR_INV_ARG;
+    }
 
-    *pRslt = EntityGroupIsValid(pWorld, pGroup);
+    SpatialQuery(pWorld->pSpatial, pMin, pMax, NULL, 0, pOut, out_cap, pCount);
 
     return PRP_OK;
 }
 
-PRP_API PRP_Result PRP_CALL FECS_EntityKill(FECS_WorldId world_id,
-                                            FECS_EntityId *pEntity) {
+PRP_API PRP_Result PRP_CALL FECS_SpatialQueryRadius(
+    FECS_WorldId world_id, const MATH_Vec3 *pCenter, PRP_F32 radius,
+    FECS_EntityId *pOut, PRP_Size out_cap, PRP_Size *pCount) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(pEntity != NULL);
+    PRP_DIAG_ASSERT(pCenter != NULL);
+    PRP_DIAG_ASSERT(pCount != NULL);
+    PRP_DIAG_ASSERT(pOut != NULL || !out_cap);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!pEntity) {
+    if (!pCenter || !pCount || (!pOut && out_cap)) {
         return PRP_ERR_INV_ARG;
     }
     FECS_World *pWorld;
@@ -308,27 +1932,37 @@ PRP_API PRP_Result PRP_CALL FECS_EntityKill(FECS_WorldId world_id,
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
-    PRP_Bool is_valid = EntityIsValid(pWorld, *pEntity);
-    PRP_DIAG_ASSERT_MSG(
-        is_valid, "The given entity is not a valid entity in this world.");
-    if (!is_valid) {
+    PRP_DIAG_ASSERT_MSG(pWorld->pSpatial != NULL,
+                        "No spatial grid is bound to the given world.");
+    if (!pWorld->pSpatial) {
         return PRP_ERR_INV_ARG;
     }
 
-    EntityKill(pWorld, pEntity);
+    MATH_Vec3 min = {pCenter->x - radius, pCenter->y - radius,
+                     pCenter->z - radius};
+    MATH_Vec3 max = {pCenter->x + radius, pCenter->y + radius,
+                     pCenter->z + radius};
+    SpatialQuery(pWorld->pSpatial, &min, &max, pCenter, radius, pOut, out_cap,
+                 pCount);
 
     return PRP_OK;
 }
 
-PRP_API PRP_Result PRP_CALL FECS_EntityGroupKill(FECS_WorldId world_id,
-                                                 FECS_EntityGroupId **ppGroup) {
+/* ----  COLUMN SCANS ---- */
+
+PRP_API PRP_Result PRP_CALL FECS_LayoutFilter(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size pred_count,
+    const FECS_ScanPredicate *pPreds, FECS_SystemExecOccupancyMask *pMasks,
+    PRP_Size mask_cap, PRP_Size *pChunk_count) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(ppGroup != NULL);
+    PRP_DIAG_ASSERT(!pred_count || pPreds != NULL);
+    PRP_DIAG_ASSERT(!mask_cap || pMasks != NULL);
+    PRP_DIAG_ASSERT(pChunk_count != NULL);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!ppGroup) {
+    if ((pred_count && !pPreds) || (mask_cap && !pMasks) || !pChunk_count) {
         return PRP_ERR_INV_ARG;
     }
     FECS_World *pWorld;
@@ -338,27 +1972,29 @@ PRP_API PRP_Result PRP_CALL FECS_EntityGroupKill(FECS_WorldId world_id,
         return PRP_ERR_INV_ARG;
     }
     PRP_DIAG_ASSERT_MSG(
-        EntityGroupIsValid(pWorld, *ppGroup),
-        "The given entity group is not a valid entity group in this world.");
+        layout_id < pWorld->layout_count,
+        "The given layout id is not a valid layout id in this world.");
+    if (layout_id >= pWorld->layout_count) {
+        return PRP_ERR_INV_ARG;
+    }
 
-    // This checks entity group validity internally so no need for extra checks.
-    return EntityGroupKill(pWorld, ppGroup);
+    FECS_Layout *pLayout = &pWorld->pLayouts[layout_id];
+    *pChunk_count = CHUNK_DIR_LEN(&pLayout->chunk_dir);
+
+    return LayoutScanFilter(pLayout, pred_count, pPreds, mask_cap, pMasks);
 }
 
-PRP_API PRP_Result PRP_CALL FECS_EntityGetComp(FECS_WorldId world_id,
-                                               const FECS_EntityId entity,
-                                               FECS_CompId comp_id,
-                                               void **ppComp_ptr) {
+PRP_API PRP_Result PRP_CALL FECS_LayoutFilterGroup(
+    FECS_WorldId world_id, FECS_LayoutId layout_id, PRP_Size pred_count,
+    const FECS_ScanPredicate *pPreds, FECS_EntityGroupId **ppGroup) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(ppComp_ptr != NULL);
-    PRP_DIAG_ASSERT_MSG(
-        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
-        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT(!pred_count || pPreds != NULL);
+    PRP_DIAG_ASSERT(ppGroup != NULL);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!ppComp_ptr || comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+    if ((pred_count && !pPreds) || !ppGroup) {
         return PRP_ERR_INV_ARG;
     }
     FECS_World *pWorld;
@@ -367,30 +2003,30 @@ PRP_API PRP_Result PRP_CALL FECS_EntityGetComp(FECS_WorldId world_id,
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
-    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
     PRP_DIAG_ASSERT_MSG(
-        is_valid, "The given entity is not a valid entity in this world.");
-    if (!is_valid) {
+        layout_id < pWorld->layout_count,
+        "The given layout id is not a valid layout id in this world.");
+    if (layout_id >= pWorld->layout_count) {
         return PRP_ERR_INV_ARG;
     }
 
-    return EntityGetComp(pWorld, entity, comp_id, ppComp_ptr);
+    return LayoutScanFilterGroup(pWorld, layout_id, pred_count, pPreds,
+                                 ppGroup);
 }
 
-PRP_API PRP_Result PRP_CALL FECS_EntitySetComp(FECS_WorldId world_id,
-                                               FECS_EntityId entity,
-                                               FECS_CompId comp_id,
-                                               const void *pComp_data) {
+PRP_API PRP_Result PRP_CALL FECS_LayoutReduce(
+    FECS_WorldId world_id, FECS_LayoutId layout_id,
+    const FECS_ScanField *pField, FECS_ScanReduceOp op,
+    const FECS_SystemExecOccupancyMask *pMasks, PRP_Size mask_count,
+    FECS_ScanReduceResult *pResult) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(pComp_data != NULL);
-    PRP_DIAG_ASSERT_MSG(
-        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
-        "The given comp_id is not a valid component in the FECS runtime.");
+    PRP_DIAG_ASSERT(op == FECS_SCAN_REDUCE_COUNT || pField != NULL);
+    PRP_DIAG_ASSERT(pResult != NULL);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!pComp_data || comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
+    if (!pResult) {
         return PRP_ERR_INV_ARG;
     }
     FECS_World *pWorld;
@@ -399,55 +2035,56 @@ PRP_API PRP_Result PRP_CALL FECS_EntitySetComp(FECS_WorldId world_id,
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
-    PRP_Bool is_valid = EntityIsValid(pWorld, entity);
     PRP_DIAG_ASSERT_MSG(
-        is_valid, "The given entity is not a valid entity in this world.");
-    if (!is_valid) {
+        layout_id < pWorld->layout_count,
+        "The given layout id is not a valid layout id in this world.");
+    if (layout_id >= pWorld->layout_count) {
         return PRP_ERR_INV_ARG;
     }
 
-    return EntitySetComp(pWorld, entity, comp_id, pComp_data);
+    // A missing field is rejected internally, along with malformed ones.
+    return LayoutScanReduce(&pWorld->pLayouts[layout_id], pField, op,
+                            mask_count, pMasks, pResult);
 }
 
-PRP_API PRP_Result PRP_CALL FECS_EntityGroupForEach(
-    FECS_WorldId world_id, FECS_EntityGroupId *pGroup, FECS_CompId comp_id,
-    PRP_Result (*cb)(void *pComp_data, void *pUser_data), void *pUser_data) {
+/* ----  SYSTEM INSTANCE ---- */
+
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceExec(
+    FECS_WorldId world_id, FECS_SystemInstanceId system_instance_id,
+    void *pUser_data) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
-    PRP_DIAG_ASSERT(pGroup != NULL);
-    PRP_DIAG_ASSERT(cb != NULL);
-    PRP_DIAG_ASSERT_MSG(
-        comp_id < CONT_ArrLen(g_ctx->pComp_sizes),
-        "The given comp_id is not a valid component in the FECS runtime.");
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
-    if (!pGroup || !cb || comp_id >= CONT_ArrLen(g_ctx->pComp_sizes)) {
-        return PRP_ERR_INV_ARG;
-    }
     FECS_World *pWorld;
     PRP_Result code =
         CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
     if (code != PRP_OK) {
         return PRP_ERR_INV_ARG;
     }
-    PRP_DIAG_ASSERT_MSG(
-        EntityGroupIsValid(pWorld, pGroup),
-        "The given entity group is not a valid entity group in this world.");
+    PRP_DIAG_ASSERT_MSG(system_instance_id < pWorld->system_instance_count,
+                        "The given system instance id is not a valid system "
+                        "instance id in this world.");
+    if (system_instance_id >= pWorld->system_instance_count) {
+        return PRP_ERR_INV_ARG;
+    }
 
-    return EntityGroupForEach(pWorld, pGroup, comp_id, cb, pUser_data);
+    return SystemInstanceExec(pWorld, system_instance_id, pUser_data);
 }
 
-/* ----  SYSTEM INSTANCE ---- */
-
-PRP_API PRP_Result PRP_CALL FECS_SystemInstanceExec(
+PRP_API PRP_Result PRP_CALL FECS_WorldGetSystemStats(
     FECS_WorldId world_id, FECS_SystemInstanceId system_instance_id,
-    void *pUser_data) {
+    FECS_SystemStats *pStats) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
+    PRP_DIAG_ASSERT(pStats != NULL);
     PRP_DIAG_ASSERT_MSG(CONT_DSIdIsValidUnchecked(g_ctx->pWorlds, world_id),
                         "The given world id is not valid.");
+    if (!pStats) {
+        return PRP_ERR_INV_ARG;
+    }
     FECS_World *pWorld;
     PRP_Result code =
         CONT_DSIdToDataChecked(g_ctx->pWorlds, world_id, (void **)&pWorld);
@@ -461,9 +2098,7 @@ PRP_API PRP_Result PRP_CALL FECS_SystemInstanceExec(
         return PRP_ERR_INV_ARG;
     }
 
-    SystemInstanceExec(pWorld, system_instance_id, pUser_data);
-
-    return PRP_OK;
+    return SystemInstanceGetStats(pWorld, system_instance_id, pStats);
 }
 
 PRP_API PRP_Result PRP_CALL
@@ -486,6 +2121,88 @@ FECS_SystemInstanceFetchComp(const FECS_SystemExecInternalData *pExec_internals,
     return PRP_OK;
 }
 
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceFetchBatchComp(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size chunk_idx,
+    PRP_Size idx, void **ppComp_arr) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pExec_internals != NULL);
+    PRP_DIAG_ASSERT(ppComp_arr != NULL);
+    if (!pExec_internals || !ppComp_arr) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *ppComp_arr = SystemInstanceFetchBatchComp(pExec_internals, chunk_idx, idx);
+    if (!(*ppComp_arr)) {
+        return PRP_ERR_OOB;
+    }
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceFetchPrevComp(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size idx,
+    void **ppComp_arr) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pExec_internals != NULL);
+    PRP_DIAG_ASSERT(ppComp_arr != NULL);
+    if (!pExec_internals || !ppComp_arr) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *ppComp_arr = SystemInstanceFetchPrevComp(pExec_internals,
+                                              PRP_INVALID_INDEX, idx);
+    if (!(*ppComp_arr)) {
+        return PRP_ERR_OOB;
+    }
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceFetchBatchPrevComp(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size chunk_idx,
+    PRP_Size idx, void **ppComp_arr) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pExec_internals != NULL);
+    PRP_DIAG_ASSERT(ppComp_arr != NULL);
+    if (!pExec_internals || !ppComp_arr) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *ppComp_arr =
+        SystemInstanceFetchPrevComp(pExec_internals, chunk_idx, idx);
+    if (!(*ppComp_arr)) {
+        return PRP_ERR_OOB;
+    }
+
+    return PRP_OK;
+}
+
+PRP_API PRP_Result PRP_CALL FECS_SystemInstanceFetchSparse(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size idx,
+    PRP_Size slot, void **ppComp) {
+    if (!CTX_INVARIANT_EXPR) {
+        PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
+    }
+    PRP_DIAG_ASSERT(pExec_internals != NULL);
+    PRP_DIAG_ASSERT(ppComp != NULL);
+    if (!pExec_internals || !ppComp) {
+        return PRP_ERR_INV_ARG;
+    }
+
+    *ppComp = SystemInstanceFetchSparse(pExec_internals, idx, slot);
+    if (!(*ppComp)) {
+        return PRP_ERR_NOT_FOUND;
+    }
+
+    return PRP_OK;
+}
+
 /* ----  FECS ---- */
 
 PRP_API PRP_Result PRP_CALL FECS_Init(void) {
@@ -503,6 +2220,18 @@ PRP_API PRP_Result PRP_CALL FECS_Init(void) {
     if (code != PRP_OK) {
         goto err_path;
     }
+    code = CONT_ArrCreateUnchecked(sizeof(FECS_CompStorage),
+                                   CONT_ARR_DEFAULT_CAP,
+                                   &g_ctx->pComp_storages);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
+    code = CONT_ArrCreateUnchecked(sizeof(FECS_CompDefault),
+                                   CONT_ARR_DEFAULT_CAP,
+                                   &g_ctx->pComp_defaults);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
     code = CONT_ArrCreateUnchecked(sizeof(FECS_SystemInfo),
                                    CONT_ARR_DEFAULT_CAP, &g_ctx->pSystem_infos);
     if (code != PRP_OK) {
@@ -525,6 +2254,11 @@ PRP_API PRP_Result PRP_CALL FECS_Init(void) {
     if (code != PRP_OK) {
         goto err_path;
     }
+    code = CONT_StrArrCreateUnchecked(INIT_BFFR_SIZE, INIT_CAP,
+                                      &g_ctx->pComp_default_names);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
 
     return PRP_OK;
 
@@ -532,6 +2266,12 @@ err_path:
     if (g_ctx->pComp_sizes) {
         CONT_ArrDeleteUnchecked(&g_ctx->pComp_sizes);
     }
+    if (g_ctx->pComp_storages) {
+        CONT_ArrDeleteUnchecked(&g_ctx->pComp_storages);
+    }
+    if (g_ctx->pComp_defaults) {
+        CONT_ArrDeleteUnchecked(&g_ctx->pComp_defaults);
+    }
     if (g_ctx->pSystem_infos) {
         CONT_ArrDeleteUnchecked(&g_ctx->pSystem_infos);
     }
@@ -544,6 +2284,9 @@ err_path:
     if (g_ctx->pSystem_names) {
         CONT_StrArrDeleteUnchecked(&g_ctx->pSystem_names);
     }
+    if (g_ctx->pComp_default_names) {
+        CONT_StrArrDeleteUnchecked(&g_ctx->pComp_default_names);
+    }
     free(g_ctx);
     g_ctx = NULL;
 
@@ -554,8 +2297,14 @@ PRP_API void PRP_CALL FECS_Exit(void) {
     if (!CTX_INVARIANT_EXPR) {
         PRP_DIAG_PANIC_MSG("The engine is corrupted/not-initilized correctly.");
     }
+    PRP_DIAG_ASSERT_MSG(!g_ctx->world_load_count,
+                        "Every world load must be waited on before exiting.");
 
     CONT_ArrDeleteUnchecked(&g_ctx->pComp_sizes);
+    CONT_ArrDeleteUnchecked(&g_ctx->pComp_storages);
+    CONT_ArrForEachUnchecked(g_ctx->pComp_defaults, CompDefaultDeleteCb, NULL);
+    CONT_ArrDeleteUnchecked(&g_ctx->pComp_defaults);
+    CONT_StrArrDeleteUnchecked(&g_ctx->pComp_default_names);
     CONT_ArrForEachUnchecked(g_ctx->pSystem_infos, SystemInfoDeleteCb, NULL);
     CONT_ArrDeleteUnchecked(&g_ctx->pSystem_infos);
     CONT_DSArrDeleteUnchecked(&g_ctx->pWorlds);
@@ -1,13 +1,18 @@
 #include "Forge/Internals/FECS/FECS-Internals.h"
+#include "Forge/Internals/World-Compiler/Compiler-Internals.h"
+#include <pthread.h>
 
 FECS_InternalCtx *g_ctx = NULL;
 
 /* ----  COMPS ---- */
 
 PRP_Result CompRegister(PRP_Char8 *pName, PRP_Size name_len, PRP_Size comp_size,
-                        FECS_CompId *pComp_id) {
+                        FECS_CompStorage storage, FECS_CompId *pComp_id) {
     *pComp_id = FECS_INVALID_ID;
 
+    if (g_ctx->world_load_count) {
+        return PRP_ERR_BUSY;
+    }
     if (CONT_StrArrSearchUnchecked(g_ctx->pComp_names, pName, name_len,
                                    pComp_id)) {
         return PRP_ERR_ALREADY_EXISTS;
@@ -27,20 +32,80 @@ PRP_Result CompRegister(PRP_Char8 *pName, PRP_Size name_len, PRP_Size comp_size,
         CONT_StrArrPopUnchecked(g_ctx->pComp_names, NULL, NULL);
         return code;
     }
+    code = CONT_ArrPushUnchecked(g_ctx->pComp_storages, &storage);
+    if (code != PRP_OK) {
+        CONT_StrArrPopUnchecked(g_ctx->pComp_names, NULL, NULL);
+        CONT_ArrPopUnchecked(g_ctx->pComp_sizes, NULL);
+        return code;
+    }
     *pComp_id = len;
 
     return PRP_OK;
 }
 
+PRP_Result CompDefaultRegister(PRP_Char8 *pName, PRP_Size name_len,
+                               FECS_CompId comp_id, const void *pData,
+                               FECS_CompDefaultId *pDefault_id) {
+    *pDefault_id = FECS_INVALID_ID;
+
+    if (g_ctx->world_load_count) {
+        return PRP_ERR_BUSY;
+    }
+    if (CONT_StrArrSearchUnchecked(g_ctx->pComp_default_names, pName,
+                                   name_len, pDefault_id)) {
+        return PRP_ERR_ALREADY_EXISTS;
+    }
+
+    FECS_CompDefault comp_default = {.comp_id = comp_id,
+                                     .pData = malloc(COMP_SIZE(comp_id))};
+    if (!comp_default.pData) {
+        return PRP_ERR_OOM;
+    }
+    memcpy(comp_default.pData, pData, COMP_SIZE(comp_id));
+
+    PRP_Size len = CONT_ArrLen(g_ctx->pComp_defaults);
+    PRP_Result code =
+        CONT_StrArrPushUnchecked(g_ctx->pComp_default_names, pName, name_len);
+    if (code != PRP_OK) {
+        free(comp_default.pData);
+        return code;
+    }
+    code = CONT_ArrPushUnchecked(g_ctx->pComp_defaults, &comp_default);
+    if (code != PRP_OK) {
+        CONT_StrArrPopUnchecked(g_ctx->pComp_default_names, NULL, NULL);
+        free(comp_default.pData);
+        return code;
+    }
+    *pDefault_id = len;
+
+    return PRP_OK;
+}
+
+PRP_Result CompDefaultDeleteCb(void *pVal, void *_) {
+    (void)_;
+    FECS_CompDefault *pComp_default = pVal;
+
+    free(pComp_default->pData);
+#ifdef PRP_DEBUG_MODE
+    pComp_default->pData = NULL;
+#endif
+
+    return PRP_OK;
+}
+
 /* ----  SYTEMS ---- */
 
 PRP_Result SystemRegister(PRP_Char8 *pName, PRP_Size name_len,
                           FECS_SystemFunc system_func,
+                          FECS_SystemBatchFunc system_batch_func,
                           PRP_Size comp_ids_needed_count,
                           FECS_CompId *pComp_ids_needed,
                           FECS_SystemId *pSystem_id) {
     *pSystem_id = FECS_INVALID_ID;
 
+    if (g_ctx->world_load_count) {
+        return PRP_ERR_BUSY;
+    }
     if (CONT_StrArrSearchUnchecked(g_ctx->pSystem_names, pName, name_len,
                                    pSystem_id)) {
 
@@ -48,6 +113,7 @@ PRP_Result SystemRegister(PRP_Char8 *pName, PRP_Size name_len,
     }
 
     FECS_SystemInfo info = {.systmem_func = system_func,
+                            .system_batch_func = system_batch_func,
                             .comp_ids_needed_count = comp_ids_needed_count};
     info.pComp_ids_needed = malloc(sizeof(FECS_CompId) * comp_ids_needed_count);
     if (!info.pComp_ids_needed) {
@@ -57,6 +123,7 @@ PRP_Result SystemRegister(PRP_Char8 *pName, PRP_Size name_len,
     for (PRP_Size i = 0; i < comp_ids_needed_count; i++) {
         FECS_CompId comp_id = pComp_ids_needed[i];
         if (comp_id >= comps_len) {
+            free(info.pComp_ids_needed);
             return PRP_ERR_INV_ARG;
         }
         info.pComp_ids_needed[i] = comp_id;
@@ -66,11 +133,13 @@ PRP_Result SystemRegister(PRP_Char8 *pName, PRP_Size name_len,
     PRP_Result code =
         CONT_StrArrPushUnchecked(g_ctx->pSystem_names, pName, name_len);
     if (code != PRP_OK) {
+        free(info.pComp_ids_needed);
         return code;
     }
     code = CONT_ArrPushUnchecked(g_ctx->pSystem_infos, &info);
     if (code != PRP_OK) {
         CONT_StrArrPopUnchecked(g_ctx->pSystem_names, NULL, NULL);
+        free(info.pComp_ids_needed);
         return code;
     }
     *pSystem_id = len;
@@ -89,3 +158,96 @@ PRP_Result SystemInfoDeleteCb(void *pVal, void *_) {
 
     return PRP_OK;
 }
+
+/* ----  WORLD LOADS ---- */
+
+struct FECS_WorldLoadTask {
+    pthread_t thread;
+    // Guards is_done, the rest is only written by the thread till it's joined.
+    pthread_mutex_t mutex;
+    PRP_Bool is_done;
+
+    PRP_Result code;
+    FECS_World world;
+    PRP_Char8 pFile_path[];
+};
+
+/**
+ * The body of a world load thread, runs the same path as FECS_WorldLoad up to
+ * publishing the world.
+ *
+ * @param pArg The task of the thread.
+ *
+ * @return Always NULL, the result is stored in the task.
+ */
+static void *WorldLoadTaskRun(void *pArg);
+
+static void *WorldLoadTaskRun(void *pArg) {
+    FECS_WorldLoadTask *pTask = pArg;
+
+    FECS_WorldCreateInfo world_create_info;
+    PRP_Result code = CompilerCompile(pTask->pFile_path, &world_create_info);
+    if (code == PRP_OK) {
+        // The entire create info is consumed regardless.
+        code = WorldCreate(&world_create_info, &pTask->world);
+    }
+    pTask->code = code;
+
+    pthread_mutex_lock(&pTask->mutex);
+    pTask->is_done = PRP_True;
+    pthread_mutex_unlock(&pTask->mutex);
+
+    return NULL;
+}
+
+PRP_Result WorldLoadTaskCreate(const PRP_Char8 *pFile_path,
+                               FECS_WorldLoadTask **ppTask) {
+    *ppTask = NULL;
+
+    PRP_Size path_len = strlen(pFile_path);
+    FECS_WorldLoadTask *pTask =
+        malloc(sizeof(FECS_WorldLoadTask) + path_len + 1);
+    if (!pTask) {
+        return PRP_ERR_OOM;
+    }
+    memcpy(pTask->pFile_path, pFile_path, path_len + 1);
+    pTask->is_done = PRP_False;
+    pTask->code = PRP_OK;
+
+    if (pthread_mutex_init(&pTask->mutex, NULL)) {
+        free(pTask);
+        return PRP_ERR_OOM;
+    }
+    if (pthread_create(&pTask->thread, NULL, WorldLoadTaskRun, pTask)) {
+        pthread_mutex_destroy(&pTask->mutex);
+        free(pTask);
+        return PRP_ERR_RES_EXHAUSTED;
+    }
+    *ppTask = pTask;
+
+    return PRP_OK;
+}
+
+PRP_Bool WorldLoadTaskIsDone(FECS_WorldLoadTask *pTask) {
+    pthread_mutex_lock(&pTask->mutex);
+    PRP_Bool is_done = pTask->is_done;
+    pthread_mutex_unlock(&pTask->mutex);
+
+    return is_done;
+}
+
+PRP_Result WorldLoadTaskJoin(FECS_WorldLoadTask **ppTask, FECS_World *pWorld) {
+    FECS_WorldLoadTask *pTask = *ppTask;
+
+    pthread_join(pTask->thread, NULL);
+    PRP_Result code = pTask->code;
+    if (code == PRP_OK) {
+        *pWorld = pTask->world;
+    }
+
+    pthread_mutex_destroy(&pTask->mutex);
+    free(pTask);
+    *ppTask = NULL;
+
+    return code;
+}
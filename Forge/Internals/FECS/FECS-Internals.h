@@ -7,6 +7,7 @@ extern "C" {
 #include "Containers/Arr.h"
 #include "Containers/DSArr.h"
 #include "Containers/StringArr.h"
+#include "Forge/Internals/FECS-World/World-Internals.h"
 #include "Forge/Internals/Typedefs.h"
 
 /**
@@ -16,50 +17,143 @@ extern "C" {
 
 /* ----  INTERNAL CONTEXT ---- */
 
+/**
+ * Describes where and how a component's data lives inside a layout.
+ *
+ * FECS_COMP_STORAGE_COLUMN: A CHUNK_CAP long array of the component per chunk.
+ * FECS_COMP_STORAGE_TAG:    A single FECS_ChunkFreeSlotType slot mask per
+ *                           chunk, a set bit means the entity in that slot has
+ *                           the tag. Tags carry no data.
+ * FECS_COMP_STORAGE_SHARED: A single value per chunk shared by every entity of
+ *                           the chunk. Entities are grouped into chunks by
+ *                           their shared values.
+ * FECS_COMP_STORAGE_SPARSE: A dense array per layout of only the entities that
+ *                           currently have the component. Adding/removing is
+ *                           O(1) and never moves the entity.
+ * FECS_COMP_STORAGE_DOUBLE: A column plus a second copy of it holding the
+ *                           values as of the last world buffer swap, so
+ *                           systems can read the previous frame while others
+ *                           write the current one.
+ */
+typedef enum FECS_CompStorage {
+    FECS_COMP_STORAGE_COLUMN,
+    FECS_COMP_STORAGE_TAG,
+    FECS_COMP_STORAGE_SHARED,
+    FECS_COMP_STORAGE_SPARSE,
+    FECS_COMP_STORAGE_DOUBLE,
+} FECS_CompStorage;
+
 typedef struct FECS_InternalCtx {
     CONT_Arr *pComp_sizes;
+    // Parallel to pComp_sizes, stores FECS_CompStorage of each component.
+    CONT_Arr *pComp_storages;
     CONT_StrArr *pComp_names;
 
+    // Named comp values layouts can default to, see FECS_CompDefault.
+    CONT_Arr *pComp_defaults;
+    CONT_StrArr *pComp_default_names;
+
     CONT_Arr *pSystem_infos;
     CONT_StrArr *pSystem_names;
 
     CONT_DSArr *pWorlds;
+    /*
+     * Worlds being loaded in the background. Their compile reads the comp and
+     * system registries, so those can't grow till this is back to 0.
+     */
+    PRP_Size world_load_count;
 } FECS_InternalCtx;
 
 extern FECS_InternalCtx *g_ctx;
 
 #define CTX_INVARIANT_EXPR                                                     \
     (g_ctx != NULL && CONT_ArrIsValid(g_ctx->pComp_sizes) &&                   \
+     CONT_ArrIsValid(g_ctx->pComp_storages) &&                                 \
+     CONT_ArrIsValid(g_ctx->pComp_defaults) &&                                 \
      CONT_ArrIsValid(g_ctx->pSystem_infos) &&                                  \
      CONT_DSArrIsValid(g_ctx->pWorlds) &&                                      \
      CONT_StrArrIsValid(g_ctx->pComp_names) &&                                 \
      CONT_StrArrIsValid(g_ctx->pSystem_names) &&                               \
+     CONT_StrArrIsValid(g_ctx->pComp_default_names) &&                         \
      CONT_ArrLen(g_ctx->pComp_sizes) == CONT_StrArrLen(g_ctx->pComp_names) &&  \
+     CONT_ArrLen(g_ctx->pComp_sizes) == CONT_ArrLen(g_ctx->pComp_storages) &&  \
+     CONT_ArrLen(g_ctx->pComp_defaults) ==                                     \
+         CONT_StrArrLen(g_ctx->pComp_default_names) &&                         \
      CONT_ArrLen(g_ctx->pSystem_infos) ==                                      \
          CONT_StrArrLen(g_ctx->pSystem_names))
 
 /* ----  COMPS ---- */
 
+#define COMP_SIZE(comp_id)                                                     \
+    (*(PRP_Size *)CONT_ArrGetUnchecked(g_ctx->pComp_sizes, (comp_id)))
+#define COMP_STORAGE(comp_id)                                                  \
+    (*(FECS_CompStorage *)CONT_ArrGetUnchecked(g_ctx->pComp_storages,          \
+                                               (comp_id)))
+// Comps with a per entity value in a chunk column.
+#define COMP_HAS_COLUMN(comp_id)                                               \
+    (COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_COLUMN ||                      \
+     COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_DOUBLE)
+
 /**
  * Registers a new component to the FECS registry.
  *
  * @param pName     The name of the component.
  * @param name_len  The len of the name.
  * @param comp_size The size of the component struct.
+ * @param storage   How the component is stored inside layouts.
  * @param pComp_id  Output pointer to the component id.
  *
  * @return PRP_OK on success.
  * @return PRP_ERR_ALREADY_EXISTS if the component name is already used.
  * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
  * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending.
  */
 PRP_Result CompRegister(PRP_Char8 *pName, PRP_Size name_len, PRP_Size comp_size,
-                        FECS_CompId *pComp_id);
+                        FECS_CompStorage storage, FECS_CompId *pComp_id);
+
+/**
+ * A named value of a column comp, layouts declared with it in the world file
+ * spawn their entities with the value.
+ */
+typedef struct FECS_CompDefault {
+    FECS_CompId comp_id;
+    void *pData;
+} FECS_CompDefault;
+
+/**
+ * Registers a new named comp default to the FECS registry.
+ *
+ * @param pName       The name of the default.
+ * @param name_len    The len of the name.
+ * @param comp_id     The comp the value is of, must have a column.
+ * @param pData       The value, COMP_SIZE(comp_id) bytes are copied.
+ * @param pDefault_id Output pointer to the default id.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_ALREADY_EXISTS if the default name is already used.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_BUSY if a world load is pending.
+ */
+PRP_Result CompDefaultRegister(PRP_Char8 *pName, PRP_Size name_len,
+                               FECS_CompId comp_id, const void *pData,
+                               FECS_CompDefaultId *pDefault_id);
+/**
+ * Deletes a given comp default's internals.
+ * Called via CONT_ArrForEach_...
+ *
+ * @param pVal Comp default to delete internals of.
+ *
+ * @return PRP_OK on success.
+ */
+PRP_Result CompDefaultDeleteCb(void *pVal, void *_);
 
 /* ----  SYTEMS ---- */
 
 typedef struct FECS_SystemInfo {
+    // Exactly one of the two is set, depending on how it was registered.
     FECS_SystemFunc systmem_func;
+    FECS_SystemBatchFunc system_batch_func;
     PRP_Size comp_ids_needed_count;
     FECS_CompId *pComp_ids_needed;
 } FECS_SystemInfo;
@@ -69,7 +163,9 @@ typedef struct FECS_SystemInfo {
  *
  * @param pName                 The name of the system.
  * @param name_len              The len of the name.
- * @param system_func           The function pointer to the system func.
+ * @param system_func           The function pointer to the system func or NULL.
+ * @param system_batch_func     The function pointer to the batched system func
+ *                              or NULL, exactly one of the two must be set.
  * @param comp_ids_needed_count The len of the pComp_ids_needed array.
  * @param pComp_ids_needed      The array of component ids the system will use.
  * @param pSystem_id            Output pointer to the component id.
@@ -79,9 +175,11 @@ typedef struct FECS_SystemInfo {
  * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
  * @return PRP_ERR_OOM if allocation fails.
  * @return PRP_ERR_INV_ARG if pComp_ids_needed contains invalid comp id(s).
+ * @return PRP_ERR_BUSY if a world load is pending.
  */
 PRP_Result SystemRegister(PRP_Char8 *pName, PRP_Size name_len,
                           FECS_SystemFunc system_func,
+                          FECS_SystemBatchFunc system_batch_func,
                           PRP_Size comp_ids_needed_count,
                           FECS_CompId *pComp_ids_needed,
                           FECS_SystemId *pSystem_id);
@@ -96,6 +194,40 @@ PRP_Result SystemRegister(PRP_Char8 *pName, PRP_Size name_len,
  */
 PRP_Result SystemInfoDeleteCb(void *pVal, void *_);
 
+/* ----  WORLD LOADS ---- */
+
+/**
+ * Starts compiling and creating a world on a new thread. The thread only
+ * touches the task and reads the registries, the world is handed out by
+ * WorldLoadTaskJoin on the calling thread.
+ *
+ * @param pFile_path The file to load, copied into the task.
+ * @param ppTask     Output pointer to the task.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_RES_EXHAUSTED if no thread can be started.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+PRP_Result WorldLoadTaskCreate(const PRP_Char8 *pFile_path,
+                               FECS_WorldLoadTask **ppTask);
+/**
+ * Checks without blocking if the thread of a task is done.
+ *
+ * @param pTask The task to check.
+ *
+ * @return PRP_True if WorldLoadTaskJoin won't block.
+ */
+PRP_Bool WorldLoadTaskIsDone(FECS_WorldLoadTask *pTask);
+/**
+ * Blocks till the thread of a task is done and deletes the task.
+ *
+ * @param ppTask The task to join, set to NULL.
+ * @param pWorld Output pointer to the loaded world, only set on PRP_OK.
+ *
+ * @return The result of the load, same as CompilerCompile and WorldCreate.
+ */
+PRP_Result WorldLoadTaskJoin(FECS_WorldLoadTask **ppTask, FECS_World *pWorld);
+
 #ifdef __cplusplus
 }
 #endif
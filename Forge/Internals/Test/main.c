@@ -0,0 +1,572 @@
+#include "Forge/FECS.h"
+#include "Math/Matrix/Mat4/Mat4-Affine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * FECS regression tests.
+ *
+ * Usage: Test [path/to/Test.world]
+ *
+ * Every failed check prints its file, line and expression to stderr, the exit
+ * code is EXIT_FAILURE if any check failed.
+ */
+
+#define TEST_DEFAULT_WORLD_PATH ("Forge/Internals/Test/Test.world")
+// Unlinked by FECS right after it is created.
+#define TEST_CHUNK_FILE_PATH ("Forge/Internals/Test/Test.chunks")
+
+#define TEST_ENTITY_COUNT (1000)
+// The number of distinct Team values spawned into the Squad layout.
+#define TEST_TEAM_COUNT (8)
+
+#define TEST_CHECK(expr)                                                       \
+    do {                                                                       \
+        if (!(expr)) {                                                         \
+            fprintf(stderr, "%s:%d: %s failed.\n", __FILE__, __LINE__, #expr); \
+            g_failed_count++;                                                  \
+        }                                                                      \
+    } while (0)
+
+typedef struct Vec3 {
+    PRP_F32 x, y, z;
+} Vec3;
+
+// An in memory delta stream, read back from pos.
+typedef struct TestStream {
+    PRP_U8 *pData;
+    PRP_Size len;
+    PRP_Size cap;
+    PRP_Size pos;
+} TestStream;
+
+typedef struct TestCtx {
+    const PRP_Char8 *pWorld_path;
+    FECS_CompId pos_id, vel_id, team_id, hp_id, armor_id;
+} TestCtx;
+
+static PRP_Size g_failed_count = 0;
+
+/**
+ * The system of the MoveAll instance, adds Vel to Pos.
+ */
+static void Move(const FECS_SystemExecInternalData *pExec_internals,
+                 FECS_SystemExecOccupancyMask occupancy_mask,
+                 void *pUser_data);
+/**
+ * Appends to a TestStream, a FECS_DeltaWriteFunc.
+ */
+static PRP_Result StreamWrite(const void *pData, PRP_Size size,
+                              void *pUser_data);
+/**
+ * Reads the next bytes of a TestStream, a FECS_DeltaReadFunc. Reading past
+ * the end fails with PRP_ERR_IO.
+ */
+static PRP_Result StreamRead(void *pData, PRP_Size size, void *pUser_data);
+/**
+ * Sort key of the Pos comp, its x as an integer.
+ */
+static PRP_U64 PosKey(const void *pComp_data, void *pUser_data);
+/**
+ * Loads the test world and fills its Mover layout with TEST_ENTITY_COUNT
+ * entities, entity i at Pos.x = i.
+ *
+ * @param pCtx      The test ctx.
+ * @param pWorld_id Output pointer to the world.
+ * @param pMover_id Output pointer to the Mover layout.
+ * @param pEntities Output array of TEST_ENTITY_COUNT entities, may be NULL.
+ *
+ * @return PRP_OK on success, error of the failed call otherwise.
+ */
+static PRP_Result LoadMovers(const TestCtx *pCtx, FECS_WorldId *pWorld_id,
+                             FECS_LayoutId *pMover_id,
+                             FECS_EntityId *pEntities);
+/**
+ * Calls that replace, pop or repack chunks return PRP_ERR_BUSY while a spawn
+ * context of the layout is alive, and work again once it is deleted.
+ *
+ * @param pCtx The test ctx.
+ */
+static void TestSpawnCtxGuards(const TestCtx *pCtx);
+/**
+ * FECS_EntityGetComp reads compressed chunks and chunks shared with a fork
+ * without decompressing or copying them.
+ *
+ * @param pCtx The test ctx.
+ */
+static void TestGetCompReadOnly(const TestCtx *pCtx);
+/**
+ * A delta cut short fails to apply and leaves the world as it was, the whole
+ * delta applies afterwards.
+ *
+ * @param pCtx The test ctx.
+ */
+static void TestDeltaApplyRollback(const TestCtx *pCtx);
+/**
+ * Merging into a layout with a backing file copies the entities into chunks
+ * mapped from the file instead of moving the source chunks.
+ *
+ * @param pCtx The test ctx.
+ */
+static void TestMergeIntoBackingFile(const TestCtx *pCtx);
+/**
+ * Entities spawned with a shared comp value land in the chunk keyed with it,
+ * and a chunk emptied by kills is taken by the next new value instead of a
+ * new chunk.
+ *
+ * @param pCtx The test ctx.
+ */
+static void TestSharedChunkReuse(const TestCtx *pCtx);
+/**
+ * Removing a hierarchy node turns only its current children into roots that
+ * keep their world transform, a child reparented away beforehand keeps
+ * following its new parent.
+ *
+ * @param pCtx The test ctx.
+ */
+static void TestHierarchyRemoveNode(const TestCtx *pCtx);
+/**
+ * Every sparse comp of a layout resolves to its own sparse set, comps that
+ * aren't sparse or aren't in the layout resolve to none.
+ *
+ * @param pCtx The test ctx.
+ */
+static void TestSparseLookup(const TestCtx *pCtx);
+/**
+ * Fetches the world x translation of a hierarchy node.
+ */
+static PRP_F32 NodeWorldX(FECS_WorldId world_id, FECS_HierarchyNodeId node);
+
+static void Move(const FECS_SystemExecInternalData *pExec_internals,
+                 FECS_SystemExecOccupancyMask occupancy_mask,
+                 void *pUser_data) {
+    (void)pUser_data;
+    Vec3 *pPos, *pVel;
+    FECS_SystemInstanceFetchComp(pExec_internals, 0, (void **)&pPos);
+    FECS_SystemInstanceFetchComp(pExec_internals, 1, (void **)&pVel);
+
+    PRP_Size i;
+    FECS_SYSTEM_EXEC_FOREACH_OCCUPIED(occupancy_mask, i) {
+        pPos[i].x += pVel[i].x;
+        pPos[i].y += pVel[i].y;
+        pPos[i].z += pVel[i].z;
+    }
+}
+
+static PRP_Result StreamWrite(const void *pData, PRP_Size size,
+                              void *pUser_data) {
+    TestStream *pStream = pUser_data;
+    if (pStream->len + size > pStream->cap) {
+        PRP_Size cap = (pStream->len + size) * 2;
+        PRP_U8 *pNew_data = realloc(pStream->pData, cap);
+        if (!pNew_data) {
+            return PRP_ERR_OOM;
+        }
+        pStream->pData = pNew_data;
+        pStream->cap = cap;
+    }
+    memcpy(pStream->pData + pStream->len, pData, size);
+    pStream->len += size;
+
+    return PRP_OK;
+}
+
+static PRP_Result StreamRead(void *pData, PRP_Size size, void *pUser_data) {
+    TestStream *pStream = pUser_data;
+    if (size > pStream->len - pStream->pos) {
+        return PRP_ERR_IO;
+    }
+    memcpy(pData, pStream->pData + pStream->pos, size);
+    pStream->pos += size;
+
+    return PRP_OK;
+}
+
+static PRP_U64 PosKey(const void *pComp_data, void *pUser_data) {
+    (void)pUser_data;
+    const Vec3 *pPos = pComp_data;
+
+    return (PRP_U64)pPos->x;
+}
+
+static PRP_Result LoadMovers(const TestCtx *pCtx, FECS_WorldId *pWorld_id,
+                             FECS_LayoutId *pMover_id,
+                             FECS_EntityId *pEntities) {
+    PRP_Result code = FECS_WorldLoad(pCtx->pWorld_path, pWorld_id);
+    if (code != PRP_OK) {
+        return code;
+    }
+    code = FECS_WorldFindLayoutId(*pWorld_id, "Mover", 5, pMover_id);
+    for (PRP_Size i = 0; i < TEST_ENTITY_COUNT && code == PRP_OK; i++) {
+        FECS_EntityId entity;
+        code = FECS_EntitySpawn(*pWorld_id, *pMover_id, &entity);
+        if (code != PRP_OK) {
+            break;
+        }
+        Vec3 pos = {(PRP_F32)i, 0.0f, 0.0f};
+        code = FECS_EntitySetComp(*pWorld_id, entity, pCtx->pos_id, &pos);
+        if (pEntities) {
+            pEntities[i] = entity;
+        }
+    }
+    if (code != PRP_OK) {
+        FECS_WorldUnload(pWorld_id);
+    }
+
+    return code;
+}
+
+static void TestSpawnCtxGuards(const TestCtx *pCtx) {
+    FECS_WorldId world_id, other_world_id;
+    FECS_LayoutId mover_id, other_mover_id;
+    if (LoadMovers(pCtx, &world_id, &mover_id, NULL) != PRP_OK ||
+        LoadMovers(pCtx, &other_world_id, &other_mover_id, NULL) != PRP_OK) {
+        TEST_CHECK(!"The test world loads.");
+        return;
+    }
+    FECS_Fork *pFork = NULL;
+    TEST_CHECK(FECS_WorldFork(world_id, &pFork) == PRP_OK);
+    TestStream stream = {0};
+    FECS_Fork *pBase = NULL;
+    TEST_CHECK(FECS_WorldDeltaWrite(world_id, &pBase, StreamWrite, &stream) ==
+               PRP_OK);
+
+    FECS_SpawnCtx *pSpawn_ctx;
+    TEST_CHECK(FECS_SpawnCtxCreate(world_id, mover_id, 64, 0, NULL, NULL,
+                                   &pSpawn_ctx) == PRP_OK);
+    TEST_CHECK(FECS_LayoutSort(world_id, mover_id, pCtx->pos_id, PosKey, NULL,
+                               NULL) == PRP_ERR_BUSY);
+    TEST_CHECK(FECS_WorldMergeLayout(world_id, mover_id, other_world_id,
+                                     other_mover_id, NULL) == PRP_ERR_BUSY);
+    TEST_CHECK(FECS_WorldMergeLayout(other_world_id, other_mover_id, world_id,
+                                     mover_id, NULL) == PRP_ERR_BUSY);
+    TEST_CHECK(FECS_WorldRestore(world_id, pFork) == PRP_ERR_BUSY);
+    TEST_CHECK(FECS_WorldDeltaApply(world_id, StreamRead, &stream) ==
+               PRP_ERR_BUSY);
+    TEST_CHECK(stream.pos == 0);
+
+    // The reserved chunks are still the context's to spawn into.
+    FECS_EntityId entity;
+    TEST_CHECK(FECS_SpawnCtxSpawn(pSpawn_ctx, &entity) == PRP_OK);
+    PRP_Bool is_valid = PRP_False;
+    TEST_CHECK(FECS_EntityIsValid(world_id, entity, &is_valid) == PRP_OK &&
+               is_valid);
+    TEST_CHECK(FECS_SpawnCtxDelete(&pSpawn_ctx) == PRP_OK);
+
+    TEST_CHECK(FECS_LayoutSort(world_id, mover_id, pCtx->pos_id, PosKey, NULL,
+                               NULL) == PRP_OK);
+    TEST_CHECK(FECS_WorldRestore(world_id, pFork) == PRP_OK);
+    TEST_CHECK(FECS_WorldMergeLayout(other_world_id, other_mover_id, world_id,
+                                     mover_id, NULL) == PRP_OK);
+
+    free(stream.pData);
+    FECS_ForkDelete(&pBase);
+    FECS_ForkDelete(&pFork);
+    FECS_WorldUnload(&other_world_id);
+    FECS_WorldUnload(&world_id);
+}
+
+static void TestGetCompReadOnly(const TestCtx *pCtx) {
+    FECS_WorldId world_id;
+    FECS_LayoutId mover_id;
+    FECS_EntityId *pEntities =
+        malloc(sizeof(FECS_EntityId) * TEST_ENTITY_COUNT);
+    if (!pEntities ||
+        LoadMovers(pCtx, &world_id, &mover_id, pEntities) != PRP_OK) {
+        TEST_CHECK(!"The test world loads.");
+        free(pEntities);
+        return;
+    }
+    TEST_CHECK(FECS_LayoutSetCompression(world_id, mover_id, 1) == PRP_OK);
+    for (PRP_Size i = 0; i < 3; i++) {
+        TEST_CHECK(FECS_WorldCompressIdleChunks(world_id) == PRP_OK);
+    }
+    FECS_LayoutMemoryStats stats;
+    TEST_CHECK(FECS_WorldGetLayoutMemoryStats(world_id, mover_id, &stats) ==
+               PRP_OK);
+    PRP_Size compressed_chunk_count = stats.compressed_chunk_count;
+    TEST_CHECK(compressed_chunk_count > 0);
+
+    FECS_Fork *pFork = NULL;
+    TEST_CHECK(FECS_WorldFork(world_id, &pFork) == PRP_OK);
+    PRP_Size bad_count = 0;
+    for (PRP_Size i = 0; i < TEST_ENTITY_COUNT; i++) {
+        Vec3 *pPos;
+        if (FECS_EntityGetComp(world_id, pEntities[i], pCtx->pos_id,
+                               (void **)&pPos) != PRP_OK ||
+            pPos->x != (PRP_F32)i) {
+            bad_count++;
+        }
+    }
+    TEST_CHECK(bad_count == 0);
+    TEST_CHECK(FECS_WorldGetLayoutMemoryStats(world_id, mover_id, &stats) ==
+               PRP_OK);
+    TEST_CHECK(stats.compressed_chunk_count == compressed_chunk_count);
+
+    // Writes still copy the chunk away from the fork.
+    Vec3 pos = {-1.0f, 0.0f, 0.0f};
+    TEST_CHECK(FECS_EntitySetComp(world_id, pEntities[0], pCtx->pos_id, &pos) ==
+               PRP_OK);
+    TEST_CHECK(FECS_WorldRestore(world_id, pFork) == PRP_OK);
+    Vec3 *pPos = NULL;
+    TEST_CHECK(FECS_EntityGetComp(world_id, pEntities[0], pCtx->pos_id,
+                                  (void **)&pPos) == PRP_OK &&
+               pPos->x == 0.0f);
+
+    FECS_ForkDelete(&pFork);
+    FECS_WorldUnload(&world_id);
+    free(pEntities);
+}
+
+static void TestDeltaApplyRollback(const TestCtx *pCtx) {
+    FECS_WorldId world_id, replica_id;
+    FECS_LayoutId mover_id, replica_mover_id;
+    FECS_EntityId *pEntities =
+        malloc(sizeof(FECS_EntityId) * TEST_ENTITY_COUNT);
+    if (!pEntities ||
+        LoadMovers(pCtx, &world_id, &mover_id, pEntities) != PRP_OK) {
+        TEST_CHECK(!"The test world loads.");
+        free(pEntities);
+        return;
+    }
+    if (FECS_WorldLoad(pCtx->pWorld_path, &replica_id) != PRP_OK) {
+        TEST_CHECK(!"The test world loads.");
+        FECS_WorldUnload(&world_id);
+        free(pEntities);
+        return;
+    }
+    TEST_CHECK(FECS_WorldFindLayoutId(replica_id, "Mover", 5,
+                                      &replica_mover_id) == PRP_OK);
+    TestStream stream = {0};
+    FECS_Fork *pBase = NULL;
+    TEST_CHECK(FECS_WorldDeltaWrite(world_id, &pBase, StreamWrite, &stream) ==
+               PRP_OK);
+
+    // Cut inside the last layout, after the Mover layout is patched.
+    PRP_Size len = stream.len;
+    stream.len = len - 1;
+    TEST_CHECK(FECS_WorldDeltaApply(replica_id, StreamRead, &stream) ==
+               PRP_ERR_IO);
+    FECS_LayoutMemoryStats stats;
+    TEST_CHECK(FECS_WorldGetLayoutMemoryStats(replica_id, replica_mover_id,
+                                              &stats) == PRP_OK &&
+               stats.chunk_count == 0);
+    PRP_Bool is_valid = PRP_True;
+    TEST_CHECK(FECS_EntityIsValid(replica_id, pEntities[0], &is_valid) ==
+                   PRP_OK &&
+               !is_valid);
+
+    stream.len = len;
+    stream.pos = 0;
+    TEST_CHECK(FECS_WorldDeltaApply(replica_id, StreamRead, &stream) ==
+               PRP_OK);
+    PRP_Size bad_count = 0;
+    for (PRP_Size i = 0; i < TEST_ENTITY_COUNT; i++) {
+        Vec3 *pPos;
+        if (FECS_EntityGetComp(replica_id, pEntities[i], pCtx->pos_id,
+                               (void **)&pPos) != PRP_OK ||
+            pPos->x != (PRP_F32)i) {
+            bad_count++;
+        }
+    }
+    TEST_CHECK(bad_count == 0);
+
+    free(stream.pData);
+    FECS_ForkDelete(&pBase);
+    FECS_WorldUnload(&replica_id);
+    FECS_WorldUnload(&world_id);
+    free(pEntities);
+}
+
+static void TestMergeIntoBackingFile(const TestCtx *pCtx) {
+    FECS_WorldId world_id, src_world_id;
+    FECS_LayoutId mover_id, src_mover_id;
+    if (LoadMovers(pCtx, &world_id, &mover_id, NULL) != PRP_OK ||
+        LoadMovers(pCtx, &src_world_id, &src_mover_id, NULL) != PRP_OK) {
+        TEST_CHECK(!"The test world loads.");
+        return;
+    }
+    PRP_Result code =
+        FECS_LayoutSetBackingFile(world_id, mover_id, TEST_CHUNK_FILE_PATH);
+    TEST_CHECK(code == PRP_OK || code == PRP_ERR_UNSUPPORTED);
+    if (code == PRP_OK) {
+        FECS_EntityRemap *pRemap = NULL;
+        TEST_CHECK(FECS_WorldMergeLayout(world_id, mover_id, src_world_id,
+                                         src_mover_id, &pRemap) == PRP_OK);
+        FECS_LayoutMemoryStats stats;
+        TEST_CHECK(FECS_WorldGetLayoutMemoryStats(world_id, mover_id,
+                                                  &stats) == PRP_OK);
+        TEST_CHECK(stats.alive_entity_count == TEST_ENTITY_COUNT * 2);
+        TEST_CHECK(stats.file_chunk_count == stats.chunk_count);
+        FECS_EntityRemapDelete(&pRemap);
+    }
+
+    FECS_WorldUnload(&src_world_id);
+    FECS_WorldUnload(&world_id);
+}
+
+static void TestSharedChunkReuse(const TestCtx *pCtx) {
+    FECS_WorldId world_id;
+    FECS_LayoutId squad_id;
+    if (FECS_WorldLoad(pCtx->pWorld_path, &world_id) != PRP_OK) {
+        TEST_CHECK(!"The test world loads.");
+        return;
+    }
+    TEST_CHECK(FECS_WorldFindLayoutId(world_id, "Squad", 5, &squad_id) ==
+               PRP_OK);
+
+    // A chunk holds 64 entities, a chunk per team value fits all of them.
+    static FECS_EntityId entities[TEST_TEAM_COUNT * 60];
+    for (PRP_Size i = 0; i < TEST_TEAM_COUNT * 60; i++) {
+        PRP_U32 team = (PRP_U32)(i % TEST_TEAM_COUNT);
+        const void *pShared_data = &team;
+        TEST_CHECK(FECS_EntitySpawnShared(world_id, squad_id, 1,
+                                          &pCtx->team_id, &pShared_data,
+                                          &entities[i]) == PRP_OK);
+    }
+    FECS_LayoutMemoryStats stats;
+    FECS_WorldGetLayoutMemoryStats(world_id, squad_id, &stats);
+    TEST_CHECK(stats.chunk_count == TEST_TEAM_COUNT);
+
+    for (PRP_Size i = 3; i < TEST_TEAM_COUNT * 60; i += TEST_TEAM_COUNT) {
+        TEST_CHECK(FECS_EntityKill(world_id, &entities[i]) == PRP_OK);
+    }
+    PRP_U32 team = TEST_TEAM_COUNT;
+    const void *pShared_data = &team;
+    FECS_EntityId entity;
+    TEST_CHECK(FECS_EntitySpawnShared(world_id, squad_id, 1, &pCtx->team_id,
+                                      &pShared_data, &entity) == PRP_OK);
+    PRP_U32 *pTeam;
+    TEST_CHECK(FECS_EntityGetComp(world_id, entity, pCtx->team_id,
+                                  (void **)&pTeam) == PRP_OK &&
+               *pTeam == TEST_TEAM_COUNT);
+    FECS_WorldGetLayoutMemoryStats(world_id, squad_id, &stats);
+    TEST_CHECK(stats.chunk_count == TEST_TEAM_COUNT);
+    TEST_CHECK(stats.alive_entity_count == (TEST_TEAM_COUNT - 1) * 60 + 1);
+
+    FECS_WorldUnload(&world_id);
+}
+
+static PRP_F32 NodeWorldX(FECS_WorldId world_id, FECS_HierarchyNodeId node) {
+    MATH_Mat4 world;
+    if (FECS_HierarchyGetWorld(world_id, node, &world) != PRP_OK) {
+        return -1.0f;
+    }
+
+    return MATH_Mat4ExtractTranslation(world).x;
+}
+
+static void TestHierarchyRemoveNode(const TestCtx *pCtx) {
+    FECS_WorldId world_id;
+    if (FECS_WorldLoad(pCtx->pWorld_path, &world_id) != PRP_OK) {
+        TEST_CHECK(!"The test world loads.");
+        return;
+    }
+    // root -> mid -> {a -> leaf, b}, every node translates x by its value.
+    MATH_Mat4 root_local =
+        MATH_Mat4CreateTranslation(MATH_Vec3Create(10.0f, 0.0f, 0.0f));
+    MATH_Mat4 mid_local =
+        MATH_Mat4CreateTranslation(MATH_Vec3Create(3.0f, 0.0f, 0.0f));
+    MATH_Mat4 a_local =
+        MATH_Mat4CreateTranslation(MATH_Vec3Create(1.0f, 0.0f, 0.0f));
+    MATH_Mat4 b_local =
+        MATH_Mat4CreateTranslation(MATH_Vec3Create(2.0f, 0.0f, 0.0f));
+    MATH_Mat4 leaf_local =
+        MATH_Mat4CreateTranslation(MATH_Vec3Create(4.0f, 0.0f, 0.0f));
+    FECS_HierarchyNodeId root, mid, a, b, leaf;
+    TEST_CHECK(FECS_HierarchyAddNode(world_id, FECS_INVALID_ID, &root_local,
+                                     &root) == PRP_OK);
+    TEST_CHECK(FECS_HierarchyAddNode(world_id, root, &mid_local, &mid) ==
+               PRP_OK);
+    TEST_CHECK(FECS_HierarchyAddNode(world_id, mid, &a_local, &a) == PRP_OK);
+    TEST_CHECK(FECS_HierarchyAddNode(world_id, mid, &b_local, &b) == PRP_OK);
+    TEST_CHECK(FECS_HierarchyAddNode(world_id, a, &leaf_local, &leaf) ==
+               PRP_OK);
+    TEST_CHECK(FECS_HierarchySetParent(world_id, b, root) == PRP_OK);
+    TEST_CHECK(FECS_HierarchyPropagate(world_id) == PRP_OK);
+    TEST_CHECK(NodeWorldX(world_id, a) == 14.0f);
+    TEST_CHECK(NodeWorldX(world_id, b) == 12.0f);
+
+    TEST_CHECK(FECS_HierarchyRemoveNode(world_id, mid) == PRP_OK);
+    root_local = MATH_Mat4CreateTranslation(MATH_Vec3Create(20.0f, 0.0f, 0.0f));
+    TEST_CHECK(FECS_HierarchySetLocal(world_id, root, &root_local) == PRP_OK);
+    TEST_CHECK(FECS_HierarchyPropagate(world_id) == PRP_OK);
+    TEST_CHECK(NodeWorldX(world_id, a) == 14.0f);
+    TEST_CHECK(NodeWorldX(world_id, leaf) == 18.0f);
+    TEST_CHECK(NodeWorldX(world_id, b) == 22.0f);
+
+    FECS_WorldUnload(&world_id);
+}
+
+static void TestSparseLookup(const TestCtx *pCtx) {
+    FECS_WorldId world_id;
+    if (FECS_WorldLoad(pCtx->pWorld_path, &world_id) != PRP_OK) {
+        TEST_CHECK(!"The test world loads.");
+        return;
+    }
+    FECS_LayoutId squad_id, mover_id;
+    TEST_CHECK(FECS_WorldFindLayoutId(world_id, "Squad", 5, &squad_id) ==
+               PRP_OK);
+    TEST_CHECK(FECS_WorldFindLayoutId(world_id, "Mover", 5, &mover_id) ==
+               PRP_OK);
+    FECS_EntityId hp_entity, armor_entity, mover;
+    TEST_CHECK(FECS_EntitySpawn(world_id, squad_id, &hp_entity) == PRP_OK);
+    TEST_CHECK(FECS_EntitySpawn(world_id, squad_id, &armor_entity) == PRP_OK);
+    TEST_CHECK(FECS_EntitySpawn(world_id, mover_id, &mover) == PRP_OK);
+
+    PRP_U32 hp = 100, armor = 7;
+    TEST_CHECK(FECS_EntityAddSparse(world_id, hp_entity, pCtx->hp_id, &hp) ==
+               PRP_OK);
+    TEST_CHECK(FECS_EntityAddSparse(world_id, armor_entity, pCtx->armor_id,
+                                    &armor) == PRP_OK);
+    PRP_U32 *pValue;
+    TEST_CHECK(FECS_EntityGetComp(world_id, hp_entity, pCtx->hp_id,
+                                  (void **)&pValue) == PRP_OK &&
+               *pValue == hp);
+    TEST_CHECK(FECS_EntityGetComp(world_id, armor_entity, pCtx->armor_id,
+                                  (void **)&pValue) == PRP_OK &&
+               *pValue == armor);
+    TEST_CHECK(FECS_EntityGetComp(world_id, hp_entity, pCtx->armor_id,
+                                  (void **)&pValue) != PRP_OK);
+    TEST_CHECK(FECS_EntityAddSparse(world_id, hp_entity, pCtx->pos_id, &hp) !=
+               PRP_OK);
+    TEST_CHECK(FECS_EntityAddSparse(world_id, mover, pCtx->hp_id, &hp) !=
+               PRP_OK);
+
+    FECS_WorldUnload(&world_id);
+}
+
+int main(int argc, char **argv) {
+    TestCtx ctx = {.pWorld_path =
+                       argc > 1 ? argv[1] : TEST_DEFAULT_WORLD_PATH};
+
+    if (FECS_Init() != PRP_OK) {
+        return EXIT_FAILURE;
+    }
+    FECS_CompRegister("Pos", 3, sizeof(Vec3), &ctx.pos_id);
+    FECS_CompRegister("Vel", 3, sizeof(Vec3), &ctx.vel_id);
+    FECS_CompRegisterShared("Team", 4, sizeof(PRP_U32), &ctx.team_id);
+    FECS_CompRegisterSparse("Hp", 2, sizeof(PRP_U32), &ctx.hp_id);
+    FECS_CompRegisterSparse("Armor", 5, sizeof(PRP_U32), &ctx.armor_id);
+    FECS_CompId comp_ids[] = {ctx.pos_id, ctx.vel_id};
+    FECS_SystemId system_id;
+    FECS_SystemRegister("Move", 4, Move, 2, comp_ids, &system_id);
+
+    TestSpawnCtxGuards(&ctx);
+    TestGetCompReadOnly(&ctx);
+    TestDeltaApplyRollback(&ctx);
+    TestMergeIntoBackingFile(&ctx);
+    TestSharedChunkReuse(&ctx);
+    TestHierarchyRemoveNode(&ctx);
+    TestSparseLookup(&ctx);
+
+    FECS_Exit();
+    if (g_failed_count) {
+        fprintf(stderr, "%zu checks failed.\n", g_failed_count);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed.\n");
+
+    return EXIT_SUCCESS;
+}
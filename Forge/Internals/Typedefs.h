@@ -7,11 +7,13 @@ extern "C" {
 #include "Containers/Arr.h"
 #include "Containers/Bitmap.h"
 #include "Containers/DSArr.h"
+#include "Core/Time/Time.h"
 #include <string.h>
 
 /* ----  VARIOUS IDS ---- */
 
 typedef PRP_Size FECS_CompId;
+typedef PRP_Size FECS_CompDefaultId;
 typedef PRP_Size FECS_SystemId;
 
 typedef PRP_Size FECS_LayoutId;
@@ -35,6 +37,14 @@ typedef CONT_DSId FECS_WorldId;
  */
 #define FECS_COMPONENTS_MAX_CAP (PRP_U16_MAX)
 
+/* ----  WORLD ---- */
+
+/**
+ * A world being compiled and created on a background thread.
+ * Opaque, used via FECS_WorldLoadPoll and FECS_WorldLoadWait.
+ */
+typedef struct FECS_WorldLoadTask FECS_WorldLoadTask;
+
 /* ----  ENTITIES ---- */
 
 typedef struct FECS_EntityId {
@@ -48,6 +58,110 @@ typedef struct FECS_EntityGroupId {
     CONT_Arr *pChunk_views;
 } FECS_EntityGroupId;
 
+/**
+ * Maps the entity ids of a layout from before a FECS_LayoutSort or
+ * FECS_WorldMergeLayout to after it.
+ * Opaque, used via FECS_EntityRemapApply.
+ */
+typedef struct FECS_EntityRemap FECS_EntityRemap;
+/**
+ * Computes the sort key of an entity from the value of its key comp, e.g. the
+ * morton code of a position.
+ */
+typedef PRP_U64 (*FECS_LayoutSortKeyFunc)(const void *pComp_data,
+                                          void *pUser_data);
+/**
+ * A copy on write snapshot of the entities of a world.
+ * Opaque, used via FECS_WorldRestore.
+ */
+typedef struct FECS_Fork FECS_Fork;
+/**
+ * Streams the bytes of a world delta out, e.g. into a file or a socket.
+ * Must return PRP_OK only if all size bytes were written.
+ */
+typedef PRP_Result (*FECS_DeltaWriteFunc)(const void *pData, PRP_Size size,
+                                          void *pUser_data);
+/**
+ * Streams the bytes of a world delta in. Must return PRP_OK only if all size
+ * bytes were read.
+ */
+typedef PRP_Result (*FECS_DeltaReadFunc)(void *pData, PRP_Size size,
+                                         void *pUser_data);
+/**
+ * A set of chunks of a layout reserved for spawning from a single thread.
+ * Opaque, used via FECS_SpawnCtxSpawn.
+ */
+typedef struct FECS_SpawnCtx FECS_SpawnCtx;
+
+/* ----  HIERARCHY ---- */
+
+typedef PRP_Size FECS_HierarchyNodeId;
+
+/* ----  MEMORY STATS ---- */
+
+/**
+ * Memory footprint of a layout, split by what the bytes are used for.
+ *
+ * Bytes count the payload of the allocations only, container headers and
+ * allocator overhead are not included.
+ */
+typedef struct FECS_LayoutMemoryStats {
+    PRP_Size chunk_count;
+    // Chunks with no alive entity, kept around for reuse.
+    PRP_Size empty_chunk_count;
+    // Chunks with every slot occupied.
+    PRP_Size full_chunk_count;
+    // Chunks mapped from a backing file, see FECS_LayoutSetBackingFile.
+    PRP_Size file_chunk_count;
+    // Chunks with compressed columns, see FECS_LayoutSetCompression.
+    PRP_Size compressed_chunk_count;
+    PRP_Size alive_entity_count;
+    // Total entity slots of all chunks, i.e. chunk_count * chunk cap.
+    PRP_Size slot_count;
+
+    // Per chunk gens and free/enabled slot masks.
+    PRP_Size chunk_header_bytes;
+    PRP_Size tag_mask_bytes;
+    PRP_Size shared_bytes;
+    PRP_Size sparse_map_bytes;
+    // Current and previous frame columns of double buffered comps.
+    PRP_Size double_buffer_bytes;
+    // Compressed chunks count their compressed size.
+    PRP_Size column_bytes;
+    /*
+     * Column bytes of the compressed chunks before and after compression, and
+     * their ratio, 0 without compressed chunks.
+     */
+    PRP_Size compressed_raw_bytes;
+    PRP_Size compressed_bytes;
+    PRP_F32 compression_ratio;
+    // Packed values and owner idxs of the sparse sets, by capacity.
+    PRP_Size sparse_dense_bytes;
+    // Stride tables, chunk ptr array, bitmaps and scratch buffers.
+    PRP_Size metadata_bytes;
+    PRP_Size total_bytes;
+} FECS_LayoutMemoryStats;
+
+/**
+ * Memory footprint of a world, the layout fields are the sums over all of its
+ * layouts. Same counting rules as FECS_LayoutMemoryStats.
+ */
+typedef struct FECS_WorldMemoryStats {
+    PRP_Size layout_count;
+    PRP_Size chunk_count;
+    PRP_Size empty_chunk_count;
+    PRP_Size alive_entity_count;
+    PRP_Size slot_count;
+
+    PRP_Size layout_bytes;
+    PRP_Size system_instance_bytes;
+    PRP_Size hierarchy_bytes;
+    PRP_Size spatial_bytes;
+    // Layout and system instance name arrays.
+    PRP_Size name_bytes;
+    PRP_Size total_bytes;
+} FECS_WorldMemoryStats;
+
 /* ----  SYSTEMS ---- */
 
 typedef struct FECS_SystemExecInternalData FECS_SystemExecInternalData;
@@ -55,6 +169,32 @@ typedef PRP_U64 FECS_SystemExecOccupancyMask;
 typedef void (*FECS_SystemFunc)(
     const FECS_SystemExecInternalData *pExec_internals,
     FECS_SystemExecOccupancyMask occupancy_mask, void *pUser_data);
+/**
+ * Batched variant of FECS_SystemFunc, receives upto FECS_SYSTEM_EXEC_BATCH_CAP
+ * non empty chunks per call. pOccupancy_masks[i] is the mask of the i'th chunk,
+ * its comp arrays are fetched with FECS_SystemInstanceFetchBatchComp.
+ */
+typedef void (*FECS_SystemBatchFunc)(
+    const FECS_SystemExecInternalData *pExec_internals, PRP_Size chunk_count,
+    const FECS_SystemExecOccupancyMask *pOccupancy_masks, void *pUser_data);
+// Max number of chunks handed to a FECS_SystemBatchFunc per call.
+#define FECS_SYSTEM_EXEC_BATCH_CAP (16)
+
+/**
+ * Execution counters of a system instance, accumulated over every exec since
+ * the world was loaded. Only collected when built with PRP_FECS_SYSTEM_STATS.
+ *
+ * Ticks are converted with PRP_TimeTicksToTimeUnits.
+ */
+typedef struct FECS_SystemStats {
+    PRP_Size exec_count;
+    PRP_TimeTicks total_exec_ticks;
+    PRP_TimeTicks last_exec_ticks;
+    PRP_Size chunks_visited;
+    // Chunks with no entity left to process after tag filtering.
+    PRP_Size chunks_skipped_empty;
+    PRP_Size entities_processed;
+} FECS_SystemStats;
 /**
  * The user will use the idx provided to index into their component arrays
  * provided by the fetch function.
@@ -64,6 +204,135 @@ typedef void (*FECS_SystemFunc)(
            (((idx) = CONT_BitwordFFS(occupancy_mask)), 1) &&                   \
            (((occupancy_mask) &= (occupancy_mask) - 1), 1))
 
+// The occupancy mask of a chunk with every slot occupied.
+#define FECS_SYSTEM_EXEC_FULL_MASK                                             \
+    ((FECS_SystemExecOccupancyMask)(~(FECS_SystemExecOccupancyMask)0))
+// The number of slots an occupancy mask covers, i.e. the chunk cap.
+#define FECS_SYSTEM_EXEC_SLOT_COUNT                                            \
+    ((PRP_Size)(sizeof(FECS_SystemExecOccupancyMask) * 8))
+/**
+ * Full chunk fast path, if true the system can loop over
+ * [0, FECS_SYSTEM_EXEC_SLOT_COUNT) directly without touching the mask.
+ */
+#define FECS_SYSTEM_EXEC_IS_FULL(occupancy_mask)                               \
+    ((occupancy_mask) == FECS_SYSTEM_EXEC_FULL_MASK)
+
+/**
+ * Pops the lowest contiguous run of occupied slots off the occupancy mask.
+ *
+ * @param pOccupancy_mask The mask to pop the run off, the run is cleared.
+ * @param pBegin          Output pointer to the first slot of the run.
+ * @param pEnd            Output pointer to one past the last slot of the run.
+ *
+ * @return PRP_True if a run was popped, PRP_False if the mask is empty.
+ */
+static inline PRP_Bool
+FECS_SystemExecNextRun(FECS_SystemExecOccupancyMask *pOccupancy_mask,
+                       PRP_Size *pBegin, PRP_Size *pEnd) {
+    CONT_Bitword mask = *pOccupancy_mask;
+    if (!mask) {
+        return PRP_False;
+    }
+    CONT_Bitword low = mask & (~mask + 1);
+    /*
+     * Adding the lowest set bit carries through the whole run, clearing it and
+     * setting the first bit after it. Overflowing to 0 means the run reached
+     * the top of the word.
+     */
+    CONT_Bitword past_run = mask + low;
+    *pBegin = CONT_BitwordCTZ(low);
+    *pEnd = past_run ? CONT_BitwordCTZ(past_run) : BITWORD_BITS;
+    *pOccupancy_mask = (FECS_SystemExecOccupancyMask)(mask & past_run);
+
+    return PRP_True;
+}
+/**
+ * Dense run path, iterates the contiguous runs of occupied slots so the
+ * system can use plain vectorizable loops:
+ *
+ * FECS_SYSTEM_EXEC_FOREACH_RUN(occupancy_mask, begin, end) {
+ *     for (PRP_Size i = begin; i < end; i++) { ... }
+ * }
+ *
+ * Costs a couple of bit ops per run instead of per entity.
+ */
+#define FECS_SYSTEM_EXEC_FOREACH_RUN(occupancy_mask, begin, end)               \
+    while (FECS_SystemExecNextRun(&(occupancy_mask), &(begin), &(end)))
+
+/* ----  COLUMN SCANS ---- */
+
+// The type of a scalar field scanned inside a component.
+typedef enum FECS_ScanType {
+    FECS_SCAN_TYPE_F32,
+    FECS_SCAN_TYPE_F64,
+    FECS_SCAN_TYPE_I32,
+    FECS_SCAN_TYPE_U32,
+    FECS_SCAN_TYPE_I64,
+    FECS_SCAN_TYPE_U64,
+} FECS_ScanType;
+
+// A scalar value, read through the member matching the FECS_ScanType.
+typedef union FECS_ScanValue {
+    PRP_F32 f32;
+    PRP_F64 f64;
+    PRP_I32 i32;
+    PRP_U32 u32;
+    PRP_I64 i64;
+    PRP_U64 u64;
+} FECS_ScanValue;
+
+/**
+ * A scalar field inside a component, e.g. the y of a position is
+ * {pos_comp_id, offsetof(Vec3, y), FECS_SCAN_TYPE_F32}.
+ */
+typedef struct FECS_ScanField {
+    FECS_CompId comp_id;
+    PRP_Size ofs;
+    FECS_ScanType type;
+} FECS_ScanField;
+
+typedef enum FECS_ScanCmp {
+    FECS_SCAN_CMP_EQ,
+    FECS_SCAN_CMP_NE,
+    FECS_SCAN_CMP_LT,
+    FECS_SCAN_CMP_LE,
+    FECS_SCAN_CMP_GT,
+    FECS_SCAN_CMP_GE,
+    // val <= field <= hi.
+    FECS_SCAN_CMP_RANGE,
+} FECS_ScanCmp;
+
+/**
+ * Matches the entities whose field compares true against val, e.g.
+ * health < 0 is {health_field, FECS_SCAN_CMP_LT, {.f32 = 0.0f}}.
+ * hi is only read by FECS_SCAN_CMP_RANGE.
+ */
+typedef struct FECS_ScanPredicate {
+    FECS_ScanField field;
+    FECS_ScanCmp cmp;
+    FECS_ScanValue val;
+    FECS_ScanValue hi;
+} FECS_ScanPredicate;
+
+typedef enum FECS_ScanReduceOp {
+    FECS_SCAN_REDUCE_SUM,
+    FECS_SCAN_REDUCE_MIN,
+    FECS_SCAN_REDUCE_MAX,
+    // Ignores the field, only counts the entities.
+    FECS_SCAN_REDUCE_COUNT,
+} FECS_ScanReduceOp;
+
+typedef struct FECS_ScanReduceResult {
+    // Number of entities reduced.
+    PRP_Size count;
+    /*
+     * In the member matching the field type. Sums accumulate in that type,
+     * integers wrap around modulo 2^bits like unsigned ints do, signed ones
+     * included. Zeroed if count is 0 or for FECS_SCAN_REDUCE_COUNT.
+     */
+    FECS_ScanValue val;
+} FECS_ScanReduceResult;
+
 #ifdef __cplusplus
 }
 #endif
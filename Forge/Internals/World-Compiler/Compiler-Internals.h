@@ -87,9 +87,17 @@ void LexerTokStreamDelete(FECS_WCTokStream *pTok_stream);
 
 /* ----  PARSER ---- */
 
+// A "Comp: Default;" field of a layout decl.
+typedef struct FECS_WCCompDefaultDecl {
+    FECS_WCIdentifierTok comp_name;
+    FECS_WCIdentifierTok default_name;
+} FECS_WCCompDefaultDecl;
+
 typedef struct FECS_WCLayoutDecl {
     FECS_WCIdentifierTok layout_name;
     CONT_Arr *pComp_names;
+    // Comps with a default are in pComp_names too.
+    CONT_Arr *pDefault_decls;
 } FECS_WCLayoutDecl;
 
 typedef struct FECS_WCSystemInstanceDecl {
@@ -1,6 +1,7 @@
 #include "Forge/Internals/World-Compiler/Compiler-Internals.h"
 
 #define TOKS_PER_FIELD (2)
+#define TOKS_PER_DEFAULT_FIELD (4)
 #define EMPTY_DECL_TOK_COUNT (4)
 
 typedef struct ParserState {
@@ -202,6 +203,7 @@ static PRP_Result LayoutDelCb(void *pVal, void *_) {
     FECS_WCLayoutDecl *pLayout_decl = pVal;
 
     CONT_ArrDeleteUnchecked(&pLayout_decl->pComp_names);
+    CONT_ArrDeleteUnchecked(&pLayout_decl->pDefault_decls);
 
     return PRP_OK;
 }
@@ -222,16 +224,34 @@ static PRP_Result ParseLayoutDecl(ParserState *pParser_state,
     if (code != PRP_OK) {
         return code;
     }
+    code = CONT_ArrCreateUnchecked(sizeof(FECS_WCCompDefaultDecl),
+                                   CONT_ARR_DEFAULT_CAP,
+                                   &layout_decl.pDefault_decls);
+    if (code != PRP_OK) {
+        goto err_path;
+    }
 
     layout_decl.layout_name = RegisterIdentifier(pParser_state, pParse_table);
     pParse_table->layout_names_size += layout_decl.layout_name.size;
 
+    // A field is either "Comp;" or "Comp: Default;".
     FECS_WCTokType pMatch[TOKS_PER_FIELD] = {WC_TOK_IDENTIFIER,
                                              WC_TOK_SEMICOLON};
-    for (PRP_Size i = 0; i < toks_to_parse;
-         i += TOKS_PER_FIELD, pParser_state->types_idx += TOKS_PER_FIELD) {
-        if (memcmp(&pParser_state->pTypes[pParser_state->types_idx], pMatch,
-                   sizeof(FECS_WCTokType) * TOKS_PER_FIELD) != 0) {
+    FECS_WCTokType pDefault_match[TOKS_PER_DEFAULT_FIELD] = {
+        WC_TOK_IDENTIFIER, WC_TOK_COLON, WC_TOK_IDENTIFIER, WC_TOK_SEMICOLON};
+    for (PRP_Size i = 0; i < toks_to_parse;) {
+        const FECS_WCTokType *pField =
+            &pParser_state->pTypes[pParser_state->types_idx];
+        PRP_Size field_toks;
+        if (memcmp(pField, pMatch, sizeof(FECS_WCTokType) * TOKS_PER_FIELD) ==
+            0) {
+            field_toks = TOKS_PER_FIELD;
+        } else if (toks_to_parse - i >= TOKS_PER_DEFAULT_FIELD &&
+                   memcmp(pField, pDefault_match,
+                          sizeof(FECS_WCTokType) * TOKS_PER_DEFAULT_FIELD) ==
+                       0) {
+            field_toks = TOKS_PER_DEFAULT_FIELD;
+        } else {
             code = PRP_ERR_PARSE;
             goto err_path;
         }
@@ -241,6 +261,19 @@ static PRP_Result ParseLayoutDecl(ParserState *pParser_state,
         if (code != PRP_OK) {
             goto err_path;
         }
+        if (field_toks == TOKS_PER_DEFAULT_FIELD) {
+            FECS_WCCompDefaultDecl default_decl = {
+                .comp_name = comp_name,
+                .default_name =
+                    RegisterIdentifier(pParser_state, pParse_table)};
+            code = CONT_ArrPushUnchecked(layout_decl.pDefault_decls,
+                                         &default_decl);
+            if (code != PRP_OK) {
+                goto err_path;
+            }
+        }
+        i += field_toks;
+        pParser_state->types_idx += field_toks;
     }
     CONT_ArrShrinkFitUnchecked(layout_decl.pComp_names);
     code = CONT_ArrPushUnchecked(pParse_table->pLayout_table, &layout_decl);
@@ -252,6 +285,9 @@ static PRP_Result ParseLayoutDecl(ParserState *pParser_state,
 
 err_path:
     CONT_ArrDeleteUnchecked(&layout_decl.pComp_names);
+    if (layout_decl.pDefault_decls) {
+        CONT_ArrDeleteUnchecked(&layout_decl.pDefault_decls);
+    }
 
     return code;
 }
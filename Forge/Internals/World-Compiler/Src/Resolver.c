@@ -47,6 +47,27 @@ static PRP_Result CreateInfoInit(const FECS_WCParseTable *pParse_table,
  */
 static PRP_Result ResolveCompName(void *pVal, void *pUser_data);
 
+/**
+ * Resolves the "Comp: Default;" fields of a layout decl into comp default ids.
+ *
+ * @param pLayout_name     The name of the layout to resolve.
+ * @param layout_name_len  The len of the layout name.
+ * @param pLayout_decl     The layout decl to resolve.
+ * @param pIdentifier_bffr The identifier bbfr that stores names of comps and
+ *                         defaults in the pParse_table.
+ * @param ppDefault_ids    Output resolved FECS_CompDefaultId array, NULL if the
+ *                         layout has no defaults.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ * @return PRP_ERR_NOT_FOUND if a default name couldn't be resolved or is not a
+ *                           default of its comp.
+ */
+static PRP_Result ResolveLayoutDefaults(const PRP_Char8 *pLayout_name,
+                                        PRP_Size layout_name_len,
+                                        const FECS_WCLayoutDecl *pLayout_decl,
+                                        CONT_ByteBffr *pIdentifier_bffr,
+                                        CONT_Arr **ppDefault_ids);
 /**
  * Resolve an entire layout decl to create pLayout_create_info bitmap.
  * Called via CONT_ArrForEach_...
@@ -57,6 +78,8 @@ static PRP_Result ResolveCompName(void *pVal, void *pUser_data);
  * @return PRP_OK on success.
  * @return PRP_OK if layout already exists. This is to not halt foreach exec.
  * @return PRP_OK if unregisterd comps exist. This is to not halt foreach exec.
+ * @return PRP_OK if unregisterd/mismatched comp defaults exist. This is to not
+ *                halt foreach exec.
  * @return PRP_ERR_RES_EXHAUSTED if max cap is reached.
  * @return PRP_ERR_OOM if allocation fails.
  */
@@ -82,6 +105,24 @@ static PRP_Result CreateSystemInstanceCompSets(
     FECS_WCSystemInstanceDecl *pSystem_instance_decl,
     CONT_ByteBffr *pIdentifier_bffr, CONT_Bitmap **ppInc_comp_set,
     CONT_Bitmap **ppExc_comp_set);
+/**
+ * Moves the tag (and sparse) components of the inc and exc comp sets into the
+ * tag filter of the system instance create info.
+ * Exc tags are cleared from the exc comp set since tags filter entities and not
+ * layouts, inc tags stay in the inc comp set since the layout must still
+ * declare the tag for the entities to have it.
+ *
+ * @param pInc_comp_set                The inc component bit set.
+ * @param pExc_comp_set                The exc component bit set.
+ * @param pSystem_instance_create_info Create info to where load the tag
+ *                                     filters.
+ *
+ * @return PRP_OK on success.
+ * @return PRP_ERR_OOM if allocation fails.
+ */
+static PRP_Result
+ExtractTagFilters(const CONT_Bitmap *pInc_comp_set, CONT_Bitmap *pExc_comp_set,
+                  FECS_SystemInstanceCreateInfo *pSystem_instance_create_info);
 /**
  * Filters existing layouts based on the inc and exc comp sets.
  *
@@ -124,6 +165,15 @@ static void DestroyCreateInfo(FECS_WorldCreateInfo *pCreate_info) {
             CONT_BitmapDeleteUnchecked(&pLayout_create_info);
         }
         free(pCreate_info->ppLayout_create_infos);
+        if (pCreate_info->ppLayout_defaults) {
+            for (PRP_Size i = 0; i < pCreate_info->layout_count; i++) {
+                if (pCreate_info->ppLayout_defaults[i]) {
+                    CONT_ArrDeleteUnchecked(
+                        &pCreate_info->ppLayout_defaults[i]);
+                }
+            }
+            free(pCreate_info->ppLayout_defaults);
+        }
         CONT_StrArrDeleteUnchecked(&pCreate_info->pLayout_names);
         pCreate_info->layout_count = 0;
     }
@@ -132,6 +182,7 @@ static void DestroyCreateInfo(FECS_WorldCreateInfo *pCreate_info) {
             FECS_SystemInstanceCreateInfo *pSystem_instance_create_info =
                 &pCreate_info->pSystem_instance_create_infos[i];
             free(pSystem_instance_create_info->pLayout_id_matches);
+            free(pSystem_instance_create_info->pTag_filter_ids);
         }
         free(pCreate_info->pSystem_instance_create_infos);
         CONT_StrArrDeleteUnchecked(&pCreate_info->pSystem_instance_names);
@@ -144,6 +195,7 @@ static PRP_Result CreateInfoInit(const FECS_WCParseTable *pParse_table,
     // This will be incremented as we parse, this is to account for failed init.
     pCreate_info->layout_count = 0;
     pCreate_info->system_instance_count = 0;
+    pCreate_info->ppLayout_defaults = NULL;
 
     PRP_Size layout_count = CONT_ArrLen(pParse_table->pLayout_table);
     pCreate_info->ppLayout_create_infos =
@@ -158,6 +210,11 @@ static PRP_Result CreateInfoInit(const FECS_WCParseTable *pParse_table,
         DestroyCreateInfo(pCreate_info);
         return code;
     }
+    pCreate_info->ppLayout_defaults = calloc(layout_count, sizeof(CONT_Arr *));
+    if (!pCreate_info->ppLayout_defaults) {
+        DestroyCreateInfo(pCreate_info);
+        return PRP_ERR_OOM;
+    }
 
     PRP_Size system_instance_count =
         CONT_ArrLen(pParse_table->pSystem_instance_table);
@@ -196,6 +253,69 @@ static PRP_Result ResolveCompName(void *pVal, void *pUser_data) {
     return PRP_OK;
 }
 
+static PRP_Result ResolveLayoutDefaults(const PRP_Char8 *pLayout_name,
+                                        PRP_Size layout_name_len,
+                                        const FECS_WCLayoutDecl *pLayout_decl,
+                                        CONT_ByteBffr *pIdentifier_bffr,
+                                        CONT_Arr **ppDefault_ids) {
+    *ppDefault_ids = NULL;
+    PRP_Size default_count;
+    const FECS_WCCompDefaultDecl *pDefault_decls =
+        CONT_ArrRawUnchecked(pLayout_decl->pDefault_decls, &default_count);
+    if (!default_count) {
+        return PRP_OK;
+    }
+
+    PRP_Result code = CONT_ArrCreateUnchecked(
+        sizeof(FECS_CompDefaultId), default_count, ppDefault_ids);
+    if (code != PRP_OK) {
+        return code;
+    }
+    for (PRP_Size i = 0; i < default_count; i++) {
+        FECS_WCIdentifierTok comp_tok = pDefault_decls[i].comp_name;
+        FECS_WCIdentifierTok default_tok = pDefault_decls[i].default_name;
+        PRP_Char8 *pComp_name =
+            CONT_ByteBffrGetUnchecked(pIdentifier_bffr, comp_tok.ofs);
+        PRP_Char8 *pDefault_name =
+            CONT_ByteBffrGetUnchecked(pIdentifier_bffr, default_tok.ofs);
+
+        // The comp names were already resolved, so this never fails.
+        FECS_CompId comp_id;
+        CONT_StrArrSearchUnchecked(g_ctx->pComp_names, pComp_name,
+                                   comp_tok.size, &comp_id);
+        FECS_CompDefaultId default_id;
+        if (!CONT_StrArrSearchUnchecked(g_ctx->pComp_default_names,
+                                        pDefault_name, default_tok.size,
+                                        &default_id)) {
+            PRP_LOG_INFO(PRP_LOG_DEFAULT_LOG_FILE,
+                         "Layout: %.*s, contains unregistered component "
+                         "default name: %.*s, the entire layout declaration "
+                         "will be skipped.",
+                         (int)layout_name_len, pLayout_name,
+                         (int)default_tok.size, pDefault_name);
+            CONT_ArrDeleteUnchecked(ppDefault_ids);
+            return PRP_ERR_NOT_FOUND;
+        }
+        const FECS_CompDefault *pComp_default =
+            CONT_ArrGetUnchecked(g_ctx->pComp_defaults, default_id);
+        if (pComp_default->comp_id != comp_id) {
+            PRP_LOG_INFO(PRP_LOG_DEFAULT_LOG_FILE,
+                         "Layout: %.*s, uses component default: %.*s, which "
+                         "is not a default of component: %.*s, the entire "
+                         "layout declaration will be skipped.",
+                         (int)layout_name_len, pLayout_name,
+                         (int)default_tok.size, pDefault_name,
+                         (int)comp_tok.size, pComp_name);
+            CONT_ArrDeleteUnchecked(ppDefault_ids);
+            return PRP_ERR_NOT_FOUND;
+        }
+        // Can't fail, the arr was created with room for every default.
+        CONT_ArrPushUnchecked(*ppDefault_ids, &default_id);
+    }
+
+    return PRP_OK;
+}
+
 static PRP_Result ResolveLayoutDecl(void *pVal, void *pUser_data) {
     FECS_WCLayoutDecl *pLayout_decl = pVal;
     DeclResolveData *pResolve_data = pUser_data;
@@ -233,15 +353,29 @@ static PRP_Result ResolveLayoutDecl(void *pVal, void *pUser_data) {
             (int)comp_resolve_data.comp_name_len, comp_resolve_data.pName);
         return PRP_OK;
     }
+    CONT_Arr *pDefault_ids;
+    code = ResolveLayoutDefaults(pLayout_name, layout_name_len, pLayout_decl,
+                                 pResolve_data->pIdentifier_bffr,
+                                 &pDefault_ids);
+    if (code != PRP_OK) {
+        CONT_BitmapDeleteUnchecked(&pLayout_create_info);
+        return code == PRP_ERR_NOT_FOUND ? PRP_OK : code;
+    }
 
     code = CONT_StrArrPushUnchecked(pResolve_data->pCreate_info->pLayout_names,
                                     pLayout_name, layout_name_len);
     if (code != PRP_OK) {
         CONT_BitmapDeleteUnchecked(&pLayout_create_info);
+        if (pDefault_ids) {
+            CONT_ArrDeleteUnchecked(&pDefault_ids);
+        }
         return code;
     }
     CONT_Bitmap **ppLayout_create_infos =
         pResolve_data->pCreate_info->ppLayout_create_infos;
+    pResolve_data->pCreate_info
+        ->ppLayout_defaults[pResolve_data->pCreate_info->layout_count] =
+        pDefault_ids;
     ppLayout_create_infos[pResolve_data->pCreate_info->layout_count++] =
         pLayout_create_info;
 
@@ -299,6 +433,71 @@ static PRP_Result CreateSystemInstanceCompSets(
     return PRP_OK;
 }
 
+static PRP_Result
+ExtractTagFilters(const CONT_Bitmap *pInc_comp_set, CONT_Bitmap *pExc_comp_set,
+                  FECS_SystemInstanceCreateInfo *pSystem_instance_create_info) {
+    const CONT_Bitmap *pComp_sets[] = {pInc_comp_set, pExc_comp_set};
+    PRP_Size tag_counts[2] = {0, 0};
+
+    for (PRP_Size k = 0; k < 2; k++) {
+        PRP_Size cap, bit_cap;
+        const CONT_Bitword *pBitwords =
+            CONT_BitmapRawUnchecked(pComp_sets[k], &cap, &bit_cap);
+        for (PRP_Size i = 0, j = 0; i < cap; i++) {
+            CONT_Bitword word = pBitwords[i];
+            while (word) {
+                PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+                if (COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_TAG ||
+                    COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_SPARSE) {
+                    tag_counts[k]++;
+                }
+                word &= word - 1;
+            }
+            j += sizeof(CONT_Bitword) * 8;
+        }
+    }
+
+    pSystem_instance_create_info->inc_tag_count = tag_counts[0];
+    pSystem_instance_create_info->tag_filter_count =
+        tag_counts[0] + tag_counts[1];
+    if (pSystem_instance_create_info->tag_filter_count == 0) {
+        return PRP_OK;
+    }
+    pSystem_instance_create_info->pTag_filter_ids = malloc(
+        sizeof(FECS_CompId) * pSystem_instance_create_info->tag_filter_count);
+    if (!pSystem_instance_create_info->pTag_filter_ids) {
+        pSystem_instance_create_info->inc_tag_count = 0;
+        pSystem_instance_create_info->tag_filter_count = 0;
+        return PRP_ERR_OOM;
+    }
+
+    PRP_Size tag_i = 0;
+    for (PRP_Size k = 0; k < 2; k++) {
+        PRP_Size cap, bit_cap;
+        const CONT_Bitword *pBitwords =
+            CONT_BitmapRawUnchecked(pComp_sets[k], &cap, &bit_cap);
+        for (PRP_Size i = 0, j = 0; i < cap; i++) {
+            // Copied since the exc set is modified while iterating.
+            CONT_Bitword word = pBitwords[i];
+            while (word) {
+                PRP_Size comp_id = CONT_BitwordFFS(word) + j;
+                if (COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_TAG ||
+                    COMP_STORAGE(comp_id) == FECS_COMP_STORAGE_SPARSE) {
+                    pSystem_instance_create_info->pTag_filter_ids[tag_i++] =
+                        comp_id;
+                    if (k == 1) {
+                        CONT_BitmapClrUnchecked(pExc_comp_set, comp_id);
+                    }
+                }
+                word &= word - 1;
+            }
+            j += sizeof(CONT_Bitword) * 8;
+        }
+    }
+
+    return PRP_OK;
+}
+
 static PRP_Result
 FilterLayouts(DeclResolveData *pResolve_data, CONT_Bitmap *pInc_comp_set,
               CONT_Bitmap *pExc_comp_set,
@@ -415,7 +614,10 @@ static PRP_Result ResolveSystemInstanceDecl(void *pVal, void *pUser_data) {
         .system_id = system_id,
         .layout_id_match_count = 0,
         .pLayout_id_matches = NULL,
-        .stride_dispatch_count = pSystem_info->comp_ids_needed_count};
+        .stride_dispatch_count = pSystem_info->comp_ids_needed_count,
+        .tag_filter_count = 0,
+        .inc_tag_count = 0,
+        .pTag_filter_ids = NULL};
     code = PRP_OK; // Never hurts to be explicit.
     if (CONT_BitmapHasAnyUnchecked(pExc_comp_set, pInc_comp_set)) {
         PRP_LOG_INFO(PRP_LOG_DEFAULT_LOG_FILE,
@@ -423,12 +625,17 @@ static PRP_Result ResolveSystemInstanceDecl(void *pVal, void *pUser_data) {
                      "exclude components, this will not match any layouts.",
                      system_instance_name_len, pSystem_instance_name);
     } else if (pResolve_data->pCreate_info->layout_count != 0) {
-        code = FilterLayouts(pResolve_data, pInc_comp_set, pExc_comp_set,
-                             &system_instance_create_info);
+        code = ExtractTagFilters(pInc_comp_set, pExc_comp_set,
+                                 &system_instance_create_info);
+        if (code == PRP_OK) {
+            code = FilterLayouts(pResolve_data, pInc_comp_set, pExc_comp_set,
+                                 &system_instance_create_info);
+        }
     }
     CONT_BitmapDeleteUnchecked(&pInc_comp_set);
     CONT_BitmapDeleteUnchecked(&pExc_comp_set);
     if (code != PRP_OK) {
+        free(system_instance_create_info.pTag_filter_ids);
         return code;
     }
 
@@ -437,6 +644,7 @@ static PRP_Result ResolveSystemInstanceDecl(void *pVal, void *pUser_data) {
         pSystem_instance_name, system_instance_name_len);
     if (code != PRP_OK) {
         free(system_instance_create_info.pLayout_id_matches);
+        free(system_instance_create_info.pTag_filter_ids);
         return code;
     }
     FECS_SystemInstanceCreateInfo *pSystem_instance_create_infos =